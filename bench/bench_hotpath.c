@@ -0,0 +1,271 @@
+/**
+ * @file bench_hotpath.c
+ * @brief ns/op and throughput of the SDK hot paths, emitted as JSON
+ *
+ * Runs against tests/mock_hal.c, whose HTTP post copies the body and returns
+ * immediately, so a flush measures serialization and bookkeeping only. The
+ * same source is built twice: bench_hotpath and bench_hotpath_ts (with
+ * PLEXUS_ENABLE_THREAD_SAFE=1). The mock mutex is a counter, so the
+ * difference is the SDK's locking overhead, not a real lock's cost.
+ *
+ * Build: cmake -S bench -B build-bench && cmake --build build-bench && ./build-bench/bench_hotpath
+ * Compare: ./build-bench/bench_hotpath > before.json (one JSON document on stdout)
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Each case runs for at least this long after calibration */
+#define MIN_CASE_NS 200000000ull
+
+static volatile uint32_t s_sink; /* Keeps results observable */
+static char s_buf[PLEXUS_JSON_BUFFER_SIZE];
+static int s_results = 0;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/*
+ * A case runs `iters` operations and returns the nanoseconds they took, so
+ * cases with per-iteration setup can leave it out of the measurement.
+ */
+typedef uint64_t (*bench_fn)(plexus_client_t* client, uint32_t iters);
+
+static void report(const char* name, uint32_t iters, uint64_t ns,
+                   double items_per_op, const char* unit) {
+    double ns_per_op = (double)ns / (double)iters;
+    double ops_per_sec = ns_per_op > 0.0 ? 1e9 / ns_per_op : 0.0;
+    printf("%s\n    {\"name\": \"%s\", \"iterations\": %lu, \"ns_per_op\": %.2f, "
+           "\"ops_per_sec\": %.0f, \"throughput\": %.0f, \"unit\": \"%s\"}",
+           s_results++ ? "," : "", name, (unsigned long)iters, ns_per_op,
+           ops_per_sec, ops_per_sec * items_per_op, unit);
+}
+
+static void run_case(const char* name, bench_fn fn, plexus_client_t* client,
+                     double items_per_op, const char* unit) {
+    uint32_t iters = 64;
+    uint64_t ns = fn(client, iters); /* Warm caches */
+
+    /* Double until the run is long enough to trust, then report that run */
+    do {
+        iters *= 2;
+        ns = fn(client, iters);
+    } while (ns < MIN_CASE_NS && iters < (1u << 30));
+
+    report(name, iters, ns, items_per_op, unit);
+}
+
+/* ---- Setup helpers ---- */
+
+static plexus_client_t* new_client(void) {
+    plexus_client_t* c = plexus_init("plx_bench_key", "bench-001");
+    if (c) {
+        /* Only explicit flushes; the bench never calls plexus_tick() */
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    }
+    return c;
+}
+
+static const char* s_tag_keys[PLEXUS_MAX_TAGS] = { "host", "zone", "line", "unit" };
+static const char* s_tag_values[PLEXUS_MAX_TAGS] = { "gw-01", "eu-west", "3", "a" };
+
+/* Value types for the serialize cases */
+enum { VAL_NUMBER, VAL_STRING, VAL_BOOL };
+
+static void fill_queue(plexus_client_t* c, int type, uint16_t points, uint8_t tags) {
+    plexus_clear(c);
+    for (uint16_t i = 0; i < points; i++) {
+        plexus_err_t err = PLEXUS_OK;
+#if PLEXUS_ENABLE_TAGS
+        if (tags > 0) {
+            err = plexus_send_number_tagged(c, "motor.rpm", 1500.0 + i,
+                                            s_tag_keys, s_tag_values, tags);
+        } else
+#endif
+        if (type == VAL_NUMBER) {
+            err = plexus_send_number(c, "motor.rpm", 1500.0 + i);
+#if PLEXUS_ENABLE_STRING_VALUES
+        } else if (type == VAL_STRING) {
+            err = plexus_send_string(c, "motor.state", "running");
+#endif
+#if PLEXUS_ENABLE_BOOL_VALUES
+        } else if (type == VAL_BOOL) {
+            err = plexus_send_bool(c, "motor.on", true);
+#endif
+        }
+        (void)err;
+    }
+    (void)tags;
+}
+
+/* ---- Cases ---- */
+
+static uint64_t bench_send_number(plexus_client_t* c, uint32_t iters) {
+    plexus_clear(c);
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        if (plexus_send_number(c, "motor.rpm", (double)i) != PLEXUS_OK) {
+            plexus_clear(c); /* Queue full: amortized into the send cost */
+        }
+    }
+    return now_ns() - start;
+}
+
+#if PLEXUS_ENABLE_TAGS
+static uint64_t bench_send_number_tagged(plexus_client_t* c, uint32_t iters) {
+    plexus_clear(c);
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        if (plexus_send_number_tagged(c, "motor.rpm", (double)i,
+                                      s_tag_keys, s_tag_values, 2) != PLEXUS_OK) {
+            plexus_clear(c);
+        }
+    }
+    return now_ns() - start;
+}
+#endif
+
+static uint64_t bench_json_serialize(plexus_client_t* c, uint32_t iters) {
+    /* Queue filled by the caller; serialization leaves it untouched */
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        s_sink += (uint32_t)plexus_json_serialize(c, s_buf, sizeof(s_buf));
+    }
+    return now_ns() - start;
+}
+
+#if PLEXUS_ENABLE_WEBSOCKET
+static const char s_ws_msg[] =
+    "{\"type\":\"typed_command\",\"id\":\"cmd_8f2a\",\"command\":\"set_speed\","
+    "\"params\":{\"rpm\":1800,\"ramp_ms\":500,\"mode\":\"closed_loop\"}}";
+
+static uint64_t bench_ws_find_string(plexus_client_t* c, uint32_t iters) {
+    char out[32];
+    (void)c;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        s_sink += plexus_json_find_string(s_ws_msg, "command", out, sizeof(out));
+    }
+    return now_ns() - start;
+}
+
+static uint64_t bench_ws_find_value(plexus_client_t* c, uint32_t iters) {
+    char out[128];
+    (void)c;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        s_sink += plexus_json_find_value(s_ws_msg, "params", out, sizeof(out));
+    }
+    return now_ns() - start;
+}
+#endif
+
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+static size_t s_crc_len;
+
+static uint64_t bench_crc32(plexus_client_t* c, uint32_t iters) {
+    (void)c;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        s_sink += plexus_crc32(s_buf, s_crc_len);
+    }
+    return now_ns() - start;
+}
+#endif
+
+static uint16_t s_flush_points;
+
+static uint64_t bench_flush(plexus_client_t* c, uint32_t iters) {
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < iters; i++) {
+        fill_queue(c, VAL_NUMBER, s_flush_points, 0);
+        uint64_t start = now_ns();
+        s_sink += (uint32_t)plexus_flush(c);
+        total += now_ns() - start;
+    }
+    return total;
+}
+
+int main(void) {
+    static const uint16_t batch_sizes[] = { 1, 8, PLEXUS_MAX_METRICS };
+    char name[64];
+
+    plexus_client_t* c = new_client();
+    if (!c) {
+        fprintf(stderr, "bench_hotpath: plexus_init failed\n");
+        return 1;
+    }
+
+    printf("{\n  \"suite\": \"plexus_hotpath\",\n  \"sdk_version\": \"%s\",\n"
+           "  \"config\": {\"thread_safe\": %d, \"max_metrics\": %d, \"json_buffer_size\": %d},\n"
+           "  \"results\": [",
+           PLEXUS_SDK_VERSION, PLEXUS_ENABLE_THREAD_SAFE, PLEXUS_MAX_METRICS,
+           PLEXUS_JSON_BUFFER_SIZE);
+
+    run_case("send_number", bench_send_number, c, 1.0, "points/s");
+#if PLEXUS_ENABLE_TAGS
+    run_case("send_number_tagged/tags=2", bench_send_number_tagged, c, 1.0, "points/s");
+#endif
+
+    for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+        fill_queue(c, VAL_NUMBER, batch_sizes[i], 0);
+        snprintf(name, sizeof(name), "json_serialize/number/n=%u", (unsigned)batch_sizes[i]);
+        run_case(name, bench_json_serialize, c, batch_sizes[i], "points/s");
+    }
+#if PLEXUS_ENABLE_STRING_VALUES
+    fill_queue(c, VAL_STRING, PLEXUS_MAX_METRICS, 0);
+    snprintf(name, sizeof(name), "json_serialize/string/n=%u", (unsigned)PLEXUS_MAX_METRICS);
+    run_case(name, bench_json_serialize, c, PLEXUS_MAX_METRICS, "points/s");
+#endif
+#if PLEXUS_ENABLE_BOOL_VALUES
+    fill_queue(c, VAL_BOOL, PLEXUS_MAX_METRICS, 0);
+    snprintf(name, sizeof(name), "json_serialize/bool/n=%u", (unsigned)PLEXUS_MAX_METRICS);
+    run_case(name, bench_json_serialize, c, PLEXUS_MAX_METRICS, "points/s");
+#endif
+#if PLEXUS_ENABLE_TAGS
+    for (uint8_t tags = 2; tags <= PLEXUS_MAX_TAGS; tags += 2) {
+        fill_queue(c, VAL_NUMBER, PLEXUS_MAX_METRICS, tags);
+        snprintf(name, sizeof(name), "json_serialize/number/n=%u/tags=%u",
+                 (unsigned)PLEXUS_MAX_METRICS, (unsigned)tags);
+        run_case(name, bench_json_serialize, c, PLEXUS_MAX_METRICS, "points/s");
+    }
+#endif
+    plexus_clear(c);
+
+#if PLEXUS_ENABLE_WEBSOCKET
+    run_case("ws_find_string", bench_ws_find_string, c, (double)sizeof(s_ws_msg) - 1, "bytes/s");
+    run_case("ws_find_value", bench_ws_find_value, c, (double)sizeof(s_ws_msg) - 1, "bytes/s");
+#endif
+
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+    {
+        static const size_t crc_sizes[] = { 64, 1024, PLEXUS_JSON_BUFFER_SIZE };
+        for (size_t i = 0; i < sizeof(s_buf); i++) {
+            s_buf[i] = (char)(i * 31u);
+        }
+        for (size_t i = 0; i < sizeof(crc_sizes) / sizeof(crc_sizes[0]); i++) {
+            s_crc_len = crc_sizes[i];
+            snprintf(name, sizeof(name), "crc32/bytes=%u", (unsigned)s_crc_len);
+            run_case(name, bench_crc32, c, (double)s_crc_len, "bytes/s");
+        }
+    }
+#endif
+
+    for (size_t i = 0; i < sizeof(batch_sizes) / sizeof(batch_sizes[0]); i++) {
+        s_flush_points = batch_sizes[i];
+        snprintf(name, sizeof(name), "flush/n=%u", (unsigned)s_flush_points);
+        run_case(name, bench_flush, c, s_flush_points, "points/s");
+    }
+
+    printf("\n  ]\n}\n");
+    plexus_free(c);
+    return 0;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file bench_stats.c
+ * @brief Throughput of the plexus_stats_* kernels against plain scalar loops
+ *
+ * Each case summarizes the same float array (count, sum, sum of squares,
+ * min, max) with the compile-time selected kernel, the portable kernel and a
+ * straightforward one-accumulator loop, and reports ns per call and
+ * samples per microsecond.
+ *
+ * Build: cmake -S bench -B build-bench && cmake --build build-bench && ./build-bench/bench_stats
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#define MAX_LEN 4096
+
+static float s_data[MAX_LEN];
+static volatile double s_sink; /* Keeps results observable */
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+/* The loop an application would write by hand */
+static void scalar_summary(const float* v, size_t n, plexus_stats_summary_t* out) {
+    double sum = 0.0;
+    double sumsq = 0.0;
+    float lo = v[0];
+    float hi = v[0];
+    for (size_t i = 0; i < n; i++) {
+        double d = (double)v[i];
+        sum += d;
+        sumsq += d * d;
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+    }
+    out->count = n;
+    out->sum = sum;
+    out->sumsq = sumsq;
+    out->min = lo;
+    out->max = hi;
+}
+
+typedef void (*summary_fn)(const float*, size_t, plexus_stats_summary_t*);
+
+static double time_kernel(summary_fn fn, size_t n) {
+    plexus_stats_summary_t s;
+    uint32_t iters = (uint32_t)(20000000 / n) + 1;
+
+    fn(s_data, n, &s); /* Warm caches */
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < iters; i++) {
+        fn(s_data, n, &s);
+        s_sink = s.sum + s.max;
+    }
+    return (double)(now_ns() - start) / (double)iters;
+}
+
+int main(void) {
+    static const size_t sizes[] = {16, 64, 256, 1024, 4096};
+
+    for (size_t i = 0; i < MAX_LEN; i++) {
+        s_data[i] = (float)sin((double)i * 0.01) * 100.0f + (float)(i % 7);
+    }
+
+    printf("plexus_stats kernel: %s\n\n", plexus_stats_backend());
+    printf("%6s  %12s  %12s  %12s  %8s\n", "n", "kernel ns", "portable ns", "scalar ns", "speedup");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        size_t n = sizes[i];
+        double k = time_kernel(plexus_stats_summary_f32, n);
+        double p = time_kernel(plexus_stats_summary_f32_portable, n);
+        double s = time_kernel(scalar_summary, n);
+        printf("%6zu  %12.1f  %12.1f  %12.1f  %7.2fx\n", n, k, p, s, s / k);
+    }
+
+    return 0;
+}
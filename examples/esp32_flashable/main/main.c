@@ -430,6 +430,14 @@ void app_main(void) {
 
     plexus_set_flush_interval(plexus, 5000);
 
+    /* System metrics are sampled every loop but rarely change — report them
+     * by exception, with a 60 s heartbeat so the dashboard shows liveness. */
+#if PLEXUS_ENABLE_DEADBAND
+    (void)plexus_set_deadband(plexus, "free_heap", 2.0, PLEXUS_DEADBAND_PERCENT, 60000);
+    (void)plexus_set_deadband(plexus, "wifi_rssi", 3.0, PLEXUS_DEADBAND_ABSOLUTE, 60000);
+    (void)plexus_set_deadband(plexus, "uptime_s", 60.0, PLEXUS_DEADBAND_ABSOLUTE, 60000);
+#endif
+
     /* ================================================================= */
     /* WebSocket setup (conditional on org_id)                           */
     /* ================================================================= */
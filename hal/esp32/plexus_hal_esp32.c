@@ -171,4 +171,23 @@ void plexus_hal_mutex_destroy(void* mutex) {
 
 #endif /* PLEXUS_ENABLE_THREAD_SAFE */
 
+/* ========================================================================= */
+/* Cycle counter: Xtensa/RISC-V CCOUNT                                       */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_TIMING
+
+#include "esp_cpu.h"
+#include "esp_rom_sys.h"
+
+uint32_t plexus_hal_get_cycles(void) {
+    return (uint32_t)esp_cpu_get_cycle_count();
+}
+
+uint32_t plexus_hal_cycles_per_us(void) {
+    return esp_rom_get_cpu_ticks_per_us();
+}
+
+#endif /* PLEXUS_ENABLE_TIMING */
+
 #endif /* ESP_PLATFORM */
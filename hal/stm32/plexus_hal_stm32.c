@@ -506,4 +506,27 @@ void  plexus_hal_mutex_destroy(void* mutex) { (void)mutex; }
 
 #endif /* PLEXUS_ENABLE_THREAD_SAFE */
 
+/* ========================================================================= */
+/* Cycle counter: DWT CYCCNT (Cortex-M3 and up)                              */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_TIMING
+
+uint32_t plexus_hal_get_cycles(void) {
+    /* Enable the counter on first use; a debugger may also have done so */
+    if (!(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) {
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    return DWT->CYCCNT;
+}
+
+uint32_t plexus_hal_cycles_per_us(void) {
+    uint32_t mhz = SystemCoreClock / 1000000U;
+    return mhz > 0 ? mhz : 1;
+}
+
+#endif /* PLEXUS_ENABLE_TIMING */
+
 #endif /* STM32 */
@@ -110,6 +110,9 @@ uint64_t plexus_hal_get_time_ms(void) {
  *   - MUST return a monotonically increasing millisecond counter
  *   - MUST NOT return wall-clock time
  *   - Wrapping at UINT32_MAX is expected and handled by the SDK
+ *   - MUST be callable from an ISR if the app uses plexus_send_from_isr()
+ *     (PLEXUS_ENABLE_ISR_QUEUE); HAL_GetTick(), millis() and
+ *     esp_timer_get_time() all are
  *
  * @return Milliseconds since boot/start
  */
@@ -244,6 +247,30 @@ void plexus_hal_mutex_destroy(void* mutex) {
 
 #endif /* PLEXUS_ENABLE_THREAD_SAFE */
 
+/* ========================================================================= */
+/* OPTIONAL: Cycle counter (only if PLEXUS_ENABLE_TIMING=1)                  */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_TIMING
+
+/**
+ * Read a free-running high-resolution counter for plexus::ScopedTimer.
+ * A CPU cycle counter is ideal; any timer faster than 1 MHz works. It may
+ * wrap — only differences between reads are used.
+ */
+uint32_t plexus_hal_get_cycles(void) {
+    /* TODO: Return the cycle counter (e.g. DWT->CYCCNT on Cortex-M3+) */
+    return 0;
+}
+
+/** Counter increments per microsecond (e.g. CPU MHz). Must be >= 1. */
+uint32_t plexus_hal_cycles_per_us(void) {
+    /* TODO: Return the counter frequency in MHz */
+    return 1;
+}
+
+#endif /* PLEXUS_ENABLE_TIMING */
+
 /* ========================================================================= */
 /* Verification Checklist                                                    */
 /* ========================================================================= */
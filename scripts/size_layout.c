@@ -0,0 +1,74 @@
+/**
+ * @file size_layout.c
+ * @brief Layout probe for size_report.py — one symbol per client field
+ *
+ * Compiled once per profile and never linked. Each plexus_size_<field> is
+ * exactly as large as that field of plexus_client_t, so `nm -S` reads the
+ * layout back without running anything, which works the same with a cross
+ * compiler. Bytes not covered by a symbol are scalars and padding.
+ *
+ * Keep the #if blocks in step with struct plexus_client in plexus.h.
+ */
+
+#include "plexus.h"
+
+#define SIZE_OF(field) char plexus_size_##field[sizeof(((plexus_client_t*)0)->field)]
+
+char plexus_size__total[sizeof(plexus_client_t)];
+
+SIZE_OF(api_key);
+SIZE_OF(source_id);
+SIZE_OF(session_id);
+SIZE_OF(endpoint);
+#if PLEXUS_CACHE_LINE_SIZE > 0
+SIZE_OF(totals_pad_before);
+SIZE_OF(totals_pad_after);
+#endif
+
+#if PLEXUS_ENABLE_ISR_QUEUE
+SIZE_OF(isr_ring);
+#endif
+#if PLEXUS_ENABLE_THREAD_STAGING
+SIZE_OF(stages);
+#endif
+#if PLEXUS_ENABLE_AGGREGATION
+SIZE_OF(aggregates);
+#endif
+#if PLEXUS_ENABLE_DEADBAND
+SIZE_OF(deadbands);
+#endif
+#if PLEXUS_ENABLE_SDT
+SIZE_OF(sdt);
+#endif
+#if PLEXUS_ENABLE_SKETCHES
+SIZE_OF(sketches);
+#endif
+#if PLEXUS_ENABLE_COUNTERS
+SIZE_OF(counters);
+#endif
+#if PLEXUS_ENABLE_DOWNSAMPLE
+SIZE_OF(downsampled);
+#endif
+#if PLEXUS_ENABLE_TRIGGER
+SIZE_OF(triggers);
+#endif
+#if PLEXUS_ENABLE_LAST_VALUE
+SIZE_OF(last_values);
+#endif
+#if PLEXUS_ENABLE_HISTORY
+SIZE_OF(history);
+#endif
+#if PLEXUS_ENABLE_CLIENT_STATS
+SIZE_OF(cstats);
+#endif
+
+#if PLEXUS_ENABLE_WEBSOCKET
+SIZE_OF(ws_endpoint);
+SIZE_OF(org_id);
+SIZE_OF(ws_cmd_queue);
+SIZE_OF(ws_commands);
+SIZE_OF(ws_last_cmd_name);
+#endif
+
+SIZE_OF(metrics_storage);
+SIZE_OF(json_storage);
@@ -0,0 +1,347 @@
+#!/usr/bin/env python3
+"""
+Footprint report for the Plexus C SDK.
+
+Compiles the SDK once per memory profile (PLEXUS_PROFILE_TINY / _DEFAULT /
+_GATEWAY) and once per feature flag, then reports:
+
+  1. the plexus_client_t layout per profile, field by field
+     (scripts/size_layout.c, read back with nm)
+  2. code size and client bytes per feature flag, against the default profile
+  3. worst-case stack per public API per profile, from GCC's
+     -fstack-usage / -fcallgraph-info call graph
+
+Nothing is linked or run, so a cross compiler works as well as the host one:
+
+    scripts/size_report.py --cc arm-none-eabi-gcc --cflags "-mcpu=cortex-m4 -mthumb"
+
+Code sizes are for unlinked objects: an application's link with
+--gc-sections drops the APIs it never calls. Stack depths stop at the HAL,
+libc and callbacks, which are marked in the table; add your HAL's own
+frames to those rows.
+
+Usually run through the build: cmake --build <dir> --target size_report
+"""
+
+import argparse
+import concurrent.futures
+import json
+import os
+import re
+import shlex
+import subprocess
+import sys
+import tempfile
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+SRC = os.path.join(ROOT, "src")
+LAYOUT_PROBE = os.path.join(ROOT, "scripts", "size_layout.c")
+
+PROFILES = ["tiny", "default", "gateway"]
+
+# Flags measured against the default profile, as (flag, value that turns it
+# on[, defines it needs in both builds]). Every feature source is wrapped in
+# #if, so each build compiles all of src/*.c and the flag alone decides what
+# lands in the object.
+FEATURES = [
+    ("PLEXUS_ENABLE_TAGS", 1),
+    ("PLEXUS_ENABLE_STRING_VALUES", 1),
+    ("PLEXUS_ENABLE_BOOL_VALUES", 1),
+    ("PLEXUS_ENABLE_PERSISTENT_BUFFER", 1),
+    ("PLEXUS_ENABLE_STATUS_CALLBACK", 1),
+    ("PLEXUS_ENABLE_THREAD_SAFE", 1),
+    ("PLEXUS_ENABLE_AGGREGATION", 1),
+    ("PLEXUS_ENABLE_STATS", 1),
+    ("PLEXUS_ENABLE_DEADBAND", 1),
+    ("PLEXUS_ENABLE_SDT", 1),
+    ("PLEXUS_ENABLE_SKETCHES", 1),
+    ("PLEXUS_ENABLE_COUNTERS", 1),
+    ("PLEXUS_ENABLE_DOWNSAMPLE", 1),
+    ("PLEXUS_ENABLE_TRIGGER", 1),
+    ("PLEXUS_ENABLE_LAST_VALUE", 1),
+    ("PLEXUS_ENABLE_HISTORY", 1),
+    ("PLEXUS_ENABLE_CLIENT_STATS", 1),
+    ("PLEXUS_ENABLE_TRACE", 1),
+    ("PLEXUS_ENABLE_WAKE_CALLBACK", 1),
+    ("PLEXUS_ENABLE_ISR_QUEUE", 1),
+    ("PLEXUS_ENABLE_THREAD_STAGING", 1, ["PLEXUS_ENABLE_THREAD_SAFE=1"]),
+    ("PLEXUS_ENABLE_SHARED_TRANSPORT", 1),
+    ("PLEXUS_ENABLE_WEBSOCKET", 1),
+]
+
+BASE_CFLAGS = ["-std=c99", "-Os", "-ffunction-sections", "-fdata-sections", "-fno-common"]
+STACK_CFLAGS = ["-fstack-usage", "-fcallgraph-info=su"]
+
+
+class Toolchain:
+    def __init__(self, args):
+        self.cc = shlex.split(args.cc)
+        self.cflags = shlex.split(args.cflags) + ["-D" + d for d in args.define]
+        prefix = ""
+        if self.cc[-1].endswith("gcc"):
+            prefix = self.cc[-1][:-3]
+        self.nm = args.nm or prefix + "nm"
+        self.size = args.size or prefix + "size"
+        self.jobs = args.jobs
+        self.stack = not args.no_stack and self._supports(STACK_CFLAGS)
+
+    def _supports(self, flags):
+        with tempfile.TemporaryDirectory() as tmp:
+            probe = os.path.join(tmp, "probe.c")
+            with open(probe, "w") as f:
+                f.write("int probe(void) { return 0; }\n")
+            r = subprocess.run(self.cc + flags + ["-c", probe, "-o", os.path.join(tmp, "probe.o")],
+                               cwd=tmp, capture_output=True)
+            return r.returncode == 0
+
+    def target(self):
+        r = subprocess.run(self.cc + ["-dumpmachine"], capture_output=True, text=True)
+        return r.stdout.strip() or "unknown"
+
+    def compile(self, src, obj, defines, extra=()):
+        cmd = (self.cc + BASE_CFLAGS + list(extra) + self.cflags +
+               ["-D" + d for d in defines] + ["-I" + SRC, "-c", src, "-o", obj])
+        r = subprocess.run(cmd, cwd=os.path.dirname(obj), capture_output=True, text=True)
+        if r.returncode != 0:
+            raise RuntimeError("compile failed: %s\n%s" % (" ".join(cmd), r.stderr))
+
+
+def sdk_sources():
+    return sorted(os.path.join(SRC, f) for f in os.listdir(SRC) if f.endswith(".c"))
+
+
+def build(tc, out_dir, name, defines, stack=False):
+    """Compile the SDK and the layout probe into out_dir/name; return the objects."""
+    build_dir = os.path.join(out_dir, name)
+    os.makedirs(build_dir, exist_ok=True)
+    extra = STACK_CFLAGS if stack else []
+    objs = []
+    for src in sdk_sources():
+        obj = os.path.join(build_dir, os.path.basename(src)[:-2] + ".o")
+        tc.compile(src, obj, defines, extra)
+        objs.append(obj)
+    layout = os.path.join(build_dir, "size_layout.o")
+    tc.compile(LAYOUT_PROBE, layout, defines)
+    return {"dir": build_dir, "objects": objs, "layout": layout}
+
+
+# ---- Client layout ----
+
+def layout_fields():
+    with open(LAYOUT_PROBE) as f:
+        return re.findall(r"^SIZE_OF\((\w+)\);", f.read(), re.M)
+
+
+def read_layout(tc, obj):
+    out = subprocess.run([tc.nm, "-S", "--defined-only", obj],
+                         capture_output=True, text=True, check=True).stdout
+    sizes = {}
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) == 4 and parts[3].startswith("plexus_size_"):
+            sizes[parts[3][len("plexus_size_"):]] = int(parts[1], 16)
+    total = sizes.pop("_total")
+    sizes["(scalars + padding)"] = total - sum(sizes.values())
+    sizes["total"] = total
+    return sizes
+
+
+# ---- Code size ----
+
+def code_size(tc, objs):
+    """Flash (text + data) and static RAM (data + bss) of a set of objects."""
+    out = subprocess.run([tc.size] + objs, capture_output=True, text=True, check=True).stdout
+    text = data = bss = 0
+    for line in out.splitlines()[1:]:
+        cols = line.split()
+        text += int(cols[0])
+        data += int(cols[1])
+        bss += int(cols[2])
+    return {"flash": text + data, "ram": data + bss}
+
+
+# ---- Stack ----
+
+NODE_RE = re.compile(r'^node: \{ title: "([^"]+)" label: "([^"]*)"')
+EDGE_RE = re.compile(r'^edge: \{ sourcename: "([^"]+)" targetname: "([^"]+)"')
+FRAME_RE = re.compile(r"\\n(\d+) bytes \(([^)]*)\)")
+
+
+def read_callgraph(build_dir):
+    frames = {}    # defined function -> (bytes, qualifier)
+    edges = {}
+    for f in sorted(os.listdir(build_dir)):
+        if not f.endswith(".ci"):
+            continue
+        with open(os.path.join(build_dir, f)) as ci:
+            for line in ci:
+                m = NODE_RE.match(line)
+                if m:
+                    fm = FRAME_RE.search(m.group(2))
+                    if fm:
+                        frames[m.group(1)] = (int(fm.group(1)), fm.group(2))
+                    continue
+                m = EDGE_RE.match(line)
+                if m:
+                    edges.setdefault(m.group(1), set()).add(m.group(2))
+    return frames, edges
+
+
+def worst_stack(frames, edges):
+    """Deepest path from every defined function; externals end a path and are noted."""
+    memo = {}
+
+    def visit(fn, active):
+        if fn in memo:
+            return memo[fn]
+        if fn not in frames:
+            if "indirect" in fn:
+                return 0, {"callback"}
+            return 0, {"HAL" if fn.startswith("plexus_hal_") else "libc"}
+        if fn in active:
+            return 0, {"recursive"}
+        own, qual = frames[fn]
+        notes = {"dynamic"} if "dynamic" in qual and "bounded" not in qual else set()
+        deepest = 0
+        active.add(fn)
+        for callee in sorted(edges.get(fn, ())):
+            depth, callee_notes = visit(callee, active)
+            deepest = max(deepest, depth)
+            notes |= callee_notes
+        active.discard(fn)
+        memo[fn] = (own + deepest, notes)
+        return memo[fn]
+
+    return {fn: visit(fn, set()) for fn in frames}
+
+
+def public_api():
+    with open(os.path.join(SRC, "plexus.h")) as f:
+        return sorted(set(re.findall(r"\b(plexus_\w+)\s*\(", f.read())))
+
+
+# ---- Report ----
+
+def fmt_table(header, rows):
+    widths = [max(len(str(r[i])) for r in [header] + rows) for i in range(len(header))]
+    lines = []
+    for n, row in enumerate([header] + rows):
+        cells = [str(c).ljust(widths[0]) if i == 0 else str(c).rjust(widths[i])
+                 for i, c in enumerate(row)]
+        lines.append("  " + "  ".join(cells))
+        if n == 0:
+            lines.append("  " + "  ".join("-" * w for w in widths))
+    return "\n".join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("--cc", default=os.environ.get("CC", "cc"), help="C compiler (default: $CC or cc)")
+    ap.add_argument("--cflags", default="", help="Extra target flags, e.g. \"-mcpu=cortex-m4 -mthumb\"")
+    ap.add_argument("-D", "--define", action="append", default=[],
+                    help="Extra define for every build, e.g. -D PLEXUS_ENABLE_WEBSOCKET=1")
+    ap.add_argument("--nm", help="nm to use (default: derived from --cc)")
+    ap.add_argument("--size", help="size to use (default: derived from --cc)")
+    ap.add_argument("--out-dir", help="Keep objects here (default: a temporary directory)")
+    ap.add_argument("--json", help="Also write the report as JSON to this file")
+    ap.add_argument("--no-stack", action="store_true", help="Skip the stack analysis")
+    ap.add_argument("-j", "--jobs", type=int, default=os.cpu_count() or 1)
+    args = ap.parse_args()
+
+    tc = Toolchain(args)
+    tmp = None
+    out_dir = args.out_dir
+    if not out_dir:
+        tmp = tempfile.TemporaryDirectory()
+        out_dir = tmp.name
+    os.makedirs(out_dir, exist_ok=True)
+
+    jobs = {}
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        for p in PROFILES:
+            defines = ["PLEXUS_PROFILE=PLEXUS_PROFILE_" + p.upper()]
+            jobs["profile/" + p] = pool.submit(build, tc, out_dir, "profile_" + p, defines, tc.stack)
+        for flag, on, *requires in FEATURES:
+            for state, value in (("on", on), ("off", 1 - on)):
+                defines = (requires[0] if requires else []) + ["%s=%d" % (flag, value)]
+                jobs["%s/%s" % (flag, state)] = pool.submit(
+                    build, tc, out_dir, "%s_%s" % (flag.lower(), state), defines)
+        try:
+            builds = {k: f.result() for k, f in jobs.items()}
+        except RuntimeError as e:
+            sys.exit("size_report: %s" % e)
+
+    report = {"target": tc.target(), "cc": " ".join(tc.cc), "cflags": " ".join(BASE_CFLAGS + tc.cflags),
+              "profiles": {}, "features": {}, "stack": {}}
+
+    for p in PROFILES:
+        b = builds["profile/" + p]
+        report["profiles"][p] = {"layout": read_layout(tc, b["layout"]), "code": code_size(tc, b["objects"])}
+
+    for flag, *_ in FEATURES:
+        on, off = builds[flag + "/on"], builds[flag + "/off"]
+        code_on, code_off = code_size(tc, on["objects"]), code_size(tc, off["objects"])
+        report["features"][flag] = {
+            "flash": code_on["flash"] - code_off["flash"],
+            "ram": code_on["ram"] - code_off["ram"],
+            "client": read_layout(tc, on["layout"])["total"] - read_layout(tc, off["layout"])["total"],
+        }
+
+    if tc.stack:
+        api = public_api()
+        for p in PROFILES:
+            frames, edges = read_callgraph(builds["profile/" + p]["dir"])
+            depths = worst_stack(frames, edges)
+            report["stack"][p] = {fn: {"bytes": depths[fn][0], "notes": sorted(depths[fn][1])}
+                                  for fn in api if fn in depths}
+
+    # Text report
+    print("Plexus C SDK footprint — target %s" % report["target"])
+    print("  cc: %s %s" % (report["cc"], report["cflags"]))
+
+    print("\nplexus_client_t layout (bytes)\n")
+    fields = layout_fields() + ["(scalars + padding)", "total"]
+    rows = []
+    for field in fields:
+        cells = [report["profiles"][p]["layout"].get(field) for p in PROFILES]
+        if any(c is not None for c in cells):
+            rows.append([field] + ["-" if c is None else c for c in cells])
+    print(fmt_table(["field"] + PROFILES, rows))
+
+    print("\nCode per profile (bytes, unlinked)\n")
+    print(fmt_table(["profile", "flash", "static ram"],
+                    [[p, report["profiles"][p]["code"]["flash"], report["profiles"][p]["code"]["ram"]]
+                     for p in PROFILES]))
+
+    print("\nCost per feature flag against the default profile (bytes)\n")
+    print(fmt_table(["flag", "flash", "static ram", "client"],
+                    [[flag, "%+d" % f["flash"], "%+d" % f["ram"], "%+d" % f["client"]]
+                     for flag, f in report["features"].items()]))
+
+    if tc.stack:
+        print("\nWorst-case stack per API (bytes, excluding the frames of marked callees)\n")
+        apis = sorted(set().union(*(report["stack"][p].keys() for p in PROFILES)))
+        rows = []
+        for fn in apis:
+            row = [fn]
+            for p in PROFILES:
+                s = report["stack"][p].get(fn)
+                row.append("-" if s is None else
+                           "%d%s" % (s["bytes"], " +" + "+".join(s["notes"]) if s["notes"] else ""))
+            rows.append(row)
+        print(fmt_table(["api"] + PROFILES, rows))
+    else:
+        print("\nWorst-case stack: skipped (needs GCC 10+ for -fcallgraph-info)")
+
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+            f.write("\n")
+        print("\nwrote %s" % args.json)
+
+    if tmp:
+        tmp.cleanup()
+
+
+if __name__ == "__main__":
+    main()
@@ -55,7 +55,7 @@ typedef struct {
  * Bitwise CRC32 — no lookup table, saves ~1KB of flash.
  * Uses IEEE 802.3 polynomial (0xEDB88320 reflected).
  */
-static uint32_t plexus_crc32(const void* data, size_t len) {
+uint32_t plexus_crc32(const void* data, size_t len) {
     const uint8_t* p = (const uint8_t*)data;
     uint32_t crc = 0xFFFFFFFFU;
     for (size_t i = 0; i < len; i++) {
@@ -73,18 +73,6 @@ static uint32_t plexus_crc32(const void* data, size_t len) {
 
 #endif /* PLEXUS_ENABLE_PERSISTENT_BUFFER */
 
-/* ------------------------------------------------------------------------- */
-/* Thread safety macros                                                      */
-/* ------------------------------------------------------------------------- */
-
-#if PLEXUS_ENABLE_THREAD_SAFE
-    #define PLEXUS_LOCK(c)   do { if ((c)->mutex) plexus_hal_mutex_lock((c)->mutex); } while(0)
-    #define PLEXUS_UNLOCK(c) do { if ((c)->mutex) plexus_hal_mutex_unlock((c)->mutex); } while(0)
-#else
-    #define PLEXUS_LOCK(c)   ((void)0)
-    #define PLEXUS_UNLOCK(c) ((void)0)
-#endif
-
 /* ------------------------------------------------------------------------- */
 /* Connection status helper                                                  */
 /* ------------------------------------------------------------------------- */
@@ -169,7 +157,7 @@ bool plexus_internal_is_url_safe(const char* s) {
  * Rejects control characters, newlines, tabs, and non-ASCII bytes that could
  * produce invalid JSON or break server-side processing.
  */
-static bool is_valid_metric_name(const char* s) {
+bool plexus_internal_is_valid_metric_name(const char* s) {
     if (!s || s[0] == '\0') {
         return false;
     }
@@ -197,7 +185,12 @@ static plexus_client_t* client_init_common(plexus_client_t* client,
                                              const char* api_key,
                                              const char* source_id,
                                              bool heap_allocated) {
-    memset(client, 0, sizeof(plexus_client_t));
+    /* Only the fixed part: sized clients end where metrics_storage starts */
+    memset(client, 0, offsetof(plexus_client_t, metrics_storage));
+    client->metrics = client->metrics_storage;
+    client->max_metrics = PLEXUS_MAX_METRICS;
+    client->json_buffer = client->json_storage;
+    client->json_buffer_size = PLEXUS_JSON_BUFFER_SIZE;
 
     strncpy(client->api_key, api_key, PLEXUS_MAX_API_KEY_LEN - 1);
     strncpy(client->source_id, source_id, PLEXUS_MAX_SOURCE_ID_LEN - 1);
@@ -205,13 +198,23 @@ static plexus_client_t* client_init_common(plexus_client_t* client,
 
     client->metric_count = 0;
     client->last_flush_ms = plexus_hal_get_tick_ms();
-    client->total_sent = 0;
-    client->total_errors = 0;
+    memset(&client->totals, 0, sizeof(client->totals));
     client->retry_backoff_ms = 0;
     client->rate_limit_until_ms = 0;
     client->initialized = true;
     client->_heap_allocated = heap_allocated;
 
+#if PLEXUS_ENABLE_TRACE
+    client->trace_callback = NULL;
+    client->trace_callback_data = NULL;
+#endif
+
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+    client->wake_callback = NULL;
+    client->wake_callback_data = NULL;
+    client->wake_armed = false;
+#endif
+
 #if PLEXUS_ENABLE_STATUS_CALLBACK
     client->status_callback = NULL;
     client->status_callback_data = NULL;
@@ -234,21 +237,31 @@ static plexus_client_t* client_init_common(plexus_client_t* client,
     return client;
 }
 
-plexus_client_t* plexus_init(const char* api_key, const char* source_id) {
+/**
+ * Validate the credentials shared by every init path.
+ */
+static bool init_args_valid(const char* api_key, const char* source_id) {
     if (!api_key || !source_id) {
-        return NULL;
+        return false;
     }
     if (!plexus_internal_is_url_safe(source_id)) {
-        return NULL;
+        return false;
     }
     if (strlen(api_key) >= PLEXUS_MAX_API_KEY_LEN ||
         strlen(source_id) >= PLEXUS_MAX_SOURCE_ID_LEN) {
-        return NULL;
+        return false;
     }
     if (strncmp(api_key, "plx_", 4) != 0) {
 #if PLEXUS_DEBUG
         plexus_hal_log("plexus: API key does not start with 'plx_'");
 #endif
+        return false;
+    }
+    return true;
+}
+
+plexus_client_t* plexus_init(const char* api_key, const char* source_id) {
+    if (!init_args_valid(api_key, source_id)) {
         return NULL;
     }
 
@@ -274,21 +287,44 @@ plexus_client_t* plexus_init_static(void* buf, size_t buf_size,
     if (((uintptr_t)buf % sizeof(void*)) != 0) {
         return NULL;
     }
-    if (!plexus_internal_is_url_safe(source_id)) {
+    if (!init_args_valid(api_key, source_id)) {
         return NULL;
     }
-    if (strlen(api_key) >= PLEXUS_MAX_API_KEY_LEN ||
-        strlen(source_id) >= PLEXUS_MAX_SOURCE_ID_LEN) {
+
+    return client_init_common((plexus_client_t*)buf, api_key, source_id, false);
+}
+
+size_t plexus_client_size_for(uint16_t max_metrics, size_t json_buffer_size) {
+    return PLEXUS_CLIENT_SIZE_FOR(max_metrics, json_buffer_size);
+}
+
+plexus_client_t* plexus_init_sized(void* buf, size_t buf_size,
+                                     uint16_t max_metrics, size_t json_buffer_size,
+                                     const char* api_key, const char* source_id) {
+    if (!buf || !api_key || !source_id) {
         return NULL;
     }
-    if (strncmp(api_key, "plx_", 4) != 0) {
-#if PLEXUS_DEBUG
-        plexus_hal_log("plexus: API key does not start with 'plx_'");
-#endif
+    if (max_metrics == 0 || json_buffer_size < 256) {
+        return NULL;
+    }
+    if (buf_size < PLEXUS_CLIENT_SIZE_FOR(max_metrics, json_buffer_size)) {
+        return NULL;
+    }
+    if (((uintptr_t)buf % sizeof(void*)) != 0) {
+        return NULL;
+    }
+    if (!init_args_valid(api_key, source_id)) {
         return NULL;
     }
 
-    return client_init_common((plexus_client_t*)buf, api_key, source_id, false);
+    /* Queue slots, then the JSON buffer, right after the fixed part */
+    plexus_client_t* client = client_init_common((plexus_client_t*)buf, api_key, source_id, false);
+    uint8_t* tail = (uint8_t*)buf + offsetof(plexus_client_t, metrics_storage);
+    client->metrics = (plexus_metric_t*)(void*)tail;
+    client->max_metrics = max_metrics;
+    client->json_buffer = (char*)(tail + (size_t)max_metrics * sizeof(plexus_metric_t));
+    client->json_buffer_size = json_buffer_size;
+    return client;
 }
 
 void plexus_free(plexus_client_t* client) {
@@ -300,6 +336,12 @@ void plexus_free(plexus_client_t* client) {
     plexus_ws_cleanup(client);
 #endif
 
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+    if (client->transport) {
+        plexus_internal_transport_detach(client);
+    }
+#endif
+
 #if PLEXUS_ENABLE_THREAD_SAFE
     if (client->mutex) {
         plexus_hal_mutex_destroy(client->mutex);
@@ -419,7 +461,7 @@ const char* plexus_session_id(const plexus_client_t* client) {
  * prevents buffer overflows, and the caller should be aware that send
  * functions may block when the buffer fills to the flush threshold.
  */
-static plexus_err_t maybe_auto_flush(plexus_client_t* client) {
+plexus_err_t plexus_internal_maybe_auto_flush(plexus_client_t* client) {
     uint16_t flush_count = client->auto_flush_count > 0
         ? client->auto_flush_count : PLEXUS_AUTO_FLUSH_COUNT;
     if (flush_count > 0 && client->metric_count >= flush_count) {
@@ -429,10 +471,10 @@ static plexus_err_t maybe_auto_flush(plexus_client_t* client) {
 }
 
 /**
- * Queue a metric into the client's buffer.
+ * Validate the common arguments of every send path.
  */
-static plexus_err_t add_metric(plexus_client_t* client, const char* metric,
-                                plexus_value_t* value, uint64_t timestamp_ms) {
+static plexus_err_t validate_metric(const plexus_client_t* client, const char* metric,
+                                     const plexus_value_t* value) {
     if (!client || !metric || !value) {
         return PLEXUS_ERR_NULL_PTR;
     }
@@ -442,10 +484,23 @@ static plexus_err_t add_metric(plexus_client_t* client, const char* metric,
     if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) {
         return PLEXUS_ERR_STRING_TOO_LONG;
     }
-    if (!is_valid_metric_name(metric)) {
+    if (!plexus_internal_is_valid_metric_name(metric)) {
         return PLEXUS_ERR_INVALID_ARG;
     }
-    if (client->metric_count >= PLEXUS_MAX_METRICS) {
+    return PLEXUS_OK;
+}
+
+/**
+ * Append a point to the client's buffer. Does not validate the name and
+ * does not trigger auto-flush — callers hold the lock and decide that.
+ */
+plexus_err_t plexus_internal_enqueue(plexus_client_t* client, const char* metric,
+                                      const plexus_value_t* value, uint64_t timestamp_ms) {
+    if (client->metric_count >= client->max_metrics) {
+        PLEXUS_ADD_RELAXED(&client->totals.dropped, 1);
+#if PLEXUS_ENABLE_CLIENT_STATS
+        client->cstats.drops_buffer_full++;
+#endif
         return PLEXUS_ERR_BUFFER_FULL;
     }
 
@@ -462,12 +517,173 @@ static plexus_err_t add_metric(plexus_client_t* client, const char* metric,
     }
 
     client->metric_count++;
+    PLEXUS_STORE_RELAXED(&client->totals.pending, client->metric_count);
+#if PLEXUS_ENABLE_CLIENT_STATS
+    if (client->metric_count > client->cstats.queue_high_water) {
+        client->cstats.queue_high_water = client->metric_count;
+    }
+#endif
 
 #if PLEXUS_DEBUG
     plexus_hal_log("Queued metric: %s (total: %d)", metric, client->metric_count);
 #endif
 
-    return maybe_auto_flush(client);
+    return PLEXUS_OK;
+}
+
+/**
+ * Route a validated metric through the enabled features and queue it.
+ * The caller runs the auto-flush check.
+ */
+static plexus_err_t route_point(plexus_client_t* client, const char* metric,
+                                plexus_value_t* value, uint64_t timestamp_ms) {
+    plexus_err_t err;
+
+#if PLEXUS_ENABLE_LAST_VALUE
+    /* Cache the current value before any feature decides not to queue it */
+    plexus_last_value_update(client, metric, value, timestamp_ms);
+#endif
+
+#if PLEXUS_ENABLE_HISTORY
+    /* History is recorded alongside whatever happens to the sample below */
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        plexus_history_t* hist = plexus_history_find(client, metric);
+        if (hist) {
+            plexus_history_record(hist, value->data.number,
+                                  timestamp_ms > 0 ? timestamp_ms : plexus_hal_get_time_ms());
+        }
+    }
+#endif
+
+#if PLEXUS_ENABLE_AGGREGATION
+    /* Aggregated metrics are folded into their window, not queued */
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        plexus_aggregate_t* agg = plexus_agg_find(client, metric);
+        if (agg) {
+            err = plexus_agg_fold(client, agg, value->data.number);
+            return err;
+        }
+    }
+#endif
+
+#if PLEXUS_ENABLE_COUNTERS
+    /* Counters, gauges and rates are coalesced into one point per window */
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        plexus_counter_t* ctr = plexus_counter_find(client, metric);
+        if (ctr) {
+            err = plexus_counter_update(client, ctr, value->data.number);
+            return err;
+        }
+    }
+#endif
+
+#if PLEXUS_ENABLE_DOWNSAMPLE
+    /* Waveform samples are buffered and decimated at flush */
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        plexus_downsample_t* ds = plexus_downsample_find(client, metric);
+        if (ds) {
+            plexus_downsample_append(ds, value->data.number,
+                                     timestamp_ms > 0 ? timestamp_ms : plexus_hal_get_time_ms());
+            return PLEXUS_OK;
+        }
+    }
+#endif
+
+#if PLEXUS_ENABLE_TRIGGER
+    /* Burst-captured samples go to the pre-trigger ring */
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        plexus_trigger_t* trg = plexus_trigger_find(client, metric);
+        if (trg) {
+            plexus_trigger_sample(client, trg, value->data.number,
+                                  timestamp_ms > 0 ? timestamp_ms : plexus_hal_get_time_ms());
+            return PLEXUS_OK;
+        }
+    }
+#endif
+
+#if PLEXUS_ENABLE_SDT
+    /* Swinging-door: only segment endpoints are queued */
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        plexus_sdt_t* sdt = plexus_sdt_find(client, metric);
+        if (sdt) {
+            err = plexus_sdt_update(client, sdt, value->data.number,
+                                    timestamp_ms > 0 ? timestamp_ms : plexus_hal_get_time_ms());
+            return err;
+        }
+    }
+#endif
+
+#if PLEXUS_ENABLE_DEADBAND
+    /* Unchanged values inside the deadband are dropped before queuing */
+    plexus_deadband_t* db = NULL;
+    if (value->type == PLEXUS_VALUE_NUMBER) {
+        db = plexus_deadband_find(client, metric);
+        if (db && plexus_deadband_suppress(db, value->data.number)) {
+            return PLEXUS_OK;
+        }
+    }
+#endif
+
+    err = plexus_internal_enqueue(client, metric, value, timestamp_ms);
+    if (err != PLEXUS_OK) {
+        return err;
+    }
+
+#if PLEXUS_ENABLE_DEADBAND
+    if (db) {
+        plexus_deadband_commit(db, value->data.number);
+    }
+#endif
+
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_internal_route(plexus_client_t* client, const char* metric,
+                                   plexus_value_t* value, uint64_t timestamp_ms) {
+    return route_point(client, metric, value, timestamp_ms);
+}
+
+/**
+ * Route a validated metric, then check the count-based auto-flush.
+ */
+static plexus_err_t route_metric(plexus_client_t* client, const char* metric,
+                                  plexus_value_t* value, uint64_t timestamp_ms) {
+    plexus_err_t err = route_point(client, metric, value, timestamp_ms);
+    if (err != PLEXUS_OK) {
+        return err;
+    }
+    err = plexus_internal_maybe_auto_flush(client);
+    PLEXUS_WAKE_IF_SOONER(client);
+    return err;
+}
+
+/**
+ * Queue a metric into the client's buffer.
+ */
+static plexus_err_t add_metric(plexus_client_t* client, const char* metric,
+                                plexus_value_t* value, uint64_t timestamp_ms) {
+    plexus_err_t err = validate_metric(client, metric, value);
+    if (err != PLEXUS_OK) {
+        return err;
+    }
+    return route_metric(client, metric, value, timestamp_ms);
+}
+
+/**
+ * Queue a metric whose name the caller has already validated.
+ */
+static plexus_err_t add_metric_unchecked(plexus_client_t* client, const char* metric,
+                                          plexus_value_t* value, uint64_t timestamp_ms) {
+    if (!client || !metric) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+    PLEXUS_LOCK(client);
+    plexus_err_t err = route_metric(client, metric, value, timestamp_ms);
+    PLEXUS_UNLOCK(client);
+    return err;
 }
 
 plexus_err_t plexus_send_number(plexus_client_t* client, const char* metric, double value) {
@@ -533,24 +749,23 @@ plexus_err_t plexus_send_number_tagged(plexus_client_t* client, const char* metr
     if (tag_count > PLEXUS_MAX_TAGS) {
         tag_count = PLEXUS_MAX_TAGS;
     }
-
-    /* Validate and queue metric first. We need to suppress auto-flush
-     * until tags are attached, so temporarily disable it. */
     if (!client) {
         return PLEXUS_ERR_NULL_PTR;
     }
-    PLEXUS_LOCK(client);
-    uint16_t saved_flush_count = client->auto_flush_count;
-    client->auto_flush_count = 0; /* Suppress auto-flush temporarily */
 
+    /* Tagged points are always queued as-is: per-metric filters key on the
+     * name alone and would lose the tags. Auto-flush waits until the tags
+     * are attached. */
     plexus_value_t v;
     memset(&v, 0, sizeof(v));
     v.type = PLEXUS_VALUE_NUMBER;
     v.data.number = value;
 
-    plexus_err_t err = add_metric(client, metric, &v, 0);
-    client->auto_flush_count = saved_flush_count; /* Restore */
-
+    PLEXUS_LOCK(client);
+    plexus_err_t err = validate_metric(client, metric, &v);
+    if (err == PLEXUS_OK) {
+        err = plexus_internal_enqueue(client, metric, &v, 0);
+    }
     if (err != PLEXUS_OK) {
         PLEXUS_UNLOCK(client);
         return err;
@@ -568,11 +783,212 @@ plexus_err_t plexus_send_number_tagged(plexus_client_t* client, const char* metr
         }
     }
 
-    err = maybe_auto_flush(client);
+    err = plexus_internal_maybe_auto_flush(client);
+    PLEXUS_UNLOCK(client);
+    return err;
+}
+#endif
+
+plexus_err_t plexus_send_number_unchecked(plexus_client_t* client, const char* metric,
+                                           double value, uint64_t timestamp_ms) {
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+    v.data.number = value;
+    return add_metric_unchecked(client, metric, &v, timestamp_ms);
+}
+
+#if PLEXUS_ENABLE_STRING_VALUES
+plexus_err_t plexus_send_string_unchecked(plexus_client_t* client, const char* metric,
+                                           const char* value, size_t value_len,
+                                           uint64_t timestamp_ms) {
+    if (!value && value_len > 0) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (value_len >= PLEXUS_MAX_STRING_VALUE_LEN) {
+        return PLEXUS_ERR_STRING_TOO_LONG;
+    }
+
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_STRING;
+    if (value_len > 0) {
+        memcpy(v.data.string, value, value_len);
+    }
+    return add_metric_unchecked(client, metric, &v, timestamp_ms);
+}
+#endif
+
+#if PLEXUS_ENABLE_BOOL_VALUES
+plexus_err_t plexus_send_bool_unchecked(plexus_client_t* client, const char* metric,
+                                         bool value, uint64_t timestamp_ms) {
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_BOOL;
+    v.data.boolean = value;
+    return add_metric_unchecked(client, metric, &v, timestamp_ms);
+}
+#endif
+
+plexus_err_t plexus_send_batch(plexus_client_t* client, const plexus_point_t* points,
+                               size_t count) {
+    return plexus_send_batch_accepted(client, points, count, NULL);
+}
+
+plexus_err_t plexus_send_batch_accepted(plexus_client_t* client, const plexus_point_t* points,
+                                        size_t count, size_t* accepted) {
+    if (accepted) {
+        *accepted = 0;
+    }
+    if (!client || (!points && count > 0)) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!points[i].metric) {
+            return PLEXUS_ERR_NULL_PTR;
+        }
+        if (strlen(points[i].metric) >= PLEXUS_MAX_METRIC_NAME_LEN) {
+            return PLEXUS_ERR_STRING_TOO_LONG;
+        }
+        if (!plexus_internal_is_valid_metric_name(points[i].metric)) {
+            return PLEXUS_ERR_INVALID_ARG;
+        }
+    }
+    if (count == 0) {
+        return PLEXUS_OK;
+    }
+
+    PLEXUS_LOCK(client);
+
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+
+    /* Points folded into a feature need no slot, so the room is only known
+     * point by point: stop at the first one that fails (no room, a window
+     * emit using up the room, a rejected reading) and report how far the
+     * batch got. The caller keeps that point, so it is not counted as
+     * dropped. */
+    plexus_err_t err = PLEXUS_OK;
+    size_t i = 0;
+    for (; i < count; i++) {
+        plexus_total_t dropped = PLEXUS_LOAD_RELAXED(&client->totals.dropped);
+#if PLEXUS_ENABLE_CLIENT_STATS
+        uint32_t drops_buffer_full = client->cstats.drops_buffer_full;
+#endif
+        v.data.number = points[i].value;
+        err = route_point(client, points[i].metric, &v, points[i].timestamp_ms);
+        if (err != PLEXUS_OK) {
+            PLEXUS_STORE_RELAXED(&client->totals.dropped, dropped);
+#if PLEXUS_ENABLE_CLIENT_STATS
+            client->cstats.drops_buffer_full = drops_buffer_full;
+#endif
+            break;
+        }
+    }
+    if (accepted) {
+        *accepted = i;
+    }
+    if (err == PLEXUS_OK) {
+        err = plexus_internal_maybe_auto_flush(client);
+    }
+    PLEXUS_WAKE_IF_SOONER(client);
+
     PLEXUS_UNLOCK(client);
     return err;
 }
+
+#if PLEXUS_ENABLE_ISR_QUEUE
+
+#define ISR_RING_MASK ((uint16_t)(PLEXUS_ISR_QUEUE_SIZE - 1))
+
+plexus_err_t plexus_send_from_isr(plexus_client_t* client, const char* metric, double value) {
+    if (!client || !metric) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) {
+        return PLEXUS_ERR_STRING_TOO_LONG;
+    }
+    if (!plexus_internal_is_valid_metric_name(metric)) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    uint16_t head = client->isr_head;
+    uint16_t next = (uint16_t)((head + 1) & ISR_RING_MASK);
+    if (next == PLEXUS_LOAD_ACQUIRE(&client->isr_tail)) {
+        PLEXUS_STORE_RELAXED(&client->isr_dropped, client->isr_dropped + 1);
+        return PLEXUS_ERR_BUFFER_FULL;
+    }
+
+    plexus_isr_sample_t* s = &client->isr_ring[head];
+    s->metric = metric;
+    s->value = value;
+    s->tick_ms = plexus_hal_get_tick_ms();
+    PLEXUS_STORE_RELEASE(&client->isr_head, next);
+    return PLEXUS_OK;
+}
+
+static bool isr_pending(const plexus_client_t* client) {
+    return client->isr_tail != PLEXUS_LOAD_ACQUIRE(&client->isr_head);
+}
+
+/**
+ * Route the samples staged when the tick started, checking the count-based
+ * auto-flush after each. Stops while the queue is full, leaving the rest
+ * staged for the next tick. Caller holds the lock.
+ */
+static plexus_err_t isr_drain(plexus_client_t* client) {
+    uint32_t dropped = PLEXUS_LOAD_RELAXED(&client->isr_dropped);
+    if (dropped != client->isr_dropped_seen) {
+        PLEXUS_ADD_RELAXED(&client->totals.dropped, dropped - client->isr_dropped_seen);
+#if PLEXUS_ENABLE_CLIENT_STATS
+        client->cstats.drops_buffer_full += dropped - client->isr_dropped_seen;
 #endif
+        client->isr_dropped_seen = dropped;
+    }
+
+    uint16_t tail = client->isr_tail;
+    uint16_t head = PLEXUS_LOAD_ACQUIRE(&client->isr_head);
+    if (tail == head) {
+        return PLEXUS_OK;
+    }
+
+    /* Ticks stamped in the ISR become wall time relative to now */
+    uint32_t now_tick = plexus_hal_get_tick_ms();
+    uint64_t now_ms = plexus_hal_get_time_ms();
+
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+
+    plexus_err_t err = PLEXUS_OK;
+    while (tail != head && client->metric_count < client->max_metrics) {
+        const plexus_isr_sample_t* s = &client->isr_ring[tail];
+        const char* metric = s->metric;
+        uint32_t age_ms = now_tick - s->tick_ms;
+        v.data.number = s->value;
+        tail = (uint16_t)((tail + 1) & ISR_RING_MASK);
+        PLEXUS_STORE_RELEASE(&client->isr_tail, tail);
+
+        /* No wall clock yet: 0 lets the enqueue stamp it like any send */
+        uint64_t timestamp_ms = now_ms > age_ms ? now_ms - age_ms : 0;
+        (void)route_point(client, metric, &v, timestamp_ms);
+
+        err = plexus_internal_maybe_auto_flush(client);
+        if (err != PLEXUS_OK) {
+            break;
+        }
+    }
+    return err;
+}
+
+#endif /* PLEXUS_ENABLE_ISR_QUEUE */
 
 /* ------------------------------------------------------------------------- */
 /* Backoff helpers                                                           */
@@ -591,25 +1007,25 @@ static uint32_t backoff_rand(uint32_t seed) {
 /**
  * Compute next backoff delay with exponential growth and jitter.
  */
-static uint32_t compute_backoff(plexus_client_t* client) {
-    if (client->retry_backoff_ms == 0) {
-        client->retry_backoff_ms = PLEXUS_RETRY_BASE_MS;
+static uint32_t compute_backoff(uint32_t* backoff_ms) {
+    if (*backoff_ms == 0) {
+        *backoff_ms = PLEXUS_RETRY_BASE_MS;
     } else {
-        client->retry_backoff_ms *= 2;
-        if (client->retry_backoff_ms > PLEXUS_RETRY_MAX_MS) {
-            client->retry_backoff_ms = PLEXUS_RETRY_MAX_MS;
+        *backoff_ms *= 2;
+        if (*backoff_ms > PLEXUS_RETRY_MAX_MS) {
+            *backoff_ms = PLEXUS_RETRY_MAX_MS;
         }
     }
 
     /* Add ±25% jitter */
-    uint32_t jitter_range = client->retry_backoff_ms / 4;
+    uint32_t jitter_range = *backoff_ms / 4;
     if (jitter_range > 0) {
-        uint32_t seed = plexus_hal_get_tick_ms() ^ client->retry_backoff_ms;
+        uint32_t seed = plexus_hal_get_tick_ms() ^ *backoff_ms;
         uint32_t jitter = backoff_rand(seed) % (jitter_range * 2);
-        return client->retry_backoff_ms - jitter_range + jitter;
+        return *backoff_ms - jitter_range + jitter;
     }
 
-    return client->retry_backoff_ms;
+    return *backoff_ms;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -662,33 +1078,136 @@ static void persist_save_meta(const plexus_persist_meta_t* meta) {
     plexus_hal_storage_write("plexus_meta", &out, sizeof(out));
 }
 
+#if PLEXUS_ENABLE_CLIENT_STATS
+uint16_t plexus_internal_persist_backlog(void) {
+    plexus_persist_meta_t meta;
+    persist_load_meta(&meta);
+    return (uint16_t)meta.count;
+}
+#endif
+
 #endif /* PLEXUS_ENABLE_PERSISTENT_BUFFER */
 
 /* ------------------------------------------------------------------------- */
 /* Flush & network                                                           */
 /* ------------------------------------------------------------------------- */
 
-plexus_err_t plexus_flush(plexus_client_t* client) {
-    if (!client) {
-        return PLEXUS_ERR_NULL_PTR;
+/**
+ * True if a feature holds samples that are only queued at flush time.
+ */
+static bool has_deferred_points(const plexus_client_t* client) {
+#if PLEXUS_ENABLE_DOWNSAMPLE
+    if (plexus_downsample_pending(client)) return true;
+#endif
+#if PLEXUS_ENABLE_SDT
+    if (plexus_sdt_pending(client)) return true;
+#endif
+#if PLEXUS_ENABLE_THREAD_STAGING
+    if (plexus_stage_pending(client)) return true;
+#endif
+    (void)client;
+    return false;
+}
+
+/**
+ * Move flush-time samples into the batch being sent.
+ */
+static void queue_deferred_points(plexus_client_t* client) {
+#if PLEXUS_ENABLE_SDT
+    /* Held segment endpoints, so the server is at most one flush behind */
+    plexus_sdt_flush_held(client);
+#endif
+#if PLEXUS_ENABLE_DOWNSAMPLE
+    /* Decimate buffered waveforms */
+    (void)plexus_downsample_drain(client);
+#endif
+#if PLEXUS_ENABLE_THREAD_STAGING
+    /* Per-thread staging buffers, merged by timestamp */
+    plexus_stage_collect(client);
+#endif
+    (void)client;
+}
+
+/**
+ * Drop all queued points (after a successful send or plexus_clear()).
+ */
+static void clear_metrics(plexus_client_t* client) {
+    client->metric_count = 0;
+    PLEXUS_STORE_RELAXED(&client->totals.pending, (uint16_t)0);
+#if PLEXUS_ENABLE_SKETCHES
+    /* Queued sketch points reference per-sketch storage — release it */
+    plexus_sketch_release_pending(client);
+#endif
+}
+
+/**
+ * POST a body with the client's API key, recording the client's trace and stats.
+ */
+static plexus_err_t http_post_body(plexus_client_t* client, const char* endpoint,
+                                   const char* body, size_t body_len) {
+#if PLEXUS_ENABLE_CLIENT_STATS
+    uint32_t start = plexus_hal_get_tick_ms();
+#endif
+    PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_HTTP_POST, body_len);
+    plexus_err_t err = plexus_hal_http_post(endpoint, client->api_key,
+                                            PLEXUS_USER_AGENT, body, body_len);
+    PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_HTTP_POST, body_len, err);
+#if PLEXUS_ENABLE_CLIENT_STATS
+    plexus_client_stats_post(client, plexus_hal_get_tick_ms() - start, err);
+#endif
+    return err;
+}
+
+/**
+ * POST the first body_len bytes of the JSON buffer to the ingest endpoint.
+ */
+static plexus_err_t http_post(plexus_client_t* client, size_t body_len) {
+    return http_post_body(client, client->endpoint, client->json_buffer, body_len);
+}
+
+#if PLEXUS_ENABLE_WEBSOCKET
+/**
+ * Send the queue as WebSocket telemetry when connected and enabled. True
+ * if that delivered the batch and no HTTP post is needed; false leaves it
+ * queued for HTTP, as a fallback or for persistence in dual transport mode.
+ * Caller holds the lock.
+ */
+static bool ws_deliver(plexus_client_t* client) {
+    if (!client->ws_telemetry_enabled || client->ws_state != PLEXUS_WS_CONNECTED) {
+        return false;
     }
-    if (!client->initialized) {
-        return PLEXUS_ERR_NOT_INITIALIZED;
+    if (plexus_ws_send_telemetry(client) != PLEXUS_OK || client->http_persist_enabled) {
+        return false;
     }
+    /* WS-only mode — clear metrics and done */
+    PLEXUS_ADD_RELAXED(&client->totals.sent, client->metric_count);
+    clear_metrics(client);
+    client->last_flush_ms = plexus_hal_get_tick_ms();
+    return true;
+}
+#endif
 
-    PLEXUS_LOCK(client);
+/**
+ * Everything before the HTTP post: rate-limit cooldown, deferred points,
+ * persisted batches, serialization and the WebSocket path. Sets *out_sent
+ * when the WebSocket delivered the batch and no HTTP post is needed.
+ * Caller holds the lock.
+ */
+static plexus_err_t flush_prepare(plexus_client_t* client, int* out_json_len, bool* out_sent) {
+    *out_sent = false;
 
     /* Respect rate limit cooldown */
     if (client->rate_limit_until_ms > 0) {
         uint32_t now = plexus_hal_get_tick_ms();
         if (!tick_elapsed(now, client->rate_limit_until_ms)) {
-            PLEXUS_UNLOCK(client);
             return PLEXUS_ERR_RATE_LIMIT;
         }
         /* Cooldown expired */
         client->rate_limit_until_ms = 0;
     }
 
+    queue_deferred_points(client);
+
 #if PLEXUS_ENABLE_PERSISTENT_BUFFER
     /* Attempt to drain persisted ring buffer first */
     {
@@ -698,16 +1217,21 @@ plexus_err_t plexus_flush(plexus_client_t* client) {
         while (meta.count > 0) {
             char slot_key[16];
             persist_slot_key(slot_key, sizeof(slot_key), meta.tail);
+            PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_PERSIST_DRAIN, 0);
 
             size_t stored_len = 0;
             plexus_err_t restore_err = plexus_hal_storage_read(
-                slot_key, client->json_buffer, PLEXUS_JSON_BUFFER_SIZE, &stored_len);
+                slot_key, client->json_buffer, client->json_buffer_size, &stored_len);
             if (restore_err != PLEXUS_OK || stored_len <= sizeof(plexus_persist_header_t)) {
                 /* Corrupt slot — skip it */
                 plexus_hal_storage_clear(slot_key);
                 meta.tail = (meta.tail + 1) % PLEXUS_PERSIST_MAX_BATCHES;
                 meta.count--;
                 persist_save_meta(&meta);
+#if PLEXUS_ENABLE_CLIENT_STATS
+                client->cstats.drops_persist_corrupt++;
+#endif
+                PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_PERSIST_DRAIN, stored_len, PLEXUS_ERR_HAL);
                 continue;
             }
 
@@ -725,15 +1249,18 @@ plexus_err_t plexus_flush(plexus_client_t* client) {
                 meta.tail = (meta.tail + 1) % PLEXUS_PERSIST_MAX_BATCHES;
                 meta.count--;
                 persist_save_meta(&meta);
+#if PLEXUS_ENABLE_CLIENT_STATS
+                client->cstats.drops_persist_corrupt++;
+#endif
+                PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_PERSIST_DRAIN, stored_len, PLEXUS_ERR_HAL);
                 continue;
             }
 
             /* Shift payload to front of buffer for sending */
             memmove(client->json_buffer, client->json_buffer + sizeof(header), header.data_len);
 
-            plexus_err_t send_err = plexus_hal_http_post(
-                client->endpoint, client->api_key, PLEXUS_USER_AGENT,
-                client->json_buffer, header.data_len);
+            plexus_err_t send_err = http_post(client, header.data_len);
+            PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_PERSIST_DRAIN, header.data_len, send_err);
             if (send_err == PLEXUS_OK) {
                 plexus_hal_storage_clear(slot_key);
                 meta.tail = (meta.tail + 1) % PLEXUS_PERSIST_MAX_BATCHES;
@@ -748,103 +1275,101 @@ plexus_err_t plexus_flush(plexus_client_t* client) {
 #endif
 
     if (client->metric_count == 0) {
-        PLEXUS_UNLOCK(client);
         return PLEXUS_ERR_NO_DATA;
     }
 
     /* Serialize to JSON */
-    int json_len = plexus_json_serialize(client, client->json_buffer, PLEXUS_JSON_BUFFER_SIZE);
+#if PLEXUS_ENABLE_CLIENT_STATS
+    uint32_t serialize_start = plexus_internal_clock_stamp();
+#endif
+    PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_SERIALIZE, client->metric_count);
+    int json_len = plexus_json_serialize(client, client->json_buffer, client->json_buffer_size);
+    PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_SERIALIZE, json_len > 0 ? json_len : 0,
+                      json_len < 0 ? PLEXUS_ERR_JSON : PLEXUS_OK);
+#if PLEXUS_ENABLE_CLIENT_STATS
+    plexus_client_stats_serialize(client, serialize_start);
+#endif
     if (json_len < 0) {
-        client->total_errors++;
-        PLEXUS_UNLOCK(client);
+        PLEXUS_ADD_RELAXED(&client->totals.errors, 1);
         return PLEXUS_ERR_JSON;
     }
+    *out_json_len = json_len;
 
 #if PLEXUS_DEBUG
     plexus_hal_log("Sending %d metrics (%d bytes)", client->metric_count, json_len);
 #endif
 
 #if PLEXUS_ENABLE_WEBSOCKET
-    /* WebSocket path — send via WS if connected and enabled */
-    if (client->ws_telemetry_enabled && client->ws_state == PLEXUS_WS_CONNECTED) {
-        plexus_err_t ws_err = plexus_ws_send_telemetry(client);
-        if (ws_err == PLEXUS_OK) {
-            if (!client->http_persist_enabled) {
-                /* WS-only mode — clear metrics and done */
-                client->total_sent += client->metric_count;
-                client->metric_count = 0;
-                client->last_flush_ms = plexus_hal_get_tick_ms();
-                PLEXUS_UNLOCK(client);
-                return PLEXUS_OK;
-            }
-            /* Dual transport: WS delivered to dashboard.
-             * Fall through to HTTP for persistence (metrics still in buffer).
-             * HTTP path will clear metrics on success. */
-        }
-        /* If WS send failed, fall through to HTTP path as fallback */
+    /* WebSocket path. Dual transport: WS delivered to dashboard, HTTP
+     * persists (and clears the buffer on success); a failed WS send falls
+     * through to HTTP as a fallback. */
+    if (ws_deliver(client)) {
+        *out_sent = true;
+        return PLEXUS_OK;
     }
 #endif
 
-    /* Send with retries and exponential backoff */
-    plexus_err_t err = PLEXUS_ERR_NETWORK;
-    client->retry_backoff_ms = 0; /* Reset backoff for this flush attempt */
-
-    for (int retry = 0; retry < PLEXUS_MAX_RETRIES; retry++) {
-        if (retry > 0) {
-            uint32_t delay = compute_backoff(client);
-            plexus_hal_delay_ms(delay);
-        }
+    return PLEXUS_OK;
+}
 
-        err = plexus_hal_http_post(client->endpoint, client->api_key,
-                                    PLEXUS_USER_AGENT,
-                                    client->json_buffer, (size_t)json_len);
+/**
+ * One HTTP post of the serialized batch. Clears the queue on success and
+ * records auth / rate-limit outcomes. Caller holds the lock.
+ */
+static plexus_err_t flush_post(plexus_client_t* client, int json_len) {
+    plexus_err_t err = http_post(client, (size_t)json_len);
 
-        if (err == PLEXUS_OK) {
-            client->total_sent += client->metric_count;
-            client->metric_count = 0;
-            client->last_flush_ms = plexus_hal_get_tick_ms();
-            client->retry_backoff_ms = 0;
+    if (err == PLEXUS_OK) {
+#if PLEXUS_ENABLE_CLIENT_STATS
+        client->cstats.points_posted += client->metric_count;
+        client->cstats.bytes_posted += (uint64_t)json_len;
+#endif
+        PLEXUS_ADD_RELAXED(&client->totals.sent, client->metric_count);
+        clear_metrics(client);
+        client->last_flush_ms = plexus_hal_get_tick_ms();
+        client->retry_backoff_ms = 0;
 #if PLEXUS_ENABLE_STATUS_CALLBACK
-            notify_status(client, PLEXUS_STATUS_CONNECTED);
+        notify_status(client, PLEXUS_STATUS_CONNECTED);
 #endif
-            PLEXUS_UNLOCK(client);
-            return PLEXUS_OK;
-        }
+        return PLEXUS_OK;
+    }
 
-        /* Don't retry on auth, forbidden, or billing errors */
-        if (err == PLEXUS_ERR_AUTH || err == PLEXUS_ERR_FORBIDDEN) {
 #if PLEXUS_ENABLE_STATUS_CALLBACK
-            notify_status(client, PLEXUS_STATUS_AUTH_FAILED);
+    if (err == PLEXUS_ERR_AUTH || err == PLEXUS_ERR_FORBIDDEN) {
+        notify_status(client, PLEXUS_STATUS_AUTH_FAILED);
+    }
 #endif
-            break;
-        }
-
-        if (err == PLEXUS_ERR_BILLING) {
-            break;
-        }
 
-        /* On rate limit, enter cooldown and stop immediately */
-        if (err == PLEXUS_ERR_RATE_LIMIT) {
-            client->rate_limit_until_ms =
-                plexus_hal_get_tick_ms() + PLEXUS_RATE_LIMIT_COOLDOWN_MS;
+    /* On rate limit, enter cooldown */
+    if (err == PLEXUS_ERR_RATE_LIMIT) {
+        client->rate_limit_until_ms =
+            plexus_hal_get_tick_ms() + PLEXUS_RATE_LIMIT_COOLDOWN_MS;
 #if PLEXUS_ENABLE_STATUS_CALLBACK
-            notify_status(client, PLEXUS_STATUS_RATE_LIMITED);
+        notify_status(client, PLEXUS_STATUS_RATE_LIMITED);
 #endif
 #if PLEXUS_DEBUG
-            plexus_hal_log("Rate limited — cooling down for %d ms",
-                           PLEXUS_RATE_LIMIT_COOLDOWN_MS);
-#endif
-            break;
-        }
-
-#if PLEXUS_DEBUG
-        plexus_hal_log("Retry %d/%d after error: %s (backoff: %lu ms)",
-                       retry + 1, PLEXUS_MAX_RETRIES, plexus_strerror(err),
-                       (unsigned long)client->retry_backoff_ms);
+        plexus_hal_log("Rate limited — cooling down for %d ms",
+                       PLEXUS_RATE_LIMIT_COOLDOWN_MS);
 #endif
     }
 
-    /* All retries exhausted (or non-retryable error) */
+    return err;
+}
+
+/** Don't retry on auth, forbidden, billing or rate-limit errors */
+static bool flush_retryable(plexus_err_t err) {
+    return err != PLEXUS_OK && err != PLEXUS_ERR_AUTH && err != PLEXUS_ERR_FORBIDDEN &&
+           err != PLEXUS_ERR_BILLING && err != PLEXUS_ERR_RATE_LIMIT;
+}
+
+/**
+ * Give up on the batch after the last attempt: report the status and, with
+ * persistent buffering, move the batch to storage. Caller holds the lock.
+ */
+static void flush_failed(plexus_client_t* client, plexus_err_t err, int json_len) {
+    (void)err;
+    (void)json_len;
+
 #if PLEXUS_ENABLE_STATUS_CALLBACK
     if (err != PLEXUS_ERR_AUTH && err != PLEXUS_ERR_FORBIDDEN &&
         err != PLEXUS_ERR_BILLING && err != PLEXUS_ERR_RATE_LIMIT) {
@@ -854,7 +1379,7 @@ plexus_err_t plexus_flush(plexus_client_t* client) {
 
 #if PLEXUS_ENABLE_PERSISTENT_BUFFER
     /* Save failed batch to next ring buffer slot */
-    if ((size_t)json_len + sizeof(plexus_persist_header_t) <= PLEXUS_JSON_BUFFER_SIZE) {
+    if ((size_t)json_len + sizeof(plexus_persist_header_t) <= client->json_buffer_size) {
         plexus_persist_meta_t meta;
         persist_load_meta(&meta);
 
@@ -871,18 +1396,29 @@ plexus_err_t plexus_flush(plexus_client_t* client) {
                                      (size_t)json_len);
         memcpy(client->json_buffer, &header, sizeof(header));
 
-        plexus_hal_storage_write(slot_key, client->json_buffer,
-                                  sizeof(header) + (size_t)json_len);
+        PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_PERSIST_WRITE, sizeof(header) + (size_t)json_len);
+        plexus_err_t write_err = plexus_hal_storage_write(slot_key, client->json_buffer,
+                                                           sizeof(header) + (size_t)json_len);
+        PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_PERSIST_WRITE, sizeof(header) + (size_t)json_len,
+                          write_err);
 
         meta.head = (meta.head + 1) % PLEXUS_PERSIST_MAX_BATCHES;
         if (meta.count >= PLEXUS_PERSIST_MAX_BATCHES) {
             /* Overwrite oldest — advance tail */
             meta.tail = (meta.tail + 1) % PLEXUS_PERSIST_MAX_BATCHES;
+#if PLEXUS_ENABLE_CLIENT_STATS
+            client->cstats.drops_persist_overwrite++;
+#endif
         } else {
             meta.count++;
         }
         persist_save_meta(&meta);
 
+        /* The batch now lives in storage; keeping it queued would send it twice */
+        if (write_err == PLEXUS_OK) {
+            clear_metrics(client);
+        }
+
 #if PLEXUS_DEBUG
         plexus_hal_log("Persisted %d bytes to slot %u (count: %u)",
                        json_len, (unsigned)((meta.head + PLEXUS_PERSIST_MAX_BATCHES - 1) % PLEXUS_PERSIST_MAX_BATCHES),
@@ -891,7 +1427,368 @@ plexus_err_t plexus_flush(plexus_client_t* client) {
     }
 #endif
 
-    client->total_errors++;
+    PLEXUS_ADD_RELAXED(&client->totals.errors, 1);
+}
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+
+/* ------------------------------------------------------------------------- */
+/* Coalesced flush through a shared transport                                */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_STATUS_CALLBACK
+/** Status for a batch's final outcome, as flush_post() and flush_failed() report it */
+static void notify_flush_result(plexus_client_t* client, plexus_err_t err) {
+    switch (err) {
+        case PLEXUS_OK:
+            notify_status(client, PLEXUS_STATUS_CONNECTED);
+            break;
+        case PLEXUS_ERR_AUTH:
+        case PLEXUS_ERR_FORBIDDEN:
+            notify_status(client, PLEXUS_STATUS_AUTH_FAILED);
+            break;
+        case PLEXUS_ERR_RATE_LIMIT:
+            notify_status(client, PLEXUS_STATUS_RATE_LIMITED);
+            break;
+        case PLEXUS_ERR_BILLING:
+            break;
+        default:
+            notify_status(client, PLEXUS_STATUS_DISCONNECTED);
+            break;
+    }
+}
+#endif
+
+/**
+ * Drop the first n queued points once a request that could not hold the
+ * whole queue has delivered them.
+ */
+static void drop_sent_metrics(plexus_client_t* client, uint16_t n) {
+    if (n >= client->metric_count) {
+        clear_metrics(client);
+        return;
+    }
+#if PLEXUS_ENABLE_SKETCHES
+    for (uint16_t i = 0; i < n; i++) {
+        if (client->metrics[i].value.type == PLEXUS_VALUE_SKETCH) {
+            plexus_sketch_release_one(client, client->metrics[i].value.data.sketch);
+        }
+    }
+#endif
+    memmove(&client->metrics[0], &client->metrics[n],
+            (size_t)(client->metric_count - n) * sizeof(client->metrics[0]));
+    client->metric_count -= n;
+    PLEXUS_STORE_RELAXED(&client->totals.pending, client->metric_count);
+}
+
+/**
+ * Serialize attached clients from *cursor into the transport buffer until
+ * it is full, recording in packed[] how many leading points of each went
+ * in. A queue that doesn't fit is split: its head ends this request, and
+ * *cursor stays on it so the rest leads the next one. Returns the body
+ * length (0 once no client has points), or -1 after dropping a point too
+ * large for any request.
+ */
+static int transport_pack(plexus_transport_t* transport, uint8_t* cursor, uint16_t* packed) {
+    size_t len = 0;
+    memset(packed, 0, PLEXUS_MAX_TRANSPORT_CLIENTS * sizeof(packed[0]));
+    while (*cursor < transport->client_count) {
+        plexus_client_t* client = transport->clients[*cursor];
+        if (client->metric_count == 0) {
+            (*cursor)++;
+            continue;
+        }
+
+#if PLEXUS_ENABLE_CLIENT_STATS
+        uint32_t serialize_start = plexus_internal_clock_stamp();
+#endif
+        PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_SERIALIZE, client->metric_count);
+        uint16_t count = 0;
+        int json_len = plexus_json_append_points(client, transport->json_buffer,
+                                                 sizeof(transport->json_buffer), len, &count);
+        PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_SERIALIZE, json_len > 0 ? json_len : 0,
+                          json_len < 0 ? PLEXUS_ERR_JSON : PLEXUS_OK);
+#if PLEXUS_ENABLE_CLIENT_STATS
+        plexus_client_stats_serialize(client, serialize_start);
+#endif
+
+        if (json_len < 0) {
+            if (len == 0) {
+                /* Could never be sent; dropping it keeps the queue moving */
+                drop_sent_metrics(client, 1);
+                PLEXUS_ADD_RELAXED(&client->totals.dropped, 1);
+                PLEXUS_ADD_RELAXED(&client->totals.errors, 1);
+                return -1;
+            }
+            break;      /* Leads the next request */
+        }
+        len = (size_t)json_len;
+        packed[*cursor] = count;
+        if (count < client->metric_count) {
+            break;      /* The rest leads the next request */
+        }
+        (*cursor)++;
+    }
+    return (int)len;
+}
+
+/**
+ * Post one coalesced body and settle the clients in it: their packed points
+ * dropped on success, an error counted on each once retries are exhausted,
+ * and every attached client held back on a 429. The first client in the
+ * body carries the trace and post stats. Caller holds the transport lock.
+ */
+static plexus_err_t transport_post(plexus_transport_t* transport, const uint16_t* packed,
+                                   int json_len, bool wait, uint32_t* retry_after_ms) {
+    plexus_client_t* first = NULL;
+    for (uint8_t i = 0; i < transport->client_count && !first; i++) {
+        if (packed[i] > 0) {
+            first = transport->clients[i];
+        }
+    }
+
+    if (wait) {
+        transport->flush_attempts = 0;
+    }
+    if (transport->flush_attempts == 0) {
+        transport->retry_backoff_ms = 0;
+    }
+
+    plexus_err_t err = PLEXUS_OK;
+    for (int retry = 0; retry < PLEXUS_MAX_RETRIES; retry++) {
+        if (retry > 0) {
+            uint32_t delay = compute_backoff(&transport->retry_backoff_ms);
+#if PLEXUS_ENABLE_CLIENT_STATS
+            first->cstats.retries++;
+            first->cstats.backoff_ms_total += delay;
+#endif
+            PLEXUS_TRACE_ENTER(first, PLEXUS_TRACE_BACKOFF, delay);
+            plexus_hal_delay_ms(delay);
+            PLEXUS_TRACE_EXIT(first, PLEXUS_TRACE_BACKOFF, delay, PLEXUS_OK);
+        }
+
+        err = http_post_body(first, transport->endpoint, transport->json_buffer, (size_t)json_len);
+        if (!wait || !flush_retryable(err)) {
+            break;
+        }
+    }
+
+    if (!wait && flush_retryable(err) && retry_after_ms &&
+        ++transport->flush_attempts < PLEXUS_MAX_RETRIES) {
+        /* Batch stays queued; the caller comes back after the backoff */
+        *retry_after_ms = compute_backoff(&transport->retry_backoff_ms);
+#if PLEXUS_ENABLE_CLIENT_STATS
+        first->cstats.retries++;
+        first->cstats.backoff_ms_total += *retry_after_ms;
+#endif
+        return err;
+    }
+    transport->flush_attempts = 0;
+
+    uint32_t now = plexus_hal_get_tick_ms();
+    if (err == PLEXUS_ERR_RATE_LIMIT) {
+        /* One key, one limit: hold back every client on the transport */
+        transport->rate_limit_until_ms = now + PLEXUS_RATE_LIMIT_COOLDOWN_MS;
+        for (uint8_t i = 0; i < transport->client_count; i++) {
+            transport->clients[i]->rate_limit_until_ms = transport->rate_limit_until_ms;
+        }
+    }
+#if PLEXUS_ENABLE_CLIENT_STATS
+    if (err == PLEXUS_OK) {
+        first->cstats.bytes_posted += (uint64_t)json_len;
+    }
+#endif
+
+    for (uint8_t i = 0; i < transport->client_count; i++) {
+        if (packed[i] == 0) {
+            continue;
+        }
+        plexus_client_t* client = transport->clients[i];
+        if (err == PLEXUS_OK) {
+#if PLEXUS_ENABLE_CLIENT_STATS
+            client->cstats.points_posted += packed[i];
+#endif
+            PLEXUS_ADD_RELAXED(&client->totals.sent, packed[i]);
+            drop_sent_metrics(client, packed[i]);
+            client->last_flush_ms = now;
+        } else {
+            PLEXUS_ADD_RELAXED(&client->totals.errors, 1);
+        }
+#if PLEXUS_ENABLE_STATUS_CALLBACK
+        notify_flush_result(client, err);
+#endif
+    }
+    return err;
+}
+
+plexus_err_t plexus_internal_transport_flush(plexus_transport_t* transport, bool wait,
+                                             uint32_t* retry_after_ms) {
+    /* Respect the shared rate limit cooldown */
+    if (transport->rate_limit_until_ms > 0) {
+        if (!tick_elapsed(plexus_hal_get_tick_ms(), transport->rate_limit_until_ms)) {
+            return PLEXUS_ERR_RATE_LIMIT;
+        }
+        transport->rate_limit_until_ms = 0;
+        for (uint8_t i = 0; i < transport->client_count; i++) {
+            transport->clients[i]->rate_limit_until_ms = 0;
+        }
+    }
+
+    plexus_err_t result = PLEXUS_ERR_NO_DATA;
+    for (uint8_t i = 0; i < transport->client_count; i++) {
+        plexus_client_t* client = transport->clients[i];
+        queue_deferred_points(client);
+#if PLEXUS_ENABLE_WEBSOCKET
+        /* Sockets stay per client; only HTTP batches are coalesced */
+        if (client->metric_count > 0 && ws_deliver(client)) {
+            result = PLEXUS_OK;
+        }
+#endif
+    }
+
+    uint8_t cursor = 0;
+    while (cursor < transport->client_count) {
+        uint16_t packed[PLEXUS_MAX_TRANSPORT_CLIENTS];
+        int json_len = transport_pack(transport, &cursor, packed);
+        if (json_len < 0) {
+            result = PLEXUS_ERR_JSON;
+            continue;
+        }
+        if (json_len == 0) {
+            break;
+        }
+
+        plexus_err_t err = transport_post(transport, packed, json_len, wait, retry_after_ms);
+        if (err != PLEXUS_OK) {
+            return err;     /* Later clients stay queued */
+        }
+        if (result == PLEXUS_ERR_NO_DATA) {
+            result = PLEXUS_OK;
+        }
+    }
+    return result;
+}
+
+#endif /* PLEXUS_ENABLE_SHARED_TRANSPORT */
+
+plexus_err_t plexus_flush(plexus_client_t* client) {
+    if (!client) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    PLEXUS_LOCK(client);
+    PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_FLUSH, client->metric_count);
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+    if (client->transport) {
+        plexus_err_t shared_err = plexus_internal_transport_flush(client->transport, true, NULL);
+        PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_FLUSH, 0, shared_err);
+        PLEXUS_UNLOCK(client);
+        return shared_err;
+    }
+#endif
+
+    int json_len = 0;
+    bool sent = false;
+    plexus_err_t err = flush_prepare(client, &json_len, &sent);
+    if (err != PLEXUS_OK || sent) {
+        PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_FLUSH, json_len, err);
+        PLEXUS_UNLOCK(client);
+        return err;
+    }
+
+    /* Send with retries and exponential backoff */
+    client->retry_backoff_ms = 0; /* Reset backoff for this flush attempt */
+    client->flush_attempts = 0;
+
+    for (int retry = 0; retry < PLEXUS_MAX_RETRIES; retry++) {
+        if (retry > 0) {
+            uint32_t delay = compute_backoff(&client->retry_backoff_ms);
+#if PLEXUS_ENABLE_CLIENT_STATS
+            client->cstats.retries++;
+            client->cstats.backoff_ms_total += delay;
+#endif
+            PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_BACKOFF, delay);
+            plexus_hal_delay_ms(delay);
+            PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_BACKOFF, delay, PLEXUS_OK);
+        }
+
+        err = flush_post(client, json_len);
+        if (!flush_retryable(err)) {
+            break;
+        }
+
+#if PLEXUS_DEBUG
+        plexus_hal_log("Retry %d/%d after error: %s (backoff: %lu ms)",
+                       retry + 1, PLEXUS_MAX_RETRIES, plexus_strerror(err),
+                       (unsigned long)client->retry_backoff_ms);
+#endif
+    }
+
+    if (err != PLEXUS_OK) {
+        flush_failed(client, err, json_len);
+    }
+    PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_FLUSH, json_len, err);
+    PLEXUS_UNLOCK(client);
+    return err;
+}
+
+plexus_err_t plexus_flush_nowait(plexus_client_t* client, uint32_t* retry_after_ms) {
+    if (retry_after_ms) {
+        *retry_after_ms = 0;
+    }
+    if (!client) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    PLEXUS_LOCK(client);
+    PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_FLUSH, client->metric_count);
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+    if (client->transport) {
+        plexus_err_t shared_err = plexus_internal_transport_flush(client->transport, false, retry_after_ms);
+        PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_FLUSH, 0, shared_err);
+        PLEXUS_UNLOCK(client);
+        return shared_err;
+    }
+#endif
+
+    int json_len = 0;
+    bool sent = false;
+    plexus_err_t err = flush_prepare(client, &json_len, &sent);
+    if (err != PLEXUS_OK || sent) {
+        PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_FLUSH, json_len, err);
+        PLEXUS_UNLOCK(client);
+        return err;
+    }
+
+    if (client->flush_attempts == 0) {
+        client->retry_backoff_ms = 0;
+    }
+
+    err = flush_post(client, json_len);
+    if (flush_retryable(err) && retry_after_ms &&
+        ++client->flush_attempts < PLEXUS_MAX_RETRIES) {
+        /* Batch stays queued; the caller comes back after the backoff */
+        *retry_after_ms = compute_backoff(&client->retry_backoff_ms);
+#if PLEXUS_ENABLE_CLIENT_STATS
+        client->cstats.retries++;
+        client->cstats.backoff_ms_total += *retry_after_ms;
+#endif
+    } else {
+        client->flush_attempts = 0;
+        if (err != PLEXUS_OK) {
+            flush_failed(client, err, json_len);
+        }
+    }
+
+    PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_FLUSH, json_len, err);
     PLEXUS_UNLOCK(client);
     return err;
 }
@@ -900,13 +1797,13 @@ uint16_t plexus_pending_count(const plexus_client_t* client) {
     if (!client || !client->initialized) {
         return 0;
     }
-    return client->metric_count;
+    return PLEXUS_LOAD_RELAXED(&client->totals.pending);
 }
 
 void plexus_clear(plexus_client_t* client) {
     if (client && client->initialized) {
         PLEXUS_LOCK(client);
-        client->metric_count = 0;
+        clear_metrics(client);
         PLEXUS_UNLOCK(client);
     }
 }
@@ -915,14 +1812,29 @@ uint32_t plexus_total_sent(const plexus_client_t* client) {
     if (!client || !client->initialized) {
         return 0;
     }
-    return client->total_sent;
+    return (uint32_t)PLEXUS_LOAD_RELAXED(&client->totals.sent);
 }
 
 uint32_t plexus_total_errors(const plexus_client_t* client) {
     if (!client || !client->initialized) {
         return 0;
     }
-    return client->total_errors;
+    return (uint32_t)PLEXUS_LOAD_RELAXED(&client->totals.errors);
+}
+
+plexus_err_t plexus_get_totals(const plexus_client_t* client, plexus_totals_t* out) {
+    if (!client || !out) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    out->sent = PLEXUS_LOAD_RELAXED(&client->totals.sent);
+    out->errors = PLEXUS_LOAD_RELAXED(&client->totals.errors);
+    out->dropped = PLEXUS_LOAD_RELAXED(&client->totals.dropped);
+    out->pending = PLEXUS_LOAD_RELAXED(&client->totals.pending);
+    return PLEXUS_OK;
 }
 
 plexus_err_t plexus_tick(plexus_client_t* client) {
@@ -940,8 +1852,45 @@ plexus_err_t plexus_tick(plexus_client_t* client) {
 
     PLEXUS_LOCK(client);
 
+#if PLEXUS_ENABLE_ISR_QUEUE
+    /* Staged samples first, so they land in the windows closed below */
+    plexus_err_t isr_err = isr_drain(client);
+    if (isr_err != PLEXUS_OK) {
+        PLEXUS_UNLOCK(client);
+        return isr_err;
+    }
+#endif
+
+#if PLEXUS_ENABLE_AGGREGATION
+    /* Close due windows. A full buffer keeps the window open for next tick. */
+    (void)plexus_agg_tick(client);
+#endif
+#if PLEXUS_ENABLE_SKETCHES
+    (void)plexus_sketch_tick(client);
+#endif
+#if PLEXUS_ENABLE_COUNTERS
+    (void)plexus_counter_tick(client);
+#endif
+#if PLEXUS_ENABLE_HISTORY
+    plexus_history_tick(client);
+#endif
+#if PLEXUS_ENABLE_CLIENT_STATS
+    plexus_client_stats_tick(client);
+#endif
+#if PLEXUS_ENABLE_TRIGGER
+    /* Continue moving a burst larger than the queue, flushing as it fills */
+    plexus_trigger_drain(client);
+    if (client->metric_count > 0) {
+        plexus_err_t burst_err = plexus_internal_maybe_auto_flush(client);
+        if (burst_err != PLEXUS_OK) {
+            PLEXUS_UNLOCK(client);
+            return burst_err;
+        }
+    }
+#endif
+
     /* Nothing to flush — return OK (idle is not an error) */
-    if (client->metric_count == 0) {
+    if (client->metric_count == 0 && !has_deferred_points(client)) {
         PLEXUS_UNLOCK(client);
         return PLEXUS_OK;
     }
@@ -964,6 +1913,183 @@ plexus_err_t plexus_tick(plexus_client_t* client) {
     return PLEXUS_OK;
 }
 
+/* ------------------------------------------------------------------------- */
+/* Deadlines & wake hook                                                     */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Milliseconds until plexus_tick() has work, or PLEXUS_DEADLINE_NONE.
+ * Caller must hold the client lock.
+ */
+static uint32_t next_deadline(const plexus_client_t* client, uint32_t now) {
+    uint32_t wait = PLEXUS_DEADLINE_NONE;
+
+    /* Time-based flush of queued points, held back by a 429 cooldown */
+    uint32_t flush_wait = PLEXUS_DEADLINE_NONE;
+    if (client->metric_count > 0 || has_deferred_points(client)) {
+        uint32_t interval = client->flush_interval_ms > 0
+            ? client->flush_interval_ms : PLEXUS_AUTO_FLUSH_INTERVAL_MS;
+        if (interval > 0) {
+            plexus_internal_deadline(now, client->last_flush_ms + interval, &flush_wait);
+        }
+        if (client->rate_limit_until_ms > 0 && flush_wait != PLEXUS_DEADLINE_NONE) {
+            uint32_t cooldown = PLEXUS_DEADLINE_NONE;
+            plexus_internal_deadline(now, client->rate_limit_until_ms, &cooldown);
+            if (cooldown > flush_wait) {
+                flush_wait = cooldown;
+            }
+        }
+    }
+    if (flush_wait < wait) {
+        wait = flush_wait;
+    }
+
+    /* Windows that emit into the queue cannot close while it is full */
+    uint32_t emit_wait = PLEXUS_DEADLINE_NONE;
+#if PLEXUS_ENABLE_AGGREGATION
+    plexus_agg_next_deadline(client, now, &emit_wait);
+#endif
+#if PLEXUS_ENABLE_SKETCHES
+    plexus_sketch_next_deadline(client, now, &emit_wait);
+#endif
+#if PLEXUS_ENABLE_COUNTERS
+    plexus_counter_next_deadline(client, now, &emit_wait);
+#endif
+#if PLEXUS_ENABLE_TRIGGER
+    if (plexus_trigger_pending(client)) {
+        emit_wait = 0;
+    }
+#endif
+#if PLEXUS_ENABLE_ISR_QUEUE
+    if (isr_pending(client)) {
+        emit_wait = 0;
+    }
+#endif
+    if (client->metric_count >= client->max_metrics && emit_wait < flush_wait) {
+        emit_wait = flush_wait;
+    }
+    if (emit_wait < wait) {
+        wait = emit_wait;
+    }
+
+#if PLEXUS_ENABLE_HISTORY
+    plexus_history_next_deadline(client, now, &wait);
+#endif
+#if PLEXUS_ENABLE_CLIENT_STATS
+    plexus_client_stats_next_deadline(client, now, &wait);
+#endif
+#if PLEXUS_ENABLE_WEBSOCKET
+    plexus_ws_next_deadline(client, now, &wait);
+#endif
+
+    return wait;
+}
+
+uint32_t plexus_next_deadline_ms(plexus_client_t* client) {
+    if (!client || !client->initialized) {
+        return 0; /* plexus_tick() reports the error */
+    }
+
+    PLEXUS_LOCK(client);
+    uint32_t now = plexus_hal_get_tick_ms();
+    uint32_t wait = next_deadline(client, now);
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+    client->wake_armed = true;
+    client->wake_unbounded = wait == PLEXUS_DEADLINE_NONE;
+    client->wake_deadline_ms = now + wait;
+#endif
+    PLEXUS_UNLOCK(client);
+    return wait;
+}
+
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+
+void plexus_internal_wake_if_sooner(plexus_client_t* client) {
+    if (!client->wake_callback || !client->wake_armed) {
+        return;
+    }
+    uint32_t now = plexus_hal_get_tick_ms();
+    uint32_t wait = next_deadline(client, now);
+    if (wait == PLEXUS_DEADLINE_NONE) {
+        return;
+    }
+    if (client->wake_unbounded || !tick_elapsed(now + wait, client->wake_deadline_ms)) {
+        /* Once per plexus_next_deadline_ms(): the app re-arms after its tick */
+        client->wake_armed = false;
+        client->wake_callback(client->wake_callback_data);
+    }
+}
+
+void plexus_internal_wake(plexus_client_t* client) {
+    plexus_wake_callback_t callback = client->wake_callback;
+    if (callback) {
+        callback(client->wake_callback_data);
+    }
+}
+
+plexus_err_t plexus_on_wake(plexus_client_t* client,
+                            plexus_wake_callback_t callback,
+                            void* user_data) {
+    if (!client) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+
+    PLEXUS_LOCK(client);
+    client->wake_callback = callback;
+    client->wake_callback_data = user_data;
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_WAKE_CALLBACK */
+
+/* ------------------------------------------------------------------------- */
+/* Trace hooks                                                               */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_TRACE
+
+void plexus_internal_trace(plexus_client_t* client, plexus_trace_phase_t phase,
+                           plexus_trace_edge_t edge, uint32_t value, plexus_err_t err) {
+    if (!client->trace_callback) {
+        return;
+    }
+    /* Advance a microsecond clock by whole microseconds, keeping the
+     * remainder in trace_stamp, so timestamps survive the stamp wrapping */
+    uint32_t now = plexus_internal_clock_stamp();
+    uint32_t span_us = plexus_internal_clock_span_us(client->trace_stamp, now);
+#if PLEXUS_ENABLE_TIMING
+    client->trace_stamp += span_us * plexus_hal_cycles_per_us();
+#else
+    client->trace_stamp = now;
+#endif
+    client->trace_us += span_us;
+
+    plexus_trace_event_t ev;
+    ev.phase = phase;
+    ev.edge = edge;
+    ev.timestamp_us = client->trace_us;
+    ev.value = value;
+    ev.err = err;
+    client->trace_callback(&ev, client->trace_callback_data);
+}
+
+plexus_err_t plexus_on_trace(plexus_client_t* client,
+                             plexus_trace_callback_t callback,
+                             void* user_data) {
+    if (!client) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+
+    PLEXUS_LOCK(client);
+    client->trace_callback = callback;
+    client->trace_callback_data = user_data;
+    client->trace_stamp = plexus_internal_clock_stamp();
+    client->trace_us = 0;
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_TRACE */
+
 /* ------------------------------------------------------------------------- */
 /* Connection status API                                                     */
 /* ------------------------------------------------------------------------- */
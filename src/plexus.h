@@ -89,6 +89,9 @@ typedef enum {
     PLEXUS_VALUE_NUMBER,
     PLEXUS_VALUE_STRING,
     PLEXUS_VALUE_BOOL,
+#if PLEXUS_ENABLE_SKETCHES
+    PLEXUS_VALUE_SKETCH,
+#endif
 } plexus_value_type_t;
 
 /** @internal Tagged value union */
@@ -101,6 +104,9 @@ typedef struct {
 #endif
 #if PLEXUS_ENABLE_BOOL_VALUES
         bool boolean;
+#endif
+#if PLEXUS_ENABLE_SKETCHES
+        uint8_t sketch;     /* Index of the sketch whose pending window is queued */
 #endif
     } data;
 } plexus_value_t;
@@ -117,6 +123,360 @@ typedef struct {
 #endif
 } plexus_metric_t;
 
+/** Numeric point for plexus_send_batch() */
+typedef struct {
+    const char* metric;
+    double value;
+    uint64_t timestamp_ms;  /* 0 = now */
+} plexus_point_t;
+
+#if PLEXUS_ENABLE_ISR_QUEUE
+/** @internal Sample staged by plexus_send_from_isr() */
+typedef struct {
+    const char* metric;     /* Caller's string, read again when drained */
+    double value;
+    uint32_t tick_ms;       /* plexus_hal_get_tick_ms() in the ISR */
+} plexus_isr_sample_t;
+#endif
+
+/* Array statistics types (when enabled) */
+#if PLEXUS_ENABLE_STATS
+
+/** Single-pass summary of a float array; derive mean/RMS/variance from it */
+typedef struct {
+    size_t count;
+    double sum;             /* Accumulated in double or compensated float */
+    double sumsq;
+    float min;
+    float max;
+} plexus_stats_summary_t;
+
+#endif /* PLEXUS_ENABLE_STATS */
+
+/* Aggregation types (when enabled) */
+#if PLEXUS_ENABLE_AGGREGATION
+
+/** Window statistics emitted by an aggregate (combine as a bitmask) */
+typedef enum {
+    PLEXUS_AGG_MIN   = 1 << 0,  /* "<metric>.min" */
+    PLEXUS_AGG_MAX   = 1 << 1,  /* "<metric>.max" */
+    PLEXUS_AGG_MEAN  = 1 << 2,  /* "<metric>.mean" */
+    PLEXUS_AGG_COUNT = 1 << 3,  /* "<metric>.count" */
+    PLEXUS_AGG_SUM   = 1 << 4,  /* "<metric>.sum" */
+    PLEXUS_AGG_ALL   = 0x1F,    /* min, max, mean, count and sum */
+    PLEXUS_AGG_RMS   = 1 << 5,  /* "<metric>.rms" */
+    PLEXUS_AGG_STDDEV = 1 << 6, /* "<metric>.stddev" (population) */
+} plexus_agg_stat_t;
+
+/** @internal Streaming window accumulator for one metric */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    uint32_t window_ms;
+    uint32_t window_start;  /* Tick of the first sample in the open window */
+    uint32_t count;         /* Samples in the open window (0 = no window open) */
+    double sum;
+    double sumsq;           /* For RMS / standard deviation */
+    double min;
+    double max;
+    uint8_t stats_mask;
+} plexus_aggregate_t;
+
+#endif /* PLEXUS_ENABLE_AGGREGATION */
+
+/* Deadband types (when enabled) */
+#if PLEXUS_ENABLE_DEADBAND
+
+/** How a deadband threshold is interpreted */
+typedef enum {
+    PLEXUS_DEADBAND_ABSOLUTE,   /* |value - last| <= threshold is suppressed */
+    PLEXUS_DEADBAND_PERCENT,    /* |value - last| <= threshold% of |last| is suppressed */
+} plexus_deadband_mode_t;
+
+/** @internal Per-metric deadband state */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    double threshold;
+    double last_value;          /* Last value actually queued */
+    uint32_t last_sent_ms;      /* Tick when last_value was queued */
+    uint32_t max_silence_ms;    /* Heartbeat: force a point after this long (0 = never) */
+    plexus_deadband_mode_t mode;
+    bool has_last;
+} plexus_deadband_t;
+
+#endif /* PLEXUS_ENABLE_DEADBAND */
+
+/* Swinging-door compression types (when enabled) */
+#if PLEXUS_ENABLE_SDT
+
+/** @internal Swinging-door state for one metric */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    double error_bound;
+    double archived_value;      /* Last queued point (segment start) */
+    double held_value;          /* Latest sample, not yet queued */
+    double slope_upper;         /* Door slopes from the archived point */
+    double slope_lower;
+    uint64_t archived_ts;
+    uint64_t held_ts;
+    uint32_t max_silence_ms;
+    uint32_t last_archive_ms;   /* Tick of the last queued point */
+    bool has_archive;
+    bool has_held;
+} plexus_sdt_t;
+
+#endif /* PLEXUS_ENABLE_SDT */
+
+/* Quantile sketch types (when enabled) */
+#if PLEXUS_ENABLE_SKETCHES
+
+/** Handle returned by plexus_sketch_register(), passed to plexus_observe() */
+typedef uint8_t plexus_sketch_handle_t;
+
+/** @internal Log-bucketed sample counts for one window (mergeable) */
+typedef struct {
+    uint32_t bins[PLEXUS_SKETCH_BINS]; /* Counts, as wide as count so a window cannot saturate one */
+    int32_t offset;         /* Log-index of bins[0] */
+    uint32_t zero_count;    /* Samples <= 0 */
+    uint32_t count;
+    double sum;
+    double min;
+    double max;
+} plexus_sketch_data_t;
+
+/** @internal Registered sketch metric */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    uint32_t window_ms;
+    uint32_t window_start;  /* Tick of the first sample in the open window */
+    double gamma;           /* (1 + alpha) / (1 - alpha) */
+    double log_gamma;
+    plexus_sketch_data_t active;
+    plexus_sketch_data_t pending;   /* Closed window(s) waiting to be flushed */
+    bool pending_queued;            /* pending is referenced by a queued point */
+} plexus_sketch_t;
+
+#endif /* PLEXUS_ENABLE_SKETCHES */
+
+/* Counter / gauge / rate types (when enabled) */
+#if PLEXUS_ENABLE_COUNTERS
+
+/** How a registered metric's samples are reduced to one point per window */
+typedef enum {
+    PLEXUS_KIND_GAUGE,      /* Last value in the window */
+    PLEXUS_KIND_COUNTER,    /* Increase over the window */
+    PLEXUS_KIND_RATE,       /* Increase over the window, per second */
+} plexus_metric_kind_t;
+
+/** @internal Per-metric counter state */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    uint32_t window_ms;     /* 0 = follow the client's flush interval */
+    uint32_t window_start;  /* Tick of the first update in the open window */
+    uint32_t rate_start;    /* Rate: tick the open window's increase accrues from */
+    uint32_t quiet_since;   /* Rate: tick of the last emit, or of the last reading */
+    double value;           /* Gauge: last value. Counter/rate: accumulated delta */
+    double last_reading;    /* Last cumulative reading passed to plexus_send_number() */
+    uint8_t kind;           /* plexus_metric_kind_t */
+    bool has_reading;       /* last_reading is valid */
+    bool open;              /* A window has received updates */
+} plexus_counter_t;
+
+#endif /* PLEXUS_ENABLE_COUNTERS */
+
+/* Downsampling types (when enabled) */
+#if PLEXUS_ENABLE_DOWNSAMPLE
+
+/** Decimation algorithm for a downsampled metric */
+typedef enum {
+    PLEXUS_DOWNSAMPLE_LTTB,     /* Largest-Triangle-Three-Buckets: preserves visual shape */
+    PLEXUS_DOWNSAMPLE_MINMAX,   /* Min and max of each bucket: preserves every peak */
+} plexus_downsample_method_t;
+
+/** @internal Raw sample held until the next flush */
+typedef struct {
+    uint32_t dt_ms;         /* Offset from plexus_downsample_t.base_ts */
+    float value;
+} plexus_downsample_sample_t;
+
+/** @internal Per-metric raw sample buffer */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    uint64_t base_ts;       /* Timestamp of the first buffered sample */
+    uint16_t target;        /* Points to keep per flush */
+    uint16_t count;         /* Buffered samples */
+    uint8_t method;         /* plexus_downsample_method_t */
+    plexus_downsample_sample_t samples[PLEXUS_DOWNSAMPLE_CAPACITY];
+} plexus_downsample_t;
+
+#endif /* PLEXUS_ENABLE_DOWNSAMPLE */
+
+/* Burst capture types (when enabled) */
+#if PLEXUS_ENABLE_TRIGGER
+
+/** Built-in trigger conditions, evaluated on every sample */
+typedef enum {
+    PLEXUS_TRIGGER_ABOVE,   /* value rises above threshold */
+    PLEXUS_TRIGGER_BELOW,   /* value falls below threshold */
+    PLEXUS_TRIGGER_CHANGE,  /* |value - previous sample| exceeds threshold */
+    PLEXUS_TRIGGER_MANUAL,  /* Only plexus_trigger_fire() */
+} plexus_trigger_cond_t;
+
+/** @internal One captured sample */
+typedef struct {
+    uint64_t timestamp_ms;
+    float value;
+    bool sent;              /* Already queued by the low-rate report */
+} plexus_capture_sample_t;
+
+/** @internal Per-metric capture ring and trigger state */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    plexus_capture_sample_t ring[PLEXUS_TRIGGER_RING_SIZE];
+    double threshold;
+    double prev_value;
+    uint32_t report_interval_ms;    /* Low-rate reporting outside bursts (0 = none) */
+    uint32_t last_report_ms;
+    uint32_t dropped;               /* Burst samples lost to a full ring */
+    uint16_t head;                  /* Next write slot */
+    uint16_t count;                 /* Samples in the ring */
+    uint16_t pending;               /* Oldest samples committed to the queue */
+    uint16_t post_samples;
+    uint16_t post_remaining;        /* Samples left in the post-trigger window */
+    uint8_t cond;                   /* plexus_trigger_cond_t */
+    bool armed;                     /* Condition was false since the last fire */
+    bool has_prev;
+    bool has_report;
+} plexus_trigger_t;
+
+#endif /* PLEXUS_ENABLE_TRIGGER */
+
+/* Last-value cache types (when enabled) */
+#if PLEXUS_ENABLE_LAST_VALUE
+
+/** @internal Latest value of one metric */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    uint64_t timestamp_ms;
+    double number;          /* Bools are stored as 0 / 1 */
+    uint8_t type;           /* plexus_value_type_t */
+} plexus_last_value_t;
+
+#endif /* PLEXUS_ENABLE_LAST_VALUE */
+
+/* History ring types (when enabled) */
+#if PLEXUS_ENABLE_HISTORY
+
+/** @internal One history entry: interval mean, time since the previous entry */
+typedef struct {
+    uint32_t dt_ms;
+    float value;
+} plexus_history_entry_t;
+
+/** @internal Per-metric history ring and open interval */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    plexus_history_entry_t ring[PLEXUS_HISTORY_SIZE];
+    uint64_t base_ts;       /* Timestamp of the oldest entry */
+    uint64_t last_ts;       /* Timestamp of the newest entry */
+    uint64_t bucket_ts;     /* Timestamp of the first sample in the open interval */
+    double bucket_sum;
+    uint32_t bucket_count;  /* Samples in the open interval (0 = none open) */
+    uint32_t bucket_start;  /* Tick when the open interval started */
+    uint32_t interval_ms;   /* 0 = every sample is an entry */
+    uint16_t head;          /* Next write slot */
+    uint16_t count;
+} plexus_history_t;
+
+#endif /* PLEXUS_ENABLE_HISTORY */
+
+/* Client self-telemetry (when enabled) */
+#if PLEXUS_ENABLE_CLIENT_STATS
+
+/** Snapshot returned by plexus_get_stats(); counters are cumulative since init or reset */
+typedef struct {
+    /* HTTP posts, including retries and persisted batches */
+    uint32_t posts;
+    uint32_t post_failures;
+    uint32_t post_latency_hist[PLEXUS_LATENCY_BUCKETS]; /* [0] < 1 ms, [i] in [2^(i-1), 2^i) ms,
+                                                           last bucket open-ended */
+    uint32_t post_latency_total_ms;
+    uint32_t post_latency_max_ms;
+
+    /* Batch serialization (µs from plexus_hal_get_cycles() with
+     * PLEXUS_ENABLE_TIMING, otherwise from the millisecond tick) */
+    uint32_t serializations;
+    uint32_t serialize_us_total;
+    uint32_t serialize_us_max;
+
+    /* Volume of live batches delivered over HTTP */
+    uint32_t points_posted;
+    uint64_t bytes_posted;
+    uint32_t bytes_per_point;   /* bytes_posted / points_posted, filled in by plexus_get_stats() */
+    uint32_t points_sent;       /* All transports, same as plexus_total_sent() */
+
+    /* Retries */
+    uint32_t retries;
+    uint32_t backoff_ms_total;  /* Requested backoff between attempts */
+
+    /* Queue */
+    uint16_t queue_depth;       /* Filled in by plexus_get_stats() */
+    uint16_t queue_high_water;
+    uint32_t drops_buffer_full;       /* Points rejected with PLEXUS_ERR_BUFFER_FULL */
+    uint32_t drops_persist_overwrite; /* Persisted batches overwritten when storage was full */
+    uint32_t drops_persist_corrupt;   /* Persisted batches discarded on CRC/read failure */
+    uint16_t persist_backlog;         /* Persisted batches waiting to be sent */
+
+    /* WebSocket */
+    uint32_t ws_reconnects;
+    uint32_t ws_frames_sent;
+    uint32_t ws_frames_received;
+    uint64_t ws_bytes_sent;
+    uint32_t ws_frame_max_bytes;      /* Largest frame sent */
+} plexus_client_stats_t;
+
+#endif /* PLEXUS_ENABLE_CLIENT_STATS */
+
+/* Trace types (when enabled) */
+#if PLEXUS_ENABLE_TRACE
+
+typedef enum {
+    PLEXUS_TRACE_FLUSH,          /* One plexus_flush() / plexus_flush_nowait() call */
+    PLEXUS_TRACE_PERSIST_DRAIN,  /* Restore and post one persisted batch */
+    PLEXUS_TRACE_SERIALIZE,      /* Queue to JSON */
+    PLEXUS_TRACE_WS_SEND,        /* Telemetry frame over the WebSocket */
+    PLEXUS_TRACE_HTTP_POST,      /* One HTTP attempt */
+    PLEXUS_TRACE_BACKOFF,        /* Sleep between HTTP attempts */
+    PLEXUS_TRACE_PERSIST_WRITE,  /* Failed batch to storage */
+    PLEXUS_TRACE_WS_STATE,       /* WebSocket state change (instant) */
+} plexus_trace_phase_t;
+
+typedef enum {
+    PLEXUS_TRACE_BEGIN,
+    PLEXUS_TRACE_END,
+    PLEXUS_TRACE_INSTANT,
+} plexus_trace_edge_t;
+
+typedef struct {
+    plexus_trace_phase_t phase;
+    plexus_trace_edge_t edge;
+    uint32_t timestamp_us;       /* Since plexus_on_trace(), from the cycle counter with
+                                    PLEXUS_ENABLE_TIMING, else the tick */
+    uint32_t value;              /* Bytes; queued points on FLUSH/SERIALIZE begin;
+                                    delay ms for BACKOFF; new plexus_ws_state_t for WS_STATE */
+    plexus_err_t err;            /* Phase result on END, PLEXUS_OK otherwise */
+} plexus_trace_event_t;
+
+typedef void (*plexus_trace_callback_t)(const plexus_trace_event_t* event, void* user_data);
+
+#endif /* PLEXUS_ENABLE_TRACE */
+
+/** plexus_next_deadline_ms(): nothing is scheduled, sleep until woken */
+#define PLEXUS_DEADLINE_NONE UINT32_MAX
+
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+typedef void (*plexus_wake_callback_t)(void* user_data);
+#endif
+
 /* Connection status types (when enabled) */
 #if PLEXUS_ENABLE_STATUS_CALLBACK
 
@@ -197,6 +557,48 @@ typedef struct {
 
 #endif /* PLEXUS_ENABLE_WEBSOCKET */
 
+#if PLEXUS_ENABLE_THREAD_STAGING
+/** @internal Point staged by plexus_send_staged() */
+typedef struct {
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    double value;
+    uint64_t timestamp_ms;
+} plexus_staged_point_t;
+
+/** @internal One producer thread's ring; the flusher owns tail */
+typedef struct {
+    plexus_staged_point_t ring[PLEXUS_STAGE_SIZE];
+    const void* owner;          /* Producer's thread marker, NULL = free */
+    uint32_t dropped;           /* Ring and queue full, counted by the producer */
+    uint32_t dropped_seen;      /* Already added to totals.dropped */
+    uint16_t head;
+    uint16_t tail;
+    bool released;              /* Producer is done; free once drained */
+#if PLEXUS_CACHE_LINE_SIZE > 0
+    char pad[PLEXUS_CACHE_LINE_SIZE]; /* Keep the next producer's writes off this line */
+#endif
+} plexus_stage_t;
+#endif /* PLEXUS_ENABLE_THREAD_STAGING */
+
+/** Lifetime total: 64-bit where the target loads and stores that atomically */
+#if PLEXUS_TOTALS_64BIT
+typedef uint64_t plexus_total_t;
+#else
+typedef uint32_t plexus_total_t;
+#endif
+
+/**
+ * Lifetime totals returned by plexus_get_totals(). In the client they are
+ * written under the lock and read with relaxed atomics, so each field is
+ * whole but fields may come from either side of a concurrent flush.
+ */
+typedef struct {
+    plexus_total_t sent;        /* Points delivered, all transports */
+    plexus_total_t errors;      /* Failed flushes */
+    plexus_total_t dropped;     /* Points rejected for lack of queue, ISR ring or stage space */
+    uint16_t pending;           /* Points queued now */
+} plexus_totals_t;
+
 /** @internal Client struct — do not access members directly */
 struct plexus_client {
     char api_key[PLEXUS_MAX_API_KEY_LEN];
@@ -204,12 +606,22 @@ struct plexus_client {
     char session_id[PLEXUS_MAX_SESSION_ID_LEN];
     char endpoint[PLEXUS_MAX_ENDPOINT_LEN];
 
-    plexus_metric_t metrics[PLEXUS_MAX_METRICS];
+    /* Queue view: max_metrics slots, normally metrics_storage */
+    plexus_metric_t* metrics;
+    uint16_t max_metrics;
     uint16_t metric_count;
 
     uint32_t last_flush_ms;
-    uint32_t total_sent;
-    uint32_t total_errors;
+
+    /* Read lock-free from other threads and ISRs; padded so those readers
+     * don't share a cache line with the fields the send path writes */
+#if PLEXUS_CACHE_LINE_SIZE > 0
+    char totals_pad_before[PLEXUS_CACHE_LINE_SIZE];
+#endif
+    plexus_totals_t totals;
+#if PLEXUS_CACHE_LINE_SIZE > 0
+    char totals_pad_after[PLEXUS_CACHE_LINE_SIZE];
+#endif
 
     /* Runtime-configurable overrides (0 = use compile-time default) */
     uint32_t flush_interval_ms;
@@ -218,13 +630,41 @@ struct plexus_client {
     /* Retry backoff state */
     uint32_t retry_backoff_ms;
     uint32_t rate_limit_until_ms;
+    uint8_t flush_attempts;     /* Failed attempts so far (plexus_flush_nowait) */
 
     bool initialized;
     bool _heap_allocated; /* true = created via plexus_init(), safe to free() */
 
-    /* Per-client JSON serialization buffer (no global state) */
-    char json_buffer[PLEXUS_JSON_BUFFER_SIZE];
+    /* Per-client JSON serialization buffer (no global state), normally json_storage */
+    char* json_buffer;
+    size_t json_buffer_size;
+
+#if PLEXUS_ENABLE_ISR_QUEUE
+    /* SPSC staging ring: the ISR owns head, plexus_tick() owns tail */
+    plexus_isr_sample_t isr_ring[PLEXUS_ISR_QUEUE_SIZE];
+    volatile uint16_t isr_head;
+    volatile uint16_t isr_tail;
+    volatile uint32_t isr_dropped;  /* Ring full, counted by the ISR */
+    uint32_t isr_dropped_seen;      /* Already added to totals.dropped */
+#endif
+
+#if PLEXUS_ENABLE_THREAD_STAGING
+    plexus_stage_t stages[PLEXUS_MAX_STAGES];
+#endif
 
+#if PLEXUS_ENABLE_TRACE
+    plexus_trace_callback_t trace_callback;
+    void* trace_callback_data;
+    uint32_t trace_stamp;       /* Clock stamp trace_us was last advanced to */
+    uint32_t trace_us;          /* Microseconds since plexus_on_trace() */
+#endif
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+    plexus_wake_callback_t wake_callback;
+    void* wake_callback_data;
+    uint32_t wake_deadline_ms;  /* Tick last reported by plexus_next_deadline_ms() */
+    bool wake_armed;            /* The app may be sleeping until wake_deadline_ms */
+    bool wake_unbounded;        /* ...or indefinitely (PLEXUS_DEADLINE_NONE) */
+#endif
 #if PLEXUS_ENABLE_STATUS_CALLBACK
     plexus_status_callback_t status_callback;
     void* status_callback_data;
@@ -235,6 +675,64 @@ struct plexus_client {
     void* mutex;
 #endif
 
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+    struct plexus_transport* transport;  /* Attached transport, or NULL */
+#if PLEXUS_ENABLE_THREAD_SAFE
+    void* own_mutex;            /* Parked while mutex is the transport's */
+#endif
+#endif
+
+#if PLEXUS_ENABLE_AGGREGATION
+    plexus_aggregate_t aggregates[PLEXUS_MAX_AGGREGATES];
+    uint8_t aggregate_count;
+#endif
+
+#if PLEXUS_ENABLE_DEADBAND
+    plexus_deadband_t deadbands[PLEXUS_MAX_DEADBANDS];
+    uint8_t deadband_count;
+#endif
+
+#if PLEXUS_ENABLE_SDT
+    plexus_sdt_t sdt[PLEXUS_MAX_SDT];
+    uint8_t sdt_count;
+#endif
+
+#if PLEXUS_ENABLE_SKETCHES
+    plexus_sketch_t sketches[PLEXUS_MAX_SKETCHES];
+    uint8_t sketch_count;
+#endif
+
+#if PLEXUS_ENABLE_COUNTERS
+    plexus_counter_t counters[PLEXUS_MAX_COUNTERS];
+    uint8_t counter_count;
+#endif
+
+#if PLEXUS_ENABLE_DOWNSAMPLE
+    plexus_downsample_t downsampled[PLEXUS_MAX_DOWNSAMPLED];
+    uint8_t downsample_count;
+#endif
+
+#if PLEXUS_ENABLE_TRIGGER
+    plexus_trigger_t triggers[PLEXUS_MAX_TRIGGERS];
+    uint8_t trigger_count;
+#endif
+
+#if PLEXUS_ENABLE_LAST_VALUE
+    plexus_last_value_t last_values[PLEXUS_MAX_LAST_VALUES];
+    uint8_t last_value_count;
+#endif
+
+#if PLEXUS_ENABLE_HISTORY
+    plexus_history_t history[PLEXUS_MAX_HISTORY];
+    uint8_t history_count;
+#endif
+
+#if PLEXUS_ENABLE_CLIENT_STATS
+    plexus_client_stats_t cstats;
+    uint32_t cstats_interval_ms;      /* plexus.* publish interval, 0 = off */
+    uint32_t cstats_last_publish_ms;
+#endif
+
 #if PLEXUS_ENABLE_WEBSOCKET
     /* WebSocket connection state */
     char ws_endpoint[PLEXUS_MAX_ENDPOINT_LEN];
@@ -273,10 +771,44 @@ struct plexus_client {
     bool ws_telemetry_enabled;  /* Send telemetry over WS (default true) */
     bool http_persist_enabled;  /* Also send over HTTP for persistence */
 #endif
+
+    /* Default backing storage for the views above. Must stay last: clients
+     * created with plexus_init_sized() end here and lay out their own
+     * arrays from this offset. */
+    plexus_metric_t metrics_storage[PLEXUS_MAX_METRICS];
+    char json_storage[PLEXUS_JSON_BUFFER_SIZE];
 };
 
 typedef struct plexus_client plexus_client_t;
 
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+/** @internal Shared transport struct — do not access members directly */
+struct plexus_transport {
+    char endpoint[PLEXUS_MAX_ENDPOINT_LEN];
+
+    /* Attached clients, in attach order; all share the first one's API key */
+    plexus_client_t* clients[PLEXUS_MAX_TRANSPORT_CLIENTS];
+    uint8_t client_count;
+
+    /* Retry backoff state, shared by every attached client */
+    uint32_t retry_backoff_ms;
+    uint32_t rate_limit_until_ms;
+    uint8_t flush_attempts;     /* Failed attempts so far (plexus_flush_nowait) */
+
+    bool initialized;
+    bool _heap_allocated;
+
+#if PLEXUS_ENABLE_THREAD_SAFE
+    void* mutex;                /* Also the lock of every attached client */
+#endif
+
+    /* Coalesced request body */
+    char json_buffer[PLEXUS_TRANSPORT_BUFFER_SIZE];
+};
+
+typedef struct plexus_transport plexus_transport_t;
+#endif /* PLEXUS_ENABLE_SHARED_TRANSPORT */
+
 /* ------------------------------------------------------------------------- */
 /* Static allocation helpers                                                 */
 /* ------------------------------------------------------------------------- */
@@ -301,6 +833,28 @@ typedef struct plexus_client plexus_client_t;
 #define PLEXUS_CLIENT_STATIC_BUF(name) \
     static plexus_client_t name
 
+/**
+ * Size of a client with its own queue and JSON buffer capacities, for
+ * plexus_init_sized(). The fixed part of plexus_client_t is followed by
+ * @p max_metrics queue slots and @p json_buffer_size bytes.
+ *
+ */
+#define PLEXUS_CLIENT_SIZE_FOR(max_metrics, json_buffer_size) \
+    (offsetof(plexus_client_t, metrics_storage) + \
+     (size_t)(max_metrics) * sizeof(plexus_metric_t) + (size_t)(json_buffer_size))
+
+/**
+ * Declare a correctly-sized and aligned static buffer for plexus_init_sized().
+ *
+ * @example
+ *   PLEXUS_CLIENT_SIZED_BUF(diag_buf, 4, 512);
+ *   plexus_client_t* diag = plexus_init_sized(
+ *       diag_buf, sizeof(diag_buf), 4, 512, "plx_xxx", "device-001");
+ */
+#define PLEXUS_CLIENT_SIZED_BUF(name, max_metrics, json_buffer_size) \
+    static uint64_t name[(PLEXUS_CLIENT_SIZE_FOR(max_metrics, json_buffer_size) + \
+                          sizeof(uint64_t) - 1) / sizeof(uint64_t)]
+
 /* ------------------------------------------------------------------------- */
 /* Core API                                                                  */
 /* ------------------------------------------------------------------------- */
@@ -337,12 +891,39 @@ plexus_client_t* plexus_init(const char* api_key, const char* source_id);
 plexus_client_t* plexus_init_static(void* buf, size_t buf_size,
                                       const char* api_key, const char* source_id);
 
+/**
+ * Initialize a client with its own capacities in user-provided memory.
+ *
+ * Like plexus_init_static(), but the queue holds @p max_metrics points and
+ * the JSON buffer is @p json_buffer_size bytes instead of PLEXUS_MAX_METRICS
+ * and PLEXUS_JSON_BUFFER_SIZE, so one binary can run a small diagnostics
+ * client next to a large telemetry client. Per-point limits (name, string
+ * and tag lengths) and feature tables stay compile-time.
+ *
+ * @param buf              Buffer (at least PLEXUS_CLIENT_SIZE_FOR() bytes, pointer-aligned)
+ * @param buf_size         Size of the provided buffer
+ * @param max_metrics      Queue capacity in points (>= 1)
+ * @param json_buffer_size JSON buffer size in bytes (>= 256)
+ * @param api_key          Your Plexus API key
+ * @param source_id        Device identifier (same restrictions as plexus_init)
+ * @return                 Client pointer (== buf on success), or NULL on failure
+ */
+plexus_client_t* plexus_init_sized(void* buf, size_t buf_size,
+                                     uint16_t max_metrics, size_t json_buffer_size,
+                                     const char* api_key, const char* source_id);
+
 /**
  * Get the required buffer size for plexus_init_static().
  * Equivalent to sizeof(plexus_client_t) but callable at runtime.
  */
 size_t plexus_client_size(void);
 
+/**
+ * Get the required buffer size for plexus_init_sized().
+ * Equivalent to PLEXUS_CLIENT_SIZE_FOR() but callable at runtime.
+ */
+size_t plexus_client_size_for(uint16_t max_metrics, size_t json_buffer_size);
+
 /**
  * Free a heap-allocated Plexus client.
  *
@@ -467,6 +1048,160 @@ plexus_err_t plexus_send_number_tagged(plexus_client_t* client, const char* metr
                                         const char** tag_values, uint8_t tag_count);
 #endif
 
+/**
+ * Queue a numeric metric whose name has already been validated.
+ *
+ * Same as plexus_send_number_ts() but skips the per-call length and
+ * character-set scan of @p metric. Meant for callers that validate names
+ * once up front, such as plexus::Metric in plexus.hpp, which checks them at
+ * compile time. Passing a name that breaks the rules produces invalid JSON.
+ *
+ * @param client       Plexus client
+ * @param metric       Valid metric name (printable ASCII, < PLEXUS_MAX_METRIC_NAME_LEN)
+ * @param value        Numeric value
+ * @param timestamp_ms Unix timestamp in milliseconds, or 0 for now
+ * @return             PLEXUS_OK on success
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_number_unchecked(plexus_client_t* client, const char* metric,
+                                           double value, uint64_t timestamp_ms);
+
+#if PLEXUS_ENABLE_STRING_VALUES
+/**
+ * Queue a string metric whose name has already been validated.
+ *
+ * @p value does not need to be NUL-terminated.
+ *
+ * @param client       Plexus client
+ * @param metric       Valid metric name
+ * @param value        String value
+ * @param value_len    Length of @p value in bytes
+ * @param timestamp_ms Unix timestamp in milliseconds, or 0 for now
+ * @return             PLEXUS_OK, or PLEXUS_ERR_STRING_TOO_LONG
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_string_unchecked(plexus_client_t* client, const char* metric,
+                                           const char* value, size_t value_len,
+                                           uint64_t timestamp_ms);
+#endif
+
+#if PLEXUS_ENABLE_BOOL_VALUES
+/**
+ * Queue a boolean metric whose name has already been validated.
+ *
+ * @param client       Plexus client
+ * @param metric       Valid metric name
+ * @param value        Boolean value
+ * @param timestamp_ms Unix timestamp in milliseconds, or 0 for now
+ * @return             PLEXUS_OK on success
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_bool_unchecked(plexus_client_t* client, const char* metric,
+                                         bool value, uint64_t timestamp_ms);
+#endif
+
+/**
+ * Queue several numeric points in one call.
+ *
+ * All names are validated before anything is queued, so a bad name leaves
+ * the buffer unchanged. The points are then routed in order under a single
+ * lock acquisition (features such as aggregation apply to each point as
+ * usual, and a point they absorb takes no queue slot), and the count-based
+ * auto-flush is checked once, after the last point.
+ *
+ * Routing stops at the first point that fails: the queue has no room for
+ * it, a window emit took the room, or a counter rejected the reading. The
+ * points before it stay queued; it and the rest are left to the caller and
+ * not counted as dropped. Use plexus_send_batch_accepted() to learn how
+ * many were taken.
+ *
+ * @param client Plexus client
+ * @param points Points to queue, in order
+ * @param count  Number of points (0 is a no-op)
+ * @return       PLEXUS_OK, PLEXUS_ERR_INVALID_ARG / PLEXUS_ERR_STRING_TOO_LONG
+ *               for a bad name, or the error of the first point that failed
+ *               (PLEXUS_ERR_BUFFER_FULL when the queue ran out of room)
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_batch(plexus_client_t* client, const plexus_point_t* points,
+                               size_t count);
+
+/**
+ * plexus_send_batch(), also reporting how many leading points were taken.
+ *
+ * @param accepted Set to the number of points queued or folded into a
+ *                 feature, in order: 0 for a bad name, @p count on
+ *                 PLEXUS_OK, otherwise the index of the point that failed.
+ *                 May be NULL.
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_batch_accepted(plexus_client_t* client, const plexus_point_t* points,
+                                        size_t count, size_t* accepted);
+
+#if PLEXUS_ENABLE_ISR_QUEUE
+/**
+ * Stage a numeric point from an interrupt handler.
+ *
+ * Wait-free: no lock, no wall-clock read, no flush. The point is stamped
+ * with plexus_hal_get_tick_ms() and copied into a single-producer ring of
+ * PLEXUS_ISR_QUEUE_SIZE - 1 usable slots; the next plexus_tick() converts
+ * the tick to wall time and routes it like plexus_send_number() (features
+ * such as aggregation apply as usual).
+ *
+ * Call it from one producer context per client: a single ISR, or ISRs that
+ * cannot preempt each other. The name is not copied, so it must outlive the
+ * drain — a string literal. The wake hook does not run here; notify the
+ * task that calls plexus_tick() from the ISR if it sleeps.
+ *
+ * @param client Plexus client
+ * @param metric Metric name with static storage duration
+ * @param value  Numeric value
+ * @return       PLEXUS_OK, PLEXUS_ERR_INVALID_ARG / PLEXUS_ERR_STRING_TOO_LONG
+ *               for a bad name, or PLEXUS_ERR_BUFFER_FULL if the ring is
+ *               full (counted in plexus_get_totals() dropped)
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_from_isr(plexus_client_t* client, const char* metric, double value);
+#endif
+
+#if PLEXUS_ENABLE_THREAD_STAGING
+/**
+ * Queue a numeric point through the calling thread's staging buffer.
+ *
+ * The first call from a thread claims one of PLEXUS_MAX_STAGES per-client
+ * rings under the lock; after that a send is a name copy and a release
+ * store, with no lock and no read-modify-write atomics, so producers on
+ * different cores do not contend. Rings are merged into the queue in
+ * timestamp order when the client flushes (including plexus_tick()'s
+ * time-based flush) and routed like plexus_send_number().
+ *
+ * A full ring is merged under the lock on the spot, running the
+ * count-based auto-flush like plexus_send() would. Threads beyond
+ * PLEXUS_MAX_STAGES fall back to plexus_send_number(). Staged points are
+ * not in plexus_pending_count() until merged.
+ *
+ * @param client Plexus client
+ * @param metric Metric name (copied)
+ * @param value  Numeric value
+ * @return       PLEXUS_OK, PLEXUS_ERR_INVALID_ARG / PLEXUS_ERR_STRING_TOO_LONG
+ *               for a bad name, or PLEXUS_ERR_BUFFER_FULL if neither the
+ *               ring nor the queue has room
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_send_staged(plexus_client_t* client, const char* metric, double value);
+
+/**
+ * Give the calling thread's staging buffer back before the thread exits.
+ *
+ * Points it already staged are still sent. Call it from threads that come
+ * and go so their slots can be reused; a later plexus_send_staged() from
+ * the same thread claims a slot again.
+ *
+ * @param client Plexus client
+ */
+void plexus_stage_release(plexus_client_t* client);
+#endif
+
 /* ------------------------------------------------------------------------- */
 /* Flush & network                                                           */
 /* ------------------------------------------------------------------------- */
@@ -488,6 +1223,24 @@ plexus_err_t plexus_send_number_tagged(plexus_client_t* client, const char* metr
 PLEXUS_WARN_UNUSED_RESULT
 plexus_err_t plexus_flush(plexus_client_t* client);
 
+/**
+ * Flush with a single HTTP attempt and no blocking backoff delays.
+ *
+ * Same outcome as plexus_flush(), but spread over calls: after a retryable
+ * failure the batch stays queued and @p retry_after_ms is set to the
+ * backoff to wait before calling again. Once PLEXUS_MAX_RETRIES attempts
+ * have failed (or the error is not retryable) *retry_after_ms is 0 and the
+ * batch is handled as plexus_flush() would (status callback, persistence).
+ * Used by the C++ coroutine flush in plexus.hpp; usable from any event loop.
+ *
+ * @param client         Plexus client
+ * @param retry_after_ms Receives the delay before the next attempt, 0 when done.
+ *                       NULL makes this a single attempt with no retries.
+ * @return               PLEXUS_OK on success, error code of the last attempt otherwise
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_flush_nowait(plexus_client_t* client, uint32_t* retry_after_ms);
+
 /**
  * Call periodically from your main loop.
  *
@@ -501,18 +1254,56 @@ plexus_err_t plexus_flush(plexus_client_t* client);
 PLEXUS_WARN_UNUSED_RESULT
 plexus_err_t plexus_tick(plexus_client_t* client);
 
-/** Get number of queued metrics. */
+/**
+ * Milliseconds until plexus_tick() next has work to do.
+ *
+ * The earliest of: the time-based flush of queued points (pushed back by a
+ * rate-limit cooldown), the WebSocket heartbeat, reconnect and auth
+ * timeout, and any open aggregation, sketch, counter or history window or
+ * stats publish. Lets an event-driven app sleep instead of polling:
+ *
+ *     for (;;) {
+ *         (void)plexus_tick(client);
+ *         wait_for_event(plexus_next_deadline_ms(client));  // e.g. ulTaskNotifyTake
+ *     }
+ *
+ * Points sent from the sleeping task itself are covered by the auto-flush
+ * in plexus_send_*(); sends from other tasks and WebSocket events need
+ * plexus_on_wake() (PLEXUS_ENABLE_WAKE_CALLBACK) to cut the sleep short.
+ * A plexus_flush_nowait() backoff is the caller's own to wait out.
+ *
+ * @param client Plexus client
+ * @return       0 if work is due now (or the client is NULL/uninitialized),
+ *               PLEXUS_DEADLINE_NONE if nothing is scheduled
+ */
+uint32_t plexus_next_deadline_ms(plexus_client_t* client);
+
+/** Get number of queued metrics. Lock-free; safe from any thread or ISR. */
 uint16_t plexus_pending_count(const plexus_client_t* client);
 
 /** Clear all queued metrics without sending. */
 void plexus_clear(plexus_client_t* client);
 
-/** Lifetime counter: total metrics successfully sent. */
+/** Lifetime counter: total metrics successfully sent (low 32 bits). Lock-free. */
 uint32_t plexus_total_sent(const plexus_client_t* client);
 
-/** Lifetime counter: total send errors. */
+/** Lifetime counter: total send errors (low 32 bits). Lock-free. */
 uint32_t plexus_total_errors(const plexus_client_t* client);
 
+/**
+ * Read the lifetime totals without taking the client lock.
+ *
+ * Safe from any thread or ISR, including while another task is inside
+ * plexus_flush(). Totals are 64-bit when PLEXUS_TOTALS_64BIT is set
+ * (the default where the target has lock-free 64-bit atomics).
+ *
+ * @param client Plexus client
+ * @param out    Receives the totals
+ * @return PLEXUS_OK, PLEXUS_ERR_NULL_PTR or PLEXUS_ERR_NOT_INITIALIZED
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_get_totals(const plexus_client_t* client, plexus_totals_t* out);
+
 /* ------------------------------------------------------------------------- */
 /* Recording sessions                                                        */
 /* ------------------------------------------------------------------------- */
@@ -550,6 +1341,531 @@ plexus_err_t plexus_session_end(plexus_client_t* client);
  */
 const char* plexus_session_id(const plexus_client_t* client);
 
+/* ------------------------------------------------------------------------- */
+/* Array statistics kernels (opt-in via PLEXUS_ENABLE_STATS)                 */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_STATS
+
+/**
+ * Summarize a float array in one pass: count, sum, sum of squares, min, max.
+ *
+ * Uses AVX2 or SSE2 when the compiler targets them (PLEXUS_STATS_SIMD=1),
+ * otherwise portable C written so GCC/Clang auto-vectorize it. Sums are
+ * accumulated in double, or in Kahan-compensated float lanes where the FPU
+ * is single-precision (PLEXUS_STATS_FLOAT_ACCUM). For count == 0 the
+ * summary is all zeros. NaN samples propagate to sum and sumsq but are
+ * skipped by min/max; if every sample is NaN, min and max are NaN.
+ */
+void plexus_stats_summary_f32(const float* values, size_t count, plexus_stats_summary_t* out);
+
+/** Merge summary b into a (as if both arrays were summarized together) */
+void plexus_stats_merge(plexus_stats_summary_t* a, const plexus_stats_summary_t* b);
+
+/** Mean of a summary (0 if empty) */
+double plexus_stats_mean(const plexus_stats_summary_t* s);
+
+/** Root mean square of a summary (0 if empty) */
+double plexus_stats_rms(const plexus_stats_summary_t* s);
+
+/** Population variance of a summary (0 if empty) */
+double plexus_stats_variance(const plexus_stats_summary_t* s);
+
+/** Kernel selected at compile time: "avx2", "sse2" or "portable" */
+const char* plexus_stats_backend(void);
+
+#endif /* PLEXUS_ENABLE_STATS */
+
+/* ------------------------------------------------------------------------- */
+/* Windowed aggregation (opt-in via PLEXUS_ENABLE_AGGREGATION)               */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_AGGREGATION
+
+/**
+ * Aggregate a numeric metric on-device instead of queuing every sample.
+ *
+ * Once registered, plexus_send_number() / plexus_send_number_ts() on this
+ * metric fold the value into O(1) running accumulators. When the window
+ * closes, one point per selected statistic is queued as "<metric>.<stat>"
+ * (e.g. "vibration.max"). A window opens on its first sample and closes
+ * window_ms later, checked from plexus_tick() and on the next sample.
+ *
+ * Tagged sends are never aggregated. Windows with no samples emit nothing.
+ *
+ * @param client     Plexus client
+ * @param metric     Metric name to aggregate
+ * @param window_ms  Window length in milliseconds (> 0)
+ * @param stats_mask Bitwise OR of plexus_agg_stat_t values (non-zero)
+ * @return           PLEXUS_OK, PLEXUS_ERR_BUFFER_FULL if the aggregate table
+ *                   is full, PLEXUS_ERR_STRING_TOO_LONG if a selected
+ *                   "<metric>.<stat>" would not fit PLEXUS_MAX_METRIC_NAME_LEN
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_aggregate_register(plexus_client_t* client, const char* metric,
+                                        uint32_t window_ms, uint8_t stats_mask);
+
+/**
+ * Fold a block of samples (e.g. one DMA buffer) into an aggregate window.
+ *
+ * Equivalent to calling plexus_send_number() for every element, but the
+ * block is reduced with the plexus_stats_* kernels first, so the cost is
+ * one vectorized pass instead of count lock/lookup round trips.
+ *
+ * @return PLEXUS_OK, PLEXUS_ERR_INVALID_ARG if the metric is not registered
+ *         for aggregation
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_aggregate_send_array(plexus_client_t* client, const char* metric,
+                                          const float* values, size_t count);
+
+#endif /* PLEXUS_ENABLE_AGGREGATION */
+
+/* ------------------------------------------------------------------------- */
+/* Deadband filtering (opt-in via PLEXUS_ENABLE_DEADBAND)                    */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_DEADBAND
+
+/**
+ * Report a numeric metric by exception only.
+ *
+ * Once configured, plexus_send_number() / plexus_send_number_ts() on this
+ * metric compare the new value against the last value that was queued and
+ * drop it if the change is within the deadband. The first sample is always
+ * queued. If max_silence_ms is non-zero, a sample is queued at least that
+ * often even when unchanged, so the dashboard can tell "steady" from "dead".
+ *
+ * Tagged sends are never filtered. A threshold of 0 suppresses only exact
+ * repeats. Calling again for the same metric updates its settings.
+ *
+ * @param client         Plexus client
+ * @param metric         Metric name
+ * @param threshold      Deadband width (absolute units, or percent of last value)
+ * @param mode           PLEXUS_DEADBAND_ABSOLUTE or PLEXUS_DEADBAND_PERCENT
+ * @param max_silence_ms Heartbeat interval in milliseconds (0 = no heartbeat)
+ * @return               PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the deadband
+ *                       table is full
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_set_deadband(plexus_client_t* client, const char* metric,
+                                  double threshold, plexus_deadband_mode_t mode,
+                                  uint32_t max_silence_ms);
+
+#endif /* PLEXUS_ENABLE_DEADBAND */
+
+/* ------------------------------------------------------------------------- */
+/* Swinging-door compression (opt-in via PLEXUS_ENABLE_SDT)                  */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_SDT
+
+/**
+ * Compress a smooth numeric metric to piecewise-linear segments.
+ *
+ * Swinging-door trending: samples are held while a straight line from the
+ * last queued point stays within error_bound of every sample since. When
+ * a sample breaks the corridor, the previous sample is queued as the
+ * segment endpoint. Linear interpolation between queued points reproduces
+ * the signal within about error_bound.
+ *
+ * The held sample is also queued when the batch is flushed, so the server
+ * is never more than one flush behind. max_silence_ms forces a point out
+ * for perfectly straight signals (0 disables it). Points keep their own
+ * timestamps. SDT takes precedence over a deadband on the same metric;
+ * tagged sends are never compressed.
+ *
+ * @param client          Plexus client
+ * @param metric          Metric name
+ * @param error_bound     Maximum deviation from the reconstruction (>= 0)
+ * @param max_silence_ms  Longest time without a queued point, 0 = unlimited
+ * @return                PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the SDT
+ *                        table is full
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_set_sdt(plexus_client_t* client, const char* metric,
+                             double error_bound, uint32_t max_silence_ms);
+
+#endif /* PLEXUS_ENABLE_SDT */
+
+/* ------------------------------------------------------------------------- */
+/* Quantile sketches (opt-in via PLEXUS_ENABLE_SKETCHES)                     */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_SKETCHES
+
+/**
+ * Register a latency-style metric recorded as a quantile sketch.
+ *
+ * Samples passed to plexus_observe() are counted in log-spaced bins so any
+ * quantile can be recovered within relative_accuracy (e.g. 0.02 = ±2%) as
+ * long as the data spans fewer than PLEXUS_SKETCH_BINS bins; beyond that
+ * the lowest bins are merged, keeping the upper quantiles accurate.
+ *
+ * When a window closes (from plexus_tick() or the next observation) one
+ * point named after the metric is queued whose value is the bucket array,
+ * plus "<metric>.p50", "<metric>.p90" and "<metric>.p99" numeric points.
+ * If the previous window's sketch has not been flushed yet, the new window
+ * is merged into it rather than queuing a second sketch point.
+ *
+ * @param client            Plexus client
+ * @param metric            Metric name (room is needed for the ".p50" suffix)
+ * @param window_ms         Window length in milliseconds (> 0)
+ * @param relative_accuracy Bin relative accuracy, 0 < alpha < 1
+ * @param out_handle        Receives the handle for plexus_observe()
+ * @return                  PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the
+ *                          sketch table is full
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_sketch_register(plexus_client_t* client, const char* metric,
+                                     uint32_t window_ms, double relative_accuracy,
+                                     plexus_sketch_handle_t* out_handle);
+
+/**
+ * Record one sample into a sketch. O(1), no point is queued.
+ * Values <= 0 are counted in a dedicated zero bin; NaN is ignored.
+ *
+ * @return PLEXUS_OK, or PLEXUS_ERR_INVALID_ARG for an unknown handle or an
+ *         infinite value
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_observe(plexus_client_t* client, plexus_sketch_handle_t handle,
+                             double value);
+
+/**
+ * Estimate a quantile of the currently open window.
+ *
+ * @param q  Quantile in [0, 1] (0.5 = median, 0.99 = p99)
+ * @return   Estimated value, or NAN if the window is empty or args are invalid
+ */
+double plexus_sketch_quantile(const plexus_client_t* client,
+                               plexus_sketch_handle_t handle, double q);
+
+#endif /* PLEXUS_ENABLE_SKETCHES */
+
+/* ------------------------------------------------------------------------- */
+/* Counter, gauge and rate metrics (opt-in via PLEXUS_ENABLE_COUNTERS)       */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_COUNTERS
+
+/**
+ * Register a metric whose samples are coalesced into one point per window.
+ *
+ * Once registered, plexus_send_number() on this metric no longer queues a
+ * point per call:
+ *   - PLEXUS_KIND_GAUGE keeps the last value of the window.
+ *   - PLEXUS_KIND_COUNTER / PLEXUS_KIND_RATE treat the value as a monotonic
+ *     cumulative reading (bytes, packets, pulses) and accumulate the
+ *     difference from the previous reading. A reading lower than the
+ *     previous one is taken as a counter reset: the reading itself is the
+ *     increase since the reset. The first reading only sets the baseline.
+ * plexus_counter_add() adds an increment directly, without a reading.
+ *
+ * When the window closes one point named after the metric is queued: the
+ * last value, the increase, or the increase per second. A rate divides by
+ * the time the increase actually covers — since the previous point (or
+ * registration) for plexus_counter_add(), between the readings otherwise —
+ * so a sparse counter is not overstated by a window that opened late.
+ * A window opens on its first update and closes window_ms later, checked
+ * from plexus_tick() and on the next update. Windows without updates emit
+ * nothing. Tagged sends are never coalesced.
+ *
+ * @param client     Plexus client
+ * @param metric     Metric name
+ * @param kind       Gauge, counter or rate
+ * @param window_ms  Window length in milliseconds; 0 uses the client's
+ *                   flush interval
+ * @return           PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the counter
+ *                   table is full
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_counter_register(plexus_client_t* client, const char* metric,
+                                      plexus_metric_kind_t kind, uint32_t window_ms);
+
+/**
+ * Add an increment to a registered counter or rate metric.
+ *
+ * Increments between window closes are summed into a single point, so a
+ * 1 kHz pulse counter costs one point per window.
+ *
+ * @param increment  Non-negative increment
+ * @return           PLEXUS_OK, PLEXUS_ERR_INVALID_ARG if the metric is not a
+ *                   registered counter/rate or the increment is negative
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_counter_add(plexus_client_t* client, const char* metric, double increment);
+
+#endif /* PLEXUS_ENABLE_COUNTERS */
+
+/* ------------------------------------------------------------------------- */
+/* Waveform downsampling (opt-in via PLEXUS_ENABLE_DOWNSAMPLE)               */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_DOWNSAMPLE
+
+/**
+ * Decimate a high-rate numeric metric to a fixed number of points per flush.
+ *
+ * Once registered, plexus_send_number() / plexus_send_number_ts() on this
+ * metric append the sample (as float, with its timestamp) to a per-metric
+ * buffer of PLEXUS_DOWNSAMPLE_CAPACITY samples instead of the metric queue.
+ * At flush the buffer is reduced to at most target_points points, keeping
+ * the original timestamps, and queued ahead of serialization. If the buffer
+ * fills between flushes it is reduced in place and keeps filling, so long
+ * captures degrade gracefully rather than drop samples.
+ *
+ * LTTB keeps the points that best preserve the plotted shape; MINMAX keeps
+ * the minimum and maximum of each of target_points / 2 buckets, so no peak
+ * is ever lost. Tagged sends are never downsampled.
+ *
+ * @param client         Plexus client
+ * @param metric         Metric name
+ * @param target_points  Points per flush: 3..PLEXUS_MAX_METRICS for LTTB,
+ *                       2..PLEXUS_MAX_METRICS for MINMAX, and below
+ *                       PLEXUS_DOWNSAMPLE_CAPACITY
+ * @param method         PLEXUS_DOWNSAMPLE_LTTB or PLEXUS_DOWNSAMPLE_MINMAX
+ * @return               PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the
+ *                       downsample table is full
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_downsample_register(plexus_client_t* client, const char* metric,
+                                         uint16_t target_points,
+                                         plexus_downsample_method_t method);
+
+#endif /* PLEXUS_ENABLE_DOWNSAMPLE */
+
+/* ------------------------------------------------------------------------- */
+/* Burst capture (opt-in via PLEXUS_ENABLE_TRIGGER)                          */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_TRIGGER
+
+/**
+ * Capture a high-rate metric oscilloscope-style around trigger events.
+ *
+ * Once registered, plexus_send_number() / plexus_send_number_ts() on this
+ * metric write the sample into a PLEXUS_TRIGGER_RING_SIZE-sample ring
+ * instead of the queue. Outside a burst, one sample per report_interval_ms
+ * is queued so the metric still reports at a low rate.
+ *
+ * When the condition fires (edge-triggered: it must go false before it can
+ * fire again) or plexus_trigger_fire() is called, the whole ring — the
+ * pre-trigger history — plus the next post_samples samples are queued at
+ * full resolution, in order. Bursts larger than the free queue space are
+ * moved into the queue as flushes make room; samples that arrive while the
+ * ring is full of unsent burst data are dropped and counted.
+ *
+ * Tagged sends are never captured.
+ *
+ * @param client              Plexus client
+ * @param metric              Metric name
+ * @param cond                Trigger condition
+ * @param threshold           Level (ABOVE/BELOW) or step size (CHANGE)
+ * @param post_samples        Samples queued after the trigger
+ * @param report_interval_ms  Low-rate reporting interval, 0 = silent
+ * @return                    PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the
+ *                            trigger table is full
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_trigger_register(plexus_client_t* client, const char* metric,
+                                      plexus_trigger_cond_t cond, double threshold,
+                                      uint16_t post_samples, uint32_t report_interval_ms);
+
+/**
+ * Fire a metric's trigger from application logic (e.g. a fault flag or a
+ * condition over several metrics). Behaves like a built-in condition firing.
+ *
+ * @return PLEXUS_OK, or PLEXUS_ERR_INVALID_ARG if the metric has no trigger
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_trigger_fire(plexus_client_t* client, const char* metric);
+
+#endif /* PLEXUS_ENABLE_TRIGGER */
+
+/* ------------------------------------------------------------------------- */
+/* Last-value cache (opt-in via PLEXUS_ENABLE_LAST_VALUE)                    */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_LAST_VALUE
+
+/**
+ * Get the most recent value sent for a metric.
+ *
+ * Every untagged number or bool send updates the cache, including sends
+ * that are aggregated, filtered or compressed rather than queued, so this
+ * is the metric's current value even when it is not being streamed. Up to
+ * PLEXUS_MAX_LAST_VALUES metrics are cached; once the table is full, new
+ * metric names are not cached. String values and tagged sends are not
+ * cached.
+ *
+ * With PLEXUS_ENABLE_WEBSOCKET, a built-in "snapshot" command returns the
+ * whole cache in one command result (unless the application registered its
+ * own "snapshot" command).
+ *
+ * @param client        Plexus client
+ * @param metric        Metric name
+ * @param value         Receives the value (bools as 0 / 1)
+ * @param timestamp_ms  Receives the sample timestamp (NULL to skip)
+ * @return              PLEXUS_OK, or PLEXUS_ERR_NO_DATA if nothing was sent
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_last_value_get(plexus_client_t* client, const char* metric,
+                                    double* value, uint64_t* timestamp_ms);
+
+/** Number of metrics in the last-value cache */
+uint8_t plexus_last_value_count(const plexus_client_t* client);
+
+/**
+ * Serialize the last-value cache as JSON:
+ * {"points":[{"metric":"temp","value":21.5,"timestamp":1700000000000},...]}
+ *
+ * @param buf      Output buffer (NUL-terminated on success)
+ * @param out_len  Receives the JSON length (NULL to skip)
+ * @return         PLEXUS_OK, or PLEXUS_ERR_JSON if buf is too small
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_last_value_snapshot(plexus_client_t* client, char* buf, size_t buf_size,
+                                         size_t* out_len);
+
+#endif /* PLEXUS_ENABLE_LAST_VALUE */
+
+/* ------------------------------------------------------------------------- */
+/* History rings (opt-in via PLEXUS_ENABLE_HISTORY)                          */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_HISTORY
+
+/**
+ * Keep a short on-device history of a metric at reduced resolution.
+ *
+ * Every untagged plexus_send_number() / plexus_send_number_ts() of the
+ * metric is averaged into interval_ms intervals; each closed interval
+ * becomes one 8-byte entry (float32 mean, delta timestamp) in a
+ * PLEXUS_HISTORY_SIZE-entry ring, so the ring spans
+ * PLEXUS_HISTORY_SIZE * interval_ms (120 x 5 s = 10 minutes by default).
+ * Recording does not change what is queued or sent.
+ *
+ * With PLEXUS_ENABLE_WEBSOCKET, a built-in "history" command serves the
+ * ring so a dashboard can backfill recent context on connect:
+ *   params {"metric":"temp","since":1700000000000}
+ *   result {"metric":"temp","interval_ms":5000,"points":[[ts,value],...],"more":false}
+ * Entries are oldest first, newer than "since" (optional). If they do not
+ * fit PLEXUS_JSON_BUFFER_SIZE, "more" is true and the dashboard repeats the
+ * command with "since" set to the last timestamp received.
+ *
+ * @param client       Plexus client
+ * @param metric       Metric name
+ * @param interval_ms  Resolution of the history (0 = keep every sample)
+ * @return             PLEXUS_OK, or PLEXUS_ERR_BUFFER_FULL if the history
+ *                     table is full. Re-registering with a different
+ *                     interval clears the ring.
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_history_register(plexus_client_t* client, const char* metric,
+                                      uint32_t interval_ms);
+
+/** Number of closed entries in a metric's history (0 if none or not registered) */
+uint16_t plexus_history_count(plexus_client_t* client, const char* metric);
+
+/**
+ * Read one history entry, 0 = oldest.
+ *
+ * @return PLEXUS_OK, PLEXUS_ERR_INVALID_ARG if the metric has no history,
+ *         or PLEXUS_ERR_NO_DATA if index is out of range
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_history_get(plexus_client_t* client, const char* metric, uint16_t index,
+                                 double* value, uint64_t* timestamp_ms);
+
+#endif /* PLEXUS_ENABLE_HISTORY */
+
+/* ------------------------------------------------------------------------- */
+/* Self-telemetry (opt-in via PLEXUS_ENABLE_CLIENT_STATS)                    */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_CLIENT_STATS
+
+/**
+ * Copy the client's self-telemetry: post latency histogram, serialize time,
+ * bytes per point, retries and backoff, queue high-water mark, drops by
+ * reason, persisted backlog and WebSocket traffic.
+ *
+ * @param client Plexus client
+ * @param out    Receives the snapshot
+ * @return       PLEXUS_OK, PLEXUS_ERR_NULL_PTR or PLEXUS_ERR_NOT_INITIALIZED
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_get_stats(plexus_client_t* client, plexus_client_stats_t* out);
+
+/** Zero all counters */
+void plexus_reset_stats(plexus_client_t* client);
+
+/**
+ * Publish a summary as plexus.* metrics every interval_ms from plexus_tick():
+ * plexus.posts, plexus.post_failures, plexus.post_latency_ms_mean,
+ * plexus.post_latency_ms_max, plexus.bytes_per_point, plexus.retries,
+ * plexus.queue_high_water, plexus.drops, plexus.persist_backlog and
+ * plexus.ws_reconnects. Counters are cumulative. The summary is skipped
+ * for an interval if the queue lacks room for all of it.
+ *
+ * @param client      Plexus client
+ * @param interval_ms Publish interval (0 = off, the default; e.g. 300000)
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_set_stats_publish_interval(plexus_client_t* client, uint32_t interval_ms);
+
+#endif /* PLEXUS_ENABLE_CLIENT_STATS */
+
+/* ------------------------------------------------------------------------- */
+/* Trace hooks (opt-in via PLEXUS_ENABLE_TRACE)                              */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_TRACE
+
+/**
+ * Register a callback for flush-phase and WebSocket trace events.
+ *
+ * Each phase of plexus_flush() reports BEGIN and END (persisted-batch
+ * drain, serialize, WebSocket send, every HTTP attempt, backoff sleep,
+ * persist write), nested inside one FLUSH span; WebSocket state changes
+ * report INSTANT. Forward them to a tracer such as Perfetto or SystemView.
+ *
+ * The callback runs inline, under the client lock: keep it short and do
+ * not call back into the client. Pass NULL to stop tracing.
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_on_trace(plexus_client_t* client,
+                             plexus_trace_callback_t callback,
+                             void* user_data);
+
+#endif /* PLEXUS_ENABLE_TRACE */
+
+/* ------------------------------------------------------------------------- */
+/* Wake hook (opt-in via PLEXUS_ENABLE_WAKE_CALLBACK)                        */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+
+/**
+ * Register a callback that cuts short a sleep until plexus_next_deadline_ms().
+ *
+ * Fires once per plexus_next_deadline_ms() call, when a send, observe or
+ * counter update makes work due before the deadline last returned, and
+ * on every WebSocket event or incoming command. Typically it gives a
+ * semaphore or task notification the ticking task is blocked on.
+ *
+ * Sends call it inline under the client lock; WebSocket events call it
+ * from the HAL's transport context. Keep it short, ISR/thread safe, and
+ * do not call back into the client. Pass NULL to remove it.
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_on_wake(plexus_client_t* client,
+                            plexus_wake_callback_t callback,
+                            void* user_data);
+
+#endif /* PLEXUS_ENABLE_WAKE_CALLBACK */
+
 /* ------------------------------------------------------------------------- */
 /* Connection status (opt-in via PLEXUS_ENABLE_STATUS_CALLBACK)              */
 /* ------------------------------------------------------------------------- */
@@ -570,6 +1886,106 @@ plexus_conn_status_t plexus_get_status(const plexus_client_t* client);
 
 #endif /* PLEXUS_ENABLE_STATUS_CALLBACK */
 
+/* ------------------------------------------------------------------------- */
+/* Shared transport (opt-in via PLEXUS_ENABLE_SHARED_TRANSPORT)              */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+
+/**
+ * Declare a correctly-sized and aligned static buffer for a transport.
+ *
+ * @example
+ *   PLEXUS_TRANSPORT_STATIC_BUF(link_buf);
+ *   plexus_transport_t* link = plexus_transport_init_static(&link_buf, sizeof(link_buf));
+ */
+#define PLEXUS_TRANSPORT_STATIC_BUF(name) \
+    static plexus_transport_t name
+
+/**
+ * Create a transport that several clients post through (heap-allocated).
+ *
+ * Attached clients share its endpoint, its PLEXUS_TRANSPORT_BUFFER_SIZE
+ * request buffer and its retry and rate-limit state. Flushing any of them
+ * (plexus_flush(), plexus_flush_nowait(), or the auto-flush in sends and
+ * plexus_tick()) sends every attached client's queue in as few requests
+ * as the buffer allows, each point tagged with its client's source_id.
+ * A 429 answered to one client holds back all of them.
+ *
+ * Each client keeps its own WebSocket and its own JSON buffer for it, so a
+ * client that only posts through the transport can be created with
+ * plexus_init_sized() and a small buffer.
+ *
+ * @return Transport pointer, or NULL on failure
+ */
+plexus_transport_t* plexus_transport_init(void);
+
+/**
+ * Create a transport in user-provided memory (no malloc).
+ *
+ * @param buf      Buffer (at least sizeof(plexus_transport_t) bytes, pointer-aligned)
+ * @param buf_size Size of the provided buffer
+ * @return         Transport pointer (== buf on success), or NULL on failure
+ */
+plexus_transport_t* plexus_transport_init_static(void* buf, size_t buf_size);
+
+/**
+ * Detach every client and free a heap-allocated transport.
+ *
+ * Safe to pass NULL. Does NOT flush; queued points stay in their clients.
+ */
+void plexus_transport_free(plexus_transport_t* transport);
+
+/**
+ * Set the ingest endpoint URL the transport posts to.
+ * Attached clients' own endpoints are not used while attached.
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_transport_set_endpoint(plexus_transport_t* transport, const char* endpoint);
+
+/**
+ * Route a client's HTTP flushes through the transport.
+ *
+ * One request carries one API key, so every client on a transport must use
+ * the same key. With PLEXUS_ENABLE_THREAD_SAFE the client takes the
+ * transport's lock while attached; attaching and detaching are safe while
+ * other tasks use the client, but not from a callback the SDK runs under
+ * a client's or the transport's lock. Batches that fail after retries stay
+ * queued in their clients rather than going to persistent storage.
+ *
+ * @param transport Shared transport
+ * @param client    Client, not attached to any transport
+ * @return PLEXUS_OK, PLEXUS_ERR_INVALID_ARG if the client is already attached
+ *         or its API key differs, PLEXUS_ERR_BUFFER_FULL if
+ *         PLEXUS_MAX_TRANSPORT_CLIENTS are attached
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_transport_attach(plexus_transport_t* transport, plexus_client_t* client);
+
+/**
+ * Return a client to its own endpoint, buffer and lock.
+ * Queued points stay queued. plexus_free() detaches implicitly.
+ *
+ * @return PLEXUS_OK, or PLEXUS_ERR_INVALID_ARG if the client is not attached
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_transport_detach(plexus_client_t* client);
+
+/**
+ * Send every attached client's queued points, coalesced, with retries and
+ * exponential backoff as plexus_flush() does. A queue longer than the
+ * transport buffer is split across requests.
+ *
+ * @param transport Shared transport
+ * @return PLEXUS_OK, PLEXUS_ERR_NO_DATA if nothing was queued,
+ *         PLEXUS_ERR_JSON if a point too large for any request was dropped,
+ *         or the error of the request that failed (later points stay queued)
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_transport_flush(plexus_transport_t* transport);
+
+#endif /* PLEXUS_ENABLE_SHARED_TRANSPORT */
+
 /* ------------------------------------------------------------------------- */
 /* Utility                                                                   */
 /* ------------------------------------------------------------------------- */
@@ -599,6 +2015,18 @@ plexus_err_t plexus_hal_storage_read(const char* key, void* data, size_t max_len
 plexus_err_t plexus_hal_storage_clear(const char* key);
 #endif
 
+#if PLEXUS_ENABLE_TIMING
+/**
+ * Free-running high-resolution counter (CPU cycles or a fast timer) for
+ * plexus::ScopedTimer. Only differences between two reads are used, so it
+ * may wrap; intervals must stay shorter than one wrap.
+ */
+uint32_t plexus_hal_get_cycles(void);
+
+/** Counts of plexus_hal_get_cycles() per microsecond (>= 1) */
+uint32_t plexus_hal_cycles_per_us(void);
+#endif
+
 #if PLEXUS_ENABLE_THREAD_SAFE
 void* plexus_hal_mutex_create(void);
 void  plexus_hal_mutex_lock(void* mutex);
@@ -679,6 +2107,25 @@ PLEXUS_WARN_UNUSED_RESULT
 plexus_err_t plexus_command_respond(plexus_client_t* client, const char* cmd_id,
                                      const char* result_json, const char* error);
 
+/**
+ * Send a command result for a named command.
+ *
+ * Same as plexus_command_respond(), but for responses sent after other
+ * commands may have been dispatched: plexus_command_respond() reports the
+ * most recently dispatched command name.
+ *
+ * @param client      Plexus client
+ * @param cmd_id      Command ID from the handler callback
+ * @param command     Command name the result belongs to
+ * @param result_json JSON object string — NULL on error
+ * @param error       Error message string — NULL on success
+ * @return            PLEXUS_OK on success
+ */
+PLEXUS_WARN_UNUSED_RESULT
+plexus_err_t plexus_command_respond_to(plexus_client_t* client, const char* cmd_id,
+                                        const char* command, const char* result_json,
+                                        const char* error);
+
 /* --- Transport mode --- */
 
 /** Enable/disable sending telemetry over WebSocket (default: true). */
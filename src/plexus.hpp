@@ -6,6 +6,18 @@
  *   PlexusClient px("plx_xxx", "device-001");
  *   px.send("temperature", 72.5);
  *   px.tick();
+ *
+ * Or, with per-instance capacities and no heap:
+ *   static plexus::BasicClient<plexus::ClientConfig<8, 1024>> px("plx_xxx", "device-001");
+ *
+ * With C++17 or later, typed metric handles whose names are validated at
+ * compile time:
+ *   plexus::Metric<double> temp(px, "temperature");   // C++20: checked implicitly
+ *   temp.send(72.5);
+ *
+ * With C++20 coroutines, plexus::Executor runs Task<> coroutines from the
+ * main loop: co_await ex.flush(), co_await ex.connect(), coroutine command
+ * handlers.
  */
 
 #ifndef PLEXUS_HPP
@@ -13,21 +25,20 @@
 
 #include "plexus.h"
 
-class PlexusClient {
-public:
-    PlexusClient(const char* apiKey, const char* sourceId)
-        : _client(plexus_init(apiKey, sourceId)) {}
+#if __cplusplus >= 202002L
+#include <span>
+#endif
 
-    ~PlexusClient() {
-        if (_client) {
-            plexus_free(_client);
-        }
-    }
+namespace plexus {
 
-    /* Non-copyable */
-    PlexusClient(const PlexusClient&) = delete;
-    PlexusClient& operator=(const PlexusClient&) = delete;
+/** Numeric point for sendBatch() and BatchBuilder: {metric, value, timestamp_ms} */
+typedef plexus_point_t Point;
+
+namespace detail {
 
+/* Methods shared by PlexusClient and plexus::BasicClient */
+class ClientMethods {
+public:
     bool isValid() const { return _client != 0; }
 
     plexus_err_t send(const char* metric, double value) {
@@ -54,6 +65,22 @@ public:
     }
 #endif
 
+    /** Queue all points under one lock; see plexus_send_batch() */
+    plexus_err_t sendBatch(const Point* points, size_t count) {
+        return plexus_send_batch(_client, points, count);
+    }
+
+    /** sendBatch() reporting how many leading points were taken */
+    plexus_err_t sendBatch(const Point* points, size_t count, size_t* accepted) {
+        return plexus_send_batch_accepted(_client, points, count, accepted);
+    }
+
+#if __cplusplus >= 202002L
+    plexus_err_t sendBatch(std::span<const Point> points) {
+        return plexus_send_batch(_client, points.data(), points.size());
+    }
+#endif
+
     plexus_err_t flush() { return plexus_flush(_client); }
     plexus_err_t tick() { return plexus_tick(_client); }
     uint16_t pendingCount() const { return plexus_pending_count(_client); }
@@ -83,8 +110,809 @@ public:
 
     plexus_client_t* handle() { return _client; }
 
+protected:
+    explicit ClientMethods(plexus_client_t* client) : _client(client) {}
+    ~ClientMethods() {}
+
+    plexus_client_t* _client;
+};
+
+} // namespace detail
+} // namespace plexus
+
+/**
+ * Heap-allocated client sized by PLEXUS_MAX_METRICS / PLEXUS_JSON_BUFFER_SIZE.
+ */
+class PlexusClient : public plexus::detail::ClientMethods {
+public:
+    PlexusClient(const char* apiKey, const char* sourceId)
+        : ClientMethods(plexus_init(apiKey, sourceId)) {}
+
+    ~PlexusClient() {
+        if (_client) {
+            plexus_free(_client);
+        }
+    }
+
+    /* Non-copyable */
+    PlexusClient(const PlexusClient&) = delete;
+    PlexusClient& operator=(const PlexusClient&) = delete;
+};
+
+namespace plexus {
+
+/**
+ * Capacities for BasicClient.
+ *
+ * Any type with these two static constexpr members works as a Config.
+ */
+template <uint16_t MaxMetrics, size_t JsonBufferSize>
+struct ClientConfig {
+    static constexpr uint16_t max_metrics = MaxMetrics;
+    static constexpr size_t json_buffer_size = JsonBufferSize;
+};
+
+typedef ClientConfig<PLEXUS_MAX_METRICS, PLEXUS_JSON_BUFFER_SIZE> DefaultClientConfig;
+
+/**
+ * Client whose queue and JSON buffer are sized by @p Config and stored
+ * inline, so it can live in static memory, on the stack or in a
+ * placement-new buffer without touching the heap:
+ *
+ *   using DiagConfig = plexus::ClientConfig<4, 512>;
+ *   static plexus::BasicClient<DiagConfig> diag("plx_xxx", "gw-diag");
+ *   static plexus::BasicClient<plexus::ClientConfig<128, 8192>> telemetry("plx_xxx", "gw-01");
+ *
+ * Both share the same C core through plexus_init_sized().
+ */
+template <typename Config = DefaultClientConfig>
+class BasicClient : public detail::ClientMethods {
+public:
+    static_assert(Config::max_metrics >= 1, "Config::max_metrics must be at least 1");
+    static_assert(Config::json_buffer_size >= 256,
+                  "Config::json_buffer_size must be at least 256 bytes");
+
+    static constexpr size_t storage_size =
+        PLEXUS_CLIENT_SIZE_FOR(Config::max_metrics, Config::json_buffer_size);
+
+    BasicClient(const char* apiKey, const char* sourceId) : ClientMethods(0) {
+        _client = plexus_init_sized(_storage, sizeof(_storage), Config::max_metrics,
+                                    Config::json_buffer_size, apiKey, sourceId);
+    }
+
+    ~BasicClient() {
+        if (_client) {
+            plexus_free(_client);
+        }
+    }
+
+    /* Non-copyable, non-movable: the C client points into _storage */
+    BasicClient(const BasicClient&) = delete;
+    BasicClient& operator=(const BasicClient&) = delete;
+
+private:
+    alignas(plexus_client_t) unsigned char _storage[storage_size];
+};
+
+/**
+ * Fixed-capacity batch of points built on the stack and queued with one
+ * plexus_send_batch() call:
+ *
+ *   plexus::BatchBuilder<8> batch;
+ *   batch.add("accel_x", ax);
+ *   batch.add("accel_y", ay);
+ *   batch.add("accel_z", az);
+ *   batch.commit(px);
+ *
+ * Move-only, so a batch cannot be committed twice by copying it. Metric
+ * name pointers must stay valid until commit().
+ */
+template <size_t N>
+class BatchBuilder {
+public:
+    static_assert(N >= 1, "BatchBuilder capacity must be at least 1");
+
+    BatchBuilder() : _count(0) {}
+
+    BatchBuilder(BatchBuilder&& other) noexcept : _count(0) { take(other); }
+
+    BatchBuilder& operator=(BatchBuilder&& other) noexcept {
+        if (this != &other) {
+            take(other);
+        }
+        return *this;
+    }
+
+    BatchBuilder(const BatchBuilder&) = delete;
+    BatchBuilder& operator=(const BatchBuilder&) = delete;
+
+    /** Append a point; PLEXUS_ERR_BUFFER_FULL once N points are held */
+    plexus_err_t add(const char* metric, double value, uint64_t timestamp_ms = 0) {
+        if (_count >= N) {
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        _points[_count].metric = metric;
+        _points[_count].value = value;
+        _points[_count].timestamp_ms = timestamp_ms;
+        _count++;
+        return PLEXUS_OK;
+    }
+
+    /**
+     * Queue every point on @p client. Points that were taken are removed;
+     * the rest are kept (all of them for a bad name, else the tail from the
+     * first point that found no room or that a feature failed), so
+     * committing again after a flush never queues a point twice.
+     */
+    plexus_err_t commit(plexus_client_t* client) {
+        size_t accepted = 0;
+        plexus_err_t err = plexus_send_batch_accepted(client, _points, _count, &accepted);
+        for (size_t i = accepted; i < _count; i++) {
+            _points[i - accepted] = _points[i];
+        }
+        _count -= accepted;
+        return err;
+    }
+
+    plexus_err_t commit(detail::ClientMethods& client) { return commit(client.handle()); }
+
+    void clear() { _count = 0; }
+    size_t size() const { return _count; }
+    bool empty() const { return _count == 0; }
+    static constexpr size_t capacity() { return N; }
+    const Point* data() const { return _points; }
+
+#if __cplusplus >= 202002L
+    std::span<const Point> points() const { return std::span<const Point>(_points, _count); }
+#endif
+
+private:
+    void take(BatchBuilder& other) {
+        for (size_t i = 0; i < other._count; i++) {
+            _points[i] = other._points[i];
+        }
+        _count = other._count;
+        other._count = 0;
+    }
+
+    Point _points[N];
+    size_t _count;
+};
+
+} // namespace plexus
+
+#if __cplusplus >= 201703L
+
+#include <string_view>
+
+/* consteval makes every MetricName a compile-time check; C++17 gets the
+ * check whenever the name is constructed in a constant expression. */
+#if defined(__cpp_consteval) && __cpp_consteval >= 201811L
+#define PLEXUS_CONSTEVAL consteval
+#else
+#define PLEXUS_CONSTEVAL constexpr
+#endif
+
+namespace plexus {
+
+namespace detail {
+
+/* Same rules as plexus_internal_is_valid_metric_name() plus the length limit */
+constexpr bool is_valid_metric_name(const char* s, size_t len) {
+    if (len == 0 || len >= PLEXUS_MAX_METRIC_NAME_LEN) {
+        return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        unsigned char c = static_cast<unsigned char>(s[i]);
+        if (c < 0x20 || c > 0x7E) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* Not constexpr: reaching it during constant evaluation is a compile error */
+inline void invalid_metric_name() {}
+
+} // namespace detail
+
+/**
+ * A metric name checked once, when it is constructed.
+ *
+ * Construct from a string literal. In C++20 the constructor is consteval, so
+ * an empty, over-long or non-printable name fails to compile. In C++17 use a
+ * constexpr variable for the same guarantee:
+ *   constexpr plexus::MetricName kTemp("temperature");
+ * A C++17 name built at run time that fails the check holds nullptr and
+ * every send with it returns PLEXUS_ERR_NULL_PTR.
+ */
+class MetricName {
+public:
+    template <size_t N>
+    PLEXUS_CONSTEVAL MetricName(const char (&name)[N]) : _name(name) {
+        size_t len = 0;
+        while (len < N && name[len] != '\0') {
+            len++;
+        }
+        if (len == N || !detail::is_valid_metric_name(name, len)) {
+            detail::invalid_metric_name();
+            _name = nullptr;
+        }
+    }
+
+    constexpr const char* c_str() const { return _name; }
+
+private:
+    const char* _name;
+};
+
+/**
+ * Typed handle to one metric on one client.
+ *
+ * Bound once to a client and a MetricName; send() skips the per-call name
+ * scan and goes straight to the queue (and any features configured for the
+ * name). Specialised for double, bool and std::string_view.
+ */
+template <typename T>
+class Metric;
+
+namespace detail {
+
+class MetricBase {
+public:
+    MetricBase(plexus_client_t* client, MetricName name)
+        : _client(client), _name(name.c_str()) {}
+    MetricBase(ClientMethods& client, MetricName name)
+        : _client(client.handle()), _name(name.c_str()) {}
+
+    const char* name() const { return _name; }
+
+protected:
+    plexus_client_t* _client;
+    const char* _name;
+};
+
+} // namespace detail
+
+template <>
+class Metric<double> : public detail::MetricBase {
+public:
+    using MetricBase::MetricBase;
+
+    plexus_err_t send(double value, uint64_t timestamp_ms = 0) {
+        return plexus_send_number_unchecked(_client, _name, value, timestamp_ms);
+    }
+};
+
+#if PLEXUS_ENABLE_BOOL_VALUES
+template <>
+class Metric<bool> : public detail::MetricBase {
+public:
+    using MetricBase::MetricBase;
+
+    plexus_err_t send(bool value, uint64_t timestamp_ms = 0) {
+        return plexus_send_bool_unchecked(_client, _name, value, timestamp_ms);
+    }
+};
+#endif
+
+#if PLEXUS_ENABLE_STRING_VALUES
+template <>
+class Metric<std::string_view> : public detail::MetricBase {
+public:
+    using MetricBase::MetricBase;
+
+    plexus_err_t send(std::string_view value, uint64_t timestamp_ms = 0) {
+        return plexus_send_string_unchecked(_client, _name, value.data(), value.size(),
+                                            timestamp_ms);
+    }
+};
+#endif
+
+#if PLEXUS_ENABLE_TIMING
+/**
+ * Times the enclosing scope with plexus_hal_get_cycles() and records the
+ * duration in microseconds when it ends, either as a sample of a
+ * Metric<double> or into a quantile sketch. Register an aggregate (or use a
+ * sketch) for the metric so a hot loop costs one fold per pass instead of
+ * one queued point:
+ *
+ *   static plexus::Metric<double> loop_us(px, "loop_us");
+ *   plexus_aggregate_register(px.handle(), "loop_us", 10000, PLEXUS_AGG_MEAN | PLEXUS_AGG_MAX);
+ *
+ *   void loop() {
+ *       PLEXUS_TIME_SCOPE(loop_us);
+ *       ...
+ *   }
+ */
+class ScopedTimer {
+public:
+    explicit ScopedTimer(Metric<double>& metric) : _metric(&metric) {
+        _start = plexus_hal_get_cycles();
+    }
+
+#if PLEXUS_ENABLE_SKETCHES
+    ScopedTimer(plexus_client_t* client, plexus_sketch_handle_t sketch)
+        : _client(client), _sketch(sketch) {
+        _start = plexus_hal_get_cycles();
+    }
+
+    ScopedTimer(detail::ClientMethods& client, plexus_sketch_handle_t sketch)
+        : _client(client.handle()), _sketch(sketch) {
+        _start = plexus_hal_get_cycles();
+    }
+#endif
+
+    ~ScopedTimer() {
+        double us = elapsedUs();
+        if (_metric) {
+            (void)_metric->send(us);
+        }
+#if PLEXUS_ENABLE_SKETCHES
+        else {
+            (void)plexus_observe(_client, _sketch, us);
+        }
+#endif
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    /** Time since construction; wraps after one counter period */
+    double elapsedUs() const {
+        uint32_t cycles = plexus_hal_get_cycles() - _start;
+        return (double)cycles / (double)plexus_hal_cycles_per_us();
+    }
+
+private:
+    Metric<double>* _metric = nullptr;
+#if PLEXUS_ENABLE_SKETCHES
+    plexus_client_t* _client = nullptr;
+    plexus_sketch_handle_t _sketch = 0;
+#endif
+    uint32_t _start;
+};
+#endif /* PLEXUS_ENABLE_TIMING */
+
+} // namespace plexus
+
+#endif /* __cplusplus >= 201703L */
+
+#define PLEXUS_TIME_SCOPE_CAT2(a, b) a##b
+#define PLEXUS_TIME_SCOPE_CAT(a, b) PLEXUS_TIME_SCOPE_CAT2(a, b)
+
+/**
+ * Time the rest of the enclosing scope with a plexus::ScopedTimer:
+ * PLEXUS_TIME_SCOPE(metric) or PLEXUS_TIME_SCOPE(client, sketch_handle).
+ * Compiles to nothing unless PLEXUS_ENABLE_TIMING=1 (and C++17).
+ */
+#if PLEXUS_ENABLE_TIMING && __cplusplus >= 201703L
+#define PLEXUS_TIME_SCOPE(...) \
+    plexus::ScopedTimer PLEXUS_TIME_SCOPE_CAT(plexus_scope_timer_, __LINE__)(__VA_ARGS__)
+#else
+#define PLEXUS_TIME_SCOPE(...) ((void)0)
+#endif
+
+#if __cplusplus >= 202002L && defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+namespace plexus {
+
+/**
+ * Lazily started coroutine returning @p T (default-constructible).
+ *
+ * Starts when awaited or passed to Executor::spawn(); resumes its awaiter
+ * directly when it finishes. Frames come from operator new.
+ */
+template <typename T = void>
+class Task;
+
+class Executor;
+
+namespace detail {
+
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    TaskPromiseBase* next_spawned = nullptr; /* Executor's list of owned tasks */
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> h) noexcept {
+            std::coroutine_handle<> next = h.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { std::terminate(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    T value{};
+
+    Task<T> get_return_object() noexcept;
+    void return_value(T v) { value = std::move(v); }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    Task<void> get_return_object() noexcept;
+    void return_void() noexcept {}
+};
+
+} // namespace detail
+
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::TaskPromise<T>;
+
+    Task(Task&& other) noexcept : _h(other._h) { other._h = nullptr; }
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (_h) {
+                _h.destroy();
+            }
+            _h = other._h;
+            other._h = nullptr;
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (_h) {
+            _h.destroy();
+        }
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool done() const { return !_h || _h.done(); }
+
+    bool await_ready() const noexcept { return done(); }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiter) noexcept {
+        _h.promise().continuation = awaiter;
+        return _h;
+    }
+
+    T await_resume() {
+        if constexpr (!std::is_void_v<T>) {
+            return std::move(_h.promise().value);
+        }
+    }
+
+private:
+    friend struct detail::TaskPromise<T>;
+    friend class Executor;
+
+    explicit Task(std::coroutine_handle<promise_type> h) noexcept : _h(h) {}
+
+    std::coroutine_handle<promise_type> release() noexcept {
+        std::coroutine_handle<promise_type> h = _h;
+        _h = nullptr;
+        return h;
+    }
+
+    std::coroutine_handle<promise_type> _h;
+};
+
+namespace detail {
+
+template <typename T>
+inline Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+/**
+ * Awaitable returned by Executor::sleep(). Links itself into the
+ * executor's wait list while suspended, so waiting never allocates.
+ */
+class SleepAwaiter {
+public:
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> h) noexcept;
+    void await_resume() const noexcept {}
+
 private:
+    friend class Executor;
+
+    SleepAwaiter(Executor* executor, uint32_t deadline_ms)
+        : _executor(executor), _deadline_ms(deadline_ms) {}
+
+    Executor* _executor;
+    uint32_t _deadline_ms;
+    std::coroutine_handle<> _handle;
+    SleepAwaiter* _next = nullptr;
+};
+
+#if PLEXUS_ENABLE_WEBSOCKET
+/** Arguments passed to a coroutine command handler; valid until it returns */
+struct CommandArgs {
+    const char* id;
+    const char* params_json;
+    void* user_data;
+};
+
+/**
+ * Outcome of a coroutine command handler. The strings must outlive the
+ * handler's frame (literals, statics or user_data-owned buffers).
+ */
+struct CommandResult {
+    const char* json = nullptr;
+    const char* error = nullptr;
+
+    static CommandResult ok(const char* json = "{}") { return CommandResult{json, nullptr}; }
+    static CommandResult fail(const char* error) { return CommandResult{nullptr, error}; }
+};
+
+typedef Task<CommandResult> (*CommandHandler)(CommandArgs args);
+#endif
+
+/**
+ * Single-threaded executor for Plexus coroutines, driven from the
+ * application's main loop:
+ *
+ *   plexus::Executor ex(px);
+ *   ex.spawn(telemetry_loop(ex));   // Task<void> telemetry_loop(plexus::Executor&)
+ *   for (;;) { read_sensors(); ex.tick(); }
+ *
+ * tick() calls plexus_tick() and then resumes every coroutine whose wait is
+ * over. Inside a coroutine, co_await ex.flush() retries with backoff by
+ * suspending instead of blocking in plexus_hal_delay_ms(); each HTTP
+ * attempt itself still blocks for as long as the HAL's post does.
+ */
+class Executor {
+public:
+    explicit Executor(plexus_client_t* client) : _client(client) {}
+    explicit Executor(detail::ClientMethods& client) : _client(client.handle()) {}
+
+    /* Destroys coroutines that have not finished */
+    ~Executor() {
+        _waiters = nullptr;
+        while (_spawned) {
+            detail::TaskPromiseBase* p = _spawned;
+            _spawned = p->next_spawned;
+            spawned_handle(p).destroy();
+        }
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    /** Start @p task now; the executor owns it until it finishes. */
+    void spawn(Task<void> task) {
+        std::coroutine_handle<detail::TaskPromise<void>> h = task.release();
+        if (!h) {
+            return;
+        }
+        h.promise().next_spawned = _spawned;
+        _spawned = &h.promise();
+        h.resume();
+    }
+
+    /** plexus_tick(), then resume coroutines whose wait is over. */
+    plexus_err_t tick() {
+        plexus_err_t err = plexus_tick(_client);
+        uint32_t now = plexus_hal_get_tick_ms();
+
+        /* Detach the due waiters first: whatever they await next waits for
+         * the following tick */
+        SleepAwaiter* due = nullptr;
+        SleepAwaiter** due_tail = &due;
+        SleepAwaiter** link = &_waiters;
+        while (*link) {
+            SleepAwaiter* w = *link;
+            if ((int32_t)(now - w->_deadline_ms) >= 0) {
+                *link = w->_next;
+                w->_next = nullptr;
+                *due_tail = w;
+                due_tail = &w->_next;
+            } else {
+                link = &w->_next;
+            }
+        }
+        while (due) {
+            SleepAwaiter* w = due;
+            due = w->_next; /* w lives in the frame being resumed */
+            w->_handle.resume();
+        }
+
+        reap();
+        return err;
+    }
+
+    /** Resume on the first tick at least @p ms from now (0 = next tick). */
+    SleepAwaiter sleep(uint32_t ms) {
+        return SleepAwaiter(this, plexus_hal_get_tick_ms() + ms);
+    }
+
+    /** Flush without blocking between retries. */
+    Task<plexus_err_t> flush() {
+        for (;;) {
+            uint32_t retry_after_ms = 0;
+            plexus_err_t err = plexus_flush_nowait(_client, &retry_after_ms);
+            if (retry_after_ms == 0) {
+                co_return err;
+            }
+            co_await sleep(retry_after_ms);
+        }
+    }
+
+#if PLEXUS_ENABLE_WEBSOCKET
+    /**
+     * Connect the WebSocket and resume once authenticated. Returns
+     * PLEXUS_ERR_WS_AUTH_TIMEOUT if not connected within @p timeout_ms (the
+     * SDK keeps reconnecting in the background) or
+     * PLEXUS_ERR_WS_NOT_CONNECTED if the connection was closed.
+     */
+    Task<plexus_err_t> connect(uint32_t timeout_ms = PLEXUS_WS_AUTH_TIMEOUT_MS) {
+        plexus_err_t err = plexus_ws_connect(_client);
+        if (err != PLEXUS_OK) {
+            co_return err;
+        }
+        uint32_t deadline = plexus_hal_get_tick_ms() + timeout_ms;
+        for (;;) {
+            co_await sleep(0);
+            plexus_ws_state_t state = plexus_ws_state(_client);
+            if (state == PLEXUS_WS_CONNECTED) {
+                co_return PLEXUS_OK;
+            }
+            if (state == PLEXUS_WS_DISCONNECTED) {
+                co_return PLEXUS_ERR_WS_NOT_CONNECTED;
+            }
+            if ((int32_t)(plexus_hal_get_tick_ms() - deadline) >= 0) {
+                co_return PLEXUS_ERR_WS_AUTH_TIMEOUT;
+            }
+        }
+    }
+
+    /**
+     * Register a command whose handler is a coroutine. Each invocation runs
+     * as its own spawned task; the result is sent when the handler returns,
+     * so handlers may co_await sleep(), flush() or other tasks meanwhile.
+     */
+    plexus_err_t registerCommand(const char* name, const char* description,
+                                 CommandHandler handler, void* user_data = nullptr,
+                                 const plexus_param_t* params = nullptr,
+                                 uint8_t param_count = 0) {
+        if (!name || !handler) {
+            return PLEXUS_ERR_NULL_PTR;
+        }
+        if (_command_count >= PLEXUS_MAX_COMMANDS) {
+            return PLEXUS_ERR_COMMAND_FULL;
+        }
+        CommandSlot* slot = &_commands[_command_count];
+        slot->executor = this;
+        slot->handler = handler;
+        slot->user_data = user_data;
+        copy_string(slot->name, sizeof(slot->name), name);
+
+        plexus_err_t err = plexus_command_register(_client, name, description, dispatch_command,
+                                                   slot, params, param_count);
+        if (err == PLEXUS_OK) {
+            _command_count++;
+        }
+        return err;
+    }
+#endif
+
+    /** Spawned coroutines that have not finished */
+    size_t pending() const {
+        size_t n = 0;
+        for (detail::TaskPromiseBase* p = _spawned; p; p = p->next_spawned) {
+            if (!spawned_handle(p).done()) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    plexus_client_t* client() { return _client; }
+
+private:
+    friend class SleepAwaiter;
+
+    static std::coroutine_handle<detail::TaskPromise<void>> spawned_handle(
+            detail::TaskPromiseBase* p) {
+        return std::coroutine_handle<detail::TaskPromise<void>>::from_promise(
+            *static_cast<detail::TaskPromise<void>*>(p));
+    }
+
+    void add_waiter(SleepAwaiter* w) {
+        SleepAwaiter** link = &_waiters;
+        while (*link) {
+            link = &(*link)->_next;
+        }
+        *link = w;
+    }
+
+    void reap() {
+        detail::TaskPromiseBase** link = &_spawned;
+        while (*link) {
+            detail::TaskPromiseBase* p = *link;
+            std::coroutine_handle<detail::TaskPromise<void>> h = spawned_handle(p);
+            if (h.done()) {
+                *link = p->next_spawned;
+                h.destroy();
+            } else {
+                link = &p->next_spawned;
+            }
+        }
+    }
+
+    static void copy_string(char* dst, size_t size, const char* src) {
+        size_t i = 0;
+        for (; src && src[i] && i + 1 < size; i++) {
+            dst[i] = src[i];
+        }
+        dst[i] = '\0';
+    }
+
+#if PLEXUS_ENABLE_WEBSOCKET
+    struct CommandSlot {
+        Executor* executor;
+        CommandHandler handler;
+        void* user_data;
+        char name[PLEXUS_MAX_COMMAND_NAME_LEN];
+    };
+
+    /* Copied out of the command queue slot, which is reused after dispatch */
+    struct CommandCall {
+        char id[sizeof(plexus_cmd_msg_t::id)];
+        char params_json[sizeof(plexus_cmd_msg_t::params_json)];
+    };
+
+    static void dispatch_command(const char* cmd_id, const char* params_json, void* user_data) {
+        CommandSlot* slot = static_cast<CommandSlot*>(user_data);
+        CommandCall call;
+        copy_string(call.id, sizeof(call.id), cmd_id);
+        copy_string(call.params_json, sizeof(call.params_json), params_json);
+        slot->executor->spawn(slot->executor->run_command(slot, call));
+    }
+
+    Task<void> run_command(CommandSlot* slot, CommandCall call) {
+        CommandResult result =
+            co_await slot->handler(CommandArgs{call.id, call.params_json, slot->user_data});
+        (void)plexus_command_respond_to(_client, call.id, slot->name, result.json, result.error);
+    }
+
+    CommandSlot _commands[PLEXUS_MAX_COMMANDS];
+    uint8_t _command_count = 0;
+#endif
+
     plexus_client_t* _client;
+    SleepAwaiter* _waiters = nullptr;
+    detail::TaskPromiseBase* _spawned = nullptr;
 };
 
+inline void SleepAwaiter::await_suspend(std::coroutine_handle<> h) noexcept {
+    _handle = h;
+    _executor->add_waiter(this);
+}
+
+} // namespace plexus
+
+#endif /* C++20 coroutines */
+
 #endif /* PLEXUS_HPP */
@@ -0,0 +1,276 @@
+/**
+ * @file plexus_aggregate.c
+ * @brief On-device windowed aggregation for Plexus C SDK
+ *
+ * Registered metrics are not queued per sample. Each sample is folded into
+ * O(1) running accumulators (count, sum, sum of squares, min, max); when the
+ * window closes the selected statistics are queued as "<metric>.<stat>"
+ * points. Blocks passed to plexus_aggregate_send_array() are reduced with
+ * the plexus_stats_* kernels and merged into the same accumulators.
+ *
+ * A 100 Hz signal aggregated over 1 s windows with min/max/mean costs three
+ * points per second instead of a hundred, while keeping the extremes.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_AGGREGATION
+
+#include <string.h>
+#include <math.h>
+
+/* Every statistic an aggregate can emit */
+#define AGG_VALID_MASK (PLEXUS_AGG_ALL | PLEXUS_AGG_RMS | PLEXUS_AGG_STDDEV)
+
+static const struct {
+    uint8_t bit;
+    const char* suffix;
+} s_agg_stats[] = {
+    { PLEXUS_AGG_MIN,   ".min"   },
+    { PLEXUS_AGG_MAX,   ".max"   },
+    { PLEXUS_AGG_MEAN,  ".mean"  },
+    { PLEXUS_AGG_COUNT, ".count" },
+    { PLEXUS_AGG_SUM,   ".sum"   },
+    { PLEXUS_AGG_RMS,   ".rms"   },
+    { PLEXUS_AGG_STDDEV, ".stddev" },
+};
+
+#define AGG_STAT_COUNT (sizeof(s_agg_stats) / sizeof(s_agg_stats[0]))
+
+static uint8_t agg_point_count(uint8_t mask) {
+    uint8_t n = 0;
+    for (size_t i = 0; i < AGG_STAT_COUNT; i++) {
+        if (mask & s_agg_stats[i].bit) {
+            n++;
+        }
+    }
+    return n;
+}
+
+/** Longest suffix appended for the selected statistics */
+static size_t agg_max_suffix_len(uint8_t mask) {
+    size_t len = 0;
+    for (size_t i = 0; i < AGG_STAT_COUNT; i++) {
+        size_t n = strlen(s_agg_stats[i].suffix);
+        if ((mask & s_agg_stats[i].bit) && n > len) {
+            len = n;
+        }
+    }
+    return len;
+}
+
+static double agg_variance(const plexus_aggregate_t* agg) {
+    double mean = agg->sum / (double)agg->count;
+    double var = agg->sumsq / (double)agg->count - mean * mean;
+    return var > 0.0 ? var : 0.0;
+}
+
+/**
+ * Queue the statistics of the open window and reset the accumulators.
+ *
+ * All points of a window are queued together or not at all: if the buffer
+ * lacks room, the window stays open and is retried on the next call.
+ */
+static plexus_err_t agg_emit(plexus_client_t* client, plexus_aggregate_t* agg) {
+    if (agg->count == 0) {
+        return PLEXUS_OK;
+    }
+    if (client->metric_count + agg_point_count(agg->stats_mask) > client->max_metrics) {
+        return PLEXUS_ERR_BUFFER_FULL;
+    }
+
+    uint64_t now_ms = plexus_hal_get_time_ms();
+    size_t base_len = strlen(agg->name);
+
+    for (size_t i = 0; i < AGG_STAT_COUNT; i++) {
+        if (!(agg->stats_mask & s_agg_stats[i].bit)) {
+            continue;
+        }
+
+        char name[PLEXUS_MAX_METRIC_NAME_LEN];
+        memcpy(name, agg->name, base_len);
+        strcpy(name + base_len, s_agg_stats[i].suffix);
+
+        plexus_value_t v;
+        memset(&v, 0, sizeof(v));
+        v.type = PLEXUS_VALUE_NUMBER;
+        switch (s_agg_stats[i].bit) {
+            case PLEXUS_AGG_MIN:   v.data.number = agg->min; break;
+            case PLEXUS_AGG_MAX:   v.data.number = agg->max; break;
+            case PLEXUS_AGG_MEAN:  v.data.number = agg->sum / (double)agg->count; break;
+            case PLEXUS_AGG_COUNT: v.data.number = (double)agg->count; break;
+            case PLEXUS_AGG_RMS:   v.data.number = sqrt(agg->sumsq / (double)agg->count); break;
+            case PLEXUS_AGG_STDDEV: v.data.number = sqrt(agg_variance(agg)); break;
+            default:               v.data.number = agg->sum; break;
+        }
+
+        plexus_internal_enqueue(client, name, &v, now_ms);
+    }
+
+#if PLEXUS_DEBUG
+    plexus_hal_log("Aggregate %s: closed window of %lu samples",
+                   agg->name, (unsigned long)agg->count);
+#endif
+
+    agg->count = 0;
+    return PLEXUS_OK;
+}
+
+plexus_aggregate_t* plexus_agg_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->aggregate_count; i++) {
+        if (strcmp(client->aggregates[i].name, metric) == 0) {
+            return &client->aggregates[i];
+        }
+    }
+    return NULL;
+}
+
+/** Close the open window if it is overdue; on failure it stays open. */
+static plexus_err_t agg_close_overdue(plexus_client_t* client, plexus_aggregate_t* agg,
+                                      uint32_t now) {
+    if (agg->count > 0 &&
+        plexus_internal_tick_elapsed(now, agg->window_start + agg->window_ms)) {
+        return agg_emit(client, agg);
+    }
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_agg_fold(plexus_client_t* client, plexus_aggregate_t* agg, double value) {
+    uint32_t now = plexus_hal_get_tick_ms();
+
+    /* A full buffer keeps the overdue window open; fold into it rather than lose data */
+    (void)agg_close_overdue(client, agg, now);
+
+    if (agg->count == 0) {
+        agg->window_start = now;
+        agg->sum = 0.0;
+        agg->sumsq = 0.0;
+        agg->min = value;
+        agg->max = value;
+    }
+
+    agg->count++;
+    agg->sum += value;
+    agg->sumsq += value * value;
+    if (value < agg->min) agg->min = value;
+    if (value > agg->max) agg->max = value;
+
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_agg_tick(plexus_client_t* client) {
+    uint32_t now = plexus_hal_get_tick_ms();
+    plexus_err_t result = PLEXUS_OK;
+
+    for (uint8_t i = 0; i < client->aggregate_count; i++) {
+        plexus_aggregate_t* agg = &client->aggregates[i];
+        if (agg->count > 0 &&
+            plexus_internal_tick_elapsed(now, agg->window_start + agg->window_ms)) {
+            plexus_err_t err = agg_emit(client, agg);
+            if (err != PLEXUS_OK) {
+                result = err;
+            }
+        }
+    }
+
+    return result;
+}
+
+void plexus_agg_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms) {
+    for (uint8_t i = 0; i < client->aggregate_count; i++) {
+        const plexus_aggregate_t* agg = &client->aggregates[i];
+        if (agg->count > 0) {
+            plexus_internal_deadline(now, agg->window_start + agg->window_ms, wait_ms);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_aggregate_register(plexus_client_t* client, const char* metric,
+                                        uint32_t window_ms, uint8_t stats_mask) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (window_ms == 0 || (stats_mask & AGG_VALID_MASK) == 0) return PLEXUS_ERR_INVALID_ARG;
+    if (strlen(metric) + agg_max_suffix_len(stats_mask) >= PLEXUS_MAX_METRIC_NAME_LEN) {
+        return PLEXUS_ERR_STRING_TOO_LONG;
+    }
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    /* Re-registering an existing metric updates its window settings */
+    plexus_aggregate_t* agg = plexus_agg_find(client, metric);
+    if (!agg) {
+        if (client->aggregate_count >= PLEXUS_MAX_AGGREGATES) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        agg = &client->aggregates[client->aggregate_count++];
+        memset(agg, 0, sizeof(*agg));
+        strncpy(agg->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    }
+
+    agg->window_ms = window_ms;
+    agg->stats_mask = (uint8_t)(stats_mask & AGG_VALID_MASK);
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_aggregate_send_array(plexus_client_t* client, const char* metric,
+                                          const float* values, size_t count) {
+    if (!client || !metric || (!values && count > 0)) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (count == 0) return PLEXUS_OK;
+    if ((uint64_t)count > UINT32_MAX) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    plexus_aggregate_t* agg = plexus_agg_find(client, metric);
+    if (!agg) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    uint32_t now = plexus_hal_get_tick_ms();
+    /* A full buffer keeps the overdue window open; the block joins it */
+    (void)agg_close_overdue(client, agg, now);
+
+#if PLEXUS_ENABLE_STATS
+    plexus_stats_summary_t block;
+    plexus_stats_summary_f32(values, count, &block);
+#else
+    struct { double sum, sumsq; float min, max; } block = { 0.0, 0.0, values[0], values[0] };
+    for (size_t i = 0; i < count; i++) {
+        block.sum += (double)values[i];
+        block.sumsq += (double)values[i] * (double)values[i];
+        if (values[i] < block.min) block.min = values[i];
+        if (values[i] > block.max) block.max = values[i];
+    }
+#endif
+
+    if (agg->count == 0) {
+        agg->window_start = now;
+        agg->sum = 0.0;
+        agg->sumsq = 0.0;
+        agg->min = block.min;
+        agg->max = block.max;
+    }
+
+    agg->count += (uint32_t)count;
+    agg->sum += block.sum;
+    agg->sumsq += block.sumsq;
+    if (block.min < agg->min) agg->min = block.min;
+    if (block.max > agg->max) agg->max = block.max;
+
+    plexus_err_t err = plexus_internal_maybe_auto_flush(client);
+    PLEXUS_WAKE_IF_SOONER(client);
+
+    PLEXUS_UNLOCK(client);
+    return err;
+}
+
+#endif /* PLEXUS_ENABLE_AGGREGATION */
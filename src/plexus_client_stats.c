@@ -0,0 +1,151 @@
+/**
+ * @file plexus_client_stats.c
+ * @brief Self-telemetry for Plexus C SDK
+ *
+ * Counters are updated inline by the flush, queue and WebSocket paths and
+ * cost a few increments per call. plexus_get_stats() copies them out; an
+ * optional publish interval turns a summary into plexus.* metrics so a
+ * fleet can be tuned from the same dashboard as its data.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_CLIENT_STATS
+
+#include <string.h>
+
+/* Points queued by one publish */
+#define CSTATS_PUBLISH_POINTS 10
+
+static uint8_t latency_bucket(uint32_t latency_ms) {
+    uint8_t bucket = 0;
+    while (latency_ms > 0 && bucket < PLEXUS_LATENCY_BUCKETS - 1) {
+        latency_ms >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+void plexus_client_stats_post(plexus_client_t* client, uint32_t latency_ms, plexus_err_t err) {
+    plexus_client_stats_t* st = &client->cstats;
+    st->posts++;
+    if (err != PLEXUS_OK) {
+        st->post_failures++;
+    }
+    st->post_latency_hist[latency_bucket(latency_ms)]++;
+    st->post_latency_total_ms += latency_ms;
+    if (latency_ms > st->post_latency_max_ms) {
+        st->post_latency_max_ms = latency_ms;
+    }
+}
+
+void plexus_client_stats_serialize(plexus_client_t* client, uint32_t start) {
+    plexus_client_stats_t* st = &client->cstats;
+    uint32_t elapsed = plexus_internal_clock_span_us(start, plexus_internal_clock_stamp());
+    st->serializations++;
+    st->serialize_us_total += elapsed;
+    if (elapsed > st->serialize_us_max) {
+        st->serialize_us_max = elapsed;
+    }
+}
+
+static void fill_derived(const plexus_client_t* client, plexus_client_stats_t* out) {
+    out->bytes_per_point = out->points_posted > 0
+        ? (uint32_t)(out->bytes_posted / out->points_posted) : 0;
+    out->points_sent = (uint32_t)PLEXUS_LOAD_RELAXED(&client->totals.sent);
+    out->queue_depth = client->metric_count;
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+    out->persist_backlog = plexus_internal_persist_backlog();
+#endif
+}
+
+static void publish_point(plexus_client_t* client, const char* metric, double value) {
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+    v.data.number = value;
+    (void)plexus_internal_enqueue(client, metric, &v, 0);
+}
+
+void plexus_client_stats_tick(plexus_client_t* client) {
+    if (client->cstats_interval_ms == 0) {
+        return;
+    }
+    uint32_t now = plexus_hal_get_tick_ms();
+    if (!plexus_internal_tick_elapsed(now, client->cstats_last_publish_ms +
+                                           client->cstats_interval_ms)) {
+        return;
+    }
+    client->cstats_last_publish_ms = now;
+
+    /* All or nothing, and never at the cost of application points */
+    if (client->max_metrics - client->metric_count < CSTATS_PUBLISH_POINTS) {
+        return;
+    }
+
+    plexus_client_stats_t st = client->cstats;
+    fill_derived(client, &st);
+
+    publish_point(client, "plexus.posts", (double)st.posts);
+    publish_point(client, "plexus.post_failures", (double)st.post_failures);
+    publish_point(client, "plexus.post_latency_ms_mean",
+                  st.posts > 0 ? (double)st.post_latency_total_ms / (double)st.posts : 0.0);
+    publish_point(client, "plexus.post_latency_ms_max", (double)st.post_latency_max_ms);
+    publish_point(client, "plexus.bytes_per_point", (double)st.bytes_per_point);
+    publish_point(client, "plexus.retries", (double)st.retries);
+    publish_point(client, "plexus.queue_high_water", (double)st.queue_high_water);
+    publish_point(client, "plexus.drops", (double)st.drops_buffer_full +
+                                          (double)st.drops_persist_overwrite +
+                                          (double)st.drops_persist_corrupt);
+    publish_point(client, "plexus.persist_backlog", (double)st.persist_backlog);
+    publish_point(client, "plexus.ws_reconnects", (double)st.ws_reconnects);
+}
+
+void plexus_client_stats_next_deadline(const plexus_client_t* client, uint32_t now,
+                                       uint32_t* wait_ms) {
+    if (client->cstats_interval_ms > 0) {
+        plexus_internal_deadline(now, client->cstats_last_publish_ms + client->cstats_interval_ms,
+                                 wait_ms);
+    }
+}
+
+plexus_err_t plexus_get_stats(plexus_client_t* client, plexus_client_stats_t* out) {
+    if (!client || !out) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    PLEXUS_LOCK(client);
+    *out = client->cstats;
+    fill_derived(client, out);
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+void plexus_reset_stats(plexus_client_t* client) {
+    if (!client || !client->initialized) {
+        return;
+    }
+    PLEXUS_LOCK(client);
+    memset(&client->cstats, 0, sizeof(client->cstats));
+    PLEXUS_UNLOCK(client);
+}
+
+plexus_err_t plexus_set_stats_publish_interval(plexus_client_t* client, uint32_t interval_ms) {
+    if (!client) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    PLEXUS_LOCK(client);
+    client->cstats_interval_ms = interval_ms;
+    client->cstats_last_publish_ms = plexus_hal_get_tick_ms();
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_CLIENT_STATS */
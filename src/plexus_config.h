@@ -5,17 +5,19 @@
  * Override these defaults by defining them before including plexus.h
  * or via compiler flags (e.g., -DPLEXUS_MAX_METRICS=64)
  *
- * Memory sizing guide (approximate sizeof(plexus_client_t)):
+ * Profiles: -DPLEXUS_PROFILE=PLEXUS_PROFILE_TINY (or _DEFAULT, _GATEWAY)
+ * picks a coherent set of defaults below. Individual -D flags still win
+ * over the profile. Approximate sizeof(plexus_client_t):
  *
- *   Default config:                   ~17 KB
- *   Minimal config (numbers only):    ~1.5 KB
- *     -DPLEXUS_MAX_METRICS=8
- *     -DPLEXUS_ENABLE_TAGS=0
- *     -DPLEXUS_ENABLE_STRING_VALUES=0
- *     -DPLEXUS_ENABLE_BOOL_VALUES=0
- *     -DPLEXUS_JSON_BUFFER_SIZE=512
- *     -DPLEXUS_MAX_ENDPOINT_LEN=128
- *     -DPLEXUS_MAX_API_KEY_LEN=64
+ *   TINY     numbers only, 8-point queue, 512 B JSON      ~1.3 KB
+ *   DEFAULT  the values in this file                      ~17 KB
+ *   GATEWAY  64-point queue, 16 KB JSON, persistent
+ *            buffer, thread safety, status callback       ~46 KB
+ *
+ * Features with their own source file (aggregation, client stats, ...)
+ * stay opt-in in every profile so the build's source list always matches.
+ * `cmake --build <dir> --target size_report` prints the per-field layout,
+ * code size per feature flag and worst-case stack per API for each profile.
  *
  * Use plexus_client_size() at runtime or PLEXUS_CLIENT_STATIC_SIZE
  * at compile time to get the exact size for your configuration.
@@ -24,6 +26,98 @@
 #ifndef PLEXUS_CONFIG_H
 #define PLEXUS_CONFIG_H
 
+/* Memory profiles */
+#define PLEXUS_PROFILE_TINY    1       /* Small MCUs: numbers only, minimal buffers */
+#define PLEXUS_PROFILE_DEFAULT 2       /* The defaults below */
+#define PLEXUS_PROFILE_GATEWAY 3       /* Mains-powered hubs relaying many sensors */
+
+#ifndef PLEXUS_PROFILE
+#define PLEXUS_PROFILE PLEXUS_PROFILE_DEFAULT
+#endif
+
+#if PLEXUS_PROFILE == PLEXUS_PROFILE_TINY
+#ifndef PLEXUS_MAX_METRICS
+#define PLEXUS_MAX_METRICS 8
+#endif
+#ifndef PLEXUS_MAX_METRIC_NAME_LEN
+#define PLEXUS_MAX_METRIC_NAME_LEN 32
+#endif
+#ifndef PLEXUS_MAX_SOURCE_ID_LEN
+#define PLEXUS_MAX_SOURCE_ID_LEN 32
+#endif
+#ifndef PLEXUS_MAX_SESSION_ID_LEN
+#define PLEXUS_MAX_SESSION_ID_LEN 32
+#endif
+#ifndef PLEXUS_MAX_API_KEY_LEN
+#define PLEXUS_MAX_API_KEY_LEN 64
+#endif
+#ifndef PLEXUS_MAX_ENDPOINT_LEN
+#define PLEXUS_MAX_ENDPOINT_LEN 128
+#endif
+#ifndef PLEXUS_JSON_BUFFER_SIZE
+#define PLEXUS_JSON_BUFFER_SIZE 512
+#endif
+#ifndef PLEXUS_AUTO_FLUSH_COUNT
+#define PLEXUS_AUTO_FLUSH_COUNT 6      /* Flush before the 8-slot queue fills */
+#endif
+#ifndef PLEXUS_ENABLE_TAGS
+#define PLEXUS_ENABLE_TAGS 0
+#endif
+#ifndef PLEXUS_ENABLE_STRING_VALUES
+#define PLEXUS_ENABLE_STRING_VALUES 0
+#endif
+#ifndef PLEXUS_ENABLE_BOOL_VALUES
+#define PLEXUS_ENABLE_BOOL_VALUES 0
+#endif
+#ifndef PLEXUS_MAX_COMMANDS
+#define PLEXUS_MAX_COMMANDS 4
+#endif
+#ifndef PLEXUS_COMMAND_QUEUE_SIZE
+#define PLEXUS_COMMAND_QUEUE_SIZE 2
+#endif
+#ifndef PLEXUS_WS_RECV_BUFFER_SIZE
+#define PLEXUS_WS_RECV_BUFFER_SIZE 256
+#endif
+#ifndef PLEXUS_CACHE_LINE_SIZE
+#define PLEXUS_CACHE_LINE_SIZE 0       /* Single core, no data cache */
+#endif
+
+#elif PLEXUS_PROFILE == PLEXUS_PROFILE_GATEWAY
+#ifndef PLEXUS_MAX_METRICS
+#define PLEXUS_MAX_METRICS 64
+#endif
+#ifndef PLEXUS_JSON_BUFFER_SIZE
+#define PLEXUS_JSON_BUFFER_SIZE 16384
+#endif
+#ifndef PLEXUS_AUTO_FLUSH_COUNT
+#define PLEXUS_AUTO_FLUSH_COUNT 48
+#endif
+#ifndef PLEXUS_ENABLE_PERSISTENT_BUFFER
+#define PLEXUS_ENABLE_PERSISTENT_BUFFER 1
+#endif
+#ifndef PLEXUS_PERSIST_MAX_BATCHES
+#define PLEXUS_PERSIST_MAX_BATCHES 32
+#endif
+#ifndef PLEXUS_ENABLE_STATUS_CALLBACK
+#define PLEXUS_ENABLE_STATUS_CALLBACK 1
+#endif
+#ifndef PLEXUS_ENABLE_THREAD_SAFE
+#define PLEXUS_ENABLE_THREAD_SAFE 1
+#endif
+#ifndef PLEXUS_MAX_COMMANDS
+#define PLEXUS_MAX_COMMANDS 16
+#endif
+#ifndef PLEXUS_COMMAND_QUEUE_SIZE
+#define PLEXUS_COMMAND_QUEUE_SIZE 8
+#endif
+#ifndef PLEXUS_WS_RECV_BUFFER_SIZE
+#define PLEXUS_WS_RECV_BUFFER_SIZE 2048
+#endif
+
+#elif PLEXUS_PROFILE != PLEXUS_PROFILE_DEFAULT
+#error "PLEXUS_PROFILE must be PLEXUS_PROFILE_TINY, PLEXUS_PROFILE_DEFAULT or PLEXUS_PROFILE_GATEWAY"
+#endif
+
 /* Buffer sizes */
 #ifndef PLEXUS_MAX_METRICS
 #define PLEXUS_MAX_METRICS 32          /* Max metrics per flush */
@@ -133,6 +227,200 @@
 #define PLEXUS_ENABLE_THREAD_SAFE 0        /* Enable mutex-protected client access */
 #endif
 
+/* On-device windowed aggregation (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_AGGREGATION
+#define PLEXUS_ENABLE_AGGREGATION 0        /* Fold samples into per-window min/max/mean/count/sum */
+#endif
+
+#ifndef PLEXUS_MAX_AGGREGATES
+#define PLEXUS_MAX_AGGREGATES 8            /* Max metrics registered for aggregation */
+#endif
+
+/* Array statistics kernels (on with aggregation, which uses them) */
+#ifndef PLEXUS_ENABLE_STATS
+#define PLEXUS_ENABLE_STATS PLEXUS_ENABLE_AGGREGATION /* plexus_stats_* min/max/mean/RMS/variance */
+#endif
+
+#ifndef PLEXUS_STATS_SIMD
+#define PLEXUS_STATS_SIMD 1                /* Use SSE2/AVX2 when the compiler targets them (else portable C) */
+#endif
+
+/* Portable kernel accumulator width: float lanes on FPUs without double precision */
+#ifndef PLEXUS_STATS_FLOAT_ACCUM
+  #if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86) || \
+      defined(__aarch64__) || defined(_M_ARM64) || (defined(__ARM_FP) && (__ARM_FP & 8))
+    #define PLEXUS_STATS_FLOAT_ACCUM 0     /* Hardware double: accumulate in double */
+  #else
+    #define PLEXUS_STATS_FLOAT_ACCUM 1     /* Cortex-M4F, ESP32-S3: Kahan-compensated float lanes */
+  #endif
+#endif
+
+/* Report-by-exception deadband filtering (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_DEADBAND
+#define PLEXUS_ENABLE_DEADBAND 0           /* Drop numeric samples within a deadband of the last sent value */
+#endif
+
+#ifndef PLEXUS_MAX_DEADBANDS
+#define PLEXUS_MAX_DEADBANDS 8             /* Max metrics with a deadband configured */
+#endif
+
+/* Swinging-door trending compression (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_SDT
+#define PLEXUS_ENABLE_SDT 0                /* Queue only piecewise-linear segment endpoints */
+#endif
+
+#ifndef PLEXUS_MAX_SDT
+#define PLEXUS_MAX_SDT 8                   /* Max metrics with SDT compression */
+#endif
+
+/* Streaming quantile sketches (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_SKETCHES
+#define PLEXUS_ENABLE_SKETCHES 0           /* DDSketch-style quantile metrics via plexus_observe() */
+#endif
+
+#ifndef PLEXUS_MAX_SKETCHES
+#define PLEXUS_MAX_SKETCHES 4              /* Max registered sketch metrics */
+#endif
+
+#ifndef PLEXUS_SKETCH_BINS
+#define PLEXUS_SKETCH_BINS 64              /* Log-spaced bins per sketch (lowest bins collapse when exceeded) */
+#endif
+
+/* Counter / gauge / rate metric kinds (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_COUNTERS
+#define PLEXUS_ENABLE_COUNTERS 0           /* Per-window deltas, rates and coalesced gauges */
+#endif
+
+#ifndef PLEXUS_MAX_COUNTERS
+#define PLEXUS_MAX_COUNTERS 8              /* Max registered counter/gauge/rate metrics */
+#endif
+
+/* Waveform downsampling (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_DOWNSAMPLE
+#define PLEXUS_ENABLE_DOWNSAMPLE 0         /* LTTB / min-max decimation of high-rate metrics per flush */
+#endif
+
+#ifndef PLEXUS_MAX_DOWNSAMPLED
+#define PLEXUS_MAX_DOWNSAMPLED 2           /* Max downsampled metrics */
+#endif
+
+#ifndef PLEXUS_DOWNSAMPLE_CAPACITY
+#define PLEXUS_DOWNSAMPLE_CAPACITY 256     /* Raw samples held per metric (8 bytes each) before compacting */
+#endif
+
+/* Trigger-based burst capture (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_TRIGGER
+#define PLEXUS_ENABLE_TRIGGER 0            /* Pre-trigger ring + post-trigger window per metric */
+#endif
+
+#ifndef PLEXUS_MAX_TRIGGERS
+#define PLEXUS_MAX_TRIGGERS 2              /* Max metrics with burst capture */
+#endif
+
+#ifndef PLEXUS_TRIGGER_RING_SIZE
+#define PLEXUS_TRIGGER_RING_SIZE 64        /* Samples per capture ring (16 bytes each) */
+#endif
+
+/* Last-value cache (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_LAST_VALUE
+#define PLEXUS_ENABLE_LAST_VALUE 0         /* Keep the latest value of every metric for snapshots */
+#endif
+
+#ifndef PLEXUS_MAX_LAST_VALUES
+#define PLEXUS_MAX_LAST_VALUES 32          /* Cached metrics, max 255 (~88 bytes each) */
+#endif
+
+/* On-device history rings (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_HISTORY
+#define PLEXUS_ENABLE_HISTORY 0            /* Recent per-metric history served by the "history" command */
+#endif
+
+#ifndef PLEXUS_MAX_HISTORY
+#define PLEXUS_MAX_HISTORY 4               /* Max metrics with a history ring */
+#endif
+
+#ifndef PLEXUS_HISTORY_SIZE
+#define PLEXUS_HISTORY_SIZE 120            /* Entries per ring (8 bytes each), max 65535 */
+#endif
+
+/* Client self-telemetry (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_CLIENT_STATS
+#define PLEXUS_ENABLE_CLIENT_STATS 0       /* Flush latency, queue and drop counters via plexus_get_stats() */
+#endif
+
+#ifndef PLEXUS_LATENCY_BUCKETS
+#define PLEXUS_LATENCY_BUCKETS 12          /* Log2 post-latency buckets: <1 ms ... >= 1024 ms */
+#endif
+
+/* Phase trace hooks (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_TRACE
+#define PLEXUS_ENABLE_TRACE 0              /* Begin/end callbacks around flush phases and WS state changes */
+#endif
+
+/* Tickless wake hook (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_WAKE_CALLBACK
+#define PLEXUS_ENABLE_WAKE_CALLBACK 0      /* plexus_on_wake() when new work moves the next deadline earlier */
+#endif
+
+/* ISR staging ring (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_ISR_QUEUE
+#define PLEXUS_ENABLE_ISR_QUEUE 0          /* plexus_send_from_isr(), drained into the queue by plexus_tick() */
+#endif
+
+#ifndef PLEXUS_ISR_QUEUE_SIZE
+#define PLEXUS_ISR_QUEUE_SIZE 16           /* Ring slots, power of two; one stays empty */
+#endif
+
+#if PLEXUS_ENABLE_ISR_QUEUE && \
+    (PLEXUS_ISR_QUEUE_SIZE < 2 || (PLEXUS_ISR_QUEUE_SIZE & (PLEXUS_ISR_QUEUE_SIZE - 1)) != 0)
+#error "PLEXUS_ISR_QUEUE_SIZE must be a power of two of at least 2"
+#endif
+
+/* Per-thread staging buffers (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_THREAD_STAGING
+#define PLEXUS_ENABLE_THREAD_STAGING 0     /* plexus_send_staged(): lock-free per-thread rings merged at flush */
+#endif
+
+#ifndef PLEXUS_MAX_STAGES
+#define PLEXUS_MAX_STAGES 16               /* Producer threads with a stage; others use the locked path */
+#endif
+
+#ifndef PLEXUS_STAGE_SIZE
+#define PLEXUS_STAGE_SIZE 32               /* Slots per stage, power of two; one stays empty */
+#endif
+
+#if PLEXUS_ENABLE_THREAD_STAGING
+#if !PLEXUS_ENABLE_THREAD_SAFE
+#error "PLEXUS_ENABLE_THREAD_STAGING requires PLEXUS_ENABLE_THREAD_SAFE"
+#endif
+#if PLEXUS_STAGE_SIZE < 2 || (PLEXUS_STAGE_SIZE & (PLEXUS_STAGE_SIZE - 1)) != 0
+#error "PLEXUS_STAGE_SIZE must be a power of two of at least 2"
+#endif
+#endif
+
+/* Shared transport across clients (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_SHARED_TRANSPORT
+#define PLEXUS_ENABLE_SHARED_TRANSPORT 0   /* plexus_transport_t: one endpoint, buffer and backoff, coalesced posts */
+#endif
+
+#ifndef PLEXUS_MAX_TRANSPORT_CLIENTS
+#define PLEXUS_MAX_TRANSPORT_CLIENTS 4     /* Clients one transport can carry */
+#endif
+
+#ifndef PLEXUS_TRANSPORT_BUFFER_SIZE
+#define PLEXUS_TRANSPORT_BUFFER_SIZE (2 * PLEXUS_JSON_BUFFER_SIZE) /* Coalesced request body */
+#endif
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT && \
+    (PLEXUS_MAX_TRANSPORT_CLIENTS < 1 || PLEXUS_MAX_TRANSPORT_CLIENTS > 32)
+#error "PLEXUS_MAX_TRANSPORT_CLIENTS must be between 1 and 32"
+#endif
+
+/* Scoped latency timers in plexus.hpp (compile-time opt-in) */
+#ifndef PLEXUS_ENABLE_TIMING
+#define PLEXUS_ENABLE_TIMING 0             /* Needs plexus_hal_get_cycles(); off = PLEXUS_TIME_SCOPE is a no-op */
+#endif
+
 /* ========================================================================= */
 /* WebSocket support (compile-time opt-in)                                   */
 /* ========================================================================= */
@@ -185,6 +473,24 @@
 #define PLEXUS_MAX_ORG_ID_LEN 64               /* Max organization ID length */
 #endif
 
+/* Lifetime totals (plexus_get_totals(), read without the client lock) */
+#ifndef PLEXUS_TOTALS_64BIT
+  #if defined(__GCC_ATOMIC_LLONG_LOCK_FREE) && __GCC_ATOMIC_LLONG_LOCK_FREE == 2
+    #define PLEXUS_TOTALS_64BIT 1          /* Lock-free 64-bit loads/stores (x86-64, AArch64) */
+  #else
+    #define PLEXUS_TOTALS_64BIT 0          /* 32-bit totals, never torn on 32-bit cores */
+  #endif
+#endif
+
+/* Padding on each side of the totals block; 0 = none */
+#ifndef PLEXUS_CACHE_LINE_SIZE
+  #if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64)
+    #define PLEXUS_CACHE_LINE_SIZE 64      /* Hosted multi-core: keep readers off the send path's line */
+  #else
+    #define PLEXUS_CACHE_LINE_SIZE 0       /* MCUs: no coherent data cache worth 128 bytes per client */
+  #endif
+#endif
+
 /* Debug settings */
 #ifndef PLEXUS_DEBUG
 #define PLEXUS_DEBUG 0                 /* Enable debug logging */
@@ -0,0 +1,229 @@
+/**
+ * @file plexus_counter.c
+ * @brief Counter, gauge and rate metrics for Plexus C SDK
+ *
+ * Registered metrics keep per-metric state instead of queuing a point per
+ * call. Counters and rates turn monotonic cumulative readings into per-window
+ * increases (with reset detection); gauges keep only the last value. Each
+ * window costs one point regardless of how many updates it received.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_COUNTERS
+
+#include <string.h>
+#include <math.h>
+
+static uint32_t counter_window_ms(const plexus_client_t* client, const plexus_counter_t* ctr) {
+    if (ctr->window_ms > 0) {
+        return ctr->window_ms;
+    }
+    return client->flush_interval_ms > 0
+        ? client->flush_interval_ms : PLEXUS_AUTO_FLUSH_INTERVAL_MS;
+}
+
+static bool counter_window_due(const plexus_client_t* client, const plexus_counter_t* ctr,
+                               uint32_t now) {
+    return ctr->open &&
+           plexus_internal_tick_elapsed(now, ctr->window_start + counter_window_ms(client, ctr));
+}
+
+/**
+ * Queue the point for the open window and reset it. If the buffer is full
+ * the window stays open and keeps accumulating.
+ */
+static plexus_err_t counter_emit(plexus_client_t* client, plexus_counter_t* ctr, uint32_t now) {
+    if (!ctr->open) {
+        return PLEXUS_OK;
+    }
+
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+    v.data.number = ctr->value;
+
+    if (ctr->kind == PLEXUS_KIND_RATE) {
+        /* Per second of the span the increase covers, quiet time before the
+         * window included; readings cover up to the last one */
+        uint32_t end = ctr->has_reading ? ctr->quiet_since : now;
+        uint32_t elapsed = end - ctr->rate_start;
+        if (elapsed == 0) {
+            elapsed = 1;
+        }
+        v.data.number = ctr->value * 1000.0 / (double)elapsed;
+    }
+
+    plexus_err_t err = plexus_internal_enqueue(client, ctr->name, &v, 0);
+    if (err != PLEXUS_OK) {
+        return err;
+    }
+
+    ctr->open = false;
+    if (ctr->kind != PLEXUS_KIND_GAUGE) {
+        ctr->value = 0.0;
+    }
+    if (!ctr->has_reading) {
+        ctr->quiet_since = now;
+    }
+    return PLEXUS_OK;
+}
+
+/**
+ * Close an overdue window and make sure one is open for an update.
+ *
+ * A full buffer keeps the overdue window open: the update is folded into it
+ * and plexus_tick() retries the emit, so no increments are lost.
+ */
+static void counter_begin_update(plexus_client_t* client, plexus_counter_t* ctr) {
+    uint32_t now = plexus_hal_get_tick_ms();
+
+    if (counter_window_due(client, ctr, now)) {
+        (void)counter_emit(client, ctr, now);
+    }
+
+    if (!ctr->open) {
+        ctr->open = true;
+        ctr->window_start = now;
+        ctr->rate_start = ctr->quiet_since;
+    }
+}
+
+plexus_counter_t* plexus_counter_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->counter_count; i++) {
+        if (strcmp(client->counters[i].name, metric) == 0) {
+            return &client->counters[i];
+        }
+    }
+    return NULL;
+}
+
+plexus_err_t plexus_counter_update(plexus_client_t* client, plexus_counter_t* ctr, double value) {
+    if (ctr->kind == PLEXUS_KIND_GAUGE) {
+        counter_begin_update(client, ctr);
+        ctr->value = value;
+        return PLEXUS_OK;
+    }
+
+    /* NaN or infinite readings would poison the baseline — reject them */
+    if (isnan(value) || isinf(value)) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    if (!ctr->has_reading) {
+        /* First reading only establishes the baseline */
+        ctr->last_reading = value;
+        ctr->has_reading = true;
+        ctr->quiet_since = plexus_hal_get_tick_ms();
+        return PLEXUS_OK;
+    }
+
+    counter_begin_update(client, ctr);
+
+    if (value >= ctr->last_reading) {
+        ctr->value += value - ctr->last_reading;
+    } else {
+        /* Counter reset (device reboot, wraparound): it restarted from zero */
+#if PLEXUS_DEBUG
+        plexus_hal_log("Counter %s: reset detected", ctr->name);
+#endif
+        ctr->value += value > 0.0 ? value : 0.0;
+    }
+    ctr->last_reading = value;
+    ctr->quiet_since = plexus_hal_get_tick_ms();
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_counter_tick(plexus_client_t* client) {
+    uint32_t now = plexus_hal_get_tick_ms();
+    plexus_err_t result = PLEXUS_OK;
+
+    for (uint8_t i = 0; i < client->counter_count; i++) {
+        plexus_counter_t* ctr = &client->counters[i];
+        if (counter_window_due(client, ctr, now)) {
+            plexus_err_t err = counter_emit(client, ctr, now);
+            if (err != PLEXUS_OK) {
+                result = err;
+            }
+        }
+    }
+
+    return result;
+}
+
+void plexus_counter_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms) {
+    for (uint8_t i = 0; i < client->counter_count; i++) {
+        const plexus_counter_t* ctr = &client->counters[i];
+        if (ctr->open) {
+            plexus_internal_deadline(now, ctr->window_start + counter_window_ms(client, ctr),
+                                     wait_ms);
+        }
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_counter_register(plexus_client_t* client, const char* metric,
+                                      plexus_metric_kind_t kind, uint32_t window_ms) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (kind != PLEXUS_KIND_GAUGE && kind != PLEXUS_KIND_COUNTER && kind != PLEXUS_KIND_RATE) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) return PLEXUS_ERR_STRING_TOO_LONG;
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    /* Re-registering updates the window; changing the kind restarts state */
+    plexus_counter_t* ctr = plexus_counter_find(client, metric);
+    if (!ctr) {
+        if (client->counter_count >= PLEXUS_MAX_COUNTERS) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        ctr = &client->counters[client->counter_count++];
+        memset(ctr, 0, sizeof(*ctr));
+        strncpy(ctr->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+        ctr->kind = (uint8_t)kind;
+        ctr->quiet_since = plexus_hal_get_tick_ms();
+    } else if (ctr->kind != (uint8_t)kind) {
+        memset(ctr, 0, sizeof(*ctr));
+        strncpy(ctr->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+        ctr->kind = (uint8_t)kind;
+        ctr->quiet_since = plexus_hal_get_tick_ms();
+    }
+
+    ctr->window_ms = window_ms;
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_counter_add(plexus_client_t* client, const char* metric, double increment) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (!(increment >= 0.0) || isinf(increment)) {
+        return PLEXUS_ERR_INVALID_ARG; /* Negative, NaN or infinite */
+    }
+
+    PLEXUS_LOCK(client);
+
+    plexus_counter_t* ctr = plexus_counter_find(client, metric);
+    if (!ctr || ctr->kind == PLEXUS_KIND_GAUGE) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    counter_begin_update(client, ctr);
+    ctr->value += increment;
+    plexus_err_t err = plexus_internal_maybe_auto_flush(client);
+    PLEXUS_WAKE_IF_SOONER(client);
+
+    PLEXUS_UNLOCK(client);
+    return err;
+}
+
+#endif /* PLEXUS_ENABLE_COUNTERS */
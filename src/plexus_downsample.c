@@ -0,0 +1,241 @@
+/**
+ * @file plexus_downsample.c
+ * @brief Waveform downsampling for Plexus C SDK
+ *
+ * High-rate metrics are buffered as (dt, float) pairs and reduced to a fixed
+ * number of points when the batch is flushed. Both algorithms select a
+ * subset of the raw samples (no interpolation), so every emitted point is a
+ * real measurement with its real timestamp.
+ *
+ * Reduction works in place: each output index is never ahead of the input
+ * index it is copied from, so no scratch buffer is needed.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_DOWNSAMPLE
+
+#include <string.h>
+
+static uint16_t min_target(uint8_t method) {
+    return method == PLEXUS_DOWNSAMPLE_LTTB ? 3 : 2;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Reduction                                                                 */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Largest-Triangle-Three-Buckets (Steinarsson, 2013).
+ *
+ * First and last samples are kept. The rest are split into m - 2 buckets;
+ * from each bucket the sample forming the largest triangle with the
+ * previously selected point and the average of the next bucket is kept.
+ */
+static uint16_t reduce_lttb(plexus_downsample_sample_t* s, uint16_t n, uint16_t m) {
+    double every = (double)(n - 2) / (double)(m - 2);
+    plexus_downsample_sample_t a = s[0];
+    plexus_downsample_sample_t last = s[n - 1];
+    uint16_t out = 1;
+
+    for (uint16_t i = 0; i < m - 2; i++) {
+        /* Average of the next bucket (the last point for the final bucket) */
+        uint16_t next_start = (uint16_t)((double)(i + 1) * every) + 1;
+        uint16_t next_end = (uint16_t)((double)(i + 2) * every) + 1;
+        if (next_end > n) next_end = n;
+        double avg_x = 0.0;
+        double avg_y = 0.0;
+        if (next_start >= next_end) {
+            avg_x = (double)last.dt_ms;
+            avg_y = (double)last.value;
+        } else {
+            for (uint16_t j = next_start; j < next_end; j++) {
+                avg_x += (double)s[j].dt_ms;
+                avg_y += (double)s[j].value;
+            }
+            avg_x /= (double)(next_end - next_start);
+            avg_y /= (double)(next_end - next_start);
+        }
+
+        /* Pick the point in this bucket with the largest triangle */
+        uint16_t start = (uint16_t)((double)i * every) + 1;
+        uint16_t end = next_start;
+        double ax = (double)a.dt_ms;
+        double ay = (double)a.value;
+        double best_area = -1.0;
+        uint16_t best = start;
+        for (uint16_t j = start; j < end; j++) {
+            double area = (ax - avg_x) * ((double)s[j].value - ay) -
+                          (ax - (double)s[j].dt_ms) * (avg_y - ay);
+            if (area < 0) area = -area;
+            if (area > best_area) {
+                best_area = area;
+                best = j;
+            }
+        }
+
+        a = s[best];
+        s[out++] = a;
+    }
+
+    s[out++] = last;
+    return out;
+}
+
+/**
+ * Min-max decimation: m / 2 equal buckets, each contributing its minimum
+ * and maximum in time order.
+ */
+static uint16_t reduce_minmax(plexus_downsample_sample_t* s, uint16_t n, uint16_t m) {
+    uint16_t buckets = m / 2;
+    uint16_t out = 0;
+
+    for (uint16_t b = 0; b < buckets; b++) {
+        uint16_t start = (uint16_t)((uint32_t)b * n / buckets);
+        uint16_t end = (uint16_t)((uint32_t)(b + 1) * n / buckets);
+
+        uint16_t lo = start;
+        uint16_t hi = start;
+        for (uint16_t j = start + 1; j < end; j++) {
+            if (s[j].value < s[lo].value) lo = j;
+            if (s[j].value > s[hi].value) hi = j;
+        }
+
+        plexus_downsample_sample_t first = s[lo < hi ? lo : hi];
+        plexus_downsample_sample_t second = s[lo < hi ? hi : lo];
+        s[out++] = first;
+        if (lo != hi) {
+            s[out++] = second;
+        }
+    }
+
+    return out;
+}
+
+uint16_t plexus_downsample_reduce(plexus_downsample_sample_t* s, uint16_t n, uint16_t m,
+                                  uint8_t method) {
+    if (n <= m || m < min_target(method)) {
+        return n;
+    }
+    if (method == PLEXUS_DOWNSAMPLE_MINMAX) {
+        return reduce_minmax(s, n, m);
+    }
+    return reduce_lttb(s, n, m);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Buffering and drain                                                       */
+/* ------------------------------------------------------------------------- */
+
+plexus_downsample_t* plexus_downsample_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->downsample_count; i++) {
+        if (strcmp(client->downsampled[i].name, metric) == 0) {
+            return &client->downsampled[i];
+        }
+    }
+    return NULL;
+}
+
+void plexus_downsample_append(plexus_downsample_t* ds, double value, uint64_t timestamp_ms) {
+    if (ds->count >= PLEXUS_DOWNSAMPLE_CAPACITY) {
+        /* Full before a flush: compact to the target and keep capturing */
+        ds->count = plexus_downsample_reduce(ds->samples, ds->count, ds->target, ds->method);
+    }
+
+    if (ds->count == 0) {
+        ds->base_ts = timestamp_ms;
+    }
+
+    uint64_t dt = timestamp_ms > ds->base_ts ? timestamp_ms - ds->base_ts : 0;
+    plexus_downsample_sample_t* smp = &ds->samples[ds->count++];
+    smp->dt_ms = dt > UINT32_MAX ? UINT32_MAX : (uint32_t)dt;
+    smp->value = (float)value;
+}
+
+bool plexus_downsample_pending(const plexus_client_t* client) {
+    for (uint8_t i = 0; i < client->downsample_count; i++) {
+        if (client->downsampled[i].count > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+plexus_err_t plexus_downsample_drain(plexus_client_t* client) {
+    plexus_err_t result = PLEXUS_OK;
+
+    for (uint8_t i = 0; i < client->downsample_count; i++) {
+        plexus_downsample_t* ds = &client->downsampled[i];
+        if (ds->count == 0) {
+            continue;
+        }
+
+        /* Reduce to whatever fits; if not even the minimum fits, wait */
+        uint16_t room = (uint16_t)(client->max_metrics - client->metric_count);
+        uint16_t m = ds->target < room ? ds->target : room;
+        if (ds->count > m && m < min_target(ds->method)) {
+            result = PLEXUS_ERR_BUFFER_FULL;
+            continue;
+        }
+        uint16_t n = plexus_downsample_reduce(ds->samples, ds->count, m, ds->method);
+
+        for (uint16_t j = 0; j < n; j++) {
+            plexus_value_t v;
+            memset(&v, 0, sizeof(v));
+            v.type = PLEXUS_VALUE_NUMBER;
+            v.data.number = (double)ds->samples[j].value;
+            plexus_internal_enqueue(client, ds->name, &v, ds->base_ts + ds->samples[j].dt_ms);
+        }
+
+#if PLEXUS_DEBUG
+        plexus_hal_log("Downsample %s: %u samples -> %u points",
+                       ds->name, (unsigned)ds->count, (unsigned)n);
+#endif
+        ds->count = 0;
+    }
+
+    return result;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_downsample_register(plexus_client_t* client, const char* metric,
+                                         uint16_t target_points,
+                                         plexus_downsample_method_t method) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (method != PLEXUS_DOWNSAMPLE_LTTB && method != PLEXUS_DOWNSAMPLE_MINMAX) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+    if (target_points < min_target((uint8_t)method) ||
+        target_points > client->max_metrics ||
+        target_points >= PLEXUS_DOWNSAMPLE_CAPACITY) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) return PLEXUS_ERR_STRING_TOO_LONG;
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    /* Re-registering updates the target; buffered samples are kept */
+    plexus_downsample_t* ds = plexus_downsample_find(client, metric);
+    if (!ds) {
+        if (client->downsample_count >= PLEXUS_MAX_DOWNSAMPLED) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        ds = &client->downsampled[client->downsample_count++];
+        memset(ds, 0, sizeof(*ds));
+        strncpy(ds->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    }
+
+    ds->target = target_points;
+    ds->method = (uint8_t)method;
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_DOWNSAMPLE */
@@ -0,0 +1,260 @@
+/**
+ * @file plexus_filter.c
+ * @brief Report-by-exception filters for Plexus C SDK
+ *
+ * Filters run in the send path before a numeric sample is queued and drop
+ * samples that add no information. For slowly-changing values a deadband
+ * turns plexus_send_number() into a comparison against the last sent value;
+ * for smooth signals swinging-door compression keeps only the endpoints of
+ * piecewise-linear segments.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_DEADBAND || PLEXUS_ENABLE_SDT
+
+#include <string.h>
+#include <math.h>
+
+#endif
+
+#if PLEXUS_ENABLE_DEADBAND
+
+/* ------------------------------------------------------------------------- */
+/* Deadband                                                                  */
+/* ------------------------------------------------------------------------- */
+
+plexus_deadband_t* plexus_deadband_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->deadband_count; i++) {
+        if (strcmp(client->deadbands[i].name, metric) == 0) {
+            return &client->deadbands[i];
+        }
+    }
+    return NULL;
+}
+
+bool plexus_deadband_suppress(const plexus_deadband_t* db, double value) {
+    if (!db->has_last) {
+        return false;
+    }
+
+    /* Heartbeat: let one sample through after max_silence_ms */
+    if (db->max_silence_ms > 0 &&
+        plexus_internal_tick_elapsed(plexus_hal_get_tick_ms(),
+                                     db->last_sent_ms + db->max_silence_ms)) {
+        return false;
+    }
+
+    double delta = value - db->last_value;
+    if (delta < 0) delta = -delta;
+
+    double band = db->threshold;
+    if (db->mode == PLEXUS_DEADBAND_PERCENT) {
+        double ref = db->last_value < 0 ? -db->last_value : db->last_value;
+        band = ref * db->threshold / 100.0;
+    }
+
+    /* NaN compares false, so NaN samples (or a NaN last value) always pass */
+    return delta <= band;
+}
+
+void plexus_deadband_commit(plexus_deadband_t* db, double value) {
+    db->last_value = value;
+    db->last_sent_ms = plexus_hal_get_tick_ms();
+    db->has_last = true;
+}
+
+plexus_err_t plexus_set_deadband(plexus_client_t* client, const char* metric,
+                                  double threshold, plexus_deadband_mode_t mode,
+                                  uint32_t max_silence_ms) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) return PLEXUS_ERR_STRING_TOO_LONG;
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+    if (!(threshold >= 0.0)) return PLEXUS_ERR_INVALID_ARG; /* Also rejects NaN */
+    if (mode != PLEXUS_DEADBAND_ABSOLUTE && mode != PLEXUS_DEADBAND_PERCENT) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    PLEXUS_LOCK(client);
+
+    plexus_deadband_t* db = plexus_deadband_find(client, metric);
+    if (!db) {
+        if (client->deadband_count >= PLEXUS_MAX_DEADBANDS) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        db = &client->deadbands[client->deadband_count++];
+        memset(db, 0, sizeof(*db));
+        strncpy(db->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    }
+
+    db->threshold = threshold;
+    db->mode = mode;
+    db->max_silence_ms = max_silence_ms;
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_DEADBAND */
+
+#if PLEXUS_ENABLE_SDT
+
+/* ------------------------------------------------------------------------- */
+/* Swinging-door trending                                                    */
+/* ------------------------------------------------------------------------- */
+
+static void sdt_queue(plexus_client_t* client, const plexus_sdt_t* sdt,
+                      double value, uint64_t timestamp_ms) {
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+    v.data.number = value;
+    plexus_internal_enqueue(client, sdt->name, &v, timestamp_ms);
+}
+
+/* Make the last queued point the start of a new, fully open corridor */
+static void sdt_archive(plexus_sdt_t* sdt, double value, uint64_t timestamp_ms) {
+    sdt->archived_value = value;
+    sdt->archived_ts = timestamp_ms;
+    sdt->last_archive_ms = plexus_hal_get_tick_ms();
+    sdt->slope_upper = HUGE_VAL;
+    sdt->slope_lower = -HUGE_VAL;
+    sdt->has_archive = true;
+    sdt->has_held = false;
+}
+
+/**
+ * End the current segment at the held sample and queue this sample too.
+ * Used when the corridor cannot be continued (heartbeat, NaN, time going
+ * backwards). Nothing changes if the buffer lacks room for both points.
+ */
+static plexus_err_t sdt_restart(plexus_client_t* client, plexus_sdt_t* sdt,
+                                double value, uint64_t timestamp_ms) {
+    uint16_t needed = sdt->has_held ? 2 : 1;
+    if (client->metric_count + needed > client->max_metrics) {
+        return PLEXUS_ERR_BUFFER_FULL;
+    }
+    if (sdt->has_held) {
+        sdt_queue(client, sdt, sdt->held_value, sdt->held_ts);
+    }
+    sdt_queue(client, sdt, value, timestamp_ms);
+    sdt_archive(sdt, value, timestamp_ms);
+    return PLEXUS_OK;
+}
+
+plexus_sdt_t* plexus_sdt_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->sdt_count; i++) {
+        if (strcmp(client->sdt[i].name, metric) == 0) {
+            return &client->sdt[i];
+        }
+    }
+    return NULL;
+}
+
+plexus_err_t plexus_sdt_update(plexus_client_t* client, plexus_sdt_t* sdt,
+                               double value, uint64_t timestamp_ms) {
+    if (isnan(value)) {
+        /* No line passes through NaN: send it and start over afterwards */
+        plexus_err_t err = sdt_restart(client, sdt, value, timestamp_ms);
+        if (err == PLEXUS_OK) {
+            sdt->has_archive = false;
+        }
+        return err;
+    }
+
+    if (!sdt->has_archive || timestamp_ms <= sdt->archived_ts ||
+        (sdt->has_held && timestamp_ms <= sdt->held_ts)) {
+        return sdt_restart(client, sdt, value, timestamp_ms);
+    }
+
+    if (sdt->max_silence_ms > 0 &&
+        plexus_internal_tick_elapsed(plexus_hal_get_tick_ms(),
+                                     sdt->last_archive_ms + sdt->max_silence_ms)) {
+        return sdt_restart(client, sdt, value, timestamp_ms);
+    }
+
+    /* Narrow the corridor with this sample's +/- error_bound door */
+    double dt = (double)(timestamp_ms - sdt->archived_ts);
+    double upper = (value + sdt->error_bound - sdt->archived_value) / dt;
+    double lower = (value - sdt->error_bound - sdt->archived_value) / dt;
+    if (upper > sdt->slope_upper) upper = sdt->slope_upper;
+    if (lower < sdt->slope_lower) lower = sdt->slope_lower;
+
+    if (lower > upper && sdt->has_held) {
+        /* Doors opened past parallel: the held sample ends the segment */
+        if (client->metric_count >= client->max_metrics) {
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        sdt_queue(client, sdt, sdt->held_value, sdt->held_ts);
+        sdt_archive(sdt, sdt->held_value, sdt->held_ts);
+
+        dt = (double)(timestamp_ms - sdt->archived_ts);
+        upper = (value + sdt->error_bound - sdt->archived_value) / dt;
+        lower = (value - sdt->error_bound - sdt->archived_value) / dt;
+    }
+
+    sdt->slope_upper = upper;
+    sdt->slope_lower = lower;
+    sdt->held_value = value;
+    sdt->held_ts = timestamp_ms;
+    sdt->has_held = true;
+    return PLEXUS_OK;
+}
+
+void plexus_sdt_flush_held(plexus_client_t* client) {
+    for (uint8_t i = 0; i < client->sdt_count; i++) {
+        plexus_sdt_t* sdt = &client->sdt[i];
+        if (!sdt->has_held) {
+            continue;
+        }
+        if (client->metric_count >= client->max_metrics) {
+            return;
+        }
+        sdt_queue(client, sdt, sdt->held_value, sdt->held_ts);
+        sdt_archive(sdt, sdt->held_value, sdt->held_ts);
+    }
+}
+
+bool plexus_sdt_pending(const plexus_client_t* client) {
+    for (uint8_t i = 0; i < client->sdt_count; i++) {
+        if (client->sdt[i].has_held) {
+            return true;
+        }
+    }
+    return false;
+}
+
+plexus_err_t plexus_set_sdt(plexus_client_t* client, const char* metric,
+                             double error_bound, uint32_t max_silence_ms) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) return PLEXUS_ERR_STRING_TOO_LONG;
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+    if (!(error_bound >= 0.0) || isinf(error_bound)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    plexus_sdt_t* sdt = plexus_sdt_find(client, metric);
+    if (!sdt) {
+        if (client->sdt_count >= PLEXUS_MAX_SDT) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        sdt = &client->sdt[client->sdt_count++];
+        memset(sdt, 0, sizeof(*sdt));
+        strncpy(sdt->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    }
+
+    /* Reopen the corridor so the new bound applies to the open segment */
+    sdt->error_bound = error_bound;
+    sdt->max_silence_ms = max_silence_ms;
+    sdt->slope_upper = HUGE_VAL;
+    sdt->slope_lower = -HUGE_VAL;
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_SDT */
@@ -319,6 +319,36 @@ void  plexus_hal_mutex_destroy(void* mutex) { (void)mutex; }
 
 #endif /* PLEXUS_ENABLE_THREAD_SAFE */
 
+/* ========================================================================= */
+/* Cycle counter: CPU cycles on ESP32, micros() elsewhere                    */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_TIMING
+
+#if defined(ESP32)
+
+uint32_t plexus_hal_get_cycles(void) {
+    return (uint32_t)ESP.getCycleCount();
+}
+
+uint32_t plexus_hal_cycles_per_us(void) {
+    return (uint32_t)ESP.getCpuFreqMHz();
+}
+
+#else /* 1 us resolution */
+
+uint32_t plexus_hal_get_cycles(void) {
+    return (uint32_t)micros();
+}
+
+uint32_t plexus_hal_cycles_per_us(void) {
+    return 1;
+}
+
+#endif /* ESP32 */
+
+#endif /* PLEXUS_ENABLE_TIMING */
+
 } /* extern "C" */
 
 /* PlexusClient C++ wrapper is defined in plexus.h (inside #ifdef __cplusplus) */
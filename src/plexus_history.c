@@ -0,0 +1,180 @@
+/**
+ * @file plexus_history.c
+ * @brief On-device short-term history for Plexus C SDK
+ *
+ * Registered metrics are averaged into fixed intervals and each closed
+ * interval is kept as an 8-byte entry: the float32 mean and the time since
+ * the previous entry. Absolute timestamps are rebuilt from the timestamp of
+ * the oldest entry, which advances as the ring overwrites it.
+ *
+ * History is recorded alongside normal sending; it only changes what the
+ * device can answer when a dashboard asks for recent context.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_HISTORY
+
+#include <string.h>
+
+static void history_append(plexus_history_t* hist, float value, uint64_t timestamp_ms) {
+    if (hist->count == PLEXUS_HISTORY_SIZE) {
+        /* Overwrite the oldest entry; the next one becomes the base */
+        hist->count--;
+        hist->base_ts += plexus_history_entry(hist, 0)->dt_ms;
+    }
+
+    uint64_t dt = 0;
+    if (hist->count == 0) {
+        hist->base_ts = timestamp_ms;
+    } else if (timestamp_ms > hist->last_ts) {
+        dt = timestamp_ms - hist->last_ts;
+    }
+
+    plexus_history_entry_t* e = &hist->ring[hist->head];
+    e->dt_ms = dt > UINT32_MAX ? UINT32_MAX : (uint32_t)dt;
+    e->value = value;
+    hist->last_ts = hist->count == 0 ? timestamp_ms : hist->last_ts + e->dt_ms;
+    hist->head = (uint16_t)((hist->head + 1) % PLEXUS_HISTORY_SIZE);
+    hist->count++;
+}
+
+static void history_close_bucket(plexus_history_t* hist) {
+    if (hist->bucket_count == 0) {
+        return;
+    }
+    history_append(hist, (float)(hist->bucket_sum / (double)hist->bucket_count), hist->bucket_ts);
+    hist->bucket_count = 0;
+}
+
+static bool history_bucket_due(const plexus_history_t* hist, uint32_t now) {
+    return hist->bucket_count > 0 &&
+           plexus_internal_tick_elapsed(now, hist->bucket_start + hist->interval_ms);
+}
+
+plexus_history_t* plexus_history_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->history_count; i++) {
+        if (strcmp(client->history[i].name, metric) == 0) {
+            return &client->history[i];
+        }
+    }
+    return NULL;
+}
+
+void plexus_history_record(plexus_history_t* hist, double value, uint64_t timestamp_ms) {
+    if (hist->interval_ms == 0) {
+        history_append(hist, (float)value, timestamp_ms);
+        return;
+    }
+
+    uint32_t now = plexus_hal_get_tick_ms();
+    if (history_bucket_due(hist, now)) {
+        history_close_bucket(hist);
+    }
+
+    if (hist->bucket_count == 0) {
+        hist->bucket_start = now;
+        hist->bucket_ts = timestamp_ms;
+        hist->bucket_sum = 0.0;
+    }
+    hist->bucket_sum += value;
+    hist->bucket_count++;
+}
+
+void plexus_history_tick(plexus_client_t* client) {
+    uint32_t now = plexus_hal_get_tick_ms();
+    for (uint8_t i = 0; i < client->history_count; i++) {
+        if (history_bucket_due(&client->history[i], now)) {
+            history_close_bucket(&client->history[i]);
+        }
+    }
+}
+
+void plexus_history_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms) {
+    for (uint8_t i = 0; i < client->history_count; i++) {
+        const plexus_history_t* hist = &client->history[i];
+        if (hist->bucket_count > 0) {
+            plexus_internal_deadline(now, hist->bucket_start + hist->interval_ms, wait_ms);
+        }
+    }
+}
+
+uint64_t plexus_history_entry_ts(const plexus_history_t* hist, uint16_t index) {
+    uint64_t ts = hist->base_ts;
+    for (uint16_t i = 1; i <= index; i++) {
+        ts += plexus_history_entry(hist, i)->dt_ms;
+    }
+    return ts;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_history_register(plexus_client_t* client, const char* metric,
+                                      uint32_t interval_ms) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) return PLEXUS_ERR_STRING_TOO_LONG;
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    /* Re-registering with the same interval keeps the ring */
+    plexus_history_t* hist = plexus_history_find(client, metric);
+    if (!hist) {
+        if (client->history_count >= PLEXUS_MAX_HISTORY) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        hist = &client->history[client->history_count++];
+        memset(hist, 0, sizeof(*hist));
+        strncpy(hist->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    } else if (hist->interval_ms != interval_ms) {
+        memset(hist, 0, sizeof(*hist));
+        strncpy(hist->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    }
+
+    hist->interval_ms = interval_ms;
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+uint16_t plexus_history_count(plexus_client_t* client, const char* metric) {
+    if (!client || !metric || !client->initialized) return 0;
+
+    PLEXUS_LOCK(client);
+    plexus_history_t* hist = plexus_history_find(client, metric);
+    uint16_t count = hist ? hist->count : 0;
+    PLEXUS_UNLOCK(client);
+    return count;
+}
+
+plexus_err_t plexus_history_get(plexus_client_t* client, const char* metric, uint16_t index,
+                                 double* value, uint64_t* timestamp_ms) {
+    if (!client || !metric || !value) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+
+    PLEXUS_LOCK(client);
+
+    plexus_history_t* hist = plexus_history_find(client, metric);
+    if (!hist) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+    if (index >= hist->count) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_NO_DATA;
+    }
+
+    *value = (double)plexus_history_entry(hist, index)->value;
+    if (timestamp_ms) {
+        *timestamp_ms = plexus_history_entry_ts(hist, index);
+    }
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_HISTORY */
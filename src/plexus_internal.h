@@ -14,6 +14,69 @@
 /* Single definition of User-Agent string used by all source files */
 #define PLEXUS_USER_AGENT "plexus-c-sdk/" PLEXUS_SDK_VERSION
 
+/* ------------------------------------------------------------------------- */
+/* Thread safety macros                                                      */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_ENABLE_THREAD_SAFE && PLEXUS_ENABLE_SHARED_TRANSPORT
+    /* Attaching swaps a client's mutex while holding the old one, so a
+     * locker that raced the swap drops the stale mutex and takes the new */
+    #define PLEXUS_LOCK(c)   do { if (c) plexus_internal_lock_slot(&(c)->mutex); } while(0)
+    #define PLEXUS_UNLOCK(c) do { if ((c) && (c)->mutex) plexus_hal_mutex_unlock((c)->mutex); } while(0)
+#elif PLEXUS_ENABLE_THREAD_SAFE
+    /* NULL-safe: the send wrappers lock before add_metric() validates */
+    #define PLEXUS_LOCK(c)   do { if ((c) && (c)->mutex) plexus_hal_mutex_lock((c)->mutex); } while(0)
+    #define PLEXUS_UNLOCK(c) do { if ((c) && (c)->mutex) plexus_hal_mutex_unlock((c)->mutex); } while(0)
+#else
+    #define PLEXUS_LOCK(c)   ((void)0)
+    #define PLEXUS_UNLOCK(c) ((void)0)
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* Atomic access helpers                                                     */
+/*                                                                           */
+/* Acquire/release pairs order the WebSocket SPSC command ring. Relaxed      */
+/* loads and stores keep the lifetime totals untorn for lock-free readers;   */
+/* their writers are serialized by the client lock, so PLEXUS_ADD_RELAXED is */
+/* a load plus a store rather than a read-modify-write and needs no          */
+/* libatomic on cores without exclusive loads (Cortex-M0).                   */
+/* ------------------------------------------------------------------------- */
+
+#if defined(__GNUC__) || defined(__clang__)
+    /* GCC/Clang atomic builtins — work on ARM, Xtensa, x86 */
+    #define PLEXUS_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+    #define PLEXUS_LOAD_ACQUIRE(ptr)       __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+    #define PLEXUS_STORE_RELAXED(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELAXED)
+    #define PLEXUS_LOAD_RELAXED(ptr)       __atomic_load_n((ptr), __ATOMIC_RELAXED)
+#else
+    /* Fallback: volatile read/write (correct on single-core, best-effort on multi-core) */
+    #define PLEXUS_STORE_RELEASE(ptr, val) (*(volatile typeof(*(ptr))*)(ptr) = (val))
+    #define PLEXUS_LOAD_ACQUIRE(ptr)       (*(volatile typeof(*(ptr))*)(ptr))
+    #define PLEXUS_STORE_RELAXED(ptr, val) PLEXUS_STORE_RELEASE(ptr, val)
+    #define PLEXUS_LOAD_RELAXED(ptr)       PLEXUS_LOAD_ACQUIRE(ptr)
+#endif
+
+/* Single writer only: caller holds the client lock */
+#define PLEXUS_ADD_RELAXED(ptr, val) \
+    PLEXUS_STORE_RELAXED((ptr), PLEXUS_LOAD_RELAXED(ptr) + (plexus_total_t)(val))
+
+#if PLEXUS_ENABLE_THREAD_SAFE && PLEXUS_ENABLE_SHARED_TRANSPORT
+/* Lock whichever mutex *slot names once it is held; see PLEXUS_LOCK */
+static inline void plexus_internal_lock_slot(void* const* slot) {
+    for (;;) {
+        void* mutex = PLEXUS_LOAD_ACQUIRE(slot);
+        if (!mutex) {
+            return;
+        }
+        plexus_hal_mutex_lock(mutex);
+        if (PLEXUS_LOAD_ACQUIRE(slot) == mutex) {
+            return;
+        }
+        plexus_hal_mutex_unlock(mutex);
+    }
+}
+#endif
+
 /* ------------------------------------------------------------------------- */
 /* Internal function declarations                                            */
 /* ------------------------------------------------------------------------- */
@@ -24,8 +87,307 @@
  */
 bool plexus_internal_is_url_safe(const char* s);
 
+/**
+ * Validate that a metric name is non-empty printable ASCII (0x20-0x7E).
+ */
+bool plexus_internal_is_valid_metric_name(const char* s);
+
 int plexus_json_serialize(const plexus_client_t* client, char* buf, size_t buf_size);
 
+/**
+ * Append a point to the metric buffer without name validation or auto-flush.
+ * Caller must hold the client lock. timestamp_ms == 0 uses the HAL clock.
+ */
+plexus_err_t plexus_internal_enqueue(plexus_client_t* client, const char* metric,
+                                      const plexus_value_t* value, uint64_t timestamp_ms);
+
+/**
+ * Route a validated point through the enabled features and queue it, as the
+ * send functions do. Caller must hold the lock and runs the auto-flush check.
+ */
+plexus_err_t plexus_internal_route(plexus_client_t* client, const char* metric,
+                                   plexus_value_t* value, uint64_t timestamp_ms);
+
+/**
+ * Flush if the queued point count reached the auto-flush threshold.
+ * Caller must hold the client lock. May block (see plexus_flush()).
+ */
+plexus_err_t plexus_internal_maybe_auto_flush(plexus_client_t* client);
+
+/**
+ * Check if a deadline (set relative to a past tick) has passed.
+ * Handles uint32_t wraparound correctly using signed comparison.
+ */
+static inline bool plexus_internal_tick_elapsed(uint32_t now, uint32_t deadline) {
+    return (int32_t)(now - deadline) >= 0;
+}
+
+/**
+ * Lower *wait_ms to the time left until deadline (0 once it has passed).
+ * Each feature's *_next_deadline() folds its timers in with this.
+ */
+static inline void plexus_internal_deadline(uint32_t now, uint32_t deadline, uint32_t* wait_ms) {
+    uint32_t left = plexus_internal_tick_elapsed(now, deadline) ? 0 : deadline - now;
+    if (left < *wait_ms) {
+        *wait_ms = left;
+    }
+}
+
+#if PLEXUS_ENABLE_CLIENT_STATS || PLEXUS_ENABLE_TRACE
+/**
+ * Raw stamp for stats and trace timing: the cycle counter when available,
+ * else the tick. Only the span between two stamps means anything, since
+ * the cycle counter wraps.
+ */
+static inline uint32_t plexus_internal_clock_stamp(void) {
+#if PLEXUS_ENABLE_TIMING
+    return plexus_hal_get_cycles();
+#else
+    return plexus_hal_get_tick_ms();
+#endif
+}
+
+/** Microseconds between two stamps; the difference is taken before scaling */
+static inline uint32_t plexus_internal_clock_span_us(uint32_t start, uint32_t end) {
+#if PLEXUS_ENABLE_TIMING
+    return (end - start) / plexus_hal_cycles_per_us();
+#else
+    return (end - start) * 1000u;
+#endif
+}
+#endif
+
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+/** CRC32 (IEEE 802.3) guarding persisted batches and their metadata. */
+uint32_t plexus_crc32(const void* data, size_t len);
+#endif
+
+#if PLEXUS_ENABLE_STATS
+/** Portable-C summary kernel (also the reference for the SIMD kernels). */
+void plexus_stats_summary_f32_portable(const float* values, size_t count,
+                                       plexus_stats_summary_t* out);
+#endif
+
+#if PLEXUS_ENABLE_AGGREGATION
+/** Find the aggregate registered for a metric name, or NULL. */
+plexus_aggregate_t* plexus_agg_find(plexus_client_t* client, const char* metric);
+
+/** Fold one sample into its window, closing the previous window if due. */
+plexus_err_t plexus_agg_fold(plexus_client_t* client, plexus_aggregate_t* agg, double value);
+
+/** Close and emit every window whose time is up. Called from plexus_tick(). */
+plexus_err_t plexus_agg_tick(plexus_client_t* client);
+
+/** Fold the earliest open window's close into *wait_ms. */
+void plexus_agg_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms);
+#endif
+
+#if PLEXUS_ENABLE_DEADBAND
+/** Find the deadband configured for a metric name, or NULL. */
+plexus_deadband_t* plexus_deadband_find(plexus_client_t* client, const char* metric);
+
+/** True if the sample is inside the deadband and no heartbeat is due. */
+bool plexus_deadband_suppress(const plexus_deadband_t* db, double value);
+
+/** Record a sample as sent after it was successfully queued. */
+void plexus_deadband_commit(plexus_deadband_t* db, double value);
+#endif
+
+#if PLEXUS_ENABLE_SDT
+/** Find the SDT compressor configured for a metric name, or NULL. */
+plexus_sdt_t* plexus_sdt_find(plexus_client_t* client, const char* metric);
+
+/** Feed one sample; queues the previous sample if it ends a segment. */
+plexus_err_t plexus_sdt_update(plexus_client_t* client, plexus_sdt_t* sdt,
+                               double value, uint64_t timestamp_ms);
+
+/** Queue every held sample as a segment endpoint. Called from plexus_flush(). */
+void plexus_sdt_flush_held(plexus_client_t* client);
+
+/** True if any compressor holds an unqueued sample. */
+bool plexus_sdt_pending(const plexus_client_t* client);
+#endif
+
+#if PLEXUS_ENABLE_SKETCHES
+/** Close and emit every sketch window whose time is up. Called from plexus_tick(). */
+plexus_err_t plexus_sketch_tick(plexus_client_t* client);
+
+/** Fold the earliest open sketch window's close into *wait_ms. */
+void plexus_sketch_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms);
+
+/** Forget queued sketch points once the metric buffer has been cleared. */
+void plexus_sketch_release_pending(plexus_client_t* client);
+
+/** Forget one sketch's queued point once it has been sent. */
+void plexus_sketch_release_one(plexus_client_t* client, uint8_t idx);
+
+/** Estimate quantile q of a sketch window (NAN if empty). */
+double plexus_sketch_data_quantile(const plexus_sketch_t* sk,
+                                   const plexus_sketch_data_t* d, double q);
+#endif
+
+#if PLEXUS_ENABLE_COUNTERS
+/** Find the counter registered for a metric name, or NULL. */
+plexus_counter_t* plexus_counter_find(plexus_client_t* client, const char* metric);
+
+/** Fold one plexus_send_number() value (gauge value or cumulative reading). */
+plexus_err_t plexus_counter_update(plexus_client_t* client, plexus_counter_t* ctr, double value);
+
+/** Close and emit every counter window whose time is up. Called from plexus_tick(). */
+plexus_err_t plexus_counter_tick(plexus_client_t* client);
+
+/** Fold the earliest open counter window's close into *wait_ms. */
+void plexus_counter_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms);
+#endif
+
+#if PLEXUS_ENABLE_DOWNSAMPLE
+/** Find the downsample buffer registered for a metric name, or NULL. */
+plexus_downsample_t* plexus_downsample_find(plexus_client_t* client, const char* metric);
+
+/** Buffer one raw sample, compacting the buffer if it is full. */
+void plexus_downsample_append(plexus_downsample_t* ds, double value, uint64_t timestamp_ms);
+
+/** Reduce every buffer to its target and queue the points. Called from plexus_flush(). */
+plexus_err_t plexus_downsample_drain(plexus_client_t* client);
+
+/** True if any downsample buffer holds samples. */
+bool plexus_downsample_pending(const plexus_client_t* client);
+
+/** Reduce n samples in place to at most m points; returns the new count. */
+uint16_t plexus_downsample_reduce(plexus_downsample_sample_t* s, uint16_t n, uint16_t m,
+                                  uint8_t method);
+#endif
+
+#if PLEXUS_ENABLE_TRIGGER
+/** Find the trigger registered for a metric name, or NULL. */
+plexus_trigger_t* plexus_trigger_find(plexus_client_t* client, const char* metric);
+
+/** Capture one sample, evaluating the trigger and the low-rate report. */
+void plexus_trigger_sample(plexus_client_t* client, plexus_trigger_t* trg,
+                           double value, uint64_t timestamp_ms);
+
+/** Move committed burst samples into the queue as room allows. Called from plexus_tick(). */
+void plexus_trigger_drain(plexus_client_t* client);
+
+/** True if a burst still has samples waiting for queue room. */
+bool plexus_trigger_pending(const plexus_client_t* client);
+#endif
+
+#if PLEXUS_ENABLE_THREAD_STAGING
+/** Merge staged points into the queue by timestamp as room allows. Caller holds the lock. */
+void plexus_stage_collect(plexus_client_t* client);
+
+/** True if any stage holds points. */
+bool plexus_stage_pending(const plexus_client_t* client);
+#endif
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+/**
+ * Append as many of a client's queued points as fit to a coalesced body of
+ * len bytes (0 starts one), each carrying the client's source_id, and set
+ * *out_count to how many. Returns the new length, or -1 with the body left
+ * as it was if not even the first point fits.
+ */
+int plexus_json_append_points(const plexus_client_t* client, char* buf, size_t buf_size,
+                              size_t len, uint16_t* out_count);
+
+/**
+ * Coalesced flush of every attached client: blocking through the retries
+ * like plexus_flush() when wait is set, else one attempt per request like
+ * plexus_flush_nowait(). Caller holds the transport lock.
+ */
+plexus_err_t plexus_internal_transport_flush(plexus_transport_t* transport, bool wait,
+                                             uint32_t* retry_after_ms);
+
+/** Remove an attached client and give it back its own lock. */
+void plexus_internal_transport_detach(plexus_client_t* client);
+#endif
+
+#if PLEXUS_ENABLE_LAST_VALUE
+/** Record a number or bool send. Caller must hold the client lock. */
+void plexus_last_value_update(plexus_client_t* client, const char* metric,
+                              const plexus_value_t* value, uint64_t timestamp_ms);
+
+/** Serialize the cache as {"points":[...]}; returns length or -1. Caller holds the lock. */
+int plexus_json_serialize_snapshot(const plexus_client_t* client, char* buf, size_t buf_size);
+#endif
+
+#if PLEXUS_ENABLE_HISTORY
+/** Find the history ring registered for a metric name, or NULL. */
+plexus_history_t* plexus_history_find(plexus_client_t* client, const char* metric);
+
+/** Fold one sample into the open interval, closing it if it is due. */
+void plexus_history_record(plexus_history_t* hist, double value, uint64_t timestamp_ms);
+
+/** Close every interval whose time is up. Called from plexus_tick(). */
+void plexus_history_tick(plexus_client_t* client);
+
+/** Fold the earliest open interval's close into *wait_ms. */
+void plexus_history_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms);
+
+/** Timestamp of entry index (0 = oldest); index must be < count. */
+uint64_t plexus_history_entry_ts(const plexus_history_t* hist, uint16_t index);
+
+/** Ring slot of entry index (0 = oldest). */
+static inline const plexus_history_entry_t* plexus_history_entry(const plexus_history_t* hist,
+                                                                 uint16_t index) {
+    return &hist->ring[(hist->head + PLEXUS_HISTORY_SIZE - hist->count + index) % PLEXUS_HISTORY_SIZE];
+}
+#endif
+
+#if PLEXUS_ENABLE_CLIENT_STATS
+/** Record one HTTP post attempt that took latency_ms. */
+void plexus_client_stats_post(plexus_client_t* client, uint32_t latency_ms, plexus_err_t err);
+
+/** Record one serialization that started at clock stamp start. */
+void plexus_client_stats_serialize(plexus_client_t* client, uint32_t start);
+
+/** Publish plexus.* metrics when the interval is due. Called from plexus_tick(). */
+void plexus_client_stats_tick(plexus_client_t* client);
+
+/** Fold the next publish into *wait_ms. */
+void plexus_client_stats_next_deadline(const plexus_client_t* client, uint32_t now,
+                                       uint32_t* wait_ms);
+
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+/** Persisted batches waiting to be sent (reads the storage metadata). */
+uint16_t plexus_internal_persist_backlog(void);
+#endif
+#endif
+
+/* Trace hooks: compiled out entirely unless PLEXUS_ENABLE_TRACE */
+#if PLEXUS_ENABLE_TRACE
+/** Deliver one event to the client's trace callback, if any. */
+void plexus_internal_trace(plexus_client_t* client, plexus_trace_phase_t phase,
+                           plexus_trace_edge_t edge, uint32_t value, plexus_err_t err);
+
+#define PLEXUS_TRACE_ENTER(c, phase, value) \
+    plexus_internal_trace((c), (phase), PLEXUS_TRACE_BEGIN, (uint32_t)(value), PLEXUS_OK)
+#define PLEXUS_TRACE_EXIT(c, phase, value, err) \
+    plexus_internal_trace((c), (phase), PLEXUS_TRACE_END, (uint32_t)(value), (err))
+#define PLEXUS_TRACE_MARK(c, phase, value) \
+    plexus_internal_trace((c), (phase), PLEXUS_TRACE_INSTANT, (uint32_t)(value), PLEXUS_OK)
+#else
+#define PLEXUS_TRACE_ENTER(c, phase, value)     ((void)0)
+#define PLEXUS_TRACE_EXIT(c, phase, value, err) ((void)0)
+#define PLEXUS_TRACE_MARK(c, phase, value)      ((void)0)
+#endif
+
+/* Wake hook: compiled out entirely unless PLEXUS_ENABLE_WAKE_CALLBACK */
+#if PLEXUS_ENABLE_WAKE_CALLBACK
+/** Fire the wake callback if new work is due before the deadline last reported. Caller holds the lock. */
+void plexus_internal_wake_if_sooner(plexus_client_t* client);
+
+/** Fire the wake callback unconditionally (WebSocket events, any context). */
+void plexus_internal_wake(plexus_client_t* client);
+
+#define PLEXUS_WAKE_IF_SOONER(c) plexus_internal_wake_if_sooner(c)
+#define PLEXUS_WAKE(c)           plexus_internal_wake(c)
+#else
+#define PLEXUS_WAKE_IF_SOONER(c) ((void)0)
+#define PLEXUS_WAKE(c)           ((void)0)
+#endif
+
 #if PLEXUS_ENABLE_WEBSOCKET
 #include "plexus_ws.h"
 #endif
@@ -125,6 +125,120 @@ static void json_append_uint64(json_writer_t* w, uint64_t value) {
     json_append(w, num_buf);
 }
 
+#if PLEXUS_ENABLE_SKETCHES
+/**
+ * Write a sketch's pending window as a mergeable bucket object:
+ *   {"type":"ddsketch","gamma":1.04,"offset":-3,"zero":0,"bins":[..],
+ *    "count":N,"sum":..,"min":..,"max":..}
+ * bins[i] counts samples in (gamma^(offset+i-1), gamma^(offset+i)].
+ * Leading and trailing empty bins are trimmed.
+ */
+static void json_append_sketch(json_writer_t* w, const plexus_client_t* client, uint8_t idx) {
+    if (idx >= client->sketch_count) {
+        json_append(w, "null");
+        return;
+    }
+
+    const plexus_sketch_t* sk = &client->sketches[idx];
+    const plexus_sketch_data_t* d = &sk->pending;
+
+    int first = 0;
+    int last = PLEXUS_SKETCH_BINS - 1;
+    while (first <= last && d->bins[first] == 0) first++;
+    while (last >= first && d->bins[last] == 0) last--;
+
+    char num_buf[16];
+    json_append(w, "{\"type\":\"ddsketch\",\"gamma\":");
+    json_append_number(w, sk->gamma);
+    json_append(w, ",\"offset\":");
+    snprintf(num_buf, sizeof(num_buf), "%ld", (long)(d->offset + (first <= last ? first : 0)));
+    json_append(w, num_buf);
+    json_append(w, ",\"zero\":");
+    json_append_uint64(w, d->zero_count);
+    json_append(w, ",\"bins\":[");
+    for (int i = first; i <= last; i++) {
+        if (i > first) json_append_char(w, ',');
+        json_append_uint64(w, d->bins[i]);
+    }
+    json_append(w, "],\"count\":");
+    json_append_uint64(w, d->count);
+    json_append(w, ",\"sum\":");
+    json_append_number(w, d->sum);
+    json_append(w, ",\"min\":");
+    json_append_number(w, d->min);
+    json_append(w, ",\"max\":");
+    json_append_number(w, d->max);
+    json_append_char(w, '}');
+}
+#endif
+
+/* Append one queued point; source_id is per point in coalesced bodies */
+static void json_append_point(json_writer_t* w, const plexus_client_t* client,
+                              const plexus_metric_t* m, bool with_source_id) {
+    json_append(w, "{\"metric\":");
+    json_append_escaped(w, m->name);
+
+    json_append(w, ",\"value\":");
+    switch (m->value.type) {
+        case PLEXUS_VALUE_NUMBER:
+            json_append_number(w, m->value.data.number);
+            break;
+#if PLEXUS_ENABLE_STRING_VALUES
+        case PLEXUS_VALUE_STRING:
+            json_append_escaped(w, m->value.data.string);
+            break;
+#endif
+#if PLEXUS_ENABLE_BOOL_VALUES
+        case PLEXUS_VALUE_BOOL:
+            json_append(w, m->value.data.boolean ? "true" : "false");
+            break;
+#endif
+#if PLEXUS_ENABLE_SKETCHES
+        case PLEXUS_VALUE_SKETCH:
+            json_append_sketch(w, client, m->value.data.sketch);
+            break;
+#endif
+        default:
+            json_append(w, "null");
+            break;
+    }
+
+    /* Timestamp (if set) */
+    if (m->timestamp_ms > 0) {
+        json_append(w, ",\"timestamp\":");
+        json_append_uint64(w, m->timestamp_ms);
+    }
+
+    if (with_source_id) {
+        json_append(w, ",\"source_id\":");
+        json_append_escaped(w, client->source_id);
+    }
+
+    /* Session ID (only when a session is active) */
+    if (client->session_id[0] != '\0') {
+        json_append(w, ",\"session_id\":");
+        json_append_escaped(w, client->session_id);
+    }
+
+#if PLEXUS_ENABLE_TAGS
+    /* Tags */
+    if (m->tag_count > 0) {
+        json_append(w, ",\"tags\":{");
+        for (uint8_t t = 0; t < m->tag_count; t++) {
+            if (t > 0) {
+                json_append_char(w, ',');
+            }
+            json_append_escaped(w, m->tag_keys[t]);
+            json_append_char(w, ':');
+            json_append_escaped(w, m->tag_values[t]);
+        }
+        json_append_char(w, '}');
+    }
+#endif
+
+    json_append_char(w, '}');
+}
+
 /**
  * Serialize metrics to JSON format for ingest API.
  *
@@ -155,81 +269,147 @@ int plexus_json_serialize(const plexus_client_t* client, char* buf, size_t buf_s
     json_append(&w, ",\"points\":[");
 
     for (uint16_t i = 0; i < client->metric_count; i++) {
-        const plexus_metric_t* m = &client->metrics[i];
-
         if (i > 0) {
             json_append_char(&w, ',');
         }
+        json_append_point(&w, client, &client->metrics[i], false);
+    }
 
-        json_append(&w, "{\"metric\":");
-        json_append_escaped(&w, m->name);
+    json_append(&w, "]}");
 
-        json_append(&w, ",\"value\":");
-        switch (m->value.type) {
-            case PLEXUS_VALUE_NUMBER:
-                json_append_number(&w, m->value.data.number);
-                break;
-#if PLEXUS_ENABLE_STRING_VALUES
-            case PLEXUS_VALUE_STRING:
-                json_append_escaped(&w, m->value.data.string);
-                break;
-#endif
-#if PLEXUS_ENABLE_BOOL_VALUES
-            case PLEXUS_VALUE_BOOL:
-                json_append(&w, m->value.data.boolean ? "true" : "false");
-                break;
-#endif
-            default:
-                json_append(&w, "null");
-                break;
-        }
+    if (w.error) {
+        return -1;
+    }
 
-        /* Timestamp (if set) */
-        if (m->timestamp_ms > 0) {
-            json_append(&w, ",\"timestamp\":");
-            json_append_uint64(&w, m->timestamp_ms);
-        }
+    return (int)w.pos;
+}
 
-        /* Session ID (only when a session is active) */
-        if (client->session_id[0] != '\0') {
-            json_append(&w, ",\"session_id\":");
-            json_append_escaped(&w, client->session_id);
-        }
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
 
-#if PLEXUS_ENABLE_TAGS
-        /* Tags */
-        if (m->tag_count > 0) {
-            json_append(&w, ",\"tags\":{");
-            for (uint8_t t = 0; t < m->tag_count; t++) {
-                if (t > 0) {
-                    json_append_char(&w, ',');
-                }
-                json_append_escaped(&w, m->tag_keys[t]);
-                json_append_char(&w, ':');
-                json_append_escaped(&w, m->tag_values[t]);
-            }
-            json_append_char(&w, '}');
-        }
-#endif
+int plexus_json_append_points(const plexus_client_t* client, char* buf, size_t buf_size,
+                              size_t len, uint16_t* out_count) {
+    if (!client || !buf || !out_count || buf_size == 0 ||
+        (len > 0 && (len < 2 || len >= buf_size))) {
+        return -1;
+    }
 
-        json_append_char(&w, '}');
+    json_writer_t w;
+    if (len == 0) {
+        json_init(&w, buf, buf_size);
+        json_append(&w, "{\"sdk\":\"c/" PLEXUS_SDK_VERSION "\",\"points\":[");
+    } else {
+        /* Reopen the closed body: "...}]}" becomes "...}," */
+        w.buf = buf;
+        w.size = buf_size;
+        w.pos = len - 2;
+        w.error = false;
+        json_append_char(&w, ',');
     }
 
-    json_append(&w, "]}");
+    uint16_t n = 0;
+    for (; n < client->metric_count; n++) {
+        size_t mark = w.pos;
+        if (n > 0) {
+            json_append_char(&w, ',');
+        }
+        json_append_point(&w, client, &client->metrics[n], true);
+        /* The body must still close after this point */
+        json_append(&w, "]}");
+        if (w.error) {
+            w.pos = mark;
+            w.error = false;
+            break;
+        }
+        w.pos -= 2;
+    }
 
-    if (w.error) {
+    if (n == 0) {
+        /* Leave the body as it was */
+        if (len > 0) {
+            memcpy(buf + len - 2, "]}", 3);
+        }
         return -1;
     }
 
+    json_append(&w, "]}");
+    *out_count = n;
     return (int)w.pos;
 }
 
+#endif /* PLEXUS_ENABLE_SHARED_TRANSPORT */
+
+#if PLEXUS_ENABLE_LAST_VALUE
+
+/* Append the last-value cache as {"points":[...]} */
+static void json_append_snapshot(json_writer_t* w, const plexus_client_t* client) {
+    json_append(w, "{\"points\":[");
+    for (uint8_t i = 0; i < client->last_value_count; i++) {
+        const plexus_last_value_t* lv = &client->last_values[i];
+        if (i > 0) json_append_char(w, ',');
+
+        json_append(w, "{\"metric\":");
+        json_append_escaped(w, lv->name);
+        json_append(w, ",\"value\":");
+#if PLEXUS_ENABLE_BOOL_VALUES
+        if (lv->type == PLEXUS_VALUE_BOOL) {
+            json_append(w, lv->number != 0.0 ? "true" : "false");
+        } else
+#endif
+        {
+            json_append_number(w, lv->number);
+        }
+        json_append(w, ",\"timestamp\":");
+        json_append_uint64(w, lv->timestamp_ms);
+        json_append_char(w, '}');
+    }
+    json_append(w, "]}");
+}
+
+int plexus_json_serialize_snapshot(const plexus_client_t* client, char* buf, size_t buf_size) {
+    if (!client || !buf || buf_size == 0) return -1;
+
+    json_writer_t w;
+    json_init(&w, buf, buf_size);
+    json_append_snapshot(&w, client);
+
+    return w.error ? -1 : (int)w.pos;
+}
+
+#endif /* PLEXUS_ENABLE_LAST_VALUE */
+
 /* ========================================================================= */
 /* WebSocket JSON serializers                                                */
 /* ========================================================================= */
 
 #if PLEXUS_ENABLE_WEBSOCKET
 
+/* Built-in commands, advertised unless the application registered the same name */
+static const struct {
+    const char* name;
+    const char* schema;
+} s_builtin_commands[] = {
+#if PLEXUS_ENABLE_LAST_VALUE
+    { "snapshot",
+      "{\"name\":\"snapshot\",\"description\":\"Current value of every metric\",\"params\":[]}" },
+#endif
+#if PLEXUS_ENABLE_HISTORY
+    { "history",
+      "{\"name\":\"history\",\"description\":\"Recent history of a metric\",\"params\":["
+      "{\"name\":\"metric\",\"type\":\"string\",\"required\":true},"
+      "{\"name\":\"since\",\"type\":\"int\",\"min\":0,\"required\":false}]}" },
+#endif
+    { NULL, NULL }
+};
+
+static bool command_registered(const plexus_client_t* client, const char* name) {
+    for (uint8_t i = 0; i < client->ws_command_count; i++) {
+        if (strcmp(client->ws_commands[i].name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 int plexus_json_serialize_ws_auth(const plexus_client_t* client, char* buf, size_t buf_size) {
     if (!client || !buf || buf_size == 0) return -1;
 
@@ -242,8 +422,14 @@ int plexus_json_serialize_ws_auth(const plexus_client_t* client, char* buf, size
     json_append_escaped(&w, client->source_id);
     json_append(&w, ",\"platform\":\"c-sdk\",\"agent_version\":\"" PLEXUS_SDK_VERSION "\"");
 
-    /* Command schemas */
-    if (client->ws_command_count > 0) {
+    /* Command schemas: registered commands, then built-ins they don't override */
+    bool any_command = client->ws_command_count > 0;
+    for (size_t b = 0; s_builtin_commands[b].name; b++) {
+        if (!command_registered(client, s_builtin_commands[b].name)) {
+            any_command = true;
+        }
+    }
+    if (any_command) {
         json_append(&w, ",\"commands\":[");
         for (uint8_t i = 0; i < client->ws_command_count; i++) {
             const plexus_cmd_reg_t* cmd = &client->ws_commands[i];
@@ -289,6 +475,15 @@ int plexus_json_serialize_ws_auth(const plexus_client_t* client, char* buf, size
             }
             json_append(&w, "]}");
         }
+        bool first = client->ws_command_count == 0;
+        for (size_t b = 0; s_builtin_commands[b].name; b++) {
+            if (command_registered(client, s_builtin_commands[b].name)) {
+                continue;
+            }
+            if (!first) json_append_char(&w, ',');
+            json_append(&w, s_builtin_commands[b].schema);
+            first = false;
+        }
         json_append_char(&w, ']');
     }
 
@@ -339,6 +534,11 @@ int plexus_json_serialize_ws_telemetry(const plexus_client_t* client, char* buf,
             case PLEXUS_VALUE_BOOL:
                 json_append(&w, m->value.data.boolean ? "true" : "false");
                 break;
+#endif
+#if PLEXUS_ENABLE_SKETCHES
+            case PLEXUS_VALUE_SKETCH:
+                json_append_sketch(&w, client, m->value.data.sketch);
+                break;
 #endif
             default:
                 json_append(&w, "null");
@@ -402,6 +602,90 @@ int plexus_json_serialize_command_result(const char* cmd_id, const char* command
     return w.error ? -1 : (int)w.pos;
 }
 
+#if PLEXUS_ENABLE_LAST_VALUE
+int plexus_json_serialize_snapshot_result(const plexus_client_t* client, const char* cmd_id,
+                                           char* buf, size_t buf_size) {
+    if (!client || !cmd_id || !buf || buf_size == 0) return -1;
+
+    json_writer_t w;
+    json_init(&w, buf, buf_size);
+
+    json_append(&w, "{\"type\":\"command_result\",\"id\":");
+    json_append_escaped(&w, cmd_id);
+    json_append(&w, ",\"command\":\"snapshot\",\"event\":\"result\",\"result\":");
+    json_append_snapshot(&w, client);
+    json_append_char(&w, '}');
+
+    return w.error ? -1 : (int)w.pos;
+}
+#endif
+
+#if PLEXUS_ENABLE_HISTORY
+/* Floats carry ~7 significant digits; more would only print conversion noise */
+static void json_append_float(json_writer_t* w, float value) {
+    if (w->error) return;
+    if (isnan(value) || isinf(value)) {
+        json_append(w, "null");
+        return;
+    }
+    char num_buf[24];
+    snprintf(num_buf, sizeof(num_buf), "%.7g", (double)value);
+    json_append(w, num_buf);
+}
+
+/* Room kept free while adding points, for the closing "],\"more\":true}}" */
+#define HISTORY_RESULT_TAIL 24
+
+int plexus_json_serialize_history_result(const plexus_history_t* hist, const char* cmd_id,
+                                          uint64_t since_ms, char* buf, size_t buf_size) {
+    if (!hist || !cmd_id || !buf || buf_size <= HISTORY_RESULT_TAIL) return -1;
+
+    json_writer_t w;
+    json_init(&w, buf, buf_size - HISTORY_RESULT_TAIL);
+
+    json_append(&w, "{\"type\":\"command_result\",\"id\":");
+    json_append_escaped(&w, cmd_id);
+    json_append(&w, ",\"command\":\"history\",\"event\":\"result\",\"result\":{\"metric\":");
+    json_append_escaped(&w, hist->name);
+    json_append(&w, ",\"interval_ms\":");
+    json_append_uint64(&w, hist->interval_ms);
+    json_append(&w, ",\"points\":[");
+    if (w.error) return -1;
+
+    /* Oldest first; stop at the first point that does not fit */
+    bool more = false;
+    bool first = true;
+    uint64_t ts = hist->base_ts;
+    for (uint16_t i = 0; i < hist->count; i++) {
+        const plexus_history_entry_t* e = plexus_history_entry(hist, i);
+        if (i > 0) ts += e->dt_ms;
+        if (ts <= since_ms) continue;
+
+        size_t mark = w.pos;
+        if (!first) json_append_char(&w, ',');
+        json_append_char(&w, '[');
+        json_append_uint64(&w, ts);
+        json_append_char(&w, ',');
+        json_append_float(&w, e->value);
+        json_append_char(&w, ']');
+        if (w.error) {
+            w.pos = mark;
+            w.buf[mark] = '\0';
+            w.error = false;
+            more = true;
+            break;
+        }
+        first = false;
+    }
+
+    /* The tail was reserved above */
+    w.size = buf_size;
+    json_append(&w, more ? "],\"more\":true}}" : "],\"more\":false}}");
+
+    return w.error ? -1 : (int)w.pos;
+}
+#endif
+
 /* ========================================================================= */
 /* Minimal JSON field extraction                                             */
 /*                                                                           */
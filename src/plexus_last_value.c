@@ -0,0 +1,107 @@
+/**
+ * @file plexus_last_value.c
+ * @brief Last-value cache for Plexus C SDK
+ *
+ * Keeps the most recent number/bool of each metric, updated on every
+ * untagged send before any aggregation or filtering decides whether the
+ * sample is queued. A dashboard can then ask for the current value of every
+ * metric (plexus_last_value_snapshot(), or the built-in "snapshot"
+ * WebSocket command) instead of relying on slow metrics being streamed.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_LAST_VALUE
+
+#include <string.h>
+
+static plexus_last_value_t* last_value_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->last_value_count; i++) {
+        if (strcmp(client->last_values[i].name, metric) == 0) {
+            return &client->last_values[i];
+        }
+    }
+    return NULL;
+}
+
+void plexus_last_value_update(plexus_client_t* client, const char* metric,
+                              const plexus_value_t* value, uint64_t timestamp_ms) {
+    double number;
+    switch (value->type) {
+        case PLEXUS_VALUE_NUMBER:
+            number = value->data.number;
+            break;
+#if PLEXUS_ENABLE_BOOL_VALUES
+        case PLEXUS_VALUE_BOOL:
+            number = value->data.boolean ? 1.0 : 0.0;
+            break;
+#endif
+        default:
+            return;
+    }
+
+    plexus_last_value_t* lv = last_value_find(client, metric);
+    if (!lv) {
+        if (client->last_value_count >= PLEXUS_MAX_LAST_VALUES) {
+            return; /* Table full: the first PLEXUS_MAX_LAST_VALUES names stay cached */
+        }
+        lv = &client->last_values[client->last_value_count++];
+        strncpy(lv->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+        lv->name[PLEXUS_MAX_METRIC_NAME_LEN - 1] = '\0';
+    }
+
+    lv->number = number;
+    lv->type = (uint8_t)value->type;
+    lv->timestamp_ms = timestamp_ms > 0 ? timestamp_ms : plexus_hal_get_time_ms();
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_last_value_get(plexus_client_t* client, const char* metric,
+                                    double* value, uint64_t* timestamp_ms) {
+    if (!client || !metric || !value) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+
+    PLEXUS_LOCK(client);
+
+    plexus_last_value_t* lv = last_value_find(client, metric);
+    if (!lv) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_NO_DATA;
+    }
+
+    *value = lv->number;
+    if (timestamp_ms) {
+        *timestamp_ms = lv->timestamp_ms;
+    }
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+uint8_t plexus_last_value_count(const plexus_client_t* client) {
+    if (!client || !client->initialized) return 0;
+    return client->last_value_count;
+}
+
+plexus_err_t plexus_last_value_snapshot(plexus_client_t* client, char* buf, size_t buf_size,
+                                         size_t* out_len) {
+    if (!client || !buf) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+
+    PLEXUS_LOCK(client);
+    int len = plexus_json_serialize_snapshot(client, buf, buf_size);
+    PLEXUS_UNLOCK(client);
+
+    if (len < 0) {
+        return PLEXUS_ERR_JSON;
+    }
+    if (out_len) {
+        *out_len = (size_t)len;
+    }
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_LAST_VALUE */
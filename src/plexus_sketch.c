@@ -0,0 +1,370 @@
+/**
+ * @file plexus_sketch.c
+ * @brief Fixed-memory quantile sketches for Plexus C SDK
+ *
+ * DDSketch-style: a positive sample x lands in bin k = ceil(log_gamma(x)),
+ * with gamma = (1 + alpha) / (1 - alpha). Every sample in bin k is within
+ * relative error alpha of the bin's representative value, so quantiles are
+ * recovered to ±alpha. Sketches with the same gamma merge by adding bins.
+ *
+ * Memory is fixed at PLEXUS_SKETCH_BINS contiguous bins. When the data spans
+ * more bins than that, the lowest bins are collapsed into bins[0]: upper
+ * quantiles (p90/p99 — what latency dashboards care about) stay accurate.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_SKETCHES
+
+#include <string.h>
+#include <math.h>
+
+/* Longest suffix appended to a sketch metric name */
+#define SKETCH_MAX_SUFFIX_LEN 4 /* ".p50" */
+
+static const struct {
+    double q;
+    const char* suffix;
+} s_sketch_quantiles[] = {
+    { 0.50, ".p50" },
+    { 0.90, ".p90" },
+    { 0.99, ".p99" },
+};
+
+#define SKETCH_QUANTILE_COUNT (sizeof(s_sketch_quantiles) / sizeof(s_sketch_quantiles[0]))
+
+/* ------------------------------------------------------------------------- */
+/* Bin arithmetic                                                            */
+/* ------------------------------------------------------------------------- */
+
+static void sketch_data_reset(plexus_sketch_data_t* d) {
+    memset(d, 0, sizeof(*d));
+}
+
+static uint32_t sat_add32(uint32_t a, uint64_t b) {
+    uint64_t sum = (uint64_t)a + b;
+    return sum > UINT32_MAX ? UINT32_MAX : (uint32_t)sum;
+}
+
+/* Highest non-empty bin, or -1 */
+static int sketch_top_bin(const plexus_sketch_data_t* d) {
+    for (int i = PLEXUS_SKETCH_BINS - 1; i >= 0; i--) {
+        if (d->bins[i]) return i;
+    }
+    return -1;
+}
+
+/**
+ * Add n samples to log-index k, sliding or collapsing the bin window so
+ * that k fits. Assumes the data already holds at least one binned sample
+ * or has had its offset initialized.
+ */
+static void sketch_bins_add(plexus_sketch_data_t* d, int32_t k, uint32_t n) {
+    if (k < d->offset) {
+        int top = sketch_top_bin(d);
+        int32_t span = (top < 0 ? 0 : d->offset + top) - k;
+        if (top < 0 || span < PLEXUS_SKETCH_BINS) {
+            /* Slide window down: move bins up to make room at the bottom */
+            int32_t shift = d->offset - k;
+            if (top >= 0) {
+                memmove(&d->bins[shift], &d->bins[0], (size_t)(top + 1) * sizeof(d->bins[0]));
+                memset(&d->bins[0], 0, (size_t)shift * sizeof(d->bins[0]));
+            }
+            d->offset = k;
+        } else {
+            /* Out of range below: collapse into the lowest bin */
+            k = d->offset;
+        }
+    } else if (k >= d->offset + PLEXUS_SKETCH_BINS) {
+        /* Slide window up, folding bins that fall off the bottom into bins[0] */
+        int32_t shift = k - (d->offset + PLEXUS_SKETCH_BINS - 1);
+        if (shift >= PLEXUS_SKETCH_BINS) {
+            uint64_t folded = 0;
+            for (int i = 0; i < PLEXUS_SKETCH_BINS; i++) folded += d->bins[i];
+            memset(d->bins, 0, sizeof(d->bins));
+            d->bins[0] = sat_add32(0, folded);
+        } else {
+            uint64_t folded = 0;
+            for (int32_t i = 0; i <= shift; i++) folded += d->bins[i];
+            memmove(&d->bins[1], &d->bins[shift + 1],
+                    (size_t)(PLEXUS_SKETCH_BINS - shift - 1) * sizeof(d->bins[0]));
+            memset(&d->bins[PLEXUS_SKETCH_BINS - shift], 0, (size_t)shift * sizeof(d->bins[0]));
+            d->bins[0] = sat_add32(0, folded);
+        }
+        d->offset += shift;
+    }
+
+    size_t idx = (size_t)(k - d->offset);
+    d->bins[idx] = sat_add32(d->bins[idx], n);
+}
+
+/* Keeps bin indexes and their differences well inside int32_t; only a
+ * tiny alpha with an extreme sample gets near it */
+#define SKETCH_INDEX_LIMIT (1L << 24)
+
+static int32_t sketch_index(const plexus_sketch_t* sk, double x) {
+    double k = ceil(log(x) / sk->log_gamma);
+    if (k > (double)SKETCH_INDEX_LIMIT) return (int32_t)SKETCH_INDEX_LIMIT;
+    if (k < -(double)SKETCH_INDEX_LIMIT) return -(int32_t)SKETCH_INDEX_LIMIT;
+    return (int32_t)k;
+}
+
+static void sketch_data_add(const plexus_sketch_t* sk, plexus_sketch_data_t* d, double x) {
+    if (d->count == 0) {
+        d->min = x;
+        d->max = x;
+    } else {
+        if (x < d->min) d->min = x;
+        if (x > d->max) d->max = x;
+    }
+    d->count++;
+    d->sum += x;
+
+    if (x <= 0.0) {
+        d->zero_count++;
+        return;
+    }
+
+    int32_t k = sketch_index(sk, x);
+    if (sketch_top_bin(d) < 0) {
+        /* First binned sample: centre the window on it */
+        d->offset = k - PLEXUS_SKETCH_BINS / 2;
+    }
+    sketch_bins_add(d, k, 1);
+}
+
+static void sketch_data_merge(plexus_sketch_data_t* dst, const plexus_sketch_data_t* src) {
+    if (src->count == 0) return;
+
+    if (dst->count == 0) {
+        *dst = *src;
+        return;
+    }
+
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    dst->count += src->count;
+    dst->sum += src->sum;
+    dst->zero_count += src->zero_count;
+
+    bool dst_empty = sketch_top_bin(dst) < 0;
+    for (int i = 0; i < PLEXUS_SKETCH_BINS; i++) {
+        if (!src->bins[i]) continue;
+        if (dst_empty) {
+            dst->offset = src->offset;
+            dst_empty = false;
+        }
+        sketch_bins_add(dst, src->offset + i, src->bins[i]);
+    }
+}
+
+double plexus_sketch_data_quantile(const plexus_sketch_t* sk,
+                                   const plexus_sketch_data_t* d, double q) {
+    if (d->count == 0 || !(q >= 0.0 && q <= 1.0)) {
+        return NAN;
+    }
+    if (q == 0.0) return d->min;
+    if (q == 1.0) return d->max;
+
+    /* Rank within the binned counts */
+    uint64_t total = d->zero_count;
+    for (int i = 0; i < PLEXUS_SKETCH_BINS; i++) total += d->bins[i];
+    uint64_t rank = (uint64_t)(q * (double)(total - 1));
+
+    double est;
+    if (rank < d->zero_count) {
+        est = d->min < 0.0 ? d->min : 0.0;
+    } else {
+        uint64_t seen = d->zero_count;
+        int i = 0;
+        for (; i < PLEXUS_SKETCH_BINS; i++) {
+            seen += d->bins[i];
+            if (seen > rank) break;
+        }
+        if (i >= PLEXUS_SKETCH_BINS) i = PLEXUS_SKETCH_BINS - 1;
+        /* Representative value of bin k: midpoint in relative terms */
+        est = 2.0 * exp((double)(d->offset + i) * sk->log_gamma) / (sk->gamma + 1.0);
+    }
+
+    if (est < d->min) est = d->min;
+    if (est > d->max) est = d->max;
+    return est;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Window management                                                         */
+/* ------------------------------------------------------------------------- */
+
+/**
+ * Close the open window: merge it into the pending sketch (queuing a sketch
+ * point if none is queued yet) and queue the quantile points.
+ */
+static plexus_err_t sketch_emit(plexus_client_t* client, uint8_t idx) {
+    plexus_sketch_t* sk = &client->sketches[idx];
+    if (sk->active.count == 0) {
+        return PLEXUS_OK;
+    }
+
+    size_t needed = SKETCH_QUANTILE_COUNT + (sk->pending_queued ? 0 : 1);
+    if (client->metric_count + needed > client->max_metrics) {
+        return PLEXUS_ERR_BUFFER_FULL;
+    }
+
+    uint64_t now_ms = plexus_hal_get_time_ms();
+    plexus_value_t v;
+
+    size_t base_len = strlen(sk->name);
+    for (size_t i = 0; i < SKETCH_QUANTILE_COUNT; i++) {
+        char name[PLEXUS_MAX_METRIC_NAME_LEN];
+        memcpy(name, sk->name, base_len);
+        strcpy(name + base_len, s_sketch_quantiles[i].suffix);
+
+        memset(&v, 0, sizeof(v));
+        v.type = PLEXUS_VALUE_NUMBER;
+        v.data.number = plexus_sketch_data_quantile(sk, &sk->active, s_sketch_quantiles[i].q);
+        plexus_internal_enqueue(client, name, &v, now_ms);
+    }
+
+    sketch_data_merge(&sk->pending, &sk->active);
+    if (!sk->pending_queued) {
+        memset(&v, 0, sizeof(v));
+        v.type = PLEXUS_VALUE_SKETCH;
+        v.data.sketch = idx;
+        plexus_internal_enqueue(client, sk->name, &v, now_ms);
+        sk->pending_queued = true;
+    }
+
+    sketch_data_reset(&sk->active);
+    return PLEXUS_OK;
+}
+
+static bool sketch_window_due(const plexus_sketch_t* sk, uint32_t now) {
+    return sk->active.count > 0 &&
+           plexus_internal_tick_elapsed(now, sk->window_start + sk->window_ms);
+}
+
+plexus_err_t plexus_sketch_tick(plexus_client_t* client) {
+    uint32_t now = plexus_hal_get_tick_ms();
+    plexus_err_t result = PLEXUS_OK;
+
+    for (uint8_t i = 0; i < client->sketch_count; i++) {
+        if (sketch_window_due(&client->sketches[i], now)) {
+            plexus_err_t err = sketch_emit(client, i);
+            if (err != PLEXUS_OK) {
+                result = err;
+            }
+        }
+    }
+    return result;
+}
+
+void plexus_sketch_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms) {
+    for (uint8_t i = 0; i < client->sketch_count; i++) {
+        const plexus_sketch_t* sk = &client->sketches[i];
+        if (sk->active.count > 0) {
+            plexus_internal_deadline(now, sk->window_start + sk->window_ms, wait_ms);
+        }
+    }
+}
+
+void plexus_sketch_release_one(plexus_client_t* client, uint8_t idx) {
+    client->sketches[idx].pending_queued = false;
+    sketch_data_reset(&client->sketches[idx].pending);
+}
+
+void plexus_sketch_release_pending(plexus_client_t* client) {
+    for (uint8_t i = 0; i < client->sketch_count; i++) {
+        plexus_sketch_release_one(client, i);
+    }
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_sketch_register(plexus_client_t* client, const char* metric,
+                                     uint32_t window_ms, double relative_accuracy,
+                                     plexus_sketch_handle_t* out_handle) {
+    if (!client || !metric || !out_handle) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (window_ms == 0) return PLEXUS_ERR_INVALID_ARG;
+    if (!(relative_accuracy > 0.0 && relative_accuracy < 1.0)) return PLEXUS_ERR_INVALID_ARG;
+    if (strlen(metric) + SKETCH_MAX_SUFFIX_LEN >= PLEXUS_MAX_METRIC_NAME_LEN) {
+        return PLEXUS_ERR_STRING_TOO_LONG;
+    }
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    /* Re-registering an existing metric returns its handle and updates the
+     * window; the bin width is fixed once samples may have been recorded. */
+    uint8_t idx;
+    for (idx = 0; idx < client->sketch_count; idx++) {
+        if (strcmp(client->sketches[idx].name, metric) == 0) {
+            break;
+        }
+    }
+
+    if (idx == client->sketch_count) {
+        if (client->sketch_count >= PLEXUS_MAX_SKETCHES) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        plexus_sketch_t* sk = &client->sketches[client->sketch_count++];
+        memset(sk, 0, sizeof(*sk));
+        strncpy(sk->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+        sk->gamma = (1.0 + relative_accuracy) / (1.0 - relative_accuracy);
+        sk->log_gamma = log(sk->gamma);
+    }
+
+    client->sketches[idx].window_ms = window_ms;
+
+    *out_handle = idx;
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_observe(plexus_client_t* client, plexus_sketch_handle_t handle,
+                             double value) {
+    if (!client) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (isnan(value)) return PLEXUS_OK;
+    if (!isfinite(value)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+    if (handle >= client->sketch_count) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    plexus_sketch_t* sk = &client->sketches[handle];
+    uint32_t now = plexus_hal_get_tick_ms();
+    plexus_err_t err = PLEXUS_OK;
+
+    if (sketch_window_due(sk, now)) {
+        /* A full buffer keeps folding into the overdue window */
+        if (sketch_emit(client, handle) == PLEXUS_OK) {
+            err = plexus_internal_maybe_auto_flush(client);
+        }
+    }
+
+    if (sk->active.count == 0) {
+        sk->window_start = now;
+    }
+    sketch_data_add(sk, &sk->active, value);
+    PLEXUS_WAKE_IF_SOONER(client);
+
+    PLEXUS_UNLOCK(client);
+    return err;
+}
+
+double plexus_sketch_quantile(const plexus_client_t* client,
+                               plexus_sketch_handle_t handle, double q) {
+    if (!client || !client->initialized || handle >= client->sketch_count) {
+        return NAN;
+    }
+    const plexus_sketch_t* sk = &client->sketches[handle];
+    return plexus_sketch_data_quantile(sk, &sk->active, q);
+}
+
+#endif /* PLEXUS_ENABLE_SKETCHES */
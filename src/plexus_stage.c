@@ -0,0 +1,196 @@
+/**
+ * @file plexus_stage.c
+ * @brief Per-thread staging buffers for Plexus C SDK
+ *
+ * Each producer thread claims one single-producer ring in the client and
+ * fills it without the client lock: the producer owns head, the flusher
+ * owns tail, and the two meet through release/acquire stores only. The
+ * flusher merges every ring into the queue in timestamp order when the
+ * client flushes, so many threads reporting into one gateway client scale
+ * with cores instead of queuing on the mutex.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_THREAD_STAGING
+
+#include <string.h>
+
+#if defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_THREADS__)
+    #define PLEXUS_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__) || defined(__clang__)
+    #define PLEXUS_THREAD_LOCAL __thread
+#else
+    #error "PLEXUS_ENABLE_THREAD_STAGING needs thread-local storage (C11 or GCC/Clang)"
+#endif
+
+#define STAGE_MASK ((uint16_t)(PLEXUS_STAGE_SIZE - 1))
+
+/* The marker's address identifies the thread; the cache skips the lookup */
+static PLEXUS_THREAD_LOCAL char tls_marker;
+static PLEXUS_THREAD_LOCAL plexus_client_t* tls_client;
+static PLEXUS_THREAD_LOCAL plexus_stage_t* tls_stage;
+
+/**
+ * This thread's stage, claiming a free one under the lock on first use.
+ * NULL when every stage is taken.
+ */
+static plexus_stage_t* stage_for_thread(plexus_client_t* client) {
+    if (tls_client == client && tls_stage &&
+        PLEXUS_LOAD_RELAXED(&tls_stage->owner) == (const void*)&tls_marker) {
+        return tls_stage;
+    }
+
+    plexus_stage_t* found = NULL;
+    PLEXUS_LOCK(client);
+    for (uint8_t i = 0; i < PLEXUS_MAX_STAGES && !found; i++) {
+        if (client->stages[i].owner == &tls_marker) {
+            /* Released but not yet drained: keep it */
+            found = &client->stages[i];
+            PLEXUS_STORE_RELAXED(&found->released, false);
+        }
+    }
+    for (uint8_t i = 0; i < PLEXUS_MAX_STAGES && !found; i++) {
+        plexus_stage_t* st = &client->stages[i];
+        if (st->owner == NULL) {
+            PLEXUS_STORE_RELAXED(&st->released, false);
+            PLEXUS_STORE_RELAXED(&st->owner, (const void*)&tls_marker);
+            found = st;
+        }
+    }
+    PLEXUS_UNLOCK(client);
+
+    if (found) {
+        tls_client = client;
+        tls_stage = found;
+    }
+    return found;
+}
+
+static bool stage_push(plexus_stage_t* st, const char* metric, double value) {
+    uint16_t head = st->head;
+    uint16_t next = (uint16_t)((head + 1) & STAGE_MASK);
+    if (next == PLEXUS_LOAD_ACQUIRE(&st->tail)) {
+        return false;
+    }
+    plexus_staged_point_t* p = &st->ring[head];
+    strncpy(p->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    p->name[PLEXUS_MAX_METRIC_NAME_LEN - 1] = '\0';
+    p->value = value;
+    p->timestamp_ms = plexus_hal_get_time_ms();
+    PLEXUS_STORE_RELEASE(&st->head, next);
+    return true;
+}
+
+plexus_err_t plexus_send_staged(plexus_client_t* client, const char* metric, double value) {
+    if (!client || !metric) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) {
+        return PLEXUS_ERR_STRING_TOO_LONG;
+    }
+    if (!plexus_internal_is_valid_metric_name(metric)) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    plexus_stage_t* st = stage_for_thread(client);
+    if (!st) {
+        return plexus_send_number(client, metric, value);
+    }
+    if (stage_push(st, metric, value)) {
+        return PLEXUS_OK;
+    }
+
+    /* Ring full: merge now, as a send at the flush threshold would */
+    PLEXUS_LOCK(client);
+    plexus_stage_collect(client);
+    plexus_err_t err = plexus_internal_maybe_auto_flush(client);
+    PLEXUS_UNLOCK(client);
+
+    if (stage_push(st, metric, value)) {
+        return PLEXUS_OK;
+    }
+    PLEXUS_STORE_RELAXED(&st->dropped, st->dropped + 1);
+    return err != PLEXUS_OK ? err : PLEXUS_ERR_BUFFER_FULL;
+}
+
+void plexus_stage_release(plexus_client_t* client) {
+    if (!client || tls_client != client || !tls_stage) {
+        return;
+    }
+    if (PLEXUS_LOAD_RELAXED(&tls_stage->owner) == (const void*)&tls_marker) {
+        PLEXUS_STORE_RELEASE(&tls_stage->released, true);
+    }
+    tls_client = NULL;
+    tls_stage = NULL;
+}
+
+void plexus_stage_collect(plexus_client_t* client) {
+    /* Only what was staged when the merge started, so producers can't stall it */
+    uint16_t heads[PLEXUS_MAX_STAGES];
+    for (uint8_t i = 0; i < PLEXUS_MAX_STAGES; i++) {
+        plexus_stage_t* st = &client->stages[i];
+        heads[i] = PLEXUS_LOAD_ACQUIRE(&st->head);
+
+        uint32_t dropped = PLEXUS_LOAD_RELAXED(&st->dropped);
+        if (dropped != st->dropped_seen) {
+            PLEXUS_ADD_RELAXED(&client->totals.dropped, dropped - st->dropped_seen);
+#if PLEXUS_ENABLE_CLIENT_STATS
+            client->cstats.drops_buffer_full += dropped - st->dropped_seen;
+#endif
+            st->dropped_seen = dropped;
+        }
+    }
+
+    plexus_value_t v;
+    memset(&v, 0, sizeof(v));
+    v.type = PLEXUS_VALUE_NUMBER;
+
+    /* K-way merge: each ring is already in its thread's time order */
+    while (client->metric_count < client->max_metrics) {
+        plexus_stage_t* next = NULL;
+        for (uint8_t i = 0; i < PLEXUS_MAX_STAGES; i++) {
+            plexus_stage_t* st = &client->stages[i];
+            if (st->tail != heads[i] &&
+                (!next || st->ring[st->tail].timestamp_ms < next->ring[next->tail].timestamp_ms)) {
+                next = st;
+            }
+        }
+        if (!next) {
+            break;
+        }
+
+        const plexus_staged_point_t* p = &next->ring[next->tail];
+        char name[PLEXUS_MAX_METRIC_NAME_LEN];
+        memcpy(name, p->name, sizeof(name));
+        uint64_t timestamp_ms = p->timestamp_ms;
+        v.data.number = p->value;
+        PLEXUS_STORE_RELEASE(&next->tail, (uint16_t)((next->tail + 1) & STAGE_MASK));
+
+        (void)plexus_internal_route(client, name, &v, timestamp_ms);
+    }
+
+    /* Hand back drained stages of threads that released them */
+    for (uint8_t i = 0; i < PLEXUS_MAX_STAGES; i++) {
+        plexus_stage_t* st = &client->stages[i];
+        if (PLEXUS_LOAD_ACQUIRE(&st->released) &&
+            st->tail == PLEXUS_LOAD_ACQUIRE(&st->head)) {
+            PLEXUS_STORE_RELAXED(&st->owner, (const void*)NULL);
+        }
+    }
+}
+
+bool plexus_stage_pending(const plexus_client_t* client) {
+    for (uint8_t i = 0; i < PLEXUS_MAX_STAGES; i++) {
+        const plexus_stage_t* st = &client->stages[i];
+        if (st->tail != PLEXUS_LOAD_ACQUIRE(&st->head)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif /* PLEXUS_ENABLE_THREAD_STAGING */
@@ -0,0 +1,319 @@
+/**
+ * @file plexus_stats.c
+ * @brief Array statistics kernels for Plexus C SDK
+ *
+ * One fused pass computes count, sum, sum of squares, min and max; mean,
+ * RMS and variance are derived from that summary, and summaries merge, so
+ * a window can be built from several blocks.
+ *
+ * The kernel is chosen at compile time, like every other option in this SDK:
+ *   - AVX2 (Linux gateways built with -mavx2 / -march=native)
+ *   - SSE2 (any x86-64 target)
+ *   - portable C with independent per-lane accumulators, which GCC/Clang
+ *     vectorize for NEON/Helium and ESP32-S3
+ * The x86 kernels and the portable kernel on hosted targets accumulate in
+ * double. The Cortex-M4F and ESP32-S3 FPUs are single-precision only, so
+ * there (PLEXUS_STATS_FLOAT_ACCUM) the portable kernel keeps float lanes
+ * with Kahan compensation instead of software-emulated double; lanes are
+ * combined in double once at the end. Kahan does not survive -ffast-math.
+ *
+ * Every kernel skips NaN in min/max (a NaN sample never replaces the running
+ * extreme) and lets it propagate into the sums.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_STATS
+
+#include <string.h>
+#include <math.h>
+
+#if PLEXUS_STATS_SIMD && defined(__AVX2__)
+#define PLEXUS_STATS_AVX2 1
+#include <immintrin.h>
+#elif PLEXUS_STATS_SIMD && (defined(__SSE2__) || defined(_M_X64))
+#define PLEXUS_STATS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* Portable kernel                                                           */
+/* ------------------------------------------------------------------------- */
+
+#define STATS_LANES 8
+
+#if PLEXUS_STATS_FLOAT_ACCUM
+typedef float stats_acc_t;
+
+/* Kahan step: the low-order bits lost from *sum are carried in *comp */
+#define STATS_ACCUMULATE(sum, comp, x) do { \
+    float y_ = (x) - (comp);                \
+    float t_ = (sum) + y_;                  \
+    (comp) = (t_ - (sum)) - y_;             \
+    (sum) = t_;                             \
+} while (0)
+#else
+typedef double stats_acc_t;
+
+#define STATS_ACCUMULATE(sum, comp, x) ((sum) += (x))
+#endif
+
+/** NaN-skipping extremes; all-NaN input leaves +inf/-inf, reported as NaN */
+static void stats_finish_extremes(float* lo, float* hi) {
+    if (!(*lo <= *hi)) {
+        *lo = NAN;
+        *hi = NAN;
+    }
+}
+
+void plexus_stats_summary_f32_portable(const float* values, size_t count,
+                                       plexus_stats_summary_t* out) {
+    memset(out, 0, sizeof(*out));
+    if (count == 0) {
+        return;
+    }
+
+    /* Independent per-lane accumulators break the loop-carried dependency
+     * chain; the fixed-width inner loop is what compilers vectorize. */
+    stats_acc_t sum[STATS_LANES] = {0};
+    stats_acc_t sumsq[STATS_LANES] = {0};
+#if PLEXUS_STATS_FLOAT_ACCUM
+    float sum_c[STATS_LANES] = {0};
+    float sumsq_c[STATS_LANES] = {0};
+#endif
+    float mn[STATS_LANES];
+    float mx[STATS_LANES];
+    for (size_t l = 0; l < STATS_LANES; l++) {
+        mn[l] = INFINITY;
+        mx[l] = -INFINITY;
+    }
+
+    size_t i = 0;
+    for (; i + STATS_LANES <= count; i += STATS_LANES) {
+        for (size_t l = 0; l < STATS_LANES; l++) {
+            float x = values[i + l];
+            stats_acc_t d = (stats_acc_t)x;
+            STATS_ACCUMULATE(sum[l], sum_c[l], d);
+            STATS_ACCUMULATE(sumsq[l], sumsq_c[l], d * d);
+            mn[l] = x < mn[l] ? x : mn[l];
+            mx[l] = x > mx[l] ? x : mx[l];
+        }
+    }
+    for (; i < count; i++) {
+        float x = values[i];
+        stats_acc_t d = (stats_acc_t)x;
+        STATS_ACCUMULATE(sum[0], sum_c[0], d);
+        STATS_ACCUMULATE(sumsq[0], sumsq_c[0], d * d);
+        mn[0] = x < mn[0] ? x : mn[0];
+        mx[0] = x > mx[0] ? x : mx[0];
+    }
+
+    double s = 0.0;
+    double q = 0.0;
+    float lo = mn[0];
+    float hi = mx[0];
+    for (size_t l = 0; l < STATS_LANES; l++) {
+#if PLEXUS_STATS_FLOAT_ACCUM
+        s += (double)sum[l] - (double)sum_c[l];
+        q += (double)sumsq[l] - (double)sumsq_c[l];
+#else
+        s += sum[l];
+        q += sumsq[l];
+#endif
+        if (mn[l] < lo) lo = mn[l];
+        if (mx[l] > hi) hi = mx[l];
+    }
+    stats_finish_extremes(&lo, &hi);
+
+    out->count = count;
+    out->sum = s;
+    out->sumsq = q;
+    out->min = lo;
+    out->max = hi;
+}
+
+/* ------------------------------------------------------------------------- */
+/* x86 kernels                                                               */
+/* ------------------------------------------------------------------------- */
+
+#if PLEXUS_STATS_AVX2
+
+static double hsum256_pd(__m256d v) {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+}
+
+static void stats_summary_simd(const float* values, size_t count, plexus_stats_summary_t* out) {
+    __m256 vmin = _mm256_set1_ps(INFINITY);
+    __m256 vmax = _mm256_set1_ps(-INFINITY);
+    __m256d s0 = _mm256_setzero_pd();
+    __m256d s1 = _mm256_setzero_pd();
+    __m256d q0 = _mm256_setzero_pd();
+    __m256d q1 = _mm256_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_loadu_ps(values + i);
+        /* minps/maxps return the second operand on NaN: keep the running one */
+        vmin = _mm256_min_ps(v, vmin);
+        vmax = _mm256_max_ps(v, vmax);
+        __m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        __m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+        s0 = _mm256_add_pd(s0, lo);
+        s1 = _mm256_add_pd(s1, hi);
+        q0 = _mm256_add_pd(q0, _mm256_mul_pd(lo, lo));
+        q1 = _mm256_add_pd(q1, _mm256_mul_pd(hi, hi));
+    }
+
+    float mn[8];
+    float mx[8];
+    _mm256_storeu_ps(mn, vmin);
+    _mm256_storeu_ps(mx, vmax);
+
+    double s = hsum256_pd(_mm256_add_pd(s0, s1));
+    double q = hsum256_pd(_mm256_add_pd(q0, q1));
+    float lo = mn[0];
+    float hi = mx[0];
+    for (int l = 1; l < 8; l++) {
+        if (mn[l] < lo) lo = mn[l];
+        if (mx[l] > hi) hi = mx[l];
+    }
+    for (; i < count; i++) {
+        double d = (double)values[i];
+        s += d;
+        q += d * d;
+        if (values[i] < lo) lo = values[i];
+        if (values[i] > hi) hi = values[i];
+    }
+    stats_finish_extremes(&lo, &hi);
+
+    out->count = count;
+    out->sum = s;
+    out->sumsq = q;
+    out->min = lo;
+    out->max = hi;
+}
+
+#elif PLEXUS_STATS_SSE2
+
+static double hsum128_pd(__m128d v) {
+    return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+}
+
+static void stats_summary_simd(const float* values, size_t count, plexus_stats_summary_t* out) {
+    __m128 vmin = _mm_set1_ps(INFINITY);
+    __m128 vmax = _mm_set1_ps(-INFINITY);
+    __m128d s0 = _mm_setzero_pd();
+    __m128d s1 = _mm_setzero_pd();
+    __m128d q0 = _mm_setzero_pd();
+    __m128d q1 = _mm_setzero_pd();
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_loadu_ps(values + i);
+        /* minps/maxps return the second operand on NaN: keep the running one */
+        vmin = _mm_min_ps(v, vmin);
+        vmax = _mm_max_ps(v, vmax);
+        __m128d lo = _mm_cvtps_pd(v);
+        __m128d hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        s0 = _mm_add_pd(s0, lo);
+        s1 = _mm_add_pd(s1, hi);
+        q0 = _mm_add_pd(q0, _mm_mul_pd(lo, lo));
+        q1 = _mm_add_pd(q1, _mm_mul_pd(hi, hi));
+    }
+
+    float mn[4];
+    float mx[4];
+    _mm_storeu_ps(mn, vmin);
+    _mm_storeu_ps(mx, vmax);
+
+    double s = hsum128_pd(_mm_add_pd(s0, s1));
+    double q = hsum128_pd(_mm_add_pd(q0, q1));
+    float lo = mn[0];
+    float hi = mx[0];
+    for (int l = 1; l < 4; l++) {
+        if (mn[l] < lo) lo = mn[l];
+        if (mx[l] > hi) hi = mx[l];
+    }
+    for (; i < count; i++) {
+        double d = (double)values[i];
+        s += d;
+        q += d * d;
+        if (values[i] < lo) lo = values[i];
+        if (values[i] > hi) hi = values[i];
+    }
+    stats_finish_extremes(&lo, &hi);
+
+    out->count = count;
+    out->sum = s;
+    out->sumsq = q;
+    out->min = lo;
+    out->max = hi;
+}
+
+#endif
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+void plexus_stats_summary_f32(const float* values, size_t count, plexus_stats_summary_t* out) {
+    if (!out) {
+        return;
+    }
+    if (!values || count == 0) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+#if PLEXUS_STATS_AVX2 || PLEXUS_STATS_SSE2
+    stats_summary_simd(values, count, out);
+#else
+    plexus_stats_summary_f32_portable(values, count, out);
+#endif
+}
+
+void plexus_stats_merge(plexus_stats_summary_t* a, const plexus_stats_summary_t* b) {
+    if (!a || !b || b->count == 0) {
+        return;
+    }
+    if (a->count == 0) {
+        *a = *b;
+        return;
+    }
+    a->count += b->count;
+    a->sum += b->sum;
+    a->sumsq += b->sumsq;
+    if (b->min < a->min) a->min = b->min;
+    if (b->max > a->max) a->max = b->max;
+}
+
+double plexus_stats_mean(const plexus_stats_summary_t* s) {
+    if (!s || s->count == 0) return 0.0;
+    return s->sum / (double)s->count;
+}
+
+double plexus_stats_rms(const plexus_stats_summary_t* s) {
+    if (!s || s->count == 0) return 0.0;
+    return sqrt(s->sumsq / (double)s->count);
+}
+
+double plexus_stats_variance(const plexus_stats_summary_t* s) {
+    if (!s || s->count == 0) return 0.0;
+    double mean = s->sum / (double)s->count;
+    double var = s->sumsq / (double)s->count - mean * mean;
+    return var > 0.0 ? var : 0.0; /* Rounding can push a constant signal below 0 */
+}
+
+const char* plexus_stats_backend(void) {
+#if PLEXUS_STATS_AVX2
+    return "avx2";
+#elif PLEXUS_STATS_SSE2
+    return "sse2";
+#else
+    return "portable";
+#endif
+}
+
+#endif /* PLEXUS_ENABLE_STATS */
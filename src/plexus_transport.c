@@ -0,0 +1,198 @@
+/**
+ * @file plexus_transport.c
+ * @brief Shared transport for Plexus C SDK
+ *
+ * Several clients (one per subsystem, each with its own source_id) attach
+ * to one plexus_transport_t and post through its endpoint, request buffer
+ * and backoff state. Flushing any attached client sends all of their
+ * queues coalesced into as few requests as the buffer allows; the flush
+ * itself lives in plexus.c next to the per-client one.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_SHARED_TRANSPORT
+
+#include <stdlib.h>
+#include <string.h>
+
+static plexus_transport_t* transport_init_common(plexus_transport_t* transport,
+                                                 bool heap_allocated) {
+    /* The request buffer needs no clearing */
+    memset(transport, 0, offsetof(plexus_transport_t, json_buffer));
+    strncpy(transport->endpoint, PLEXUS_DEFAULT_ENDPOINT, sizeof(transport->endpoint) - 1);
+    transport->initialized = true;
+    transport->_heap_allocated = heap_allocated;
+
+#if PLEXUS_ENABLE_THREAD_SAFE
+    transport->mutex = plexus_hal_mutex_create();
+#endif
+
+    return transport;
+}
+
+plexus_transport_t* plexus_transport_init(void) {
+    plexus_transport_t* transport = (plexus_transport_t*)malloc(sizeof(plexus_transport_t));
+    if (!transport) {
+        return NULL;
+    }
+    return transport_init_common(transport, true);
+}
+
+plexus_transport_t* plexus_transport_init_static(void* buf, size_t buf_size) {
+    if (!buf || buf_size < sizeof(plexus_transport_t)) {
+        return NULL;
+    }
+    if (((uintptr_t)buf % sizeof(void*)) != 0) {
+        return NULL;
+    }
+    return transport_init_common((plexus_transport_t*)buf, false);
+}
+
+void plexus_transport_free(plexus_transport_t* transport) {
+    if (!transport) {
+        return;
+    }
+
+    PLEXUS_LOCK(transport);
+    while (transport->client_count > 0) {
+        plexus_internal_transport_detach(transport->clients[transport->client_count - 1]);
+    }
+    PLEXUS_UNLOCK(transport);
+
+#if PLEXUS_ENABLE_THREAD_SAFE
+    if (transport->mutex) {
+        plexus_hal_mutex_destroy(transport->mutex);
+        transport->mutex = NULL;
+    }
+#endif
+
+    transport->initialized = false;
+    if (transport->_heap_allocated) {
+        free(transport);
+    }
+}
+
+plexus_err_t plexus_transport_set_endpoint(plexus_transport_t* transport, const char* endpoint) {
+    if (!transport || !endpoint) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!transport->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+    if (strlen(endpoint) >= sizeof(transport->endpoint)) {
+        return PLEXUS_ERR_STRING_TOO_LONG;
+    }
+
+    PLEXUS_LOCK(transport);
+    strncpy(transport->endpoint, endpoint, sizeof(transport->endpoint) - 1);
+    transport->endpoint[sizeof(transport->endpoint) - 1] = '\0';
+    PLEXUS_UNLOCK(transport);
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_transport_attach(plexus_transport_t* transport, plexus_client_t* client) {
+    if (!transport || !client) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!transport->initialized || !client->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    /* Hold the client's own lock across the swap so nobody is inside it
+     * when its callers move to the transport's */
+    PLEXUS_LOCK(client);
+    if (client->transport) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+#if PLEXUS_ENABLE_THREAD_SAFE
+    void* own = client->mutex;
+#endif
+
+    PLEXUS_LOCK(transport);
+    plexus_err_t err = PLEXUS_OK;
+    if (transport->client_count >= PLEXUS_MAX_TRANSPORT_CLIENTS) {
+        err = PLEXUS_ERR_BUFFER_FULL;
+    } else if (transport->client_count > 0 &&
+               strcmp(transport->clients[0]->api_key, client->api_key) != 0) {
+        /* A coalesced request is authenticated once */
+        err = PLEXUS_ERR_INVALID_ARG;
+    } else {
+        transport->clients[transport->client_count++] = client;
+        client->transport = transport;
+#if PLEXUS_ENABLE_THREAD_SAFE
+        /* Flushing one client touches them all, so they share one lock */
+        client->own_mutex = own;
+        PLEXUS_STORE_RELEASE(&client->mutex, transport->mutex);
+#endif
+    }
+    PLEXUS_UNLOCK(transport);
+#if PLEXUS_ENABLE_THREAD_SAFE
+    if (own) {
+        plexus_hal_mutex_unlock(own);
+    }
+#endif
+    return err;
+}
+
+void plexus_internal_transport_detach(plexus_client_t* client) {
+    plexus_transport_t* transport = client->transport;
+
+    /* The transport's lock is the client's until the swap below */
+    PLEXUS_LOCK(transport);
+    for (uint8_t i = 0; i < transport->client_count; i++) {
+        if (transport->clients[i] == client) {
+            memmove(&transport->clients[i], &transport->clients[i + 1],
+                    (size_t)(transport->client_count - i - 1) * sizeof(transport->clients[0]));
+            transport->client_count--;
+            break;
+        }
+    }
+    client->transport = NULL;
+#if PLEXUS_ENABLE_THREAD_SAFE
+    void* own = client->own_mutex;
+    client->own_mutex = NULL;
+    PLEXUS_STORE_RELEASE(&client->mutex, own);
+#endif
+    PLEXUS_UNLOCK(transport);
+}
+
+plexus_err_t plexus_transport_detach(plexus_client_t* client) {
+    if (!client) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+
+    PLEXUS_LOCK(client);
+#if PLEXUS_ENABLE_THREAD_SAFE
+    void* held = client->mutex;
+#endif
+    plexus_err_t err = PLEXUS_ERR_INVALID_ARG;
+    if (client->transport) {
+        plexus_internal_transport_detach(client);
+        err = PLEXUS_OK;
+    }
+    /* client->mutex may have changed; release the one taken above */
+#if PLEXUS_ENABLE_THREAD_SAFE
+    if (held) {
+        plexus_hal_mutex_unlock(held);
+    }
+#endif
+    return err;
+}
+
+plexus_err_t plexus_transport_flush(plexus_transport_t* transport) {
+    if (!transport) {
+        return PLEXUS_ERR_NULL_PTR;
+    }
+    if (!transport->initialized) {
+        return PLEXUS_ERR_NOT_INITIALIZED;
+    }
+
+    PLEXUS_LOCK(transport);
+    plexus_err_t err = plexus_internal_transport_flush(transport, true, NULL);
+    PLEXUS_UNLOCK(transport);
+    return err;
+}
+
+#endif /* PLEXUS_ENABLE_SHARED_TRANSPORT */
@@ -0,0 +1,221 @@
+/**
+ * @file plexus_trigger.c
+ * @brief Trigger-based burst capture for Plexus C SDK
+ *
+ * Each captured metric owns a ring of recent samples that is never queued
+ * on its own. When the trigger fires, every sample in the ring is committed
+ * ("pending") and the next post_samples samples are committed as they
+ * arrive. Committed samples are moved from the oldest end of the ring into
+ * the metric queue whenever it has room, so a burst larger than the queue
+ * is sent over several flushes without reordering.
+ */
+
+#include "plexus_internal.h"
+
+#if PLEXUS_ENABLE_TRIGGER
+
+#include <string.h>
+#include <math.h>
+
+static uint16_t ring_oldest(const plexus_trigger_t* trg) {
+    return (uint16_t)((trg->head + PLEXUS_TRIGGER_RING_SIZE - trg->count) % PLEXUS_TRIGGER_RING_SIZE);
+}
+
+/**
+ * Append a sample. The oldest sample is overwritten only if it is not
+ * committed; otherwise the new sample is dropped.
+ */
+static plexus_capture_sample_t* ring_push(plexus_trigger_t* trg, double value,
+                                          uint64_t timestamp_ms) {
+    if (trg->count == PLEXUS_TRIGGER_RING_SIZE) {
+        if (trg->pending == trg->count) {
+            trg->dropped++;
+            return NULL;
+        }
+        /* Overwrite the oldest uncommitted sample: pending ones sit before
+         * it, so shift them up by one slot to keep the ring contiguous. */
+        if (trg->pending > 0) {
+            uint16_t oldest = ring_oldest(trg);
+            for (uint16_t i = trg->pending; i > 0; i--) {
+                uint16_t dst = (uint16_t)((oldest + i) % PLEXUS_TRIGGER_RING_SIZE);
+                uint16_t src = (uint16_t)((oldest + i - 1) % PLEXUS_TRIGGER_RING_SIZE);
+                trg->ring[dst] = trg->ring[src];
+            }
+        }
+        trg->count--;
+    }
+
+    plexus_capture_sample_t* s = &trg->ring[trg->head];
+    s->timestamp_ms = timestamp_ms;
+    s->value = (float)value;
+    s->sent = false;
+    trg->head = (uint16_t)((trg->head + 1) % PLEXUS_TRIGGER_RING_SIZE);
+    trg->count++;
+    return s;
+}
+
+static void trigger_fire(plexus_trigger_t* trg) {
+    trg->pending = trg->count;
+    trg->post_remaining = trg->post_samples;
+#if PLEXUS_DEBUG
+    plexus_hal_log("Trigger %s: fired, %u pre-trigger samples",
+                   trg->name, (unsigned)trg->count);
+#endif
+}
+
+static bool trigger_condition(plexus_trigger_t* trg, double value) {
+    switch (trg->cond) {
+        case PLEXUS_TRIGGER_ABOVE:  return value > trg->threshold;
+        case PLEXUS_TRIGGER_BELOW:  return value < trg->threshold;
+        case PLEXUS_TRIGGER_CHANGE: return trg->has_prev && fabs(value - trg->prev_value) > trg->threshold;
+        default:                    return false;
+    }
+}
+
+/** Move committed samples of one ring into the queue while there is room. */
+static void trigger_drain_one(plexus_client_t* client, plexus_trigger_t* trg) {
+    while (trg->pending > 0 && client->metric_count < client->max_metrics) {
+        plexus_capture_sample_t* s = &trg->ring[ring_oldest(trg)];
+        if (!s->sent) {
+            plexus_value_t v;
+            memset(&v, 0, sizeof(v));
+            v.type = PLEXUS_VALUE_NUMBER;
+            v.data.number = (double)s->value;
+            plexus_internal_enqueue(client, trg->name, &v, s->timestamp_ms);
+        }
+        trg->pending--;
+        trg->count--;
+    }
+}
+
+plexus_trigger_t* plexus_trigger_find(plexus_client_t* client, const char* metric) {
+    for (uint8_t i = 0; i < client->trigger_count; i++) {
+        if (strcmp(client->triggers[i].name, metric) == 0) {
+            return &client->triggers[i];
+        }
+    }
+    return NULL;
+}
+
+void plexus_trigger_sample(plexus_client_t* client, plexus_trigger_t* trg,
+                           double value, uint64_t timestamp_ms) {
+    bool in_burst = trg->post_remaining > 0;
+    bool fire = false;
+
+    if (!in_burst) {
+        bool cond = trigger_condition(trg, value);
+        fire = cond && trg->armed;
+        trg->armed = !cond;
+    }
+    trg->prev_value = value;
+    trg->has_prev = true;
+
+    plexus_capture_sample_t* s = ring_push(trg, value, timestamp_ms);
+
+    if (fire) {
+        trigger_fire(trg);
+    } else if (in_burst) {
+        if (s) {
+            trg->pending++;
+        }
+        trg->post_remaining--;
+    } else if (s && trg->report_interval_ms > 0 && trg->pending == 0) {
+        /* Low-rate report between bursts */
+        uint32_t now = plexus_hal_get_tick_ms();
+        if (!trg->has_report ||
+            plexus_internal_tick_elapsed(now, trg->last_report_ms + trg->report_interval_ms)) {
+            plexus_value_t v;
+            memset(&v, 0, sizeof(v));
+            v.type = PLEXUS_VALUE_NUMBER;
+            v.data.number = value;
+            if (plexus_internal_enqueue(client, trg->name, &v, timestamp_ms) == PLEXUS_OK) {
+                s->sent = true;
+                trg->last_report_ms = now;
+                trg->has_report = true;
+            }
+        }
+    }
+
+    trigger_drain_one(client, trg);
+}
+
+void plexus_trigger_drain(plexus_client_t* client) {
+    for (uint8_t i = 0; i < client->trigger_count; i++) {
+        trigger_drain_one(client, &client->triggers[i]);
+    }
+}
+
+bool plexus_trigger_pending(const plexus_client_t* client) {
+    for (uint8_t i = 0; i < client->trigger_count; i++) {
+        if (client->triggers[i].pending > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Public API                                                                */
+/* ------------------------------------------------------------------------- */
+
+plexus_err_t plexus_trigger_register(plexus_client_t* client, const char* metric,
+                                      plexus_trigger_cond_t cond, double threshold,
+                                      uint16_t post_samples, uint32_t report_interval_ms) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+    if (cond != PLEXUS_TRIGGER_ABOVE && cond != PLEXUS_TRIGGER_BELOW &&
+        cond != PLEXUS_TRIGGER_CHANGE && cond != PLEXUS_TRIGGER_MANUAL) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+    if (isnan(threshold) || (cond == PLEXUS_TRIGGER_CHANGE && threshold < 0.0)) {
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+    if (strlen(metric) >= PLEXUS_MAX_METRIC_NAME_LEN) return PLEXUS_ERR_STRING_TOO_LONG;
+    if (!plexus_internal_is_valid_metric_name(metric)) return PLEXUS_ERR_INVALID_ARG;
+
+    PLEXUS_LOCK(client);
+
+    /* Re-registering changes the condition; the ring is kept */
+    plexus_trigger_t* trg = plexus_trigger_find(client, metric);
+    if (!trg) {
+        if (client->trigger_count >= PLEXUS_MAX_TRIGGERS) {
+            PLEXUS_UNLOCK(client);
+            return PLEXUS_ERR_BUFFER_FULL;
+        }
+        trg = &client->triggers[client->trigger_count++];
+        memset(trg, 0, sizeof(*trg));
+        strncpy(trg->name, metric, PLEXUS_MAX_METRIC_NAME_LEN - 1);
+    }
+
+    trg->cond = (uint8_t)cond;
+    trg->threshold = threshold;
+    trg->post_samples = post_samples;
+    trg->report_interval_ms = report_interval_ms;
+    trg->armed = true;
+
+    PLEXUS_UNLOCK(client);
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_trigger_fire(plexus_client_t* client, const char* metric) {
+    if (!client || !metric) return PLEXUS_ERR_NULL_PTR;
+    if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
+
+    PLEXUS_LOCK(client);
+
+    plexus_trigger_t* trg = plexus_trigger_find(client, metric);
+    if (!trg) {
+        PLEXUS_UNLOCK(client);
+        return PLEXUS_ERR_INVALID_ARG;
+    }
+
+    trigger_fire(trg);
+    trigger_drain_one(client, trg);
+    plexus_err_t err = plexus_internal_maybe_auto_flush(client);
+    PLEXUS_WAKE_IF_SOONER(client);
+
+    PLEXUS_UNLOCK(client);
+    return err;
+}
+
+#endif /* PLEXUS_ENABLE_TRIGGER */
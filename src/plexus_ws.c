@@ -16,25 +16,7 @@
 
 #include <string.h>
 #include <stdio.h>
-
-/* ========================================================================= */
-/* Memory barrier helpers for SPSC ring buffer                               */
-/*                                                                           */
-/* The command queue is written by the HAL callback (producer, runs in the   */
-/* platform's event task) and read by plexus_ws_tick (consumer, runs in the  */
-/* app task). On multi-core targets or with write buffers, we need release/  */
-/* acquire barriers to ensure the consumer sees the data the producer wrote. */
-/* ========================================================================= */
-
-#if defined(__GNUC__) || defined(__clang__)
-    /* GCC/Clang atomic builtins — work on ARM, Xtensa, x86 */
-    #define PLEXUS_STORE_RELEASE(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
-    #define PLEXUS_LOAD_ACQUIRE(ptr)       __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
-#else
-    /* Fallback: volatile read/write (correct on single-core, best-effort on multi-core) */
-    #define PLEXUS_STORE_RELEASE(ptr, val) (*(volatile typeof(*(ptr))*)(ptr) = (val))
-    #define PLEXUS_LOAD_ACQUIRE(ptr)       (*(volatile typeof(*(ptr))*)(ptr))
-#endif
+#include <stdlib.h>
 
 /* Reuse tick_elapsed from plexus.c — check if a deadline has passed */
 static bool ws_tick_elapsed(uint32_t now, uint32_t deadline) {
@@ -51,6 +33,27 @@ static uint32_t apply_jitter(uint32_t base_ms) {
     return base_ms - jitter_range + jitter;  /* -25% to +25% */
 }
 
+/* Send one frame on the open socket */
+static plexus_err_t ws_send_frame(plexus_client_t* client, const char* data, size_t len) {
+    plexus_err_t err = plexus_hal_ws_send(client->ws_handle, data, len);
+#if PLEXUS_ENABLE_CLIENT_STATS
+    if (err == PLEXUS_OK) {
+        client->cstats.ws_frames_sent++;
+        client->cstats.ws_bytes_sent += len;
+        if (len > client->cstats.ws_frame_max_bytes) {
+            client->cstats.ws_frame_max_bytes = (uint32_t)len;
+        }
+    }
+#endif
+    return err;
+}
+
+/* Every transition after init goes through here so it can be traced */
+static void ws_set_state(plexus_client_t* client, plexus_ws_state_t state) {
+    client->ws_state = state;
+    PLEXUS_TRACE_MARK(client, PLEXUS_TRACE_WS_STATE, state);
+}
+
 /* ========================================================================= */
 /* Event flags — set by HAL callback, consumed by tick                       */
 /* ========================================================================= */
@@ -75,18 +78,24 @@ void plexus_ws_event_handler(plexus_ws_event_t event,
     switch (event) {
         case PLEXUS_WS_EVENT_CONNECTED:
             client->ws_evt_connected = true;
+            PLEXUS_WAKE(client);
             break;
 
         case PLEXUS_WS_EVENT_DISCONNECTED:
             client->ws_evt_disconnected = true;
+            PLEXUS_WAKE(client);
             break;
 
         case PLEXUS_WS_EVENT_ERROR:
             client->ws_evt_error = true;
+            PLEXUS_WAKE(client);
             break;
 
         case PLEXUS_WS_EVENT_DATA:
             if (!data || data_len == 0) break;
+#if PLEXUS_ENABLE_CLIENT_STATS
+            client->cstats.ws_frames_received++; /* HAL task; approximate if read concurrently */
+#endif
 
             /* Parse message type and route */
             {
@@ -98,6 +107,7 @@ void plexus_ws_event_handler(plexus_ws_event_t event,
                 if (strcmp(msg_type, "authenticated") == 0) {
                     /* Auth success — transition handled by tick */
                     client->ws_evt_authenticated = true;
+                    PLEXUS_WAKE(client);
 
                 } else if (strcmp(msg_type, "typed_command") == 0) {
                     /* Enqueue command into SPSC ring buffer (producer side) */
@@ -112,6 +122,7 @@ void plexus_ws_event_handler(plexus_ws_event_t event,
 
                         /* Release: ensure slot data is visible before head advances */
                         PLEXUS_STORE_RELEASE(&client->ws_cmd_head, next_head);
+                        PLEXUS_WAKE(client);
                     }
 #if PLEXUS_DEBUG
                     else {
@@ -161,7 +172,7 @@ void plexus_ws_cleanup(plexus_client_t* client) {
         plexus_hal_ws_close(client->ws_handle);
         client->ws_handle = NULL;
     }
-    client->ws_state = PLEXUS_WS_DISCONNECTED;
+    ws_set_state(client, PLEXUS_WS_DISCONNECTED);
 }
 
 /* ========================================================================= */
@@ -193,13 +204,13 @@ static void ws_start_connect(plexus_client_t* client) {
     );
 
     if (client->ws_handle) {
-        client->ws_state = PLEXUS_WS_CONNECTING;
+        ws_set_state(client, PLEXUS_WS_CONNECTING);
 #if PLEXUS_DEBUG
         plexus_hal_log("plexus_ws: connecting to %s", client->ws_endpoint);
 #endif
     } else {
         /* HAL connect failed immediately — go to reconnect */
-        client->ws_state = PLEXUS_WS_RECONNECTING;
+        ws_set_state(client, PLEXUS_WS_RECONNECTING);
         client->ws_reconnect_deadline = plexus_hal_get_tick_ms() +
             apply_jitter(PLEXUS_WS_RECONNECT_BASE_MS);
     }
@@ -207,10 +218,10 @@ static void ws_start_connect(plexus_client_t* client) {
 
 static void ws_send_auth(plexus_client_t* client) {
     int len = plexus_json_serialize_ws_auth(client, client->json_buffer,
-                                             sizeof(client->json_buffer));
+                                             client->json_buffer_size);
     if (len > 0) {
-        plexus_hal_ws_send(client->ws_handle, client->json_buffer, (size_t)len);
-        client->ws_state = PLEXUS_WS_AUTHENTICATING;
+        ws_send_frame(client, client->json_buffer, (size_t)len);
+        ws_set_state(client, PLEXUS_WS_AUTHENTICATING);
         /* Set auth timeout deadline */
         client->ws_reconnect_deadline = plexus_hal_get_tick_ms() +
             PLEXUS_WS_AUTH_TIMEOUT_MS;
@@ -222,9 +233,9 @@ static void ws_send_auth(plexus_client_t* client) {
 
 static void ws_send_heartbeat(plexus_client_t* client) {
     int len = plexus_json_serialize_ws_heartbeat(client, client->json_buffer,
-                                                  sizeof(client->json_buffer));
+                                                  client->json_buffer_size);
     if (len > 0) {
-        plexus_hal_ws_send(client->ws_handle, client->json_buffer, (size_t)len);
+        ws_send_frame(client, client->json_buffer, (size_t)len);
     }
     client->ws_last_heartbeat_ms = plexus_hal_get_tick_ms();
 }
@@ -235,8 +246,11 @@ static void ws_enter_reconnect(plexus_client_t* client) {
         client->ws_handle = NULL;
     }
 
-    client->ws_state = PLEXUS_WS_RECONNECTING;
+    ws_set_state(client, PLEXUS_WS_RECONNECTING);
     client->ws_reconnect_count++;
+#if PLEXUS_ENABLE_CLIENT_STATS
+    client->cstats.ws_reconnects++;
+#endif
 
     /* Exponential backoff: base * 2^count, capped at max */
     uint32_t backoff = PLEXUS_WS_RECONNECT_BASE_MS;
@@ -260,6 +274,60 @@ static void ws_enter_reconnect(plexus_client_t* client) {
 /* Command dispatch                                                          */
 /* ========================================================================= */
 
+#if PLEXUS_ENABLE_LAST_VALUE
+/* Built-in "snapshot": reply with the whole last-value cache */
+static void ws_respond_snapshot(plexus_client_t* client, const char* cmd_id) {
+    PLEXUS_LOCK(client);
+    int len = plexus_json_serialize_snapshot_result(client, cmd_id, client->json_buffer,
+                                                    client->json_buffer_size);
+    if (len > 0) {
+        ws_send_frame(client, client->json_buffer, (size_t)len);
+    }
+    PLEXUS_UNLOCK(client);
+
+    if (len <= 0) {
+        plexus_command_respond(client, cmd_id, NULL, "Snapshot exceeds PLEXUS_JSON_BUFFER_SIZE");
+    }
+}
+#endif
+
+#if PLEXUS_ENABLE_HISTORY
+/* Built-in "history": params {"metric":"...","since":<ms>} */
+static void ws_respond_history(plexus_client_t* client, const plexus_cmd_msg_t* msg) {
+    char metric[PLEXUS_MAX_METRIC_NAME_LEN];
+    char since_str[24];
+    uint64_t since = 0;
+
+    if (!plexus_json_find_string(msg->params_json, "metric", metric, sizeof(metric))) {
+        plexus_command_respond(client, msg->id, NULL, "Missing param: metric");
+        return;
+    }
+    if (plexus_json_find_value(msg->params_json, "since", since_str, sizeof(since_str))) {
+        since = (uint64_t)strtoull(since_str, NULL, 10);
+    }
+
+    PLEXUS_LOCK(client);
+    int len = -1;
+    plexus_history_t* hist = plexus_history_find(client, metric);
+    if (hist) {
+        len = plexus_json_serialize_history_result(hist, msg->id, since, client->json_buffer,
+                                                   client->json_buffer_size);
+        if (len > 0) {
+            ws_send_frame(client, client->json_buffer, (size_t)len);
+        }
+    }
+    PLEXUS_UNLOCK(client);
+
+    if (!hist) {
+        char err_msg[128];
+        snprintf(err_msg, sizeof(err_msg), "No history for metric: %.64s", metric);
+        plexus_command_respond(client, msg->id, NULL, err_msg);
+    } else if (len <= 0) {
+        plexus_command_respond(client, msg->id, NULL, "History exceeds PLEXUS_JSON_BUFFER_SIZE");
+    }
+}
+#endif
+
 static void ws_dispatch_commands(plexus_client_t* client) {
     /* SPSC ring buffer consumer — acquire head to see producer's writes */
     while (client->ws_cmd_tail != PLEXUS_LOAD_ACQUIRE(&client->ws_cmd_head)) {
@@ -276,7 +344,7 @@ static void ws_dispatch_commands(plexus_client_t* client) {
                         "{\"type\":\"command_result\",\"id\":\"%.30s\",\"event\":\"ack\",\"command\":\"%.30s\"}",
                         msg->id, msg->command);
                     if (ack_len > 0 && ack_len < (int)sizeof(ack_buf)) {
-                        plexus_hal_ws_send(client->ws_handle, ack_buf, (size_t)ack_len);
+                        ws_send_frame(client, ack_buf, (size_t)ack_len);
                     }
                 }
 
@@ -295,10 +363,25 @@ static void ws_dispatch_commands(plexus_client_t* client) {
         }
 
         if (!found) {
-            /* Auto-respond with error for unknown commands */
             strncpy(client->ws_last_cmd_name, msg->command,
                     PLEXUS_MAX_COMMAND_NAME_LEN - 1);
             client->ws_last_cmd_name[PLEXUS_MAX_COMMAND_NAME_LEN - 1] = '\0';
+#if PLEXUS_ENABLE_LAST_VALUE
+            if (strcmp(msg->command, "snapshot") == 0) {
+                ws_respond_snapshot(client, msg->id);
+                found = true;
+            }
+#endif
+#if PLEXUS_ENABLE_HISTORY
+            if (strcmp(msg->command, "history") == 0) {
+                ws_respond_history(client, msg);
+                found = true;
+            }
+#endif
+        }
+
+        if (!found) {
+            /* Auto-respond with error for unknown commands */
             char err_msg[128];
             snprintf(err_msg, sizeof(err_msg), "Unknown command: %.64s", msg->command);
             plexus_command_respond(client, msg->id, NULL, err_msg);
@@ -338,7 +421,7 @@ void plexus_ws_tick(plexus_client_t* client) {
         case PLEXUS_WS_AUTHENTICATING:
             if (client->ws_evt_authenticated) {
                 client->ws_evt_authenticated = false;
-                client->ws_state = PLEXUS_WS_CONNECTED;
+                ws_set_state(client, PLEXUS_WS_CONNECTED);
                 client->ws_stable_since = now;
                 client->ws_last_heartbeat_ms = now;
                 /* Reset reconnect count after stable connection */
@@ -390,6 +473,30 @@ void plexus_ws_tick(plexus_client_t* client) {
     }
 }
 
+void plexus_ws_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms) {
+    if (client->ws_evt_connected || client->ws_evt_disconnected ||
+        client->ws_evt_error || client->ws_evt_authenticated ||
+        client->ws_cmd_head != client->ws_cmd_tail) {
+        *wait_ms = 0;
+        return;
+    }
+
+    switch (client->ws_state) {
+        case PLEXUS_WS_AUTHENTICATING: /* Auth timeout */
+        case PLEXUS_WS_RECONNECTING:   /* Backoff expiry */
+            plexus_internal_deadline(now, client->ws_reconnect_deadline, wait_ms);
+            break;
+        case PLEXUS_WS_CONNECTED:
+            plexus_internal_deadline(now, client->ws_last_heartbeat_ms +
+                                          PLEXUS_WS_HEARTBEAT_INTERVAL_MS, wait_ms);
+            break;
+        case PLEXUS_WS_DISCONNECTED:
+        case PLEXUS_WS_CONNECTING:     /* Waits on HAL events only */
+        default:
+            break;
+    }
+}
+
 /* ========================================================================= */
 /* Telemetry send over WebSocket                                             */
 /* ========================================================================= */
@@ -400,13 +507,14 @@ plexus_err_t plexus_ws_send_telemetry(plexus_client_t* client) {
     }
 
     int len = plexus_json_serialize_ws_telemetry(client, client->json_buffer,
-                                                  sizeof(client->json_buffer));
+                                                  client->json_buffer_size);
     if (len <= 0) {
         return PLEXUS_ERR_JSON;
     }
 
-    plexus_err_t err = plexus_hal_ws_send(client->ws_handle,
-                                           client->json_buffer, (size_t)len);
+    PLEXUS_TRACE_ENTER(client, PLEXUS_TRACE_WS_SEND, len);
+    plexus_err_t err = ws_send_frame(client, client->json_buffer, (size_t)len);
+    PLEXUS_TRACE_EXIT(client, PLEXUS_TRACE_WS_SEND, len, err);
     if (err != PLEXUS_OK) {
         return err;
     }
@@ -511,17 +619,25 @@ plexus_err_t plexus_command_register(plexus_client_t* client, const char* name,
 
 plexus_err_t plexus_command_respond(plexus_client_t* client, const char* cmd_id,
                                      const char* result_json, const char* error) {
-    if (!client || !cmd_id) return PLEXUS_ERR_NULL_PTR;
+    if (!client) return PLEXUS_ERR_NULL_PTR;
+    return plexus_command_respond_to(client, cmd_id, client->ws_last_cmd_name,
+                                     result_json, error);
+}
+
+plexus_err_t plexus_command_respond_to(plexus_client_t* client, const char* cmd_id,
+                                        const char* command, const char* result_json,
+                                        const char* error) {
+    if (!client || !cmd_id || !command) return PLEXUS_ERR_NULL_PTR;
     if (!client->initialized) return PLEXUS_ERR_NOT_INITIALIZED;
     if (client->ws_state != PLEXUS_WS_CONNECTED) return PLEXUS_ERR_WS_NOT_CONNECTED;
 
     int len = plexus_json_serialize_command_result(
-        cmd_id, client->ws_last_cmd_name,
+        cmd_id, command,
         result_json, error,
-        client->json_buffer, sizeof(client->json_buffer));
+        client->json_buffer, client->json_buffer_size);
     if (len <= 0) return PLEXUS_ERR_JSON;
 
-    return plexus_hal_ws_send(client->ws_handle, client->json_buffer, (size_t)len);
+    return ws_send_frame(client, client->json_buffer, (size_t)len);
 }
 
 /* --- Param helpers --- */
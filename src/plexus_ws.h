@@ -22,6 +22,12 @@
  */
 void plexus_ws_tick(plexus_client_t* client);
 
+/**
+ * Fold the state machine's next timer (auth timeout, reconnect, heartbeat)
+ * into *wait_ms; 0 if HAL events or commands are waiting for the tick.
+ */
+void plexus_ws_next_deadline(const plexus_client_t* client, uint32_t now, uint32_t* wait_ms);
+
 /**
  * Send telemetry points over WebSocket.
  * Called from plexus_flush() when WS is connected.
@@ -58,6 +64,14 @@ int plexus_json_serialize_ws_telemetry(const plexus_client_t* client, char* buf,
 int plexus_json_serialize_command_result(const char* cmd_id, const char* command_name,
                                           const char* result_json, const char* error,
                                           char* buf, size_t buf_size);
+#if PLEXUS_ENABLE_LAST_VALUE
+int plexus_json_serialize_snapshot_result(const plexus_client_t* client, const char* cmd_id,
+                                           char* buf, size_t buf_size);
+#endif
+#if PLEXUS_ENABLE_HISTORY
+int plexus_json_serialize_history_result(const plexus_history_t* hist, const char* cmd_id,
+                                          uint64_t since_ms, char* buf, size_t buf_size);
+#endif
 
 /* --- Minimal JSON field extraction --- */
 
@@ -6,6 +6,10 @@
  * can compile and run on macOS/Linux without real hardware.
  */
 
+#if MOCK_HAL_REAL_MUTEX
+#define _POSIX_C_SOURCE 200809L     /* pthread_mutex_timedlock() */
+#endif
+
 #include "plexus.h"
 #include <stdarg.h>
 #include <stdio.h>
@@ -17,7 +21,8 @@ static uint64_t s_time_ms = 1700000000000ULL; /* ~Nov 2023 in ms */
 
 /* Track last HTTP POST for test assertions */
 static char s_last_post_url[256] = {0};
-static char s_last_post_body[PLEXUS_JSON_BUFFER_SIZE] = {0};
+/* Large enough for plexus_init_sized() clients with bigger JSON buffers */
+static char s_last_post_body[16384] = {0};
 static size_t s_last_post_body_len = 0;
 static char s_last_user_agent[128] = {0};
 static plexus_err_t s_next_post_result = PLEXUS_OK;
@@ -109,7 +114,8 @@ plexus_err_t plexus_hal_http_post(const char* url, const char* api_key,
 }
 
 uint64_t plexus_hal_get_time_ms(void) {
-    return s_time_ms++;
+    /* Atomic so test_stage's producer threads stay race-free */
+    return __atomic_fetch_add(&s_time_ms, 1, __ATOMIC_RELAXED);
 }
 
 uint32_t plexus_hal_get_tick_ms(void) {
@@ -209,11 +215,108 @@ plexus_err_t plexus_hal_storage_clear(const char* key) {
 
 #endif /* PLEXUS_ENABLE_PERSISTENT_BUFFER */
 
+/* ========================================================================= */
+/* Cycle counter mock — advanced by hand, 100 counts per microsecond          */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_TIMING
+
+static uint32_t s_cycles = 0;
+static uint32_t s_cycles_step = 0;
+
+void mock_hal_set_cycles(uint32_t cycles) {
+    s_cycles = cycles;
+}
+
+void mock_hal_advance_cycles(uint32_t delta) {
+    s_cycles += delta;
+}
+
+/* Also advance the counter by step after every read, e.g. across a wrap */
+void mock_hal_set_cycles_step(uint32_t step) {
+    s_cycles_step = step;
+}
+
+uint32_t plexus_hal_get_cycles(void) {
+    uint32_t cycles = s_cycles;
+    s_cycles += s_cycles_step;
+    return cycles;
+}
+
+uint32_t plexus_hal_cycles_per_us(void) {
+    return 100;
+}
+
+#endif /* PLEXUS_ENABLE_TIMING */
+
 /* ========================================================================= */
 /* Thread safety mock                                                        */
 /* ========================================================================= */
 
-#if PLEXUS_ENABLE_THREAD_SAFE
+#if PLEXUS_ENABLE_THREAD_SAFE && MOCK_HAL_REAL_MUTEX
+
+/*
+ * Recursive pthread mutexes for tests that race real threads. A lock that
+ * waits over two seconds (a deadlock) or an unlock by a thread that doesn't
+ * hold the mutex counts as an error instead of hanging or aborting.
+ */
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+
+static int s_mutex_lock_count = 0;
+static int s_mutex_unlock_count = 0;
+static int s_mutex_errors = 0;
+
+int mock_hal_mutex_lock_count(void) { return __atomic_load_n(&s_mutex_lock_count, __ATOMIC_RELAXED); }
+int mock_hal_mutex_unlock_count(void) { return __atomic_load_n(&s_mutex_unlock_count, __ATOMIC_RELAXED); }
+int mock_hal_mutex_errors(void) { return __atomic_load_n(&s_mutex_errors, __ATOMIC_RELAXED); }
+
+void mock_hal_mutex_reset(void) {
+    __atomic_store_n(&s_mutex_lock_count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mutex_unlock_count, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&s_mutex_errors, 0, __ATOMIC_RELAXED);
+}
+
+void* plexus_hal_mutex_create(void) {
+    pthread_mutex_t* m = (pthread_mutex_t*)malloc(sizeof(*m));
+    pthread_mutexattr_t attr;
+    if (!m) {
+        return NULL;
+    }
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(m, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return m;
+}
+
+void plexus_hal_mutex_lock(void* mutex) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += 2;
+    if (pthread_mutex_timedlock((pthread_mutex_t*)mutex, &deadline) != 0) {
+        __atomic_add_fetch(&s_mutex_errors, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_add_fetch(&s_mutex_lock_count, 1, __ATOMIC_RELAXED);
+}
+
+void plexus_hal_mutex_unlock(void* mutex) {
+    if (pthread_mutex_unlock((pthread_mutex_t*)mutex) != 0) {
+        __atomic_add_fetch(&s_mutex_errors, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    __atomic_add_fetch(&s_mutex_unlock_count, 1, __ATOMIC_RELAXED);
+}
+
+void plexus_hal_mutex_destroy(void* mutex) {
+    pthread_mutex_destroy((pthread_mutex_t*)mutex);
+    free(mutex);
+}
+
+#elif PLEXUS_ENABLE_THREAD_SAFE
 
 static int s_mutex_lock_count = 0;
 static int s_mutex_unlock_count = 0;
@@ -245,3 +348,69 @@ void plexus_hal_mutex_destroy(void* mutex) {
 }
 
 #endif /* PLEXUS_ENABLE_THREAD_SAFE */
+
+/* ========================================================================= */
+/* WebSocket mock — captures sends, lets tests inject events                 */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_WEBSOCKET
+
+static plexus_ws_event_cb_t s_ws_callback = NULL;
+static void* s_ws_user_data = NULL;
+static bool s_ws_open = false;
+static char s_ws_last_sent[PLEXUS_JSON_BUFFER_SIZE] = {0};
+static int s_ws_send_count = 0;
+
+void mock_hal_ws_reset(void) {
+    s_ws_callback = NULL;
+    s_ws_user_data = NULL;
+    s_ws_open = false;
+    s_ws_last_sent[0] = '\0';
+    s_ws_send_count = 0;
+}
+
+/** Deliver an event as the platform transport would (data may be NULL) */
+void mock_hal_ws_inject(plexus_ws_event_t event, const char* data) {
+    if (s_ws_callback) {
+        s_ws_callback(event, data, data ? strlen(data) : 0, s_ws_user_data);
+    }
+}
+
+const char* mock_hal_ws_last_sent(void) {
+    return s_ws_last_sent;
+}
+
+int mock_hal_ws_send_count(void) {
+    return s_ws_send_count;
+}
+
+void* plexus_hal_ws_connect(const char* url, plexus_ws_event_cb_t callback,
+                             void* user_data) {
+    (void)url;
+    s_ws_callback = callback;
+    s_ws_user_data = user_data;
+    s_ws_open = true;
+    return (void*)1; /* Non-NULL sentinel */
+}
+
+plexus_err_t plexus_hal_ws_send(void* ws_handle, const char* data, size_t data_len) {
+    (void)ws_handle;
+    s_ws_send_count++;
+    if (data && data_len < sizeof(s_ws_last_sent)) {
+        memcpy(s_ws_last_sent, data, data_len);
+        s_ws_last_sent[data_len] = '\0';
+    }
+    return PLEXUS_OK;
+}
+
+void plexus_hal_ws_close(void* ws_handle) {
+    (void)ws_handle;
+    s_ws_open = false;
+}
+
+bool plexus_hal_ws_is_connected(void* ws_handle) {
+    (void)ws_handle;
+    return s_ws_open;
+}
+
+#endif /* PLEXUS_ENABLE_WEBSOCKET */
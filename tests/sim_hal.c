@@ -0,0 +1,289 @@
+/**
+ * @file sim_hal.c
+ * @brief Simulated-network HAL — virtual time, latency, bandwidth and faults
+ *
+ * See sim_hal.h. Link instead of mock_hal.c.
+ */
+
+#include "sim_hal.h"
+#include <math.h>
+#include <string.h>
+
+#define SIM_EPOCH_MS 1700000000000ULL
+#define SIM_MAX_WINDOWS 16
+
+static uint64_t s_now_ms = 0;
+static uint32_t s_rng = 1;
+static sim_net_config_t s_net;
+static sim_hal_stats_t s_stats;
+static sim_deliver_fn s_deliver = NULL;
+static void* s_deliver_user = NULL;
+
+static struct {
+    uint64_t start_ms;
+    uint64_t end_ms;
+    plexus_err_t err;
+} s_windows[SIM_MAX_WINDOWS];
+static int s_window_count = 0;
+
+/* xorshift32: deterministic per seed, good enough for fault draws */
+static uint32_t sim_rand(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+/* Uniform in [0, 1) */
+static double sim_uniform(void) {
+    return (double)(sim_rand() >> 8) / (double)(1u << 24);
+}
+
+static bool sim_chance(double rate) {
+    return rate > 0.0 && sim_uniform() < rate;
+}
+
+static uint32_t sim_latency(void) {
+    uint32_t ms = s_net.latency_ms;
+    switch (s_net.latency_dist) {
+        case SIM_LATENCY_UNIFORM:
+            if (s_net.latency_max_ms > s_net.latency_ms) {
+                ms += sim_rand() % (s_net.latency_max_ms - s_net.latency_ms + 1);
+            }
+            break;
+        case SIM_LATENCY_EXPONENTIAL:
+            ms += (uint32_t)(-(double)s_net.latency_spread_ms * log(1.0 - sim_uniform()));
+            if (s_net.latency_max_ms > 0 && ms > s_net.latency_max_ms) {
+                ms = s_net.latency_max_ms;
+            }
+            break;
+        case SIM_LATENCY_FIXED:
+        default:
+            break;
+    }
+    return ms;
+}
+
+static bool sim_window_err(plexus_err_t* out) {
+    for (int i = 0; i < s_window_count; i++) {
+        if (s_now_ms >= s_windows[i].start_ms && s_now_ms < s_windows[i].end_ms) {
+            *out = s_windows[i].err;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sim_deliver(const char* body, size_t len) {
+    s_stats.delivered++;
+    s_stats.bytes_delivered += len;
+    if (s_deliver) {
+        s_deliver(body, len, s_now_ms, s_deliver_user);
+    }
+}
+
+/* ---- Harness API ---- */
+
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+static void sim_storage_reset(void);
+#endif
+
+void sim_hal_reset(uint32_t seed) {
+    s_now_ms = 0;
+    s_rng = seed ? seed : 1;
+    memset(&s_net, 0, sizeof(s_net));
+    memset(&s_stats, 0, sizeof(s_stats));
+    s_deliver = NULL;
+    s_deliver_user = NULL;
+    s_window_count = 0;
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+    sim_storage_reset();
+#endif
+}
+
+void sim_hal_set_network(const sim_net_config_t* cfg) {
+    s_net = *cfg;
+}
+
+bool sim_hal_add_window(uint64_t start_ms, uint64_t end_ms, plexus_err_t err) {
+    if (s_window_count >= SIM_MAX_WINDOWS) {
+        return false;
+    }
+    s_windows[s_window_count].start_ms = start_ms;
+    s_windows[s_window_count].end_ms = end_ms;
+    s_windows[s_window_count].err = err;
+    s_window_count++;
+    return true;
+}
+
+void sim_hal_set_deliver_cb(sim_deliver_fn fn, void* user_data) {
+    s_deliver = fn;
+    s_deliver_user = user_data;
+}
+
+uint64_t sim_hal_now_ms(void) {
+    return s_now_ms;
+}
+
+void sim_hal_advance(uint32_t ms) {
+    s_now_ms += ms;
+}
+
+void sim_hal_get_stats(sim_hal_stats_t* out) {
+    *out = s_stats;
+}
+
+/* ---- HAL function implementations ---- */
+
+plexus_err_t plexus_hal_http_post(const char* url, const char* api_key,
+                                   const char* user_agent,
+                                   const char* body, size_t body_len) {
+    (void)url;
+    (void)api_key;
+    (void)user_agent;
+    s_stats.posts++;
+
+    plexus_err_t window_err;
+    if (sim_window_err(&window_err)) {
+        s_stats.outage_failures++;
+        s_now_ms += window_err == PLEXUS_ERR_NETWORK ? s_net.timeout_ms : sim_latency();
+        return window_err;
+    }
+
+    if (sim_chance(s_net.loss_rate)) {
+        s_stats.lost++;
+        s_now_ms += s_net.timeout_ms;
+        return PLEXUS_ERR_NETWORK;
+    }
+
+    uint32_t elapsed = sim_latency();
+    if (s_net.bandwidth_bps > 0) {
+        elapsed += (uint32_t)((uint64_t)body_len * 1000u / s_net.bandwidth_bps);
+    }
+
+    if (sim_chance(s_net.server_error_rate)) {
+        s_stats.server_errors++;
+        s_now_ms += elapsed;
+        return PLEXUS_ERR_SERVER;
+    }
+    if (sim_chance(s_net.rate_limit_rate)) {
+        s_stats.rate_limited++;
+        s_now_ms += elapsed;
+        return PLEXUS_ERR_RATE_LIMIT;
+    }
+
+    s_now_ms += elapsed;
+    sim_deliver(body, body_len);
+
+    if (sim_chance(s_net.ack_loss_rate)) {
+        s_stats.ack_lost++;
+        if (s_net.timeout_ms > elapsed) {
+            s_now_ms += s_net.timeout_ms - elapsed;
+        }
+        return PLEXUS_ERR_NETWORK;
+    }
+    return PLEXUS_OK;
+}
+
+uint64_t plexus_hal_get_time_ms(void) {
+    return SIM_EPOCH_MS + s_now_ms;
+}
+
+uint32_t plexus_hal_get_tick_ms(void) {
+    return (uint32_t)s_now_ms;
+}
+
+void plexus_hal_delay_ms(uint32_t ms) {
+    s_now_ms += ms;
+}
+
+void plexus_hal_log(const char* fmt, ...) {
+    (void)fmt;
+}
+
+/* ========================================================================= */
+/* Persistent storage — key-value map with a byte high-water mark            */
+/* ========================================================================= */
+
+#if PLEXUS_ENABLE_PERSISTENT_BUFFER
+
+#define SIM_STORAGE_SLOTS (PLEXUS_PERSIST_MAX_BATCHES + 4)
+#define SIM_STORAGE_KEY_LEN 32
+
+static struct {
+    char key[SIM_STORAGE_KEY_LEN];
+    char data[PLEXUS_JSON_BUFFER_SIZE];
+    size_t len;
+    bool used;
+} s_storage[SIM_STORAGE_SLOTS];
+
+static void sim_storage_reset(void) {
+    memset(s_storage, 0, sizeof(s_storage));
+}
+
+static int sim_storage_find(const char* key) {
+    for (int i = 0; i < SIM_STORAGE_SLOTS; i++) {
+        if (s_storage[i].used && strcmp(s_storage[i].key, key) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void sim_storage_account(void) {
+    size_t bytes = 0;
+    for (int i = 0; i < SIM_STORAGE_SLOTS; i++) {
+        if (s_storage[i].used) {
+            bytes += s_storage[i].len;
+        }
+    }
+    s_stats.storage_bytes = bytes;
+    if (bytes > s_stats.storage_high_water) {
+        s_stats.storage_high_water = bytes;
+    }
+}
+
+plexus_err_t plexus_hal_storage_write(const char* key, const void* data, size_t len) {
+    if (len > PLEXUS_JSON_BUFFER_SIZE || strlen(key) >= SIM_STORAGE_KEY_LEN) {
+        return PLEXUS_ERR_HAL;
+    }
+    int idx = sim_storage_find(key);
+    for (int i = 0; idx < 0 && i < SIM_STORAGE_SLOTS; i++) {
+        if (!s_storage[i].used) {
+            idx = i;
+            strcpy(s_storage[i].key, key);
+            s_storage[i].used = true;
+        }
+    }
+    if (idx < 0) {
+        return PLEXUS_ERR_HAL;
+    }
+    memcpy(s_storage[idx].data, data, len);
+    s_storage[idx].len = len;
+    sim_storage_account();
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_hal_storage_read(const char* key, void* data, size_t max_len, size_t* out_len) {
+    int idx = sim_storage_find(key);
+    if (idx < 0) {
+        if (out_len) *out_len = 0;
+        return PLEXUS_OK; /* Key not found is not an error */
+    }
+    size_t len = s_storage[idx].len < max_len ? s_storage[idx].len : max_len;
+    memcpy(data, s_storage[idx].data, len);
+    if (out_len) *out_len = len;
+    return PLEXUS_OK;
+}
+
+plexus_err_t plexus_hal_storage_clear(const char* key) {
+    int idx = sim_storage_find(key);
+    if (idx >= 0) {
+        s_storage[idx].used = false;
+        s_storage[idx].len = 0;
+        sim_storage_account();
+    }
+    return PLEXUS_OK;
+}
+
+#endif /* PLEXUS_ENABLE_PERSISTENT_BUFFER */
@@ -0,0 +1,89 @@
+/**
+ * @file sim_hal.h
+ * @brief Simulated-network HAL with fault injection and virtual time
+ *
+ * A drop-in replacement for mock_hal.c (link one or the other). Time only
+ * moves when the SDK waits (plexus_hal_delay_ms, an HTTP post's latency) or
+ * the harness calls sim_hal_advance(), so hours of traffic run in seconds
+ * and every run with the same seed is identical.
+ *
+ * Each post draws a latency, adds transfer time at the configured bandwidth,
+ * then fails by schedule (outage windows) or at random by rate. A "lost"
+ * request never reaches the server; a "lost ack" reaches it and is
+ * delivered, but the client sees a timeout — the source of duplicates
+ * under at-least-once retry.
+ */
+
+#ifndef PLEXUS_SIM_HAL_H
+#define PLEXUS_SIM_HAL_H
+
+#include "plexus.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    SIM_LATENCY_FIXED,       /* Always latency_ms */
+    SIM_LATENCY_UNIFORM,     /* Uniform in [latency_ms, latency_max_ms] */
+    SIM_LATENCY_EXPONENTIAL, /* latency_ms + Exp(mean latency_spread_ms), capped at latency_max_ms */
+} sim_latency_dist_t;
+
+typedef struct {
+    sim_latency_dist_t latency_dist;
+    uint32_t latency_ms;          /* Fixed value or lower bound */
+    uint32_t latency_max_ms;      /* Upper bound (0 = none for exponential) */
+    uint32_t latency_spread_ms;   /* Mean of the exponential tail */
+    uint32_t bandwidth_bps;       /* Upload bytes per second (0 = unlimited) */
+    uint32_t timeout_ms;          /* Time a lost request takes to fail */
+    double loss_rate;             /* Request never reaches the server */
+    double ack_loss_rate;         /* Delivered, but the client sees a timeout */
+    double server_error_rate;     /* 5xx */
+    double rate_limit_rate;       /* 429 */
+} sim_net_config_t;
+
+typedef struct {
+    uint32_t posts;
+    uint32_t delivered;           /* Bodies the server accepted (incl. lost acks) */
+    uint32_t lost;
+    uint32_t ack_lost;
+    uint32_t server_errors;
+    uint32_t rate_limited;
+    uint32_t outage_failures;     /* Failures caused by a scheduled window */
+    uint64_t bytes_delivered;
+    size_t storage_bytes;         /* Persistent storage in use now */
+    size_t storage_high_water;
+} sim_hal_stats_t;
+
+/** Called for every body the server accepts, at the virtual time it lands */
+typedef void (*sim_deliver_fn)(const char* body, size_t len, uint64_t now_ms, void* user_data);
+
+/** Reset clock, storage, schedule and stats; seed the fault RNG */
+void sim_hal_reset(uint32_t seed);
+
+/** Network behaviour for subsequent posts (defaults: 0 ms, no faults) */
+void sim_hal_set_network(const sim_net_config_t* cfg);
+
+/**
+ * Fail every post in [start_ms, end_ms) of virtual time with err:
+ * PLEXUS_ERR_NETWORK (link down, fails after timeout_ms),
+ * PLEXUS_ERR_SERVER (5xx) or PLEXUS_ERR_RATE_LIMIT (429). Returns false when
+ * the schedule is full.
+ */
+bool sim_hal_add_window(uint64_t start_ms, uint64_t end_ms, plexus_err_t err);
+
+void sim_hal_set_deliver_cb(sim_deliver_fn fn, void* user_data);
+
+/** Virtual milliseconds since sim_hal_reset() */
+uint64_t sim_hal_now_ms(void);
+
+/** Move virtual time forward (the device doing other work) */
+void sim_hal_advance(uint32_t ms);
+
+void sim_hal_get_stats(sim_hal_stats_t* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PLEXUS_SIM_HAL_H */
@@ -0,0 +1,348 @@
+/**
+ * @file test_aggregate.c
+ * @brief Tests for on-device windowed aggregation
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_aggregate
+ * Requires: -DPLEXUS_ENABLE_AGGREGATION=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <math.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Find a queued point by name, or NULL */
+static const plexus_metric_t* find_point(const plexus_client_t* c, const char* name) {
+    for (uint16_t i = 0; i < c->metric_count; i++) {
+        if (strcmp(c->metrics[i].name, name) == 0) {
+            return &c->metrics[i];
+        }
+    }
+    return NULL;
+}
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_aggregate_register(NULL, "temp", 1000, PLEXUS_AGG_ALL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_aggregate_register(c, NULL, 1000, PLEXUS_AGG_ALL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_aggregate_register(c, "temp", 0, PLEXUS_AGG_ALL) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_aggregate_register(c, "temp", 1000, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_aggregate_register(c, "bad\nname", 1000, PLEXUS_AGG_ALL) == PLEXUS_ERR_INVALID_ARG);
+
+    /* Name must leave room for the ".count" suffix */
+    char long_name[PLEXUS_MAX_METRIC_NAME_LEN];
+    memset(long_name, 'a', sizeof(long_name) - 1);
+    long_name[sizeof(long_name) - 1] = '\0';
+    long_name[PLEXUS_MAX_METRIC_NAME_LEN - 6] = '\0';
+    ASSERT(plexus_aggregate_register(c, long_name, 1000, PLEXUS_AGG_ALL) == PLEXUS_ERR_STRING_TOO_LONG);
+
+    plexus_free(c);
+}
+
+TEST(register_table_full) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_AGGREGATES; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        ASSERT(plexus_aggregate_register(c, name, 1000, PLEXUS_AGG_MEAN) == PLEXUS_OK);
+    }
+    ASSERT(plexus_aggregate_register(c, "extra", 1000, PLEXUS_AGG_MEAN) == PLEXUS_ERR_BUFFER_FULL);
+
+    /* Re-registering an existing metric is an update, not a new slot */
+    ASSERT(plexus_aggregate_register(c, "m0", 500, PLEXUS_AGG_MAX) == PLEXUS_OK);
+    plexus_free(c);
+}
+
+TEST(samples_are_folded_not_queued) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_aggregate_register(c, "vib", 1000, PLEXUS_AGG_ALL) == PLEXUS_OK);
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT(plexus_send(c, "vib", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+
+    /* Other metrics are unaffected */
+    ASSERT(plexus_send(c, "temp", 21.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+
+    plexus_free(c);
+}
+
+TEST(tick_closes_window_with_all_stats) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "vib", 1000, PLEXUS_AGG_ALL) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "vib", 4.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "vib", -2.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "vib", 10.0) == PLEXUS_OK);
+
+    /* Window still open */
+    mock_hal_advance_tick(999);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 5);
+
+    const plexus_metric_t* p;
+    p = find_point(c, "vib.min");   ASSERT(p && p->value.data.number == -2.0);
+    p = find_point(c, "vib.max");   ASSERT(p && p->value.data.number == 10.0);
+    p = find_point(c, "vib.mean");  ASSERT(p && p->value.data.number == 4.0);
+    p = find_point(c, "vib.count"); ASSERT(p && p->value.data.number == 3.0);
+    p = find_point(c, "vib.sum");   ASSERT(p && p->value.data.number == 12.0);
+
+    /* Empty windows emit nothing */
+    plexus_clear(c);
+    mock_hal_advance_tick(5000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    plexus_free(c);
+}
+
+TEST(stats_mask_selects_points) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "rpm", 500, PLEXUS_AGG_MIN | PLEXUS_AGG_MAX) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "rpm", 1200.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "rpm", 1500.0) == PLEXUS_OK);
+    mock_hal_advance_tick(500);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(find_point(c, "rpm.min") != NULL);
+    ASSERT(find_point(c, "rpm.max") != NULL);
+    ASSERT(find_point(c, "rpm.mean") == NULL);
+
+    plexus_free(c);
+}
+
+TEST(late_sample_closes_previous_window) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "v", 1000, PLEXUS_AGG_MEAN) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "v", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "v", 3.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1500);
+
+    /* No tick in between: the next sample closes the old window and starts a new one */
+    ASSERT(plexus_send(c, "v", 100.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 2.0);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(c->metrics[1].value.data.number == 100.0);
+
+    plexus_free(c);
+}
+
+TEST(full_queue_keeps_folding_into_overdue_window) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "v", 1000, PLEXUS_AGG_MAX | PLEXUS_AGG_COUNT) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "v", 1.0) == PLEXUS_OK);
+    while (plexus_pending_count(c) < PLEXUS_MAX_METRICS) {
+        ASSERT(plexus_send(c, "fill", 0.0) == PLEXUS_OK);
+    }
+    mock_hal_advance_tick(1500);
+
+    /* The window is overdue but cannot close; the sample still counts */
+    ASSERT(plexus_send(c, "v", 99.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS);
+
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    const plexus_metric_t* max = find_point(c, "v.max");
+    const plexus_metric_t* count = find_point(c, "v.count");
+    ASSERT(max && max->value.data.number == 99.0);
+    ASSERT(count && count->value.data.number == 2.0);
+
+    plexus_free(c);
+}
+
+TEST(batch_stops_where_a_window_emit_took_the_room) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "v", 1000, PLEXUS_AGG_ALL) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "v", 1.0) == PLEXUS_OK);
+    while (plexus_pending_count(c) < PLEXUS_MAX_METRICS - 6) {
+        ASSERT(plexus_send(c, "fill", 0.0) == PLEXUS_OK);
+    }
+    mock_hal_advance_tick(1500);
+
+    const plexus_point_t pts[] = { { "v", 2.0, 0 }, { "x", 1.0, 0 }, { "y", 2.0, 0 } };
+    size_t accepted = 99;
+    ASSERT(plexus_send_batch_accepted(c, pts, 3, &accepted) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(accepted == 2);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS);
+    ASSERT(find_point(c, "x") != NULL);
+    ASSERT(find_point(c, "y") == NULL);
+
+    /* Full queue: "v" still folds into its window, "x" finds no room */
+    ASSERT(plexus_send_batch_accepted(c, pts, 3, &accepted) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(accepted == 1);
+
+    plexus_free(c);
+}
+
+TEST(rms_and_stddev) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "ac", 1000, PLEXUS_AGG_RMS | PLEXUS_AGG_STDDEV) == PLEXUS_OK);
+
+    /* Square wave +-3: RMS 3, mean 0, population stddev 3 */
+    for (int i = 0; i < 10; i++) {
+        ASSERT(plexus_send(c, "ac", (i & 1) ? 3.0 : -3.0) == PLEXUS_OK);
+    }
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    const plexus_metric_t* p;
+    p = find_point(c, "ac.rms");    ASSERT(p && fabs(p->value.data.number - 3.0) < 1e-9);
+    p = find_point(c, "ac.stddev"); ASSERT(p && fabs(p->value.data.number - 3.0) < 1e-9);
+
+    /* ".stddev" is the longest suffix: names that fit ".count" may not fit it */
+    char name[PLEXUS_MAX_METRIC_NAME_LEN];
+    memset(name, 'a', sizeof(name));
+    name[PLEXUS_MAX_METRIC_NAME_LEN - 7] = '\0';
+    ASSERT(plexus_aggregate_register(c, name, 1000, PLEXUS_AGG_ALL) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, name, 1000, PLEXUS_AGG_STDDEV) == PLEXUS_ERR_STRING_TOO_LONG);
+
+    plexus_free(c);
+}
+
+TEST(send_array_matches_per_sample_sends) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "a", 1000, PLEXUS_AGG_ALL | PLEXUS_AGG_RMS) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(c, "b", 1000, PLEXUS_AGG_ALL | PLEXUS_AGG_RMS) == PLEXUS_OK);
+
+    float block[37];
+    for (int i = 0; i < 37; i++) {
+        block[i] = (float)((i * 7) % 11) - 4.5f;
+        ASSERT(plexus_send(c, "b", (double)block[i]) == PLEXUS_OK);
+    }
+    ASSERT(plexus_aggregate_send_array(c, "a", block, 20) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_send_array(c, "a", block + 20, 17) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_send_array(c, "a", NULL, 0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 12);
+
+    static const char* const stats[] = {".min", ".max", ".mean", ".count", ".sum", ".rms"};
+    for (size_t i = 0; i < sizeof(stats) / sizeof(stats[0]); i++) {
+        char na[16];
+        char nb[16];
+        snprintf(na, sizeof(na), "a%s", stats[i]);
+        snprintf(nb, sizeof(nb), "b%s", stats[i]);
+        const plexus_metric_t* pa = find_point(c, na);
+        const plexus_metric_t* pb = find_point(c, nb);
+        ASSERT(pa && pb);
+        ASSERT(fabs(pa->value.data.number - pb->value.data.number) < 1e-9);
+    }
+
+    /* Unregistered metrics and bad pointers are rejected */
+    ASSERT(plexus_aggregate_send_array(c, "nope", block, 4) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_aggregate_send_array(c, "a", NULL, 4) == PLEXUS_ERR_NULL_PTR);
+
+    plexus_free(c);
+}
+
+#if PLEXUS_ENABLE_TAGS
+TEST(tagged_sends_bypass_aggregation) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_aggregate_register(c, "temp", 1000, PLEXUS_AGG_ALL) == PLEXUS_OK);
+
+    const char* keys[] = {"room"};
+    const char* vals[] = {"lab"};
+    ASSERT(plexus_send_number_tagged(c, "temp", 21.5, keys, vals, 1) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(strcmp(c->metrics[0].tag_values[0], "lab") == 0);
+
+    plexus_free(c);
+}
+#endif
+
+TEST(aggregated_points_are_flushed) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_aggregate_register(c, "hz", 1000, PLEXUS_AGG_MAX) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "hz", 50.0) == PLEXUS_OK);
+    mock_hal_advance_tick(PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+
+    /* Tick closes the window and the interval flush sends it */
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(plexus_total_sent(c) == 1);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_aggregate:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(register_table_full);
+    RUN(samples_are_folded_not_queued);
+    RUN(tick_closes_window_with_all_stats);
+    RUN(stats_mask_selects_points);
+    RUN(late_sample_closes_previous_window);
+    RUN(full_queue_keeps_folding_into_overdue_window);
+    RUN(batch_stops_where_a_window_emit_took_the_room);
+    RUN(rms_and_stddev);
+    RUN(send_array_matches_per_sample_sends);
+#if PLEXUS_ENABLE_TAGS
+    RUN(tagged_sends_bypass_aggregation);
+#endif
+    RUN(aggregated_points_are_flushed);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file test_basic_client.cpp
+ * @brief Tests for plexus::BasicClient<Config> per-instance sizing
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_basic_client
+ */
+
+#include "plexus.hpp"
+#include <new>
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern "C" void mock_hal_reset(void);
+extern "C" int mock_hal_post_call_count(void);
+extern "C" const char* mock_hal_last_post_body(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+typedef plexus::ClientConfig<4, 256> DiagConfig;
+typedef plexus::ClientConfig<128, 8192> TelemetryConfig;
+
+/* Capacity is part of the type, not the build */
+static_assert(sizeof(plexus::BasicClient<DiagConfig>) < sizeof(plexus::BasicClient<TelemetryConfig>),
+              "smaller config, smaller client");
+static_assert(plexus::BasicClient<DiagConfig>::storage_size == PLEXUS_CLIENT_SIZE_FOR(4, 256),
+              "storage matches the C layout");
+
+static plexus::BasicClient<DiagConfig> s_static_diag("plx_key", "gw-diag");
+
+/* ---- Tests ---- */
+
+TEST(static_client_has_own_capacity) {
+    ASSERT(s_static_diag.isValid());
+    s_static_diag.clear();
+    for (int i = 0; i < 4; i++) {
+        ASSERT(s_static_diag.send("cpu", i) == PLEXUS_OK);
+    }
+    ASSERT(s_static_diag.send("cpu", 5.0) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(s_static_diag.pendingCount() == 4);
+    s_static_diag.clear();
+}
+
+TEST(small_and_large_clients_coexist) {
+    plexus::BasicClient<DiagConfig> diag("plx_key", "gw-diag");
+    plexus::BasicClient<TelemetryConfig>* telemetry =
+        new plexus::BasicClient<TelemetryConfig>("plx_key", "gw-01");
+    ASSERT(diag.isValid() && telemetry->isValid());
+    ASSERT(telemetry->setFlushCount(1000) == PLEXUS_OK);
+
+    /* More points than PLEXUS_MAX_METRICS in one client */
+    for (int i = 0; i < 100; i++) {
+        ASSERT(telemetry->send("vibration", i * 0.5) == PLEXUS_OK);
+    }
+    ASSERT(telemetry->pendingCount() == 100);
+    ASSERT(diag.pendingCount() == 0);
+
+    ASSERT(telemetry->flush() == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(strstr(mock_hal_last_post_body(), "\"value\":49.5") != NULL);
+    delete telemetry;
+}
+
+TEST(placement_new_into_caller_buffer) {
+    typedef plexus::BasicClient<DiagConfig> Diag;
+    alignas(Diag) static unsigned char arena[sizeof(Diag)];
+
+    Diag* diag = new (arena) Diag("plx_key", "gw-diag");
+    ASSERT(diag->isValid());
+    ASSERT((void*)diag->handle() >= (void*)arena);
+    ASSERT((unsigned char*)diag->handle() < arena + sizeof(arena));
+
+    ASSERT(diag->send("temp", 21.0) == PLEXUS_OK);
+    ASSERT(diag->flush() == PLEXUS_OK);
+    diag->~Diag();
+}
+
+TEST(invalid_credentials_leave_client_invalid) {
+    plexus::BasicClient<DiagConfig> bad("not_a_key", "gw-diag");
+    ASSERT(!bad.isValid());
+    ASSERT(bad.send("temp", 1.0) == PLEXUS_ERR_NULL_PTR);
+}
+
+TEST(metric_handle_on_basic_client) {
+    plexus::BasicClient<DiagConfig> diag("plx_key", "gw-diag");
+    plexus::Metric<double> rssi(diag, "rssi");
+    ASSERT(rssi.send(-60.0) == PLEXUS_OK);
+    ASSERT(diag.pendingCount() == 1);
+}
+
+int main(void) {
+    printf("test_basic_client:\n");
+
+    RUN(static_client_has_own_capacity);
+    RUN(small_and_large_clients_coexist);
+    RUN(placement_new_into_caller_buffer);
+    RUN(invalid_credentials_leave_client_invalid);
+    RUN(metric_handle_on_basic_client);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
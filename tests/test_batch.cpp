@@ -0,0 +1,210 @@
+/**
+ * @file test_batch.cpp
+ * @brief Tests for sendBatch() and plexus::BatchBuilder in plexus.hpp
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_batch
+ * Requires: C++20 (std::span), -DPLEXUS_ENABLE_AGGREGATION=1
+ */
+
+#include "plexus.hpp"
+#include <stdio.h>
+#include <string.h>
+#include <array>
+#include <type_traits>
+#include <utility>
+
+/* Mock HAL helpers */
+extern "C" void mock_hal_reset(void);
+extern "C" int mock_hal_post_call_count(void);
+extern "C" void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+static_assert(!std::is_copy_constructible<plexus::BatchBuilder<4>>::value, "move-only");
+static_assert(std::is_nothrow_move_constructible<plexus::BatchBuilder<4>>::value, "movable");
+static_assert(plexus::BatchBuilder<4>::capacity() == 4, "capacity");
+
+/* ---- Tests ---- */
+
+TEST(send_batch_from_span) {
+    PlexusClient px("plx_key", "dev-001");
+    const std::array<plexus::Point, 3> pts = {{
+        { "x", 1.0, 0 }, { "y", 2.0, 0 }, { "z", 3.0, 1700000000123ULL },
+    }};
+    ASSERT(px.sendBatch(pts) == PLEXUS_OK);
+    ASSERT(px.pendingCount() == 3);
+    ASSERT(px.handle()->metrics[2].timestamp_ms == 1700000000123ULL);
+
+    /* A sub-span */
+    ASSERT(px.sendBatch(std::span<const plexus::Point>(pts).first(1)) == PLEXUS_OK);
+    ASSERT(px.pendingCount() == 4);
+}
+
+TEST(builder_commits_and_empties) {
+    PlexusClient px("plx_key", "dev-001");
+    plexus::BatchBuilder<4> batch;
+    ASSERT(batch.add("a", 1.0) == PLEXUS_OK);
+    ASSERT(batch.add("b", 2.0) == PLEXUS_OK);
+    ASSERT(batch.add("c", 3.0) == PLEXUS_OK);
+    ASSERT(batch.add("d", 4.0) == PLEXUS_OK);
+    ASSERT(batch.add("e", 5.0) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(batch.size() == 4);
+    ASSERT(batch.points().size() == 4);
+
+    ASSERT(batch.commit(px) == PLEXUS_OK);
+    ASSERT(batch.empty());
+    ASSERT(px.pendingCount() == 4);
+    ASSERT(strcmp(px.handle()->metrics[3].name, "d") == 0);
+
+    /* Committing an empty batch is a no-op */
+    ASSERT(batch.commit(px) == PLEXUS_OK);
+    ASSERT(px.pendingCount() == 4);
+}
+
+TEST(builder_move_transfers_points) {
+    PlexusClient px("plx_key", "dev-001");
+    plexus::BatchBuilder<4> a;
+    ASSERT(a.add("a", 1.0) == PLEXUS_OK);
+    ASSERT(a.add("b", 2.0) == PLEXUS_OK);
+
+    plexus::BatchBuilder<4> b(std::move(a));
+    ASSERT(a.empty());
+    ASSERT(b.size() == 2);
+
+    plexus::BatchBuilder<4> c;
+    c = std::move(b);
+    ASSERT(b.empty());
+    ASSERT(c.commit(px.handle()) == PLEXUS_OK);
+    ASSERT(px.pendingCount() == 2);
+}
+
+static plexus_total_t dropped(plexus_client_t* c) {
+    plexus_totals_t t;
+    return plexus_get_totals(c, &t) == PLEXUS_OK ? t.dropped : (plexus_total_t)-1;
+}
+
+TEST(rejected_batch_is_kept) {
+    plexus::BasicClient<plexus::ClientConfig<4, 1024>> px("plx_key", "dev-001");
+    ASSERT(px.setFlushCount(100) == PLEXUS_OK);
+    for (int i = 0; i < 4; i++) {
+        ASSERT(px.send("first", 0.0) == PLEXUS_OK);
+    }
+
+    plexus::BatchBuilder<4> batch;
+    for (int i = 0; i < 4; i++) {
+        ASSERT(batch.add("v", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(batch.commit(px) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(batch.commit(px) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(batch.size() == 4);
+    ASSERT(px.pendingCount() == 4);
+
+    /* Kept for retry, so nothing was dropped */
+    ASSERT(dropped(px.handle()) == 0);
+
+    /* Make room and retry the same batch */
+    ASSERT(px.flush() == PLEXUS_OK);
+    ASSERT(batch.commit(px) == PLEXUS_OK);
+    ASSERT(batch.empty());
+    ASSERT(px.pendingCount() == 4);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(dropped(px.handle()) == 0);
+}
+
+TEST(batch_larger_than_the_room_queues_what_fits) {
+    plexus::BasicClient<plexus::ClientConfig<4, 1024>> px("plx_key", "dev-001");
+    ASSERT(px.setFlushCount(100) == PLEXUS_OK);
+    ASSERT(px.send("first", 0.0) == PLEXUS_OK);
+
+    plexus::BatchBuilder<4> batch;
+    for (int i = 0; i < 4; i++) {
+        ASSERT(batch.add("v", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(batch.commit(px) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(batch.size() == 1);
+    ASSERT(batch.data()[0].value == 3.0);
+    ASSERT(px.pendingCount() == 4);
+    ASSERT(dropped(px.handle()) == 0);
+}
+
+TEST(folded_points_need_no_room) {
+    plexus::BasicClient<plexus::ClientConfig<4, 1024>> px("plx_key", "dev-001");
+    ASSERT(px.setFlushCount(100) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(px.handle(), "v", 1000, PLEXUS_AGG_MEAN) == PLEXUS_OK);
+    ASSERT(px.send("a", 0.0) == PLEXUS_OK);
+    ASSERT(px.send("b", 0.0) == PLEXUS_OK);
+
+    /* Five points, two free slots: the aggregated ones are folded */
+    plexus::BatchBuilder<8> batch;
+    for (int i = 0; i < 4; i++) {
+        ASSERT(batch.add("v", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(batch.add("c", 1.0) == PLEXUS_OK);
+    ASSERT(batch.commit(px) == PLEXUS_OK);
+    ASSERT(batch.empty());
+    ASSERT(px.pendingCount() == 3);
+}
+
+TEST(partially_queued_batch_keeps_the_rest) {
+    plexus::BasicClient<plexus::ClientConfig<8, 1024>> px("plx_key", "dev-001");
+    ASSERT(px.setFlushCount(100) == PLEXUS_OK);
+    ASSERT(plexus_aggregate_register(px.handle(), "v", 1000, PLEXUS_AGG_ALL) == PLEXUS_OK);
+    ASSERT(px.send("v", 1.0) == PLEXUS_OK);
+    ASSERT(px.send("a", 0.0) == PLEXUS_OK);
+    ASSERT(px.send("b", 0.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1500);
+
+    /* Six free slots pass the check, then the overdue window emits five */
+    plexus::BatchBuilder<4> batch;
+    ASSERT(batch.add("v", 2.0) == PLEXUS_OK);
+    ASSERT(batch.add("x", 1.0) == PLEXUS_OK);
+    ASSERT(batch.add("y", 2.0) == PLEXUS_OK);
+    ASSERT(batch.commit(px) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(batch.size() == 1);
+    ASSERT(strcmp(batch.data()[0].metric, "y") == 0);
+    ASSERT(px.pendingCount() == 8);
+
+    ASSERT(px.flush() == PLEXUS_OK);
+    ASSERT(batch.commit(px) == PLEXUS_OK);
+    ASSERT(batch.empty());
+    ASSERT(px.pendingCount() == 1);
+}
+
+int main(void) {
+    printf("test_batch:\n");
+
+    RUN(send_batch_from_span);
+    RUN(builder_commits_and_empties);
+    RUN(builder_move_transfers_points);
+    RUN(rejected_batch_is_kept);
+    RUN(batch_larger_than_the_room_queues_what_fits);
+    RUN(folded_points_need_no_room);
+    RUN(partially_queued_batch_keeps_the_rest);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,260 @@
+/**
+ * @file test_client_stats.c
+ * @brief Tests for plexus_get_stats() self-telemetry and plexus.* publishing
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_client_stats
+ * Requires: -DPLEXUS_ENABLE_CLIENT_STATS=1 -DPLEXUS_ENABLE_WEBSOCKET=1
+ *           -DPLEXUS_ENABLE_TIMING=1 -DPLEXUS_ENABLE_TRACE=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_ws_reset(void);
+extern void mock_hal_ws_inject(plexus_ws_event_t event, const char* data);
+extern void mock_hal_set_next_post_result(plexus_err_t err);
+extern const char* mock_hal_last_post_body(void);
+extern size_t mock_hal_last_post_body_len(void);
+extern void mock_hal_set_cycles(uint32_t cycles);
+extern void mock_hal_set_cycles_step(uint32_t step);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_ws_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Drive the WS state machine to CONNECTED */
+static void ws_connect(plexus_client_t* c) {
+    (void)plexus_set_org_id(c, "org_1");
+    (void)plexus_ws_connect(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)plexus_tick(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    (void)plexus_tick(c);
+}
+
+/* ---- Tests ---- */
+
+TEST(get_stats_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_client_stats_t st;
+    ASSERT(plexus_get_stats(NULL, &st) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_get_stats(c, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_set_stats_publish_interval(NULL, 1000) == PLEXUS_ERR_NULL_PTR);
+
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.posts == 0 && st.points_posted == 0 && st.bytes_per_point == 0);
+    plexus_reset_stats(NULL);
+    plexus_free(c);
+}
+
+TEST(posts_and_bytes_per_point) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_send_number(c, "temp", 20.0) == PLEXUS_OK);
+    ASSERT(plexus_send_number(c, "temp", 21.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+
+    plexus_client_stats_t st;
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.posts == 1);
+    ASSERT(st.post_failures == 0);
+    ASSERT(st.serializations == 1);
+    ASSERT(st.points_posted == 2);
+    ASSERT(st.points_sent == 2);
+    ASSERT(st.bytes_posted == mock_hal_last_post_body_len());
+    ASSERT(st.bytes_per_point == (uint32_t)(st.bytes_posted / 2));
+    ASSERT(st.queue_depth == 0);
+
+    /* The mock post returns instantly: everything lands in the <1 ms bucket */
+    ASSERT(st.post_latency_hist[0] == 1);
+    ASSERT(st.post_latency_max_ms == 0);
+    plexus_free(c);
+}
+
+TEST(retries_and_backoff_counted) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_send_number(c, "temp", 20.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+    ASSERT(plexus_flush(c) == PLEXUS_ERR_NETWORK);
+
+    plexus_client_stats_t st;
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.posts == PLEXUS_MAX_RETRIES);
+    ASSERT(st.post_failures == PLEXUS_MAX_RETRIES);
+    ASSERT(st.retries == PLEXUS_MAX_RETRIES - 1);
+    ASSERT(st.backoff_ms_total > 0);
+    ASSERT(st.points_posted == 0);
+    ASSERT(st.queue_depth == 1);
+    plexus_free(c);
+}
+
+TEST(high_water_and_drops) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    for (int i = 0; i < PLEXUS_MAX_METRICS; i++) {
+        ASSERT(plexus_send_number(c, "v", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_send_number(c, "v", 0.0) == PLEXUS_ERR_BUFFER_FULL);
+
+    plexus_point_t batch[2] = { { "a", 1.0, 0 }, { "b", 2.0, 0 } };
+    ASSERT(plexus_send_batch(c, batch, 2) == PLEXUS_ERR_BUFFER_FULL);
+
+    plexus_client_stats_t st;
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.queue_high_water == PLEXUS_MAX_METRICS);
+    ASSERT(st.drops_buffer_full == 1);     /* Batch points stay with the caller */
+
+    /* High water survives the queue draining; reset clears it */
+    plexus_clear(c);
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.queue_high_water == PLEXUS_MAX_METRICS);
+    ASSERT(st.queue_depth == 0);
+    plexus_reset_stats(c);
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.queue_high_water == 0 && st.drops_buffer_full == 0);
+    plexus_free(c);
+}
+
+TEST(publish_interval_emits_points) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_set_stats_publish_interval(c, 5000) == PLEXUS_OK);
+
+    mock_hal_advance_tick(4999);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 10);
+
+    /* Not again until the next interval */
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 10);
+
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    const char* body = mock_hal_last_post_body();
+    ASSERT(strstr(body, "\"metric\":\"plexus.posts\"") != NULL);
+    ASSERT(strstr(body, "\"metric\":\"plexus.queue_high_water\"") != NULL);
+    ASSERT(strstr(body, "\"metric\":\"plexus.ws_reconnects\"") != NULL);
+
+    /* Interval 0 disables publishing */
+    ASSERT(plexus_set_stats_publish_interval(c, 0) == PLEXUS_OK);
+    mock_hal_advance_tick(60000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+    plexus_free(c);
+}
+
+TEST(publish_skipped_without_room) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_set_stats_publish_interval(c, 1000) == PLEXUS_OK);
+    for (int i = 0; i < PLEXUS_MAX_METRICS - 9; i++) {
+        ASSERT(plexus_send_number(c, "v", (double)i) == PLEXUS_OK);
+    }
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS - 9);
+    plexus_free(c);
+}
+
+TEST(ws_frames_and_reconnects) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ws_connect(c);
+
+    plexus_client_stats_t st;
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.ws_frames_sent >= 1);
+    ASSERT(st.ws_bytes_sent >= st.ws_frame_max_bytes);
+    ASSERT(st.ws_frame_max_bytes > 0);
+    ASSERT(st.ws_frames_received == 1);
+    ASSERT(st.ws_reconnects == 0);
+
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DISCONNECTED, NULL);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.ws_reconnects == 1);
+    plexus_free(c);
+}
+
+static uint32_t s_trace_first_us;
+static uint32_t s_trace_last_us;
+static int s_trace_events;
+
+static void record_trace(const plexus_trace_event_t* ev, void* user_data) {
+    (void)user_data;
+    if (s_trace_events++ == 0) {
+        s_trace_first_us = ev->timestamp_us;
+    }
+    s_trace_last_us = ev->timestamp_us;
+}
+
+TEST(cycle_counter_wrap_mid_flush) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(c);
+    s_trace_events = 0;
+    /* 1 us per read at 100 counts/us, wrapping a few reads into the flush */
+    mock_hal_set_cycles(UINT32_MAX - 300);
+    mock_hal_set_cycles_step(100);
+    ASSERT(plexus_on_trace(c, record_trace, NULL) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    mock_hal_set_cycles_step(0);
+
+    plexus_client_stats_t st;
+    ASSERT(plexus_get_stats(c, &st) == PLEXUS_OK);
+    ASSERT(st.serializations == 1);
+    ASSERT(st.serialize_us_max <= 10);
+    ASSERT(s_trace_events > 4);
+    ASSERT(s_trace_last_us - s_trace_first_us <= 100);
+    ASSERT(s_trace_last_us >= s_trace_first_us);
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_client_stats:\n");
+
+    RUN(get_stats_rejects_bad_args);
+    RUN(posts_and_bytes_per_point);
+    RUN(retries_and_backoff_counted);
+    RUN(high_water_and_drops);
+    RUN(publish_interval_emits_points);
+    RUN(publish_skipped_without_room);
+    RUN(ws_frames_and_reconnects);
+    RUN(cycle_counter_wrap_mid_flush);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
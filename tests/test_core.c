@@ -141,9 +141,60 @@ TEST(free_on_static_is_safe) {
     ASSERT(plexus_send_number(c, "temp", 1.0) == PLEXUS_ERR_NOT_INITIALIZED);
 }
 
+TEST(init_sized_uses_own_capacities) {
+    PLEXUS_CLIENT_SIZED_BUF(small_buf, 3, 256);
+    ASSERT(sizeof(small_buf) >= plexus_client_size_for(3, 256));
+    ASSERT(sizeof(small_buf) < sizeof(plexus_client_t) || PLEXUS_MAX_METRICS <= 3);
+
+    plexus_client_t* c = plexus_init_sized(small_buf, sizeof(small_buf), 3, 256,
+                                           "plx_key", "dev-001");
+    ASSERT(c != NULL);
+    ASSERT((void*)c == (void*)small_buf);
+
+    ASSERT(plexus_send(c, "a", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "b", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "c", 3.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "d", 4.0) == PLEXUS_ERR_BUFFER_FULL);
+
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(strstr(mock_hal_last_post_body(), "\"metric\":\"c\"") != NULL);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    plexus_free(c);
+}
+
+TEST(init_sized_rejects_bad_sizes) {
+    PLEXUS_CLIENT_SIZED_BUF(buf, 4, 512);
+    ASSERT(plexus_init_sized(buf, sizeof(buf), 0, 512, "plx_key", "dev-001") == NULL);
+    ASSERT(plexus_init_sized(buf, sizeof(buf), 4, 255, "plx_key", "dev-001") == NULL);
+    ASSERT(plexus_init_sized(buf, sizeof(buf), 5, 512, "plx_key", "dev-001") == NULL);
+    ASSERT(plexus_init_sized(buf, sizeof(buf), 4, 512, "bad_key", "dev-001") == NULL);
+    ASSERT(plexus_init_sized((char*)buf + 1, sizeof(buf) - 8, 2, 256,
+                             "plx_key", "dev-001") == NULL);
+    ASSERT(plexus_init_sized(NULL, sizeof(buf), 4, 512, "plx_key", "dev-001") == NULL);
+    ASSERT(plexus_init_sized(buf, sizeof(buf), 4, 512, "plx_key", "dev-001") != NULL);
+}
+
+TEST(init_sized_small_json_buffer) {
+    /* More points than the JSON buffer holds: flush reports it, queue kept */
+    PLEXUS_CLIENT_SIZED_BUF(buf, 12, 256);
+    plexus_client_t* c = plexus_init_sized(buf, sizeof(buf), 12, 256, "plx_key", "dev-001");
+    ASSERT(c != NULL);
+    ASSERT(plexus_set_flush_count(c, 100) == PLEXUS_OK);
+    for (int i = 0; i < 12; i++) {
+        ASSERT(plexus_send(c, "temperature_sensor_reading", 1000.0 + i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_flush(c) == PLEXUS_ERR_JSON);
+    ASSERT(mock_hal_post_call_count() == 0);
+    ASSERT(plexus_pending_count(c) == 12);
+}
+
 TEST(client_size_matches) {
     ASSERT(plexus_client_size() == sizeof(plexus_client_t));
     ASSERT(plexus_client_size() == PLEXUS_CLIENT_STATIC_SIZE);
+    ASSERT(plexus_client_size_for(PLEXUS_MAX_METRICS, PLEXUS_JSON_BUFFER_SIZE) <=
+           sizeof(plexus_client_t));
 }
 
 TEST(version_string) {
@@ -643,6 +694,73 @@ TEST(send_rejects_control_chars_in_metric_name) {
     plexus_free(c);
 }
 
+/* ---- Batch send tests ---- */
+
+TEST(send_batch_queues_in_order) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    const plexus_point_t pts[] = {
+        { "accel_x", 0.5, 1700000000001ULL },
+        { "accel_y", -1.0, 1700000000001ULL },
+        { "accel_z", 9.81, 0 },
+    };
+    ASSERT(plexus_send_batch(c, pts, 3) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);
+    ASSERT(strcmp(c->metrics[1].name, "accel_y") == 0);
+    ASSERT(c->metrics[1].value.data.number == -1.0);
+    ASSERT(c->metrics[1].timestamp_ms == 1700000000001ULL);
+    ASSERT(c->metrics[2].timestamp_ms >= 1700000000000ULL);
+
+    ASSERT(plexus_send_batch(c, NULL, 0) == PLEXUS_OK);
+    ASSERT(plexus_send_batch(c, NULL, 1) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_send_batch(NULL, pts, 3) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_pending_count(c) == 3);
+
+    plexus_free(c);
+}
+
+TEST(send_batch_checks_names_then_fills) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    plexus_point_t pts[PLEXUS_MAX_METRICS + 1];
+    for (int i = 0; i <= PLEXUS_MAX_METRICS; i++) {
+        pts[i].metric = "v";
+        pts[i].value = (double)i;
+        pts[i].timestamp_ms = 0;
+    }
+
+    /* A bad name anywhere queues nothing */
+    pts[1].metric = "bad\nname";
+    ASSERT(plexus_send_batch(c, pts, 3) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_pending_count(c) == 0);
+    pts[1].metric = "v";
+
+    /* A batch larger than the free space queues what fits */
+    ASSERT(plexus_send(c, "first", 1.0) == PLEXUS_OK);
+    size_t accepted = 0;
+    ASSERT(plexus_send_batch_accepted(c, pts, PLEXUS_MAX_METRICS, &accepted) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(accepted == PLEXUS_MAX_METRICS - 1);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS);
+    plexus_totals_t totals;
+    ASSERT(plexus_get_totals(c, &totals) == PLEXUS_OK && totals.dropped == 0);
+
+    plexus_free(c);
+}
+
+TEST(send_batch_auto_flushes_once) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_set_flush_count(c, 2);
+
+    const plexus_point_t pts[] = {
+        { "a", 1.0, 0 }, { "b", 2.0, 0 }, { "c", 3.0, 0 }, { "d", 4.0, 0 }, { "e", 5.0, 0 },
+    };
+    ASSERT(plexus_send_batch(c, pts, 5) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_total_sent(c) == 5);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    plexus_free(c);
+}
+
 /* ---- Main ---- */
 
 int main(void) {
@@ -657,6 +775,9 @@ int main(void) {
     RUN(init_static_works);
     RUN(init_static_too_small);
     RUN(free_on_static_is_safe);
+    RUN(init_sized_uses_own_capacities);
+    RUN(init_sized_rejects_bad_sizes);
+    RUN(init_sized_small_json_buffer);
     RUN(client_size_matches);
     RUN(version_string);
     RUN(strerror_known_codes);
@@ -668,6 +789,9 @@ int main(void) {
     RUN(send_number_null_client);
     RUN(buffer_full_returns_error);
     RUN(clear_empties_buffer);
+    RUN(send_batch_queues_in_order);
+    RUN(send_batch_checks_names_then_fills);
+    RUN(send_batch_auto_flushes_once);
 
     /* Flush */
     RUN(flush_no_data);
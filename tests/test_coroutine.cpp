@@ -0,0 +1,337 @@
+/**
+ * @file test_coroutine.cpp
+ * @brief Tests for the C++20 coroutine executor in plexus.hpp
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_coroutine
+ * Requires: C++20, -DPLEXUS_ENABLE_WEBSOCKET=1
+ */
+
+#include "plexus.hpp"
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern "C" void mock_hal_reset(void);
+extern "C" void mock_hal_advance_tick(uint32_t delta_ms);
+extern "C" void mock_hal_set_next_post_result(plexus_err_t err);
+extern "C" int mock_hal_post_call_count(void);
+extern "C" int mock_hal_delay_call_count(void);
+extern "C" void mock_hal_ws_reset(void);
+extern "C" void mock_hal_ws_inject(plexus_ws_event_t event, const char* data);
+extern "C" const char* mock_hal_ws_last_sent(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_ws_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Coroutines store their results here for the test body to check */
+static plexus_err_t s_result;
+static int s_done;
+static char s_order[16];
+static size_t s_order_len;
+
+static plexus::Task<void> flush_once(plexus::Executor& ex) {
+    s_result = co_await ex.flush();
+    s_done++;
+}
+
+static plexus::Task<void> sleeper(plexus::Executor& ex, uint32_t ms, char tag) {
+    co_await ex.sleep(ms);
+    s_order[s_order_len++] = tag;
+}
+
+static plexus::Task<int> add_later(plexus::Executor& ex, int a, int b) {
+    co_await ex.sleep(10);
+    co_return a + b;
+}
+
+static plexus::Task<void> await_nested(plexus::Executor& ex) {
+    int v = co_await add_later(ex, 2, 3);
+    s_result = v == 5 ? PLEXUS_OK : PLEXUS_ERR_INVALID_ARG;
+    s_done++;
+}
+
+static plexus::Task<void> connect_once(plexus::Executor& ex) {
+    s_result = co_await ex.connect(1000);
+    s_done++;
+}
+
+/* Responds 100 ms after the command arrives */
+static plexus::Task<plexus::CommandResult> slow_honk(plexus::CommandArgs args) {
+    plexus::Executor* ex = static_cast<plexus::Executor*>(args.user_data);
+    co_await ex->sleep(100);
+    co_return plexus::CommandResult::ok("{\"honked\":true}");
+}
+
+static plexus::Task<plexus::CommandResult> fast_fail(plexus::CommandArgs args) {
+    co_return plexus::CommandResult::fail(strstr(args.params_json, "\"x\"") ? "bad x" : "no x");
+}
+
+/* Drive the WS state machine to CONNECTED */
+static void ws_connect(plexus_client_t* c) {
+    (void)plexus_set_org_id(c, "org_1");
+    (void)plexus_ws_connect(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)plexus_tick(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    (void)plexus_tick(c);
+}
+
+/* ---- Tests ---- */
+
+TEST(flush_nowait_single_attempts) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    uint32_t retry = 123;
+    ASSERT(plexus_flush_nowait(NULL, &retry) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(retry == 0);
+
+    ASSERT(plexus_send(c, "v", 1.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+    for (int i = 1; i < PLEXUS_MAX_RETRIES; i++) {
+        ASSERT(plexus_flush_nowait(c, &retry) == PLEXUS_ERR_NETWORK);
+        ASSERT(retry > 0);
+        ASSERT(plexus_pending_count(c) == 1);
+    }
+    ASSERT(plexus_flush_nowait(c, &retry) == PLEXUS_ERR_NETWORK);
+    ASSERT(retry == 0);
+    ASSERT(mock_hal_post_call_count() == PLEXUS_MAX_RETRIES);
+    ASSERT(mock_hal_delay_call_count() == 0);
+
+    /* Non-retryable errors end at once */
+    mock_hal_set_next_post_result(PLEXUS_ERR_AUTH);
+    ASSERT(plexus_send(c, "v", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_flush_nowait(c, &retry) == PLEXUS_ERR_AUTH);
+    ASSERT(retry == 0);
+
+    plexus_free(c);
+}
+
+TEST(flush_succeeds_immediately) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Executor ex(c);
+    s_done = 0;
+
+    ASSERT(plexus_send(c, "temp", 21.5) == PLEXUS_OK);
+    ex.spawn(flush_once(ex));
+    ASSERT(s_done == 1);
+    ASSERT(s_result == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(ex.pending() == 0);
+
+    plexus_free(c);
+}
+
+TEST(flush_backoff_suspends_instead_of_blocking) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus::Executor ex(c);
+    s_done = 0;
+
+    ASSERT(plexus_send(c, "temp", 21.5) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+    ex.spawn(flush_once(ex));
+    ASSERT(s_done == 0);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(ex.pending() == 1);
+
+    /* Not due yet: nothing happens */
+    ASSERT(ex.tick() == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+
+    /* First backoff is at most 625 ms (500 + 25% jitter) */
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    mock_hal_advance_tick(PLEXUS_RETRY_BASE_MS + PLEXUS_RETRY_BASE_MS / 4);
+    ASSERT(ex.tick() == PLEXUS_OK);
+    ASSERT(s_done == 1);
+    ASSERT(s_result == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 2);
+    ASSERT(mock_hal_delay_call_count() == 0);
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(ex.pending() == 0);
+
+    plexus_free(c);
+}
+
+TEST(flush_gives_up_after_max_retries) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus::Executor ex(c);
+    s_done = 0;
+
+    ASSERT(plexus_send(c, "temp", 21.5) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+    ex.spawn(flush_once(ex));
+    for (int i = 0; i < 20 && !s_done; i++) {
+        mock_hal_advance_tick(PLEXUS_RETRY_MAX_MS);
+        ASSERT(ex.tick() == PLEXUS_OK);
+    }
+    ASSERT(s_done == 1);
+    ASSERT(s_result == PLEXUS_ERR_NETWORK);
+    ASSERT(mock_hal_post_call_count() == PLEXUS_MAX_RETRIES);
+    ASSERT(mock_hal_delay_call_count() == 0);
+    ASSERT(plexus_total_errors(c) == 1);
+
+    plexus_free(c);
+}
+
+TEST(sleepers_resume_in_deadline_order) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Executor ex(c);
+    s_order_len = 0;
+    memset(s_order, 0, sizeof(s_order));
+
+    ex.spawn(sleeper(ex, 300, 'c'));
+    ex.spawn(sleeper(ex, 100, 'a'));
+    ex.spawn(sleeper(ex, 100, 'b'));
+    ex.spawn(sleeper(ex, 0, '0'));
+    ASSERT(ex.pending() == 4);
+    ASSERT(s_order_len == 0);
+
+    (void)ex.tick();
+    ASSERT(strcmp(s_order, "0") == 0);
+    mock_hal_advance_tick(99);
+    (void)ex.tick();
+    ASSERT(strcmp(s_order, "0") == 0);
+    mock_hal_advance_tick(1);
+    (void)ex.tick();
+    ASSERT(strcmp(s_order, "0ab") == 0);
+    mock_hal_advance_tick(500);
+    (void)ex.tick();
+    ASSERT(strcmp(s_order, "0abc") == 0);
+    ASSERT(ex.pending() == 0);
+
+    plexus_free(c);
+}
+
+TEST(nested_task_returns_value) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Executor ex(c);
+    s_done = 0;
+
+    ex.spawn(await_nested(ex));
+    ASSERT(s_done == 0);
+    mock_hal_advance_tick(10);
+    (void)ex.tick();
+    ASSERT(s_done == 1);
+    ASSERT(s_result == PLEXUS_OK);
+
+    plexus_free(c);
+}
+
+TEST(unfinished_tasks_destroyed_with_executor) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    s_order_len = 0;
+    {
+        plexus::Executor ex(c);
+        ex.spawn(sleeper(ex, 1000, 'x'));
+        ASSERT(ex.pending() == 1);
+    }
+    ASSERT(s_order_len == 0);
+    plexus_free(c);
+}
+
+TEST(connect_resumes_when_authenticated) {
+    PlexusClient px("plx_key", "dev-001");
+    ASSERT(plexus_set_org_id(px.handle(), "org_1") == PLEXUS_OK);
+    plexus::Executor ex(px);
+    s_done = 0;
+
+    ex.spawn(connect_once(ex));
+    ASSERT(s_done == 0);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)ex.tick();
+    ASSERT(s_done == 0);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    (void)ex.tick();
+    ASSERT(s_done == 1);
+    ASSERT(s_result == PLEXUS_OK);
+    ASSERT(plexus_ws_state(px.handle()) == PLEXUS_WS_CONNECTED);
+}
+
+TEST(connect_times_out) {
+    PlexusClient px("plx_key", "dev-001");
+    ASSERT(plexus_set_org_id(px.handle(), "org_1") == PLEXUS_OK);
+    plexus::Executor ex(px);
+    s_done = 0;
+
+    ex.spawn(connect_once(ex));
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)ex.tick();
+    mock_hal_advance_tick(1000);
+    (void)ex.tick();
+    ASSERT(s_done == 1);
+    ASSERT(s_result == PLEXUS_ERR_WS_AUTH_TIMEOUT);
+}
+
+TEST(async_command_responds_with_its_name) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Executor ex(c);
+    ASSERT(ex.registerCommand("honk", "Honk later", slow_honk, &ex) == PLEXUS_OK);
+    ASSERT(ex.registerCommand("check", NULL, fast_fail) == PLEXUS_OK);
+    ASSERT(ex.registerCommand(NULL, NULL, fast_fail) == PLEXUS_ERR_NULL_PTR);
+    ws_connect(c);
+    ASSERT(plexus_ws_state(c) == PLEXUS_WS_CONNECTED);
+
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA,
+                       "{\"type\":\"typed_command\",\"id\":\"c1\",\"command\":\"honk\",\"params\":{}}");
+    (void)ex.tick();
+    ASSERT(ex.pending() == 1);
+
+    /* Another command completes while honk is still waiting */
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA,
+                       "{\"type\":\"typed_command\",\"id\":\"c2\",\"command\":\"check\","
+                       "\"params\":{\"x\":1}}");
+    (void)ex.tick();
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"id\":\"c2\",\"command\":\"check\"") != NULL);
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"error\":\"bad x\"") != NULL);
+
+    mock_hal_advance_tick(100);
+    (void)ex.tick();
+    ASSERT(ex.pending() == 0);
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"id\":\"c1\",\"command\":\"honk\"") != NULL);
+    ASSERT(strstr(mock_hal_ws_last_sent(), "{\"honked\":true}") != NULL);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_coroutine:\n");
+
+    RUN(flush_nowait_single_attempts);
+    RUN(flush_succeeds_immediately);
+    RUN(flush_backoff_suspends_instead_of_blocking);
+    RUN(flush_gives_up_after_max_retries);
+    RUN(sleepers_resume_in_deadline_order);
+    RUN(nested_task_returns_value);
+    RUN(unfinished_tasks_destroyed_with_executor);
+    RUN(connect_resumes_when_authenticated);
+    RUN(connect_times_out);
+    RUN(async_command_responds_with_its_name);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
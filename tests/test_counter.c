@@ -0,0 +1,297 @@
+/**
+ * @file test_counter.c
+ * @brief Tests for counter, gauge and rate metric kinds
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_counter
+ * Requires: -DPLEXUS_ENABLE_COUNTERS=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_counter_register(NULL, "b", PLEXUS_KIND_COUNTER, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_counter_register(c, NULL, PLEXUS_KIND_COUNTER, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_counter_register(c, "b", (plexus_metric_kind_t)7, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_counter_register(c, "", PLEXUS_KIND_COUNTER, 0) == PLEXUS_ERR_INVALID_ARG);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_COUNTERS; i++) {
+        snprintf(name, sizeof(name), "c%d", i);
+        ASSERT(plexus_counter_register(c, name, PLEXUS_KIND_COUNTER, 1000) == PLEXUS_OK);
+    }
+    ASSERT(plexus_counter_register(c, "extra", PLEXUS_KIND_GAUGE, 1000) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_counter_register(c, "c0", PLEXUS_KIND_RATE, 500) == PLEXUS_OK);
+
+    plexus_free(c);
+}
+
+TEST(counter_add_coalesces_increments) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "pulses", PLEXUS_KIND_COUNTER, 1000) == PLEXUS_OK);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(plexus_counter_add(c, "pulses", 1.0) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(strcmp(c->metrics[0].name, "pulses") == 0);
+    ASSERT(c->metrics[0].value.data.number == 1000.0);
+
+    /* Idle window emits nothing */
+    mock_hal_advance_tick(5000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+
+    ASSERT(plexus_counter_add(c, "pulses", -1.0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_counter_add(c, "pulses", NAN) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_counter_add(c, "unknown", 1.0) == PLEXUS_ERR_INVALID_ARG);
+
+    plexus_free(c);
+}
+
+TEST(cumulative_readings_become_deltas) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "rx_bytes", PLEXUS_KIND_COUNTER, 1000) == PLEXUS_OK);
+
+    /* First reading is the baseline only */
+    ASSERT(plexus_send(c, "rx_bytes", 10000.0) == PLEXUS_OK);
+    mock_hal_advance_tick(2000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    ASSERT(plexus_send(c, "rx_bytes", 10500.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "rx_bytes", 11200.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 1200.0);
+
+    plexus_free(c);
+}
+
+TEST(reset_is_not_a_negative_spike) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "pkts", PLEXUS_KIND_COUNTER, 1000) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "pkts", 900.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "pkts", 1000.0) == PLEXUS_OK);   /* +100 */
+    ASSERT(plexus_send(c, "pkts", 30.0) == PLEXUS_OK);     /* reset: +30 */
+    ASSERT(plexus_send(c, "pkts", 50.0) == PLEXUS_OK);     /* +20 */
+    ASSERT(plexus_send(c, "pkts", INFINITY) == PLEXUS_ERR_INVALID_ARG);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 150.0);
+
+    plexus_free(c);
+}
+
+TEST(rate_is_per_second) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "tx_rate", PLEXUS_KIND_RATE, 2000) == PLEXUS_OK);
+
+    ASSERT(plexus_counter_add(c, "tx_rate", 300.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_counter_add(c, "tx_rate", 700.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(fabs(c->metrics[0].value.data.number - 500.0) < 1e-9);
+
+    plexus_free(c);
+}
+
+TEST(sparse_rate_covers_quiet_time) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "tx_rate", PLEXUS_KIND_RATE, 1000) == PLEXUS_OK);
+
+    /* One increment after 5 s of silence spans 6 s by the time it closes */
+    mock_hal_advance_tick(5000);
+    ASSERT(plexus_counter_add(c, "tx_rate", 1.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(fabs(c->metrics[0].value.data.number - 1.0 / 6.0) < 1e-9);
+
+    /* The next gap is measured from that point */
+    mock_hal_advance_tick(3000);
+    ASSERT(plexus_counter_add(c, "tx_rate", 8.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(fabs(c->metrics[1].value.data.number - 2.0) < 1e-9);
+
+    plexus_free(c);
+}
+
+TEST(sparse_readings_rate_spans_the_readings) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "rx_rate", PLEXUS_KIND_RATE, 1000) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "rx_rate", 100.0) == PLEXUS_OK);
+    mock_hal_advance_tick(5000);
+    ASSERT(plexus_send(c, "rx_rate", 101.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(fabs(c->metrics[0].value.data.number - 0.2) < 1e-9);
+
+    /* Quiet after the emit: the next increase still covers reading to reading */
+    mock_hal_advance_tick(4000);
+    ASSERT(plexus_send(c, "rx_rate", 111.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(fabs(c->metrics[1].value.data.number - 2.0) < 1e-9);
+
+    plexus_free(c);
+}
+
+TEST(gauge_keeps_last_value) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "queue_depth", PLEXUS_KIND_GAUGE, 1000) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "queue_depth", 3.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "queue_depth", 9.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "queue_depth", 4.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(plexus_counter_add(c, "queue_depth", 1.0) == PLEXUS_ERR_INVALID_ARG);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 4.0);
+
+    plexus_free(c);
+}
+
+TEST(late_update_closes_previous_window) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "n", PLEXUS_KIND_COUNTER, 1000) == PLEXUS_OK);
+
+    ASSERT(plexus_counter_add(c, "n", 5.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1500);
+    ASSERT(plexus_counter_add(c, "n", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 5.0);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(c->metrics[1].value.data.number == 2.0);
+
+    plexus_free(c);
+}
+
+TEST(buffer_full_keeps_accumulating) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "n", PLEXUS_KIND_COUNTER, 1000) == PLEXUS_OK);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_METRICS; i++) {
+        snprintf(name, sizeof(name), "fill_%d", i);
+        ASSERT(plexus_send(c, name, 0.0) == PLEXUS_OK);
+    }
+
+    ASSERT(plexus_counter_add(c, "n", 1.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_counter_add(c, "n", 1.0) == PLEXUS_OK);  /* folded into the overdue window */
+
+    plexus_clear(c);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 2.0);
+
+    plexus_free(c);
+}
+
+TEST(window_zero_follows_flush_interval) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 3000) == PLEXUS_OK);
+    ASSERT(plexus_counter_register(c, "n", PLEXUS_KIND_COUNTER, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_counter_add(c, "n", 4.0) == PLEXUS_OK);
+    mock_hal_advance_tick(2999);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    /* Window closes, then the interval flush sends it */
+    mock_hal_advance_tick(1);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(c) == 1);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_counter:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(counter_add_coalesces_increments);
+    RUN(cumulative_readings_become_deltas);
+    RUN(reset_is_not_a_negative_spike);
+    RUN(rate_is_per_second);
+    RUN(sparse_rate_covers_quiet_time);
+    RUN(sparse_readings_rate_spans_the_readings);
+    RUN(gauge_keeps_last_value);
+    RUN(late_update_closes_previous_window);
+    RUN(buffer_full_keeps_accumulating);
+    RUN(window_zero_follows_flush_interval);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
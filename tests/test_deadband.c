@@ -0,0 +1,188 @@
+/**
+ * @file test_deadband.c
+ * @brief Tests for report-by-exception deadband filtering
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_deadband
+ * Requires: -DPLEXUS_ENABLE_DEADBAND=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* ---- Tests ---- */
+
+TEST(set_deadband_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_deadband(NULL, "t", 1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_set_deadband(c, NULL, 1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_set_deadband(c, "t", -1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_set_deadband(c, "t", NAN, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_set_deadband(c, "", 1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_ERR_INVALID_ARG);
+    plexus_free(c);
+}
+
+TEST(table_full) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_DEADBANDS; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        ASSERT(plexus_set_deadband(c, name, 1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_OK);
+    }
+    ASSERT(plexus_set_deadband(c, "extra", 1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_set_deadband(c, "m0", 2.0, PLEXUS_DEADBAND_PERCENT, 0) == PLEXUS_OK);
+    plexus_free(c);
+}
+
+TEST(absolute_deadband_suppresses_small_changes) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_deadband(c, "temp", 0.5, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "temp", 20.0) == PLEXUS_OK);   /* first: always sent */
+    ASSERT(plexus_send(c, "temp", 20.3) == PLEXUS_OK);   /* within band */
+    ASSERT(plexus_send(c, "temp", 19.6) == PLEXUS_OK);   /* within band */
+    ASSERT(plexus_pending_count(c) == 1);
+
+    ASSERT(plexus_send(c, "temp", 20.6) == PLEXUS_OK);   /* outside band */
+    ASSERT(plexus_pending_count(c) == 2);
+
+    /* Band is relative to the last *sent* value (20.6), not the last sample */
+    ASSERT(plexus_send(c, "temp", 21.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 21.2) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);
+
+    /* Unconfigured metrics pass through */
+    ASSERT(plexus_send(c, "other", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "other", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 5);
+
+    plexus_free(c);
+}
+
+TEST(percent_deadband) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_deadband(c, "heap", 10.0, PLEXUS_DEADBAND_PERCENT, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "heap", 200000.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "heap", 185000.0) == PLEXUS_OK);  /* -7.5% */
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_send(c, "heap", 179000.0) == PLEXUS_OK);  /* -10.5% */
+    ASSERT(plexus_pending_count(c) == 2);
+
+    plexus_free(c);
+}
+
+TEST(zero_threshold_drops_exact_repeats) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_deadband(c, "state", 0.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "state", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "state", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "state", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    plexus_free(c);
+}
+
+TEST(max_silence_forces_heartbeat) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_set_deadband(c, "rssi", 5.0, PLEXUS_DEADBAND_ABSOLUTE, 60000) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "rssi", -60.0) == PLEXUS_OK);
+    mock_hal_advance_tick(59999);
+    ASSERT(plexus_send(c, "rssi", -61.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+
+    mock_hal_advance_tick(1);
+    ASSERT(plexus_send(c, "rssi", -61.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    /* Heartbeat restarts the silence timer */
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_send(c, "rssi", -61.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    plexus_free(c);
+}
+
+TEST(nan_always_passes) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_deadband(c, "x", 100.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "x", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "x", NAN) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "x", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);
+
+    plexus_free(c);
+}
+
+TEST(buffer_full_does_not_commit) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_set_deadband(c, "v", 1.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_OK);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_METRICS; i++) {
+        snprintf(name, sizeof(name), "fill_%d", i);
+        ASSERT(plexus_send(c, name, 0.0) == PLEXUS_OK);
+    }
+
+    /* Rejected sample must not become the deadband reference */
+    ASSERT(plexus_send(c, "v", 50.0) == PLEXUS_ERR_BUFFER_FULL);
+    plexus_clear(c);
+    ASSERT(plexus_send(c, "v", 50.5) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_deadband:\n");
+
+    RUN(set_deadband_rejects_bad_args);
+    RUN(table_full);
+    RUN(absolute_deadband_suppresses_small_changes);
+    RUN(percent_deadband);
+    RUN(zero_threshold_drops_exact_repeats);
+    RUN(max_silence_forces_heartbeat);
+    RUN(nan_always_passes);
+    RUN(buffer_full_does_not_commit);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
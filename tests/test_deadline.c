@@ -0,0 +1,255 @@
+/**
+ * @file test_deadline.c
+ * @brief Tests for plexus_next_deadline_ms() and the plexus_on_wake() hook
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_deadline
+ * Requires: -DPLEXUS_ENABLE_WAKE_CALLBACK=1 -DPLEXUS_ENABLE_WEBSOCKET=1 -DPLEXUS_ENABLE_AGGREGATION=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_set_next_post_result(plexus_err_t err);
+extern void mock_hal_ws_reset(void);
+extern void mock_hal_ws_inject(plexus_ws_event_t event, const char* data);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+static int s_wakes = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_ws_reset(); \
+    s_wakes = 0; \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+static void on_wake(void* user_data) {
+    (void)user_data;
+    s_wakes++;
+}
+
+/* Only time-based flushes, so the interval deadline is what the tests see */
+static plexus_client_t* new_client(void) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    }
+    return c;
+}
+
+/* ---- Deadlines ---- */
+
+TEST(idle_client_has_no_deadline) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_DEADLINE_NONE);
+    plexus_free(c);
+}
+
+TEST(null_client_is_due_now) {
+    ASSERT(plexus_next_deadline_ms(NULL) == 0);
+}
+
+TEST(queued_point_waits_for_flush_interval) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_set_flush_interval(c, 4000) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+
+    ASSERT(plexus_next_deadline_ms(c) == 4000);
+    mock_hal_advance_tick(1500);
+    ASSERT(plexus_next_deadline_ms(c) == 2500);
+    mock_hal_advance_tick(3000);
+    ASSERT(plexus_next_deadline_ms(c) == 0);
+
+    /* The tick flushes; nothing is left to wait for */
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_DEADLINE_NONE);
+    plexus_free(c);
+}
+
+TEST(zero_interval_uses_default_deadline) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_set_flush_interval(c, 0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    plexus_free(c);
+}
+
+TEST(rate_limit_cooldown_holds_flush_back) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_RATE_LIMIT);
+    ASSERT(plexus_flush(c) == PLEXUS_ERR_RATE_LIMIT);
+
+    ASSERT(plexus_send(c, "temp", 2.0) == PLEXUS_OK);
+    mock_hal_advance_tick(PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+
+    /* The interval has passed, but a tick could only hit the cooldown */
+    ASSERT(plexus_next_deadline_ms(c) ==
+           PLEXUS_RATE_LIMIT_COOLDOWN_MS - PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    plexus_free(c);
+}
+
+TEST(aggregation_window_close_is_a_deadline) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_aggregate_register(c, "temp", 1000, PLEXUS_AGG_MEAN) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_DEADLINE_NONE);
+
+    ASSERT(plexus_send(c, "temp", 20.0) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == 1000);
+    mock_hal_advance_tick(400);
+    ASSERT(plexus_next_deadline_ms(c) == 600);
+
+    /* Closing the window queues the mean, which then waits for the flush */
+    mock_hal_advance_tick(600);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_AUTO_FLUSH_INTERVAL_MS - 1000);
+    plexus_free(c);
+}
+
+TEST(websocket_timers_are_deadlines) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_set_org_id(c, "org_1") == PLEXUS_OK);
+    ASSERT(plexus_ws_connect(c) == PLEXUS_OK);
+
+    /* Connecting waits on the HAL only */
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_DEADLINE_NONE);
+
+    /* An unprocessed event is due now; then the auth timeout runs */
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    ASSERT(plexus_next_deadline_ms(c) == 0);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_ws_state(c) == PLEXUS_WS_AUTHENTICATING);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_WS_AUTH_TIMEOUT_MS);
+
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_ws_state(c) == PLEXUS_WS_CONNECTED);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_WS_HEARTBEAT_INTERVAL_MS - 1000);
+
+    /* Reconnect backoff (with jitter) after a drop */
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DISCONNECTED, NULL);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_ws_state(c) == PLEXUS_WS_RECONNECTING);
+    uint32_t wait = plexus_next_deadline_ms(c);
+    ASSERT(wait > 0 && wait <= PLEXUS_WS_RECONNECT_BASE_MS * 2);
+
+    (void)plexus_ws_disconnect(c);
+    plexus_free(c);
+}
+
+TEST(earliest_deadline_wins) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_aggregate_register(c, "temp", 60000, PLEXUS_AGG_MEAN) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 20.0) == PLEXUS_OK);      /* Window: 60 s */
+    ASSERT(plexus_send(c, "pressure", 1.0) == PLEXUS_OK);   /* Flush: 5 s */
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    plexus_free(c);
+}
+
+/* ---- Wake hook ---- */
+
+TEST(wake_fires_when_a_send_moves_the_deadline_earlier) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_on_wake(c, on_wake, NULL) == PLEXUS_OK);
+
+    /* Not armed until the app asks for a deadline */
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(s_wakes == 0);
+    plexus_clear(c);
+
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_DEADLINE_NONE);
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(s_wakes == 1);
+
+    /* Once per deadline handed out */
+    ASSERT(plexus_send(c, "temp", 2.0) == PLEXUS_OK);
+    ASSERT(s_wakes == 1);
+    plexus_free(c);
+}
+
+TEST(wake_skipped_when_the_deadline_does_not_move) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_on_wake(c, on_wake, NULL) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    mock_hal_advance_tick(100);
+    ASSERT(plexus_send(c, "temp", 2.0) == PLEXUS_OK);
+    ASSERT(s_wakes == 0);
+    plexus_free(c);
+}
+
+TEST(wake_fires_on_websocket_events) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_on_wake(c, on_wake, NULL) == PLEXUS_OK);
+    ASSERT(plexus_set_org_id(c, "org_1") == PLEXUS_OK);
+    ASSERT(plexus_ws_connect(c) == PLEXUS_OK);
+
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    ASSERT(s_wakes == 1);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    ASSERT(s_wakes == 2);
+
+    /* Unknown messages are not work for the tick */
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"pong\"}");
+    ASSERT(s_wakes == 2);
+
+    (void)plexus_ws_disconnect(c);
+    plexus_free(c);
+}
+
+TEST(on_wake_validates_client) {
+    ASSERT(plexus_on_wake(NULL, on_wake, NULL) == PLEXUS_ERR_NULL_PTR);
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_on_wake(c, NULL, NULL) == PLEXUS_OK);
+    plexus_free(c);
+}
+
+/* ---- Main ---- */
+
+int main(void) {
+    printf("test_deadline:\n");
+
+    RUN(idle_client_has_no_deadline);
+    RUN(null_client_is_due_now);
+    RUN(queued_point_waits_for_flush_interval);
+    RUN(zero_interval_uses_default_deadline);
+    RUN(rate_limit_cooldown_holds_flush_back);
+    RUN(aggregation_window_close_is_a_deadline);
+    RUN(websocket_timers_are_deadlines);
+    RUN(earliest_deadline_wins);
+    RUN(wake_fires_when_a_send_moves_the_deadline_earlier);
+    RUN(wake_skipped_when_the_deadline_does_not_move);
+    RUN(wake_fires_on_websocket_events);
+    RUN(on_wake_validates_client);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
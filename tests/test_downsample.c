@@ -0,0 +1,239 @@
+/**
+ * @file test_downsample.c
+ * @brief Tests for LTTB / min-max waveform downsampling
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_downsample
+ * Requires: -DPLEXUS_ENABLE_DOWNSAMPLE=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define T0 1700000000000ULL
+
+/* True if a queued point has this value */
+static bool has_value(const plexus_client_t* c, double v) {
+    for (uint16_t i = 0; i < c->metric_count; i++) {
+        if (c->metrics[i].value.data.number == v) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* True if queued timestamps are strictly increasing */
+static bool timestamps_ordered(const plexus_client_t* c) {
+    for (uint16_t i = 1; i < c->metric_count; i++) {
+        if (c->metrics[i].timestamp_ms <= c->metrics[i - 1].timestamp_ms) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(NULL, "w", 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_downsample_register(c, NULL, 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_downsample_register(c, "w", 2, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_downsample_register(c, "w", 1, PLEXUS_DOWNSAMPLE_MINMAX) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_downsample_register(c, "w", PLEXUS_MAX_METRICS + 1, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_downsample_register(c, "w", 10, (plexus_downsample_method_t)9) == PLEXUS_ERR_INVALID_ARG);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_DOWNSAMPLED; i++) {
+        snprintf(name, sizeof(name), "w%d", i);
+        ASSERT(plexus_downsample_register(c, name, 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_OK);
+    }
+    ASSERT(plexus_downsample_register(c, "extra", 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_downsample_register(c, "w0", 4, PLEXUS_DOWNSAMPLE_MINMAX) == PLEXUS_OK);
+
+    plexus_free(c);
+}
+
+TEST(samples_are_buffered_not_queued) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(c, "wave", 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_OK);
+
+    for (int i = 0; i < 100; i++) {
+        ASSERT(plexus_send_number_ts(c, "wave", (double)i, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(plexus_downsample_pending(c));
+
+    plexus_free(c);
+}
+
+TEST(lttb_keeps_endpoints_and_spike) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(c, "wave", 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_OK);
+
+    for (int i = 0; i < 200; i++) {
+        double v = (i == 97) ? 100.0 : 0.0;
+        ASSERT(plexus_send_number_ts(c, "wave", v, T0 + (uint64_t)i * 10) == PLEXUS_OK);
+    }
+    ASSERT(plexus_downsample_drain(c) == PLEXUS_OK);
+
+    ASSERT(plexus_pending_count(c) == 10);
+    ASSERT(c->metrics[0].timestamp_ms == T0);
+    ASSERT(c->metrics[9].timestamp_ms == T0 + 1990);
+    ASSERT(has_value(c, 100.0));
+    ASSERT(timestamps_ordered(c));
+    ASSERT(!plexus_downsample_pending(c));
+
+    plexus_free(c);
+}
+
+TEST(minmax_keeps_every_peak) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(c, "vib", 8, PLEXUS_DOWNSAMPLE_MINMAX) == PLEXUS_OK);
+
+    /* Four 50-sample buckets, each with one high and one low outlier */
+    for (int i = 0; i < 200; i++) {
+        double v = 0.0;
+        if (i % 50 == 10) v = 10.0 + i;
+        if (i % 50 == 40) v = -10.0 - i;
+        ASSERT(plexus_send_number_ts(c, "vib", v, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_downsample_drain(c) == PLEXUS_OK);
+
+    ASSERT(plexus_pending_count(c) == 8);
+    for (int b = 0; b < 4; b++) {
+        ASSERT(has_value(c, 10.0 + (b * 50 + 10)));
+        ASSERT(has_value(c, -10.0 - (b * 50 + 40)));
+    }
+    ASSERT(timestamps_ordered(c));
+
+    plexus_free(c);
+}
+
+TEST(under_target_sends_raw_samples) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(c, "wave", 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_OK);
+
+    for (int i = 0; i < 5; i++) {
+        ASSERT(plexus_send_number_ts(c, "wave", 1.5 * i, T0 + (uint64_t)i * 7) == PLEXUS_OK);
+    }
+    ASSERT(plexus_downsample_drain(c) == PLEXUS_OK);
+
+    ASSERT(plexus_pending_count(c) == 5);
+    ASSERT(c->metrics[4].value.data.number == 6.0);
+    ASSERT(c->metrics[4].timestamp_ms == T0 + 28);
+
+    plexus_free(c);
+}
+
+TEST(overflow_compacts_in_place) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(c, "wave", 16, PLEXUS_DOWNSAMPLE_MINMAX) == PLEXUS_OK);
+
+    int total = PLEXUS_DOWNSAMPLE_CAPACITY * 4;
+    for (int i = 0; i < total; i++) {
+        double v = (i == 3) ? 500.0 : (i == total - 2) ? -500.0 : 1.0;
+        ASSERT(plexus_send_number_ts(c, "wave", v, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(c->downsampled[0].count <= PLEXUS_DOWNSAMPLE_CAPACITY);
+
+    ASSERT(plexus_downsample_drain(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) <= 16);
+    ASSERT(has_value(c, 500.0));
+    ASSERT(has_value(c, -500.0));
+    ASSERT(timestamps_ordered(c));
+
+    plexus_free(c);
+}
+
+TEST(drain_fits_remaining_room) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_downsample_register(c, "wave", 10, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_OK);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_METRICS - 4; i++) {
+        snprintf(name, sizeof(name), "fill_%d", i);
+        ASSERT(plexus_send(c, name, 0.0) == PLEXUS_OK);
+    }
+    for (int i = 0; i < 100; i++) {
+        ASSERT(plexus_send_number_ts(c, "wave", (double)i, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+
+    ASSERT(plexus_downsample_drain(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS);
+
+    /* No room at all: samples stay buffered */
+    ASSERT(plexus_send_number_ts(c, "wave", 1.0, T0 + 500) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "wave", 2.0, T0 + 501) == PLEXUS_OK);
+    ASSERT(plexus_downsample_drain(c) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_downsample_pending(c));
+
+    plexus_free(c);
+}
+
+TEST(interval_flush_sends_waveform) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_downsample_register(c, "wave", 20, PLEXUS_DOWNSAMPLE_LTTB) == PLEXUS_OK);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(plexus_send_number_ts(c, "wave", sin(i * 0.05), T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+
+    /* Nothing is queued, but tick still flushes the buffered waveform */
+    mock_hal_advance_tick(PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(c) == 20);
+    ASSERT(!plexus_downsample_pending(c));
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_downsample:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(samples_are_buffered_not_queued);
+    RUN(lttb_keeps_endpoints_and_spike);
+    RUN(minmax_keeps_every_peak);
+    RUN(under_target_sends_raw_samples);
+    RUN(overflow_compacts_in_place);
+    RUN(drain_fits_remaining_room);
+    RUN(interval_flush_sends_waveform);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
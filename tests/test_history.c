@@ -0,0 +1,260 @@
+/**
+ * @file test_history.c
+ * @brief Tests for on-device history rings and the built-in history command
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_history
+ * Requires: -DPLEXUS_ENABLE_HISTORY=1 -DPLEXUS_ENABLE_WEBSOCKET=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_ws_reset(void);
+extern void mock_hal_ws_inject(plexus_ws_event_t event, const char* data);
+extern const char* mock_hal_ws_last_sent(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_ws_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Drive the WS state machine to CONNECTED */
+static void ws_connect(plexus_client_t* c) {
+    (void)plexus_set_org_id(c, "org_1");
+    (void)plexus_ws_connect(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)plexus_tick(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    (void)plexus_tick(c);
+}
+
+static void send_command(plexus_client_t* c, const char* params) {
+    char msg[256];
+    snprintf(msg, sizeof(msg),
+             "{\"type\":\"typed_command\",\"id\":\"h1\",\"command\":\"history\",\"params\":%s}",
+             params);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, msg);
+    (void)plexus_tick(c);
+}
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_history_register(NULL, "temp", 1000) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_history_register(c, NULL, 1000) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_history_register(c, "bad\nname", 1000) == PLEXUS_ERR_INVALID_ARG);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_HISTORY; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        ASSERT(plexus_history_register(c, name, 1000) == PLEXUS_OK);
+    }
+    ASSERT(plexus_history_register(c, "extra", 1000) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_history_register(c, "m0", 1000) == PLEXUS_OK);
+
+    double v;
+    ASSERT(plexus_history_get(c, "extra", 0, &v, NULL) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_history_get(c, "m0", 0, &v, NULL) == PLEXUS_ERR_NO_DATA);
+    ASSERT(plexus_history_count(c, "extra") == 0);
+    plexus_free(c);
+}
+
+TEST(samples_averaged_into_intervals) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_history_register(c, "temp", 1000) == PLEXUS_OK);
+
+    ASSERT(plexus_send_number_ts(c, "temp", 1.0, 5000) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "temp", 3.0, 5400) == PLEXUS_OK);
+    ASSERT(plexus_history_count(c, "temp") == 0);
+
+    /* A sample after the interval closes it */
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_send_number_ts(c, "temp", 10.0, 6000) == PLEXUS_OK);
+    ASSERT(plexus_history_count(c, "temp") == 1);
+
+    /* And so does tick */
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_history_count(c, "temp") == 2);
+
+    double v;
+    uint64_t ts;
+    ASSERT(plexus_history_get(c, "temp", 0, &v, &ts) == PLEXUS_OK);
+    ASSERT(v == 2.0 && ts == 5000);
+    ASSERT(plexus_history_get(c, "temp", 1, &v, &ts) == PLEXUS_OK);
+    ASSERT(v == 10.0 && ts == 6000);
+
+    /* Recording does not change what is queued */
+    ASSERT(plexus_pending_count(c) == 3);
+
+    plexus_free(c);
+}
+
+TEST(ring_overwrites_oldest_and_keeps_timestamps) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_history_register(c, "v", 0) == PLEXUS_OK);
+
+    for (int i = 0; i < PLEXUS_HISTORY_SIZE + 5; i++) {
+        ASSERT(plexus_send_number_ts(c, "v", (double)i, 100000 + (uint64_t)i * 250) == PLEXUS_OK);
+        plexus_clear(c);
+    }
+    ASSERT(plexus_history_count(c, "v") == PLEXUS_HISTORY_SIZE);
+
+    double v;
+    uint64_t ts;
+    ASSERT(plexus_history_get(c, "v", 0, &v, &ts) == PLEXUS_OK);
+    ASSERT(v == 5.0 && ts == 100000 + 5 * 250);
+    ASSERT(plexus_history_get(c, "v", PLEXUS_HISTORY_SIZE - 1, &v, &ts) == PLEXUS_OK);
+    ASSERT(v == (double)(PLEXUS_HISTORY_SIZE + 4));
+    ASSERT(ts == 100000 + (uint64_t)(PLEXUS_HISTORY_SIZE + 4) * 250);
+
+    /* Changing the interval starts over */
+    ASSERT(plexus_history_register(c, "v", 5000) == PLEXUS_OK);
+    ASSERT(plexus_history_count(c, "v") == 0);
+
+    plexus_free(c);
+}
+
+TEST(values_stored_as_float32) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_history_register(c, "v", 0) == PLEXUS_OK);
+    ASSERT(sizeof(plexus_history_entry_t) == 8);
+
+    ASSERT(plexus_send_number_ts(c, "v", 0.1, 1000) == PLEXUS_OK);
+    double v;
+    ASSERT(plexus_history_get(c, "v", 0, &v, NULL) == PLEXUS_OK);
+    ASSERT(v == (double)0.1f);
+
+    plexus_free(c);
+}
+
+TEST(ws_history_command) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_history_register(c, "temp", 0) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "temp", 21.5, 1700000001000ULL) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "temp", 0.1, 1700000002000ULL) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "temp", 22.0, 1700000003000ULL) == PLEXUS_OK);
+    plexus_clear(c);
+
+    ws_connect(c);
+    ASSERT(plexus_ws_state(c) == PLEXUS_WS_CONNECTED);
+
+    send_command(c, "{\"metric\":\"temp\"}");
+    ASSERT(strcmp(mock_hal_ws_last_sent(),
+                  "{\"type\":\"command_result\",\"id\":\"h1\",\"command\":\"history\","
+                  "\"event\":\"result\",\"result\":{\"metric\":\"temp\",\"interval_ms\":0,"
+                  "\"points\":[[1700000001000,21.5],[1700000002000,0.1],[1700000003000,22]],"
+                  "\"more\":false}}") == 0);
+
+    /* "since" skips what the dashboard already has */
+    send_command(c, "{\"metric\":\"temp\",\"since\":1700000002000}");
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"points\":[[1700000003000,22]]") != NULL);
+
+    plexus_free(c);
+}
+
+TEST(ws_history_pages_large_rings) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_history_register(c, "temp", 0) == PLEXUS_OK);
+    for (int i = 0; i < PLEXUS_HISTORY_SIZE; i++) {
+        ASSERT(plexus_send_number_ts(c, "temp", 20.0 + i * 0.25,
+                                     1700000000000ULL + (uint64_t)i * 5000) == PLEXUS_OK);
+        plexus_clear(c);
+    }
+    ws_connect(c);
+
+    /* Follow "more" with "since" = last timestamp received */
+    int total = 0;
+    int pages = 0;
+    unsigned long long since = 0;
+    for (;;) {
+        char params[64];
+        snprintf(params, sizeof(params), "{\"metric\":\"temp\",\"since\":%llu}", since);
+        send_command(c, params);
+        const char* msg = mock_hal_ws_last_sent();
+        ASSERT(strlen(msg) < PLEXUS_JSON_BUFFER_SIZE);
+        pages++;
+
+        const char* p = strstr(msg, "\"points\":[");
+        ASSERT(p != NULL);
+        p += strlen("\"points\":[");
+        while (*p == '[') {
+            since = strtoull(p + 1, NULL, 10);
+            total++;
+            p = strchr(p, ']') + 1;
+            if (*p == ',') p++;
+        }
+        if (strstr(msg, "\"more\":false")) break;
+        ASSERT(strstr(msg, "\"more\":true") != NULL);
+        ASSERT(pages < 100);
+    }
+
+    ASSERT(total == PLEXUS_HISTORY_SIZE);
+    ASSERT(since == 1700000000000ULL + (uint64_t)(PLEXUS_HISTORY_SIZE - 1) * 5000);
+
+    plexus_free(c);
+}
+
+TEST(ws_history_errors_and_schema) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_history_register(c, "temp", 1000) == PLEXUS_OK);
+    ws_connect(c);
+
+    send_command(c, "{}");
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"error\":\"Missing param: metric\"") != NULL);
+
+    send_command(c, "{\"metric\":\"nope\"}");
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"error\":\"No history for metric: nope\"") != NULL);
+
+    char buf[512];
+    ASSERT(plexus_json_serialize_ws_auth(c, buf, sizeof(buf)) > 0);
+    ASSERT(strstr(buf, "{\"name\":\"history\"") != NULL);
+    ASSERT(strstr(buf, "{\"name\":\"metric\",\"type\":\"string\",\"required\":true}") != NULL);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_history:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(samples_averaged_into_intervals);
+    RUN(ring_overwrites_oldest_and_keeps_timestamps);
+    RUN(values_stored_as_float32);
+    RUN(ws_history_command);
+    RUN(ws_history_pages_large_rings);
+    RUN(ws_history_errors_and_schema);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
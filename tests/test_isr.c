@@ -0,0 +1,211 @@
+/**
+ * @file test_isr.c
+ * @brief Tests for plexus_send_from_isr() and its staging ring
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_isr
+ * Requires: -DPLEXUS_ENABLE_ISR_QUEUE=1 -DPLEXUS_ENABLE_AGGREGATION=1
+ */
+
+#include "plexus.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern int mock_hal_post_call_count(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define RING_SLOTS (PLEXUS_ISR_QUEUE_SIZE - 1)
+
+/* No count-based flush unless a test asks for one */
+static plexus_client_t* new_client(void) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    }
+    return c;
+}
+
+/* ---- Staging ---- */
+
+TEST(staged_until_tick) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send_from_isr(c, "adc", 1.5) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(strcmp(c->metrics[0].name, "adc") == 0);
+    ASSERT(c->metrics[0].value.data.number == 1.5);
+    plexus_free(c);
+}
+
+TEST(tick_stamp_becomes_wall_time) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send_from_isr(c, "adc", 1.0) == PLEXUS_OK);
+    mock_hal_advance_tick(100);
+    ASSERT(plexus_send_from_isr(c, "adc", 2.0) == PLEXUS_OK);
+    mock_hal_advance_tick(150);
+
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(c->metrics[0].timestamp_ms > 0);
+    ASSERT(c->metrics[1].timestamp_ms - c->metrics[0].timestamp_ms == 100);
+    plexus_free(c);
+}
+
+TEST(ring_keeps_order_across_wraparound) {
+    plexus_client_t* c = new_client();
+    double next = 0.0;
+    for (int round = 0; round < 3 * PLEXUS_ISR_QUEUE_SIZE; round++) {
+        ASSERT(plexus_send_from_isr(c, "adc", next) == PLEXUS_OK);
+        ASSERT(plexus_tick(c) == PLEXUS_OK);
+        ASSERT(plexus_pending_count(c) == 1);
+        ASSERT(c->metrics[0].value.data.number == next);
+        plexus_clear(c);
+        next += 1.0;
+    }
+    plexus_free(c);
+}
+
+TEST(full_ring_drops_and_counts) {
+    plexus_client_t* c = new_client();
+    for (int i = 0; i < RING_SLOTS; i++) {
+        ASSERT(plexus_send_from_isr(c, "adc", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_send_from_isr(c, "adc", 99.0) == PLEXUS_ERR_BUFFER_FULL);
+
+    /* The ISR's count reaches the totals at the next tick */
+    plexus_totals_t t;
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.dropped == 1);
+    plexus_free(c);
+}
+
+TEST(validates_name_in_isr) {
+    plexus_client_t* c = new_client();
+    char long_name[PLEXUS_MAX_METRIC_NAME_LEN + 1];
+    memset(long_name, 'a', sizeof(long_name) - 1);
+    long_name[sizeof(long_name) - 1] = '\0';
+
+    ASSERT(plexus_send_from_isr(NULL, "adc", 1.0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_send_from_isr(c, NULL, 1.0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_send_from_isr(c, "", 1.0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_send_from_isr(c, long_name, 1.0) == PLEXUS_ERR_STRING_TOO_LONG);
+
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+    plexus_free(c);
+}
+
+/* ---- Draining ---- */
+
+TEST(drain_leaves_samples_staged_while_queue_full) {
+    plexus_client_t* c = new_client();
+    for (int i = 0; i < PLEXUS_MAX_METRICS - 1; i++) {
+        ASSERT(plexus_send(c, "temp", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_send_from_isr(c, "adc", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send_from_isr(c, "adc", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_send_from_isr(c, "adc", 3.0) == PLEXUS_OK);
+
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS);
+
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(c->metrics[0].value.data.number == 2.0);
+
+    plexus_totals_t t;
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.dropped == 0);
+    plexus_free(c);
+}
+
+TEST(drain_runs_count_based_auto_flush) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_set_flush_count(c, 4) == PLEXUS_OK);
+    for (int i = 0; i < 5; i++) {
+        ASSERT(plexus_send_from_isr(c, "adc", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(mock_hal_post_call_count() == 0);
+
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_total_sent(c) == 4);
+    plexus_free(c);
+}
+
+TEST(isr_samples_fold_into_aggregates) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_aggregate_register(c, "adc", 1000, PLEXUS_AGG_MEAN) == PLEXUS_OK);
+    ASSERT(plexus_send_from_isr(c, "adc", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send_from_isr(c, "adc", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_send_from_isr(c, "adc", 6.0) == PLEXUS_OK);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 3.0);
+    plexus_free(c);
+}
+
+TEST(staged_samples_make_a_tick_due) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_DEADLINE_NONE);
+    ASSERT(plexus_send_from_isr(c, "adc", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == 0);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    plexus_free(c);
+}
+
+/* ---- Main ---- */
+
+int main(void) {
+    printf("test_isr:\n");
+
+    RUN(staged_until_tick);
+    RUN(tick_stamp_becomes_wall_time);
+    RUN(ring_keeps_order_across_wraparound);
+    RUN(full_ring_drops_and_counts);
+    RUN(validates_name_in_isr);
+    RUN(drain_leaves_samples_staged_while_queue_full);
+    RUN(drain_runs_count_based_auto_flush);
+    RUN(isr_samples_fold_into_aggregates);
+    RUN(staged_samples_make_a_tick_due);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
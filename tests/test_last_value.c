@@ -0,0 +1,242 @@
+/**
+ * @file test_last_value.c
+ * @brief Tests for the last-value cache and the built-in snapshot command
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_last_value
+ * Requires: -DPLEXUS_ENABLE_LAST_VALUE=1 -DPLEXUS_ENABLE_WEBSOCKET=1 -DPLEXUS_ENABLE_DEADBAND=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_ws_reset(void);
+extern void mock_hal_ws_inject(plexus_ws_event_t event, const char* data);
+extern const char* mock_hal_ws_last_sent(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_ws_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Drive the WS state machine to CONNECTED */
+static void ws_connect(plexus_client_t* c) {
+    (void)plexus_set_org_id(c, "org_1");
+    (void)plexus_ws_connect(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)plexus_tick(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    (void)plexus_tick(c);
+}
+
+static void noop_handler(const char* cmd_id, const char* params_json, void* user_data) {
+    (void)cmd_id;
+    (void)params_json;
+    (void)user_data;
+}
+
+/* ---- Tests ---- */
+
+TEST(get_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    double v = 0.0;
+    ASSERT(plexus_last_value_get(NULL, "temp", &v, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_last_value_get(c, NULL, &v, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_last_value_get(c, "temp", NULL, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_last_value_get(c, "temp", &v, NULL) == PLEXUS_ERR_NO_DATA);
+    ASSERT(plexus_last_value_count(c) == 0);
+    ASSERT(plexus_last_value_count(NULL) == 0);
+    plexus_free(c);
+}
+
+TEST(every_send_updates_the_cache) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    double v = 0.0;
+    uint64_t ts = 0;
+
+    ASSERT(plexus_send(c, "temp", 21.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 22.5) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "rpm", 1500.0, 1234567) == PLEXUS_OK);
+
+    ASSERT(plexus_last_value_count(c) == 2);
+    ASSERT(plexus_last_value_get(c, "temp", &v, &ts) == PLEXUS_OK);
+    ASSERT(v == 22.5);
+    ASSERT(ts >= 1700000000000ULL);
+    ASSERT(plexus_last_value_get(c, "rpm", &v, &ts) == PLEXUS_OK);
+    ASSERT(v == 1500.0 && ts == 1234567);
+
+    /* Flushing or clearing the queue keeps the cache */
+    plexus_clear(c);
+    ASSERT(plexus_last_value_get(c, "temp", &v, NULL) == PLEXUS_OK);
+    ASSERT(v == 22.5);
+
+    plexus_free(c);
+}
+
+TEST(bools_cached_strings_and_tags_not) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    double v = -1.0;
+
+#if PLEXUS_ENABLE_BOOL_VALUES
+    ASSERT(plexus_send_bool(c, "door_open", true) == PLEXUS_OK);
+    ASSERT(plexus_last_value_get(c, "door_open", &v, NULL) == PLEXUS_OK);
+    ASSERT(v == 1.0);
+#endif
+#if PLEXUS_ENABLE_STRING_VALUES
+    ASSERT(plexus_send_string(c, "state", "idle") == PLEXUS_OK);
+    ASSERT(plexus_last_value_get(c, "state", &v, NULL) == PLEXUS_ERR_NO_DATA);
+#endif
+#if PLEXUS_ENABLE_TAGS
+    const char* keys[] = {"room"};
+    const char* vals[] = {"lab"};
+    ASSERT(plexus_send_number_tagged(c, "humidity", 40.0, keys, vals, 1) == PLEXUS_OK);
+    ASSERT(plexus_last_value_get(c, "humidity", &v, NULL) == PLEXUS_ERR_NO_DATA);
+#endif
+
+    plexus_free(c);
+}
+
+TEST(suppressed_sends_still_update) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_deadband(c, "rssi", 5.0, PLEXUS_DEADBAND_ABSOLUTE, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send(c, "rssi", -60.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "rssi", -62.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+
+    /* Not queued, but it is the current value */
+    double v = 0.0;
+    ASSERT(plexus_last_value_get(c, "rssi", &v, NULL) == PLEXUS_OK);
+    ASSERT(v == -62.0);
+
+    plexus_free(c);
+}
+
+TEST(table_full_keeps_first_names) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 60000) == PLEXUS_OK);
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_LAST_VALUES; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        ASSERT(plexus_send(c, name, (double)i) == PLEXUS_OK);
+        plexus_clear(c);
+    }
+    ASSERT(plexus_send(c, "extra", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_last_value_count(c) == PLEXUS_MAX_LAST_VALUES);
+
+    double v = 0.0;
+    ASSERT(plexus_last_value_get(c, "extra", &v, NULL) == PLEXUS_ERR_NO_DATA);
+    ASSERT(plexus_send(c, "m0", 99.0) == PLEXUS_OK);
+    ASSERT(plexus_last_value_get(c, "m0", &v, NULL) == PLEXUS_OK);
+    ASSERT(v == 99.0);
+
+    plexus_free(c);
+}
+
+TEST(snapshot_json) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    char buf[256];
+    size_t len = 0;
+
+    ASSERT(plexus_last_value_snapshot(c, buf, sizeof(buf), &len) == PLEXUS_OK);
+    ASSERT(strcmp(buf, "{\"points\":[]}") == 0);
+    ASSERT(len == strlen(buf));
+
+    ASSERT(plexus_send_number_ts(c, "temp", 21.5, 1700000000123ULL) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "rpm", 1500.0, 1700000000456ULL) == PLEXUS_OK);
+    ASSERT(plexus_last_value_snapshot(c, buf, sizeof(buf), &len) == PLEXUS_OK);
+    ASSERT(strcmp(buf, "{\"points\":["
+                       "{\"metric\":\"temp\",\"value\":21.5,\"timestamp\":1700000000123},"
+                       "{\"metric\":\"rpm\",\"value\":1500,\"timestamp\":1700000000456}]}") == 0);
+
+    /* Too small for the table */
+    ASSERT(plexus_last_value_snapshot(c, buf, 20, NULL) == PLEXUS_ERR_JSON);
+    ASSERT(plexus_last_value_snapshot(c, NULL, 20, NULL) == PLEXUS_ERR_NULL_PTR);
+
+    plexus_free(c);
+}
+
+TEST(ws_snapshot_command) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_send_number_ts(c, "temp", 21.5, 1700000000123ULL) == PLEXUS_OK);
+
+    ws_connect(c);
+    ASSERT(plexus_ws_state(c) == PLEXUS_WS_CONNECTED);
+
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA,
+        "{\"type\":\"typed_command\",\"id\":\"c1\",\"command\":\"snapshot\",\"params\":{}}");
+    (void)plexus_tick(c);
+
+    ASSERT(strcmp(mock_hal_ws_last_sent(),
+                  "{\"type\":\"command_result\",\"id\":\"c1\",\"command\":\"snapshot\","
+                  "\"event\":\"result\",\"result\":{\"points\":["
+                  "{\"metric\":\"temp\",\"value\":21.5,\"timestamp\":1700000000123}]}}") == 0);
+
+    plexus_free(c);
+}
+
+TEST(auth_advertises_builtin_snapshot) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ws_connect(c);
+
+    char buf[512];
+    int len = plexus_json_serialize_ws_auth(c, buf, sizeof(buf));
+    ASSERT(len > 0);
+    ASSERT(strstr(buf, "\"commands\":[{\"name\":\"snapshot\"") != NULL);
+
+    /* An application "snapshot" command replaces the built-in one */
+    ASSERT(plexus_command_register(c, "snapshot", "Custom", noop_handler, NULL, NULL, 0) == PLEXUS_OK);
+    len = plexus_json_serialize_ws_auth(c, buf, sizeof(buf));
+    ASSERT(len > 0);
+    ASSERT(strstr(buf, "Current value of every metric") == NULL);
+    ASSERT(strstr(buf, "\"description\":\"Custom\"") != NULL);
+
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA,
+        "{\"type\":\"typed_command\",\"id\":\"c2\",\"command\":\"snapshot\",\"params\":{}}");
+    (void)plexus_tick(c);
+    ASSERT(strstr(mock_hal_ws_last_sent(), "\"event\":\"ack\"") != NULL);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_last_value:\n");
+
+    RUN(get_rejects_bad_args);
+    RUN(every_send_updates_the_cache);
+    RUN(bools_cached_strings_and_tags_not);
+    RUN(suppressed_sends_still_update);
+    RUN(table_full_keeps_first_names);
+    RUN(snapshot_json);
+    RUN(ws_snapshot_command);
+    RUN(auth_advertises_builtin_snapshot);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,176 @@
+/**
+ * @file test_metric.cpp
+ * @brief Tests for the typed C++ metric handles in plexus.hpp
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_metric
+ * Requires: C++20 (consteval names). test_metric_invalid_name compiles this
+ * file with -DPLEXUS_TEST_INVALID_NAME and must fail to compile.
+ */
+
+#include "plexus.hpp"
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern "C" void mock_hal_reset(void);
+extern "C" int mock_hal_post_call_count(void);
+extern "C" const char* mock_hal_last_post_body(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Name rules are evaluated by the compiler */
+static_assert(plexus::detail::is_valid_metric_name("temperature", 11), "plain name");
+static_assert(plexus::detail::is_valid_metric_name("motor.rpm [x]", 13), "printable ASCII");
+static_assert(!plexus::detail::is_valid_metric_name("", 0), "empty");
+static_assert(!plexus::detail::is_valid_metric_name("a\nb", 3), "control character");
+static_assert(!plexus::detail::is_valid_metric_name("caf\xc3\xa9", 5), "non-ASCII");
+static_assert(sizeof(plexus::MetricName) == sizeof(const char*), "a name is one pointer");
+
+constexpr plexus::MetricName kRpm("rpm");
+static_assert(kRpm.c_str() != nullptr, "constexpr name");
+
+#ifdef PLEXUS_TEST_INVALID_NAME
+/* Must not compile: newline in the name */
+static void bad_metric(plexus_client_t* c) {
+    plexus::Metric<double> bad(c, "bad\nname");
+    (void)bad;
+}
+#endif
+
+/* ---- Tests ---- */
+
+TEST(number_metric_queues) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Metric<double> temp(c, "temperature");
+    ASSERT(strcmp(temp.name(), "temperature") == 0);
+
+    ASSERT(temp.send(21.5) == PLEXUS_OK);
+    ASSERT(temp.send(22.0, 1700000000123ULL) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    ASSERT(strcmp(c->metrics[0].name, "temperature") == 0);
+    ASSERT(c->metrics[0].value.type == PLEXUS_VALUE_NUMBER);
+    ASSERT(c->metrics[0].value.data.number == 21.5);
+    ASSERT(c->metrics[0].timestamp_ms >= 1700000000000ULL);
+    ASSERT(c->metrics[1].timestamp_ms == 1700000000123ULL);
+
+    plexus_free(c);
+}
+
+TEST(handle_bound_to_cpp_client) {
+    PlexusClient px("plx_key", "dev-001");
+    ASSERT(px.isValid());
+
+    plexus::Metric<double> rpm(px, kRpm);
+    for (int i = 0; i < 5; i++) {
+        ASSERT(rpm.send(1000.0 + i) == PLEXUS_OK);
+    }
+    ASSERT(px.pendingCount() == 5);
+}
+
+#if PLEXUS_ENABLE_BOOL_VALUES
+TEST(bool_metric_queues) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Metric<bool> door(c, "door_open");
+
+    ASSERT(door.send(true) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.type == PLEXUS_VALUE_BOOL);
+    ASSERT(c->metrics[0].value.data.boolean == true);
+
+    plexus_free(c);
+}
+#endif
+
+#if PLEXUS_ENABLE_STRING_VALUES
+TEST(string_view_metric_copies_without_terminator) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Metric<std::string_view> state(c, "state");
+
+    /* A view into a larger buffer: only the viewed bytes are queued */
+    const char buf[] = "runningXXXX";
+    ASSERT(state.send(std::string_view(buf, 7)) == PLEXUS_OK);
+    ASSERT(state.send("") == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(strcmp(c->metrics[0].value.data.string, "running") == 0);
+    ASSERT(c->metrics[1].value.data.string[0] == '\0');
+
+    char big[PLEXUS_MAX_STRING_VALUE_LEN + 1];
+    memset(big, 'x', sizeof(big));
+    ASSERT(state.send(std::string_view(big, PLEXUS_MAX_STRING_VALUE_LEN)) ==
+           PLEXUS_ERR_STRING_TOO_LONG);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    plexus_free(c);
+}
+#endif
+
+TEST(null_client_or_name) {
+    plexus::Metric<double> orphan(static_cast<plexus_client_t*>(nullptr), "temperature");
+    ASSERT(orphan.send(1.0) == PLEXUS_ERR_NULL_PTR);
+
+    ASSERT(plexus_send_number_unchecked(nullptr, "temperature", 1.0, 0) == PLEXUS_ERR_NULL_PTR);
+
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_send_number_unchecked(c, nullptr, 1.0, 0) == PLEXUS_ERR_NULL_PTR);
+    plexus_free(c);
+}
+
+TEST(auto_flush_and_body_unchanged) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_count(c, 3) == PLEXUS_OK);
+    plexus::Metric<double> v(c, "v");
+
+    ASSERT(v.send(1.0, 1700000000001ULL) == PLEXUS_OK);
+    ASSERT(v.send(2.0, 1700000000002ULL) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 0);
+    ASSERT(v.send(3.0, 1700000000003ULL) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(strstr(mock_hal_last_post_body(),
+                  "{\"metric\":\"v\",\"value\":3,\"timestamp\":1700000000003") != NULL);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_metric:\n");
+
+    RUN(number_metric_queues);
+    RUN(handle_bound_to_cpp_client);
+#if PLEXUS_ENABLE_BOOL_VALUES
+    RUN(bool_metric_queues);
+#endif
+#if PLEXUS_ENABLE_STRING_VALUES
+    RUN(string_view_metric_copies_without_terminator);
+#endif
+    RUN(null_client_or_name);
+    RUN(auto_flush_and_body_unchanged);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -70,6 +70,24 @@ TEST(failed_flush_persists_data) {
     plexus_free(c);
 }
 
+TEST(persisted_batch_leaves_queue) {
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_send(c, "temp", 25.0);
+    ASSERT(plexus_flush(c) == PLEXUS_ERR_NETWORK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    /* Drain sends the stored copy; the next batch does not repeat it */
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    plexus_send(c, "humidity", 50.0);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(strstr(mock_hal_last_post_body(), "\"humidity\"") != NULL);
+    ASSERT(strstr(mock_hal_last_post_body(), "\"temp\"") == NULL);
+
+    plexus_free(c);
+}
+
 TEST(persists_multiple_batches) {
     mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
 
@@ -221,6 +239,7 @@ int main(void) {
     printf("test_persist:\n");
 
     RUN(failed_flush_persists_data);
+    RUN(persisted_batch_leaves_queue);
     RUN(persists_multiple_batches);
     RUN(ring_buffer_wraps_around);
     RUN(no_data_after_successful_drain);
@@ -0,0 +1,220 @@
+/**
+ * @file test_sdt.c
+ * @brief Tests for swinging-door trending compression
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_sdt
+ * Requires: -DPLEXUS_ENABLE_SDT=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define T0 1700000000000ULL
+
+/* Client that never auto-flushes, so the queue can be inspected */
+static plexus_client_t* quiet_client(void) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+        (void)plexus_set_flush_interval(c, 600000);
+    }
+    return c;
+}
+
+/* Linear interpolation of the queued points at time t */
+static double reconstruct(const plexus_client_t* c, uint64_t t) {
+    for (uint16_t i = 1; i < c->metric_count; i++) {
+        const plexus_metric_t* a = &c->metrics[i - 1];
+        const plexus_metric_t* b = &c->metrics[i];
+        if (t >= a->timestamp_ms && t <= b->timestamp_ms) {
+            double f = (double)(t - a->timestamp_ms) / (double)(b->timestamp_ms - a->timestamp_ms);
+            return a->value.data.number + f * (b->value.data.number - a->value.data.number);
+        }
+    }
+    return NAN;
+}
+
+/* ---- Tests ---- */
+
+TEST(set_sdt_rejects_bad_args) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_set_sdt(NULL, "t", 0.5, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_set_sdt(c, NULL, 0.5, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_set_sdt(c, "t", -0.1, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_set_sdt(c, "t", NAN, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_set_sdt(c, "t", INFINITY, 0) == PLEXUS_ERR_INVALID_ARG);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_SDT; i++) {
+        snprintf(name, sizeof(name), "m%d", i);
+        ASSERT(plexus_set_sdt(c, name, 0.5, 0) == PLEXUS_OK);
+    }
+    ASSERT(plexus_set_sdt(c, "extra", 0.5, 0) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_set_sdt(c, "m0", 1.0, 1000) == PLEXUS_OK);
+
+    plexus_free(c);
+}
+
+TEST(linear_ramp_keeps_only_endpoints) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_set_sdt(c, "level", 0.1, 0) == PLEXUS_OK);
+
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(plexus_send_number_ts(c, "level", 0.5 * i, T0 + (uint64_t)i * 1000) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_sdt_pending(c));
+
+    plexus_sdt_flush_held(c);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(c->metrics[1].value.data.number == 499.5);
+    ASSERT(c->metrics[1].timestamp_ms == T0 + 999000);
+    ASSERT(!plexus_sdt_pending(c));
+
+    plexus_free(c);
+}
+
+TEST(slope_change_queues_the_corner) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_set_sdt(c, "tank", 0.1, 0) == PLEXUS_OK);
+
+    for (int i = 0; i <= 100; i++) {
+        ASSERT(plexus_send_number_ts(c, "tank", (double)i, T0 + (uint64_t)i * 100) == PLEXUS_OK);
+    }
+    for (int i = 1; i <= 100; i++) {
+        ASSERT(plexus_send_number_ts(c, "tank", 100.0 - i, T0 + (uint64_t)(100 + i) * 100) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(c->metrics[1].value.data.number == 100.0);
+    ASSERT(c->metrics[1].timestamp_ms == T0 + 10000);
+
+    plexus_free(c);
+}
+
+TEST(reconstruction_error_is_bounded) {
+    plexus_client_t* c = quiet_client();
+    const double bound = 0.05;
+    ASSERT(plexus_set_sdt(c, "temp", bound, 0) == PLEXUS_OK);
+
+    double raw[400];
+    for (int i = 0; i < 400; i++) {
+        raw[i] = 20.0 + sin(i * 0.02) + 0.01 * ((i * 7) % 3);
+        ASSERT(plexus_send_number_ts(c, "temp", raw[i], T0 + (uint64_t)i * 10) == PLEXUS_OK);
+    }
+    plexus_sdt_flush_held(c);
+
+    /* Large compression, bounded error (SDT guarantees within 2x the door) */
+    ASSERT(plexus_pending_count(c) < 40);
+    for (int i = 0; i < 400; i++) {
+        double est = reconstruct(c, T0 + (uint64_t)i * 10);
+        ASSERT(!isnan(est));
+        ASSERT(fabs(est - raw[i]) <= 2.0 * bound + 1e-9);
+    }
+
+    plexus_free(c);
+}
+
+TEST(max_silence_forces_point) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_set_sdt(c, "p", 1.0, 60000) == PLEXUS_OK);
+
+    ASSERT(plexus_send_number_ts(c, "p", 5.0, T0) == PLEXUS_OK);
+    mock_hal_advance_tick(30000);
+    ASSERT(plexus_send_number_ts(c, "p", 5.0, T0 + 30000) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+
+    mock_hal_advance_tick(30000);
+    ASSERT(plexus_send_number_ts(c, "p", 5.0, T0 + 60000) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);   /* held endpoint + current */
+    ASSERT(!plexus_sdt_pending(c));
+
+    plexus_free(c);
+}
+
+TEST(nan_and_time_reversal_restart_segment) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_set_sdt(c, "x", 1.0, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send_number_ts(c, "x", 1.0, T0) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "x", 1.0, T0 + 10) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "x", NAN, T0 + 20) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);
+    ASSERT(isnan(c->metrics[2].value.data.number));
+
+    ASSERT(plexus_send_number_ts(c, "x", 2.0, T0 + 30) == PLEXUS_OK);     /* fresh start */
+    ASSERT(plexus_pending_count(c) == 4);
+    ASSERT(plexus_send_number_ts(c, "x", 2.0, T0 + 5) == PLEXUS_OK);      /* older timestamp */
+    ASSERT(plexus_pending_count(c) == 5);
+
+    plexus_free(c);
+}
+
+TEST(flush_includes_held_point) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_sdt(c, "level", 0.1, 0) == PLEXUS_OK);
+
+    for (int i = 0; i < 10; i++) {
+        ASSERT(plexus_send_number_ts(c, "level", (double)i, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(c) == 2);
+
+    /* Only held data left: the interval flush still sends it */
+    ASSERT(plexus_send_number_ts(c, "level", 10.0, T0 + 10) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+    mock_hal_advance_tick(PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(c) == 3);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_sdt:\n");
+
+    RUN(set_sdt_rejects_bad_args);
+    RUN(linear_ramp_keeps_only_endpoints);
+    RUN(slope_change_queues_the_corner);
+    RUN(reconstruction_error_is_bounded);
+    RUN(max_silence_forces_point);
+    RUN(nan_and_time_reversal_restart_segment);
+    RUN(flush_includes_held_point);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
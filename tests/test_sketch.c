@@ -0,0 +1,322 @@
+/**
+ * @file test_sketch.c
+ * @brief Tests for streaming quantile sketches
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_sketch
+ * Requires: -DPLEXUS_ENABLE_SKETCHES=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <assert.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Relative error of an estimate against the exact value */
+static double rel_err(double est, double exact) {
+    return fabs(est - exact) / fabs(exact);
+}
+
+static const plexus_metric_t* find_point(const plexus_client_t* c, const char* name) {
+    for (uint16_t i = 0; i < c->metric_count; i++) {
+        if (strcmp(c->metrics[i].name, name) == 0) {
+            return &c->metrics[i];
+        }
+    }
+    return NULL;
+}
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(NULL, "lat", 1000, 0.01, &h) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_sketch_register(c, NULL, 1000, 0.01, &h) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.01, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_sketch_register(c, "lat", 0, 0.01, &h) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.0, &h) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 1.0, &h) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_sketch_register(c, "lat", 1000, NAN, &h) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_sketch_register(c, "bad\nname", 1000, 0.01, &h) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_observe(c, 0, 1.0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(isnan(plexus_sketch_quantile(c, 0, 0.5)));
+    plexus_free(c);
+}
+
+TEST(register_table_full) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_sketch_handle_t h, again;
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_SKETCHES; i++) {
+        snprintf(name, sizeof(name), "lat%d", i);
+        ASSERT(plexus_sketch_register(c, name, 1000, 0.01, &h) == PLEXUS_OK);
+        ASSERT(h == i);
+    }
+    ASSERT(plexus_sketch_register(c, "extra", 1000, 0.01, &h) == PLEXUS_ERR_BUFFER_FULL);
+
+    /* Re-registering returns the existing handle */
+    ASSERT(plexus_sketch_register(c, "lat1", 5000, 0.01, &again) == PLEXUS_OK);
+    ASSERT(again == 1);
+    plexus_free(c);
+}
+
+TEST(quantiles_within_relative_accuracy) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 60000, 0.02, &h) == PLEXUS_OK);
+
+    /* 1..1000 ms, shuffled by a stride coprime to 1000 */
+    for (int i = 0; i < 1000; i++) {
+        ASSERT(plexus_observe(c, h, (double)((i * 337) % 1000 + 1)) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+
+    ASSERT(rel_err(plexus_sketch_quantile(c, h, 0.50), 500.0) <= 0.021);
+    ASSERT(rel_err(plexus_sketch_quantile(c, h, 0.90), 900.0) <= 0.021);
+    ASSERT(rel_err(plexus_sketch_quantile(c, h, 0.99), 990.0) <= 0.021);
+    ASSERT(plexus_sketch_quantile(c, h, 0.0) == 1.0);
+    ASSERT(plexus_sketch_quantile(c, h, 1.0) == 1000.0);
+    ASSERT(isnan(plexus_sketch_quantile(c, h, 1.5)));
+
+    plexus_free(c);
+}
+
+TEST(wide_range_keeps_upper_quantiles) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 60000, 0.01, &h) == PLEXUS_OK);
+
+    /* Spans far more than PLEXUS_SKETCH_BINS log-bins: low end collapses */
+    for (int i = 0; i < 900; i++) ASSERT(plexus_observe(c, h, 1e-6) == PLEXUS_OK);
+    for (int i = 0; i < 100; i++) ASSERT(plexus_observe(c, h, 1e6 + i * 1e3) == PLEXUS_OK);
+
+    ASSERT(rel_err(plexus_sketch_quantile(c, h, 0.99), 1e6 + 89e3) <= 0.011);
+    ASSERT(plexus_sketch_quantile(c, h, 0.5) >= 1e-6);
+    ASSERT(plexus_sketch_quantile(c, h, 0.5) < 1e6);
+
+    plexus_free(c);
+}
+
+TEST(busy_bin_does_not_saturate) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 60000, 0.01, &h) == PLEXUS_OK);
+
+    /* Far more than 16 bits' worth of samples in the upper bin */
+    for (int i = 0; i < 60000; i++) ASSERT(plexus_observe(c, h, 1.0) == PLEXUS_OK);
+    for (int i = 0; i < 200000; i++) ASSERT(plexus_observe(c, h, 2.0) == PLEXUS_OK);
+
+    /* A saturated upper bin would pull p25 down into the lower one */
+    ASSERT(rel_err(plexus_sketch_quantile(c, h, 0.25), 2.0) <= 0.011);
+    ASSERT(plexus_sketch_quantile(c, h, 0.1) == 1.0);
+
+    plexus_free(c);
+}
+
+TEST(zero_and_negative_values) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "q", 60000, 0.01, &h) == PLEXUS_OK);
+
+    for (int i = 0; i < 6; i++) ASSERT(plexus_observe(c, h, 0.0) == PLEXUS_OK);
+    for (int i = 0; i < 4; i++) ASSERT(plexus_observe(c, h, 10.0) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, h, NAN) == PLEXUS_OK);
+
+    ASSERT(plexus_sketch_quantile(c, h, 0.5) == 0.0);
+    ASSERT(rel_err(plexus_sketch_quantile(c, h, 0.9), 10.0) <= 0.011);
+    ASSERT(c->sketches[h].active.count == 10);
+
+    plexus_free(c);
+}
+
+TEST(window_close_queues_sketch_and_quantiles) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.01, &h) == PLEXUS_OK);
+
+    for (int i = 1; i <= 100; i++) ASSERT(plexus_observe(c, h, (double)i) == PLEXUS_OK);
+
+    mock_hal_advance_tick(999);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 4);
+
+    const plexus_metric_t* p = find_point(c, "lat");
+    ASSERT(p && p->value.type == PLEXUS_VALUE_SKETCH);
+    ASSERT(c->sketches[h].pending.count == 100);
+    p = find_point(c, "lat.p50");
+    ASSERT(p && rel_err(p->value.data.number, 50.0) <= 0.03);
+    p = find_point(c, "lat.p99");
+    ASSERT(p && rel_err(p->value.data.number, 99.0) <= 0.011);
+    ASSERT(find_point(c, "lat.p90") != NULL);
+
+    /* Open window restarts empty */
+    ASSERT(isnan(plexus_sketch_quantile(c, h, 0.5)));
+
+    plexus_free(c);
+}
+
+TEST(unflushed_windows_merge_into_one_sketch) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.01, &h) == PLEXUS_OK);
+
+    ASSERT(plexus_observe(c, h, 5.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    /* Late sample closes the previous window */
+    ASSERT(plexus_observe(c, h, 500.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 4);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+
+    /* Second window adds only quantile points; its bins merge into the queued sketch */
+    ASSERT(plexus_pending_count(c) == 7);
+    const plexus_sketch_data_t* pending = &c->sketches[h].pending;
+    ASSERT(pending->count == 2);
+    ASSERT(pending->min == 5.0 && pending->max == 500.0);
+
+    /* Clearing the queue releases the pending sketch */
+    plexus_clear(c);
+    ASSERT(!c->sketches[h].pending_queued);
+    ASSERT(c->sketches[h].pending.count == 0);
+
+    plexus_free(c);
+}
+
+TEST(buffer_full_keeps_window_open) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1) == PLEXUS_OK);
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.01, &h) == PLEXUS_OK);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_METRICS - 2; i++) {
+        snprintf(name, sizeof(name), "fill_%d", i);
+        ASSERT(plexus_send(c, name, 0.0) == PLEXUS_OK);
+    }
+
+    ASSERT(plexus_observe(c, h, 7.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == PLEXUS_MAX_METRICS - 2);
+    ASSERT(c->sketches[h].active.count == 1);
+
+    /* Samples keep folding into the overdue window until there is room */
+    ASSERT(plexus_observe(c, h, 9.0) == PLEXUS_OK);
+    plexus_clear(c);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 4);
+    ASSERT(c->sketches[h].pending.count == 2);
+
+    plexus_free(c);
+}
+
+TEST(sketch_point_serializes_as_buckets) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.01, &h) == PLEXUS_OK);
+
+    ASSERT(plexus_observe(c, h, 0.0) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, h, 10.0) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, h, 10.0) == PLEXUS_OK);
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+
+    char buf[2048];
+    int len = plexus_json_serialize(c, buf, sizeof(buf));
+    ASSERT(len > 0);
+    ASSERT(strstr(buf, "\"metric\":\"lat\",\"value\":{\"type\":\"ddsketch\"") != NULL);
+    ASSERT(strstr(buf, "\"zero\":1,\"bins\":[2],\"count\":3") != NULL);
+    ASSERT(strstr(buf, "\"min\":0,\"max\":10}") != NULL);
+    ASSERT(strstr(buf, "\"offset\":116") != NULL); /* ceil(ln 10 / ln(1.01/0.99)) */
+
+    plexus_free(c);
+}
+
+TEST(extreme_values_stay_in_bounds) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    plexus_sketch_handle_t h, fine;
+    ASSERT(plexus_sketch_register(c, "lat", 1000, 0.01, &h) == PLEXUS_OK);
+    /* Tiny alpha puts DBL_MAX far past any int32_t bin index */
+    ASSERT(plexus_sketch_register(c, "fine", 1000, 1e-12, &fine) == PLEXUS_OK);
+
+    ASSERT(plexus_observe(c, h, INFINITY) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_observe(c, h, -INFINITY) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(c->sketches[h].active.count == 0);
+
+    ASSERT(plexus_observe(c, h, DBL_MAX) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, h, 1.0) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, fine, DBL_MAX) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, fine, DBL_MIN) == PLEXUS_OK);
+    ASSERT(plexus_observe(c, fine, 1.0) == PLEXUS_OK);
+    ASSERT(c->sketches[fine].active.count == 3);
+    ASSERT(plexus_sketch_quantile(c, fine, 1.0) == DBL_MAX);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_sketch:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(register_table_full);
+    RUN(quantiles_within_relative_accuracy);
+    RUN(wide_range_keeps_upper_quantiles);
+    RUN(busy_bin_does_not_saturate);
+    RUN(zero_and_negative_values);
+    RUN(window_close_queues_sketch_and_quantiles);
+    RUN(unflushed_windows_merge_into_one_sketch);
+    RUN(buffer_full_keeps_window_open);
+    RUN(sketch_point_serializes_as_buckets);
+    RUN(extreme_values_stay_in_bounds);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,328 @@
+/**
+ * @file test_soak.c
+ * @brief Soak scenarios on the simulated-network HAL (virtual time)
+ *
+ * Each scenario samples a sequence-numbered metric at a fixed rate through
+ * a faulty network, heals the network, drains, and accounts for every
+ * point: delivered, duplicated, lost after acceptance, or rejected at send.
+ * Hours of device time run in about a second.
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_soak [hours] [seed]
+ * Requires: -DPLEXUS_ENABLE_PERSISTENT_BUFFER=1 -DPLEXUS_ENABLE_CLIENT_STATS=1, linked with sim_hal.c
+ *
+ * [hours] scales every scenario (default 1 = ctest length); [seed] changes
+ * the fault draws.
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include "sim_hal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+static char s_report[512];
+static uint32_t s_scale = 1;
+static uint32_t s_seed = 12345;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    sim_hal_reset(s_seed); \
+    s_report[0] = '\0'; \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+    if (s_report[0]) { \
+        printf("    %s\n", s_report); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define MINUTE_MS 60000ULL
+#define HOUR_MS (60 * MINUTE_MS)
+
+/* ---- Harness ---- */
+
+typedef struct {
+    uint32_t sent;             /* Accepted by plexus_send_number() */
+    uint32_t rejected;         /* PLEXUS_ERR_BUFFER_FULL at send */
+    uint32_t delivered;        /* Unique points the server received */
+    uint32_t duplicates;       /* Extra copies beyond the first */
+    uint32_t lost;             /* Accepted but never delivered */
+    uint32_t late_lost;        /* Lost among points sent after last_fault_ms */
+    uint32_t lat_p50_ms;       /* Send to first delivery */
+    uint32_t lat_p90_ms;
+    uint32_t lat_p99_ms;
+    uint32_t lat_max_ms;
+    uint16_t persist_backlog;  /* Batches still in storage after the drain */
+    plexus_client_stats_t client;
+    sim_hal_stats_t net;
+} soak_result_t;
+
+typedef struct {
+    uint32_t capacity;
+    uint64_t* sent_at;         /* Virtual ms of each accepted point */
+    uint32_t* first_latency;
+    uint8_t* copies;
+} soak_track_t;
+
+static void on_deliver(const char* body, size_t len, uint64_t now_ms, void* user_data) {
+    soak_track_t* t = (soak_track_t*)user_data;
+    const char* end = body + len;
+    const char* p = body;
+
+    /* Every point is {"metric":"soak.seq","value":<seq>,...} */
+    while ((p = strstr(p, "\"value\":")) != NULL && p < end) {
+        p += 8;
+        uint32_t seq = (uint32_t)strtoul(p, NULL, 10);
+        if (seq < t->capacity) {
+            if (t->copies[seq] == 0) {
+                t->first_latency[seq] = (uint32_t)(now_ms - t->sent_at[seq]);
+            }
+            if (t->copies[seq] < 255) {
+                t->copies[seq]++;
+            }
+        }
+    }
+}
+
+static int cmp_u32(const void* a, const void* b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/*
+ * Sample every period_ms for duration_ms, ticking in between; a blocking
+ * flush skips the samples it overlaps, as it would on a device. Then heal the
+ * network and tick until the queue and storage are empty.
+ */
+static bool soak_run(soak_result_t* r, uint64_t duration_ms, uint32_t period_ms,
+                     uint64_t last_fault_ms) {
+    memset(r, 0, sizeof(*r));
+
+    soak_track_t t;
+    t.capacity = (uint32_t)(duration_ms / period_ms) + 1;
+    t.sent_at = (uint64_t*)calloc(t.capacity, sizeof(uint64_t));
+    t.first_latency = (uint32_t*)calloc(t.capacity, sizeof(uint32_t));
+    t.copies = (uint8_t*)calloc(t.capacity, sizeof(uint8_t));
+    plexus_client_t* c = plexus_init("plx_key", "soak-001");
+    if (!t.sent_at || !t.first_latency || !t.copies || !c) {
+        free(t.sent_at);
+        free(t.first_latency);
+        free(t.copies);
+        plexus_free(c);
+        return false;
+    }
+    sim_hal_set_deliver_cb(on_deliver, &t);
+
+    uint64_t next = 0;
+    while (r->sent < t.capacity && sim_hal_now_ms() < duration_ms) {
+        uint64_t now = sim_hal_now_ms();
+        if (now < next) {
+            sim_hal_advance((uint32_t)(next - now));
+            now = next;
+        }
+        t.sent_at[r->sent] = now;
+        if (plexus_send_number(c, "soak.seq", (double)r->sent) == PLEXUS_ERR_BUFFER_FULL) {
+            r->rejected++;
+        } else {
+            r->sent++;
+        }
+        (void)plexus_tick(c);
+        next = now + period_ms;
+    }
+
+    /* Heal and drain: faults stop, the device keeps ticking */
+    sim_net_config_t healthy;
+    memset(&healthy, 0, sizeof(healthy));
+    healthy.latency_ms = 50;
+    sim_hal_set_network(&healthy);
+    uint64_t drain_until = sim_hal_now_ms() + 10 * MINUTE_MS;
+    while (sim_hal_now_ms() < drain_until) {
+        (void)plexus_tick(c);
+        if (plexus_pending_count(c) == 0 && plexus_internal_persist_backlog() == 0) {
+            break;
+        }
+        sim_hal_advance(1000);
+        (void)plexus_flush(c);
+    }
+
+    uint32_t* lat = (uint32_t*)malloc((r->sent + 1) * sizeof(uint32_t));
+    uint32_t nlat = 0;
+    for (uint32_t i = 0; i < r->sent; i++) {
+        if (t.copies[i] == 0) {
+            r->lost++;
+            if (t.sent_at[i] >= last_fault_ms) {
+                r->late_lost++;
+            }
+            continue;
+        }
+        r->delivered++;
+        r->duplicates += (uint32_t)t.copies[i] - 1;
+        if (lat) {
+            lat[nlat++] = t.first_latency[i];
+        }
+    }
+    if (lat && nlat > 0) {
+        qsort(lat, nlat, sizeof(uint32_t), cmp_u32);
+        r->lat_p50_ms = lat[nlat / 2];
+        r->lat_p90_ms = lat[(uint64_t)nlat * 90 / 100];
+        r->lat_p99_ms = lat[(uint64_t)nlat * 99 / 100];
+        r->lat_max_ms = lat[nlat - 1];
+    }
+    free(lat);
+
+    r->persist_backlog = plexus_internal_persist_backlog();
+    (void)plexus_get_stats(c, &r->client);
+    sim_hal_get_stats(&r->net);
+
+    snprintf(s_report, sizeof(s_report),
+             "sent %lu delivered %lu dup %lu lost %lu rejected %lu | "
+             "latency p50 %lu p90 %lu p99 %lu max %lu ms | "
+             "queue hw %u (%lu B) storage hw %lu B | posts %lu retries %lu",
+             (unsigned long)r->sent, (unsigned long)r->delivered,
+             (unsigned long)r->duplicates, (unsigned long)r->lost,
+             (unsigned long)r->rejected, (unsigned long)r->lat_p50_ms,
+             (unsigned long)r->lat_p90_ms, (unsigned long)r->lat_p99_ms,
+             (unsigned long)r->lat_max_ms, (unsigned)r->client.queue_high_water,
+             (unsigned long)(r->client.queue_high_water * sizeof(plexus_metric_t)),
+             (unsigned long)r->net.storage_high_water, (unsigned long)r->net.posts,
+             (unsigned long)r->client.retries);
+
+    plexus_free(c);
+    free(t.sent_at);
+    free(t.first_latency);
+    free(t.copies);
+    return true;
+}
+
+/* ---- Scenarios ---- */
+
+TEST(transient_faults_recovered_by_retry) {
+    sim_net_config_t net;
+    memset(&net, 0, sizeof(net));
+    net.latency_dist = SIM_LATENCY_EXPONENTIAL;
+    net.latency_ms = 60;
+    net.latency_spread_ms = 40;
+    net.latency_max_ms = 3000;
+    net.bandwidth_bps = 20000;
+    net.timeout_ms = 10000;
+    net.loss_rate = 0.02;
+    net.server_error_rate = 0.01;
+    sim_hal_set_network(&net);
+
+    soak_result_t r;
+    ASSERT(soak_run(&r, 2 * HOUR_MS * s_scale, 100, 0));
+    ASSERT(r.sent > 0);
+    ASSERT(r.rejected == 0);
+    ASSERT(r.lost == 0);
+    ASSERT(r.duplicates == 0);
+    ASSERT(r.delivered == r.sent);
+    ASSERT(r.client.retries > 0);
+    ASSERT(r.lat_p50_ms < 1000);
+}
+
+TEST(lost_acks_duplicate_but_never_drop) {
+    sim_net_config_t net;
+    memset(&net, 0, sizeof(net));
+    net.latency_dist = SIM_LATENCY_UNIFORM;
+    net.latency_ms = 40;
+    net.latency_max_ms = 200;
+    net.timeout_ms = 5000;
+    net.ack_loss_rate = 0.05;
+    sim_hal_set_network(&net);
+
+    soak_result_t r;
+    ASSERT(soak_run(&r, HOUR_MS * s_scale, 100, 0));
+    ASSERT(r.net.ack_lost > 0);
+    ASSERT(r.lost == 0);
+    ASSERT(r.rejected == 0);
+    ASSERT(r.duplicates > 0);
+    ASSERT(r.delivered == r.sent);
+}
+
+TEST(outage_persisted_then_drained_once) {
+    sim_net_config_t net;
+    memset(&net, 0, sizeof(net));
+    net.latency_ms = 80;
+    net.timeout_ms = 10000;
+    sim_hal_set_network(&net);
+
+    /* Link down for 10 minutes, then a 5 minute 5xx storm */
+    uint64_t base = 20 * MINUTE_MS * s_scale;
+    ASSERT(sim_hal_add_window(base, base + 10 * MINUTE_MS, PLEXUS_ERR_NETWORK));
+    ASSERT(sim_hal_add_window(base + 30 * MINUTE_MS, base + 35 * MINUTE_MS, PLEXUS_ERR_SERVER));
+
+    soak_result_t r;
+    ASSERT(soak_run(&r, base + HOUR_MS, 200, base + 35 * MINUTE_MS));
+    ASSERT(r.net.outage_failures > 0);
+    ASSERT(r.persist_backlog == 0);
+    ASSERT(r.net.storage_high_water > 0);
+    /* Persisted batches are sent once, not again from the queue */
+    ASSERT(r.duplicates == 0);
+    /* Outages may lose what storage cannot hold, never what came after */
+    ASSERT(r.late_lost == 0);
+    ASSERT(r.delivered > r.sent / 2);
+}
+
+TEST(rate_limit_window_honours_cooldown) {
+    sim_net_config_t net;
+    memset(&net, 0, sizeof(net));
+    net.latency_ms = 30;
+    net.bandwidth_bps = 8000;
+    net.timeout_ms = 5000;
+    sim_hal_set_network(&net);
+
+    uint64_t start = 10 * MINUTE_MS;
+    uint64_t len = 4 * MINUTE_MS;
+    ASSERT(sim_hal_add_window(start, start + len, PLEXUS_ERR_RATE_LIMIT));
+
+    soak_result_t r;
+    ASSERT(soak_run(&r, HOUR_MS * s_scale, 500, start + len));
+
+    /* While limited, each cooldown expiry costs at most two posts: the
+     * persisted-batch drain and the current batch */
+    ASSERT(r.net.outage_failures <= 2 * (len / PLEXUS_RATE_LIMIT_COOLDOWN_MS + 1));
+    ASSERT(r.late_lost == 0);
+    ASSERT(r.duplicates == 0);
+    ASSERT(r.persist_backlog == 0);
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        s_scale = (uint32_t)strtoul(argv[1], NULL, 10);
+        if (s_scale == 0) {
+            s_scale = 1;
+        }
+    }
+    if (argc > 2) {
+        s_seed = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+
+    printf("test_soak (scale %lu, seed %lu):\n", (unsigned long)s_scale, (unsigned long)s_seed);
+
+    RUN(transient_faults_recovered_by_retry);
+    RUN(lost_acks_duplicate_but_never_drop);
+    RUN(outage_persisted_then_drained_once);
+    RUN(rate_limit_window_honours_cooldown);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
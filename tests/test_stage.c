@@ -0,0 +1,252 @@
+/**
+ * @file test_stage.c
+ * @brief Tests for per-thread staging buffers (plexus_send_staged())
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_stage
+ * Requires: -DPLEXUS_ENABLE_THREAD_SAFE=1 -DPLEXUS_ENABLE_THREAD_STAGING=1
+ */
+
+#include "plexus.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern int mock_hal_post_call_count(void);
+extern const char* mock_hal_last_post_body(void);
+extern void mock_hal_mutex_reset(void);
+extern int mock_hal_mutex_lock_count(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_mutex_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define STAGE_SLOTS (PLEXUS_STAGE_SIZE - 1)
+
+/* No count-based flush unless a test asks for one */
+static plexus_client_t* new_client(void) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    }
+    return c;
+}
+
+/* ---- Single thread ---- */
+
+TEST(staged_until_flush) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send_staged(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send_staged(c, "temp", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_total_sent(c) == 2);
+    plexus_free(c);
+}
+
+TEST(lock_taken_only_to_claim_a_stage) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send_staged(c, "temp", 1.0) == PLEXUS_OK);
+    int after_claim = mock_hal_mutex_lock_count();
+    for (int i = 0; i < STAGE_SLOTS - 1; i++) {
+        ASSERT(plexus_send_staged(c, "temp", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(mock_hal_mutex_lock_count() == after_claim);
+    plexus_free(c);
+}
+
+TEST(tick_flushes_staged_points_on_interval) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send_staged(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_next_deadline_ms(c) == PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 0);
+    mock_hal_advance_tick(PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_total_sent(c) == 1);
+    plexus_free(c);
+}
+
+TEST(full_stage_merges_under_the_lock) {
+    plexus_client_t* c = new_client();
+    for (int i = 0; i < STAGE_SLOTS; i++) {
+        ASSERT(plexus_send_staged(c, "temp", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+
+    /* One more makes room by merging what fits into the queue */
+    ASSERT(plexus_send_staged(c, "temp", 99.0) == PLEXUS_OK);
+    uint16_t merged = STAGE_SLOTS < PLEXUS_MAX_METRICS ? STAGE_SLOTS : PLEXUS_MAX_METRICS;
+    ASSERT(plexus_pending_count(c) == merged);
+    ASSERT(c->metrics[0].value.data.number == 0.0);
+    plexus_free(c);
+}
+
+TEST(full_stage_and_queue_drop) {
+    plexus_client_t* c = new_client();
+    for (int i = 0; i < PLEXUS_MAX_METRICS; i++) {
+        ASSERT(plexus_send(c, "temp", (double)i) == PLEXUS_OK);
+    }
+    for (int i = 0; i < STAGE_SLOTS; i++) {
+        ASSERT(plexus_send_staged(c, "temp", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_send_staged(c, "temp", 99.0) == PLEXUS_ERR_BUFFER_FULL);
+
+    plexus_totals_t t;
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.dropped == 1);
+    plexus_free(c);
+}
+
+TEST(validates_name) {
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_send_staged(NULL, "temp", 1.0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_send_staged(c, NULL, 1.0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_send_staged(c, "", 1.0) == PLEXUS_ERR_INVALID_ARG);
+    plexus_stage_release(NULL);
+    plexus_free(c);
+}
+
+/* ---- Threads ---- */
+
+#define PRODUCERS 4
+#define PER_PRODUCER (STAGE_SLOTS < (PLEXUS_MAX_METRICS - 1) / PRODUCERS ? \
+                      STAGE_SLOTS : (PLEXUS_MAX_METRICS - 1) / PRODUCERS)
+
+typedef struct {
+    plexus_client_t* client;
+    int id;
+    plexus_err_t err;
+    bool release;
+} producer_t;
+
+static pthread_mutex_t s_claim_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void* producer_main(void* arg) {
+    producer_t* p = (producer_t*)arg;
+    char name[16];
+    snprintf(name, sizeof(name), "t%d", p->id);
+
+    /* Claims take the client lock; the mock's lock is not a real mutex */
+    pthread_mutex_lock(&s_claim_lock);
+    p->err = plexus_send_staged(p->client, name, 0.0);
+    pthread_mutex_unlock(&s_claim_lock);
+
+    for (int i = 1; i < PER_PRODUCER && p->err == PLEXUS_OK; i++) {
+        p->err = plexus_send_staged(p->client, name, (double)i);
+    }
+    if (p->release) {
+        plexus_stage_release(p->client);
+    }
+    return NULL;
+}
+
+static int run_producers(plexus_client_t* c, producer_t* ps, bool release) {
+    pthread_t threads[PRODUCERS];
+    for (int i = 0; i < PRODUCERS; i++) {
+        ps[i].client = c;
+        ps[i].id = i;
+        ps[i].err = PLEXUS_OK;
+        ps[i].release = release;
+        if (pthread_create(&threads[i], NULL, producer_main, &ps[i]) != 0) {
+            return -1;
+        }
+    }
+    for (int i = 0; i < PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    return 0;
+}
+
+TEST(threads_merge_in_timestamp_order) {
+    plexus_client_t* c = new_client();
+    producer_t ps[PRODUCERS];
+    ASSERT(run_producers(c, ps, false) == 0);
+    for (int i = 0; i < PRODUCERS; i++) {
+        ASSERT(ps[i].err == PLEXUS_OK);
+    }
+
+    ASSERT(plexus_send(c, "marker", 0.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(c) == PRODUCERS * PER_PRODUCER + 1);
+
+    const char* body = mock_hal_last_post_body();
+    uint64_t last_ts = 0;
+    const char* at = body;
+    int seen = 0;
+    while ((at = strstr(at, "\"timestamp\":")) != NULL) {
+        unsigned long long ts = 0;
+        ASSERT(sscanf(at, "\"timestamp\":%llu", &ts) == 1);
+        at++;
+        if (seen++ == 0) {
+            continue;   /* The marker was queued directly, ahead of the merge */
+        }
+        ASSERT(ts >= last_ts);
+        last_ts = ts;
+    }
+    ASSERT(seen == PRODUCERS * PER_PRODUCER + 1);
+    plexus_free(c);
+}
+
+TEST(released_stages_are_reused) {
+    plexus_client_t* c = new_client();
+    producer_t ps[PRODUCERS];
+    for (int round = 0; round < (PLEXUS_MAX_STAGES / PRODUCERS) + 2; round++) {
+        ASSERT(run_producers(c, ps, true) == 0);
+        ASSERT(plexus_flush(c) == PLEXUS_OK);
+    }
+    int free_stages = 0;
+    for (int i = 0; i < PLEXUS_MAX_STAGES; i++) {
+        free_stages += c->stages[i].owner == NULL;
+    }
+    ASSERT(free_stages == PLEXUS_MAX_STAGES);
+    plexus_free(c);
+}
+
+/* ---- Main ---- */
+
+int main(void) {
+    printf("test_stage:\n");
+
+    RUN(staged_until_flush);
+    RUN(lock_taken_only_to_claim_a_stage);
+    RUN(tick_flushes_staged_points_on_interval);
+    RUN(full_stage_merges_under_the_lock);
+    RUN(full_stage_and_queue_drop);
+    RUN(validates_name);
+    RUN(threads_merge_in_timestamp_order);
+    RUN(released_stages_are_reused);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,238 @@
+/**
+ * @file test_stats.c
+ * @brief Tests for the plexus_stats_* array statistics kernels
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_stats
+ * Requires: -DPLEXUS_ENABLE_STATS=1 (test_stats_portable adds -DPLEXUS_STATS_SIMD=0,
+ *           test_stats_float also -DPLEXUS_STATS_FLOAT_ACCUM=1)
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define SIGNAL_LEN 1031 /* Prime, so every kernel runs its scalar tail */
+
+static float s_signal[SIGNAL_LEN];
+
+/* Deterministic noisy sine with a DC offset and a few outliers */
+static void fill_signal(void) {
+    uint32_t lcg = 12345;
+    for (int i = 0; i < SIGNAL_LEN; i++) {
+        lcg = lcg * 1103515245u + 12345u;
+        float noise = (float)((lcg >> 16) & 0x7FFF) / 32768.0f - 0.5f;
+        s_signal[i] = 2.5f + 4.0f * (float)sin(i * 0.05) + noise;
+    }
+    s_signal[17] = -40.0f;
+    s_signal[SIGNAL_LEN - 1] = 55.0f;
+}
+
+/* Straightforward reference loop */
+static void naive_summary(const float* v, size_t n, plexus_stats_summary_t* out) {
+    memset(out, 0, sizeof(*out));
+    for (size_t i = 0; i < n; i++) {
+        if (i == 0 || v[i] < out->min) out->min = v[i];
+        if (i == 0 || v[i] > out->max) out->max = v[i];
+        out->sum += (double)v[i];
+        out->sumsq += (double)v[i] * (double)v[i];
+    }
+    out->count = n;
+}
+
+/* Compensated float lanes agree with the double reference to float rounding */
+#if PLEXUS_STATS_FLOAT_ACCUM && !PLEXUS_STATS_SIMD
+#define SUM_TOLERANCE 1e-6
+#else
+#define SUM_TOLERANCE 1e-9
+#endif
+
+static int close_rel(double a, double b) {
+    double scale = fabs(b) > 1.0 ? fabs(b) : 1.0;
+    return fabs(a - b) <= SUM_TOLERANCE * scale;
+}
+
+static int same_summary(const plexus_stats_summary_t* a, const plexus_stats_summary_t* b) {
+    return a->count == b->count && a->min == b->min && a->max == b->max &&
+           close_rel(a->sum, b->sum) && close_rel(a->sumsq, b->sumsq);
+}
+
+/* ---- Tests ---- */
+
+TEST(empty_input_is_zero) {
+    plexus_stats_summary_t s;
+    memset(&s, 0xAB, sizeof(s));
+    plexus_stats_summary_f32(s_signal, 0, &s);
+    ASSERT(s.count == 0 && s.sum == 0.0 && s.sumsq == 0.0 && s.min == 0.0f && s.max == 0.0f);
+
+    plexus_stats_summary_f32(NULL, 5, &s);
+    ASSERT(s.count == 0);
+    ASSERT(plexus_stats_mean(&s) == 0.0);
+    ASSERT(plexus_stats_rms(&s) == 0.0);
+    ASSERT(plexus_stats_variance(&s) == 0.0);
+
+    /* NULL output is ignored */
+    plexus_stats_summary_f32(s_signal, 4, NULL);
+}
+
+TEST(kernel_matches_reference_for_every_length) {
+    /* Lengths around every vector width and unroll factor */
+    for (size_t n = 1; n <= 67; n++) {
+        plexus_stats_summary_t fast, portable, ref;
+        plexus_stats_summary_f32(s_signal + 3, n, &fast);
+        plexus_stats_summary_f32_portable(s_signal + 3, n, &portable);
+        naive_summary(s_signal + 3, n, &ref);
+        ASSERT(same_summary(&fast, &ref));
+        ASSERT(same_summary(&portable, &ref));
+    }
+}
+
+TEST(kernel_matches_reference_on_long_signal) {
+    plexus_stats_summary_t fast, ref;
+    plexus_stats_summary_f32(s_signal, SIGNAL_LEN, &fast);
+    naive_summary(s_signal, SIGNAL_LEN, &ref);
+    ASSERT(same_summary(&fast, &ref));
+    ASSERT(fast.min == -40.0f);
+    ASSERT(fast.max == 55.0f);
+}
+
+TEST(unaligned_input) {
+    /* Start at every offset within a 32-byte vector */
+    for (size_t off = 0; off < 8; off++) {
+        plexus_stats_summary_t fast, ref;
+        plexus_stats_summary_f32(s_signal + off, 100, &fast);
+        naive_summary(s_signal + off, 100, &ref);
+        ASSERT(same_summary(&fast, &ref));
+    }
+}
+
+TEST(derived_statistics) {
+    static const float v[] = {2.0f, 4.0f, 4.0f, 4.0f, 5.0f, 5.0f, 7.0f, 9.0f};
+    plexus_stats_summary_t s;
+    plexus_stats_summary_f32(v, 8, &s);
+
+    ASSERT(s.count == 8);
+    ASSERT(plexus_stats_mean(&s) == 5.0);
+    ASSERT(fabs(plexus_stats_variance(&s) - 4.0) < 1e-12);
+    ASSERT(fabs(plexus_stats_rms(&s) - sqrt(29.0)) < 1e-12);
+
+    /* A constant signal never reports negative variance */
+    float flat[33];
+    for (int i = 0; i < 33; i++) flat[i] = 0.1f;
+    plexus_stats_summary_f32(flat, 33, &s);
+    ASSERT(plexus_stats_variance(&s) >= 0.0);
+    ASSERT(plexus_stats_variance(&s) < SUM_TOLERANCE * 1e-3);
+}
+
+TEST(merge_equals_single_pass) {
+    plexus_stats_summary_t a, b, whole;
+    plexus_stats_summary_f32(s_signal, 500, &a);
+    plexus_stats_summary_f32(s_signal + 500, SIGNAL_LEN - 500, &b);
+    plexus_stats_summary_f32(s_signal, SIGNAL_LEN, &whole);
+
+    plexus_stats_merge(&a, &b);
+    ASSERT(same_summary(&a, &whole));
+
+    /* Merging into or from an empty summary */
+    plexus_stats_summary_t empty;
+    plexus_stats_summary_f32(NULL, 0, &empty);
+    plexus_stats_merge(&empty, &whole);
+    ASSERT(same_summary(&empty, &whole));
+
+    plexus_stats_summary_t none;
+    plexus_stats_summary_f32(NULL, 0, &none);
+    plexus_stats_merge(&a, &none);
+    ASSERT(same_summary(&a, &whole));
+}
+
+TEST(nan_skipped_by_min_max) {
+    /* NaN first, inside a vector block and in the scalar tail */
+    float v[21];
+    for (int i = 0; i < 21; i++) v[i] = (float)i - 5.0f;
+    v[0] = NAN;
+    v[9] = NAN;
+    v[20] = NAN;
+
+    plexus_stats_summary_t fast, portable;
+    plexus_stats_summary_f32(v, 21, &fast);
+    plexus_stats_summary_f32_portable(v, 21, &portable);
+    ASSERT(fast.min == -4.0f && fast.max == 14.0f);
+    ASSERT(portable.min == -4.0f && portable.max == 14.0f);
+    ASSERT(isnan(fast.sum) && isnan(portable.sum));
+
+    for (int i = 0; i < 21; i++) v[i] = NAN;
+    plexus_stats_summary_f32(v, 21, &fast);
+    plexus_stats_summary_f32_portable(v, 21, &portable);
+    ASSERT(isnan(fast.min) && isnan(fast.max));
+    ASSERT(isnan(portable.min) && isnan(portable.max));
+    ASSERT(fast.count == 21);
+}
+
+TEST(long_sum_stays_accurate) {
+    /* 100k samples of 0.1f: plain float accumulation drifts by ~1e-3 */
+    static float v[100000];
+    for (size_t i = 0; i < 100000; i++) v[i] = 0.1f;
+    plexus_stats_summary_t s;
+    plexus_stats_summary_f32(v, 100000, &s);
+    double expect = 100000.0 * (double)0.1f;
+    ASSERT(fabs(s.sum - expect) <= 1e-6 * expect);
+    ASSERT(fabs(plexus_stats_mean(&s) - (double)0.1f) <= 1e-6 * 0.1);
+}
+
+TEST(backend_reported) {
+    const char* b = plexus_stats_backend();
+    ASSERT(b != NULL);
+#if !PLEXUS_STATS_SIMD
+    ASSERT(strcmp(b, "portable") == 0);
+#else
+    ASSERT(strcmp(b, "avx2") == 0 || strcmp(b, "sse2") == 0 || strcmp(b, "portable") == 0);
+#endif
+}
+
+int main(void) {
+    printf("test_stats:\n");
+    fill_signal();
+
+    RUN(empty_input_is_zero);
+    RUN(kernel_matches_reference_for_every_length);
+    RUN(kernel_matches_reference_on_long_signal);
+    RUN(unaligned_input);
+    RUN(derived_statistics);
+    RUN(merge_equals_single_pass);
+    RUN(nan_skipped_by_min_max);
+    RUN(long_sum_stays_accurate);
+    RUN(backend_reported);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -60,6 +60,19 @@ TEST(send_acquires_and_releases_mutex) {
     plexus_free(c);
 }
 
+TEST(send_batch_locks_once) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    const plexus_point_t pts[] = { { "a", 1.0, 0 }, { "b", 2.0, 0 }, { "c", 3.0, 0 } };
+    mock_hal_mutex_reset();
+
+    ASSERT(plexus_send_batch(c, pts, 3) == PLEXUS_OK);
+
+    ASSERT(mock_hal_mutex_lock_count() == 1);
+    ASSERT(mock_hal_mutex_unlock_count() == 1);
+
+    plexus_free(c);
+}
+
 TEST(flush_acquires_and_releases_mutex) {
     plexus_client_t* c = plexus_init("plx_key", "dev-001");
     plexus_send_number(c, "temp", 25.0);
@@ -124,17 +137,26 @@ TEST(mutex_balanced_on_no_data_flush) {
     plexus_free(c);
 }
 
+TEST(send_null_client_does_not_lock) {
+    ASSERT(plexus_send_number(NULL, "temp", 1.0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_send_number_ts(NULL, "temp", 1.0, 1000) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(mock_hal_mutex_lock_count() == 0);
+    ASSERT(mock_hal_mutex_unlock_count() == 0);
+}
+
 /* ---- Main ---- */
 
 int main(void) {
     printf("test_threadsafe:\n");
 
     RUN(send_acquires_and_releases_mutex);
+    RUN(send_batch_locks_once);
     RUN(flush_acquires_and_releases_mutex);
     RUN(clear_acquires_and_releases_mutex);
     RUN(set_endpoint_acquires_mutex);
     RUN(mutex_balanced_on_flush_error);
     RUN(mutex_balanced_on_no_data_flush);
+    RUN(send_null_client_does_not_lock);
 
     printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
     return tests_failed > 0 ? 1 : 0;
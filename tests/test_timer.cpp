@@ -0,0 +1,134 @@
+/**
+ * @file test_timer.cpp
+ * @brief Tests for plexus::ScopedTimer and PLEXUS_TIME_SCOPE in plexus.hpp
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_timer
+ * Requires: C++20, -DPLEXUS_ENABLE_TIMING=1 -DPLEXUS_ENABLE_AGGREGATION=1 -DPLEXUS_ENABLE_SKETCHES=1
+ */
+
+#include "plexus.hpp"
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern "C" void mock_hal_reset(void);
+extern "C" void mock_hal_advance_tick(uint32_t delta_ms);
+extern "C" void mock_hal_set_cycles(uint32_t cycles);
+extern "C" void mock_hal_advance_cycles(uint32_t delta);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_set_cycles(0); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* The mock counter runs at 100 counts per microsecond */
+static void work(uint32_t us) {
+    mock_hal_advance_cycles(us * 100);
+}
+
+static void timed_work(plexus::Metric<double>& m, uint32_t us) {
+    PLEXUS_TIME_SCOPE(m);
+    work(us);
+}
+
+/* ---- Tests ---- */
+
+TEST(timer_sends_elapsed_microseconds) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Metric<double> m(c, "isr_us");
+    {
+        plexus::ScopedTimer t(m);
+        work(250);
+        ASSERT(t.elapsedUs() == 250.0);
+        work(5);
+    }
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(strcmp(c->metrics[0].name, "isr_us") == 0);
+    ASSERT(c->metrics[0].value.data.number == 255.0);
+    plexus_free(c);
+}
+
+TEST(timer_survives_counter_wrap) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    plexus::Metric<double> m(c, "wrap_us");
+    mock_hal_set_cycles(0xFFFFFF00u);
+    timed_work(m, 10);
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(c->metrics[0].value.data.number == 10.0);
+    plexus_free(c);
+}
+
+TEST(hot_loop_folds_into_aggregate) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_aggregate_register(c, "loop_us", 1000, PLEXUS_AGG_MEAN | PLEXUS_AGG_MAX) ==
+           PLEXUS_OK);
+    plexus::Metric<double> m(c, "loop_us");
+
+    for (uint32_t i = 1; i <= 100; i++) {
+        timed_work(m, i);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+
+    mock_hal_advance_tick(1000);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 2);
+    ASSERT(strcmp(c->metrics[0].name, "loop_us.max") == 0);
+    ASSERT(c->metrics[0].value.data.number == 100.0);
+    ASSERT(strcmp(c->metrics[1].name, "loop_us.mean") == 0);
+    ASSERT(c->metrics[1].value.data.number == 50.5);
+    plexus_free(c);
+}
+
+TEST(timer_observes_into_sketch) {
+    PlexusClient px("plx_key", "dev-001");
+    plexus_sketch_handle_t h;
+    ASSERT(plexus_sketch_register(px.handle(), "rpc_us", 60000, 0.05, &h) == PLEXUS_OK);
+
+    for (uint32_t i = 0; i < 99; i++) {
+        PLEXUS_TIME_SCOPE(px, h);
+        work(100);
+    }
+    {
+        PLEXUS_TIME_SCOPE(px, h);
+        work(5000);
+    }
+    ASSERT(px.pendingCount() == 0);
+    double p50 = plexus_sketch_quantile(px.handle(), h, 0.5);
+    double p100 = plexus_sketch_quantile(px.handle(), h, 1.0);
+    ASSERT(p50 > 95.0 && p50 < 105.0);
+    ASSERT(p100 > 4750.0 && p100 < 5250.0);
+}
+
+int main(void) {
+    printf("test_timer:\n");
+
+    RUN(timer_sends_elapsed_microseconds);
+    RUN(timer_survives_counter_wrap);
+    RUN(hot_loop_folds_into_aggregate);
+    RUN(timer_observes_into_sketch);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_totals.c
+ * @brief Tests for the lock-free lifetime totals (plexus_get_totals())
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_totals
+ */
+
+#include "plexus.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_set_next_post_result(plexus_err_t err);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+static plexus_client_t* new_client(void) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    }
+    return c;
+}
+
+/* ---- Totals ---- */
+
+TEST(new_client_starts_at_zero) {
+    plexus_client_t* c = new_client();
+    plexus_totals_t t;
+    memset(&t, 0xff, sizeof(t));
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.sent == 0 && t.errors == 0 && t.dropped == 0 && t.pending == 0);
+    plexus_free(c);
+}
+
+TEST(totals_follow_sends_flushes_and_errors) {
+    plexus_client_t* c = new_client();
+    plexus_totals_t t;
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(c, "temp", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.pending == 2);
+    ASSERT(plexus_pending_count(c) == 2);
+
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+    ASSERT(plexus_flush(c) == PLEXUS_ERR_NETWORK);
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.errors == 1);
+    ASSERT(t.pending == 2);
+
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.sent == 2 && t.pending == 0);
+    ASSERT(plexus_total_sent(c) == 2);
+    ASSERT(plexus_total_errors(c) == 1);
+    plexus_free(c);
+}
+
+TEST(clear_resets_pending_only) {
+    plexus_client_t* c = new_client();
+    plexus_totals_t t;
+    ASSERT(plexus_send(c, "temp", 1.0) == PLEXUS_OK);
+    plexus_clear(c);
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.pending == 0 && t.sent == 0);
+    plexus_free(c);
+}
+
+TEST(full_queue_counts_drops) {
+    plexus_client_t* c = new_client();
+    for (int i = 0; i < PLEXUS_MAX_METRICS; i++) {
+        ASSERT(plexus_send(c, "temp", (double)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_send(c, "temp", 0.0) == PLEXUS_ERR_BUFFER_FULL);
+
+    /* A refused batch stays with its caller, so it is not a drop */
+    plexus_point_t pts[2] = { { "a", 1.0, 0 }, { "b", 2.0, 0 } };
+    ASSERT(plexus_send_batch(c, pts, 2) == PLEXUS_ERR_BUFFER_FULL);
+
+    plexus_totals_t t;
+    ASSERT(plexus_get_totals(c, &t) == PLEXUS_OK);
+    ASSERT(t.dropped == 1);
+    ASSERT(t.pending == PLEXUS_MAX_METRICS);
+    plexus_free(c);
+}
+
+TEST(get_totals_validates) {
+    plexus_totals_t t;
+    ASSERT(plexus_get_totals(NULL, &t) == PLEXUS_ERR_NULL_PTR);
+    plexus_client_t* c = new_client();
+    ASSERT(plexus_get_totals(c, NULL) == PLEXUS_ERR_NULL_PTR);
+    plexus_free(c);
+    ASSERT(plexus_pending_count(NULL) == 0);
+}
+
+TEST(totals_do_not_share_a_line_with_the_send_path) {
+#if PLEXUS_CACHE_LINE_SIZE > 0
+    size_t begin = offsetof(plexus_client_t, totals);
+    size_t end = begin + sizeof(plexus_totals_t);
+    ASSERT(begin - offsetof(plexus_client_t, last_flush_ms) >= PLEXUS_CACHE_LINE_SIZE);
+    ASSERT(offsetof(plexus_client_t, flush_interval_ms) - end >= PLEXUS_CACHE_LINE_SIZE);
+#endif
+    ASSERT(sizeof(plexus_total_t) == (PLEXUS_TOTALS_64BIT ? 8 : 4));
+}
+
+/* ---- Concurrent reader ---- */
+
+#define WRITER_ROUNDS 2000
+
+typedef struct {
+    plexus_client_t* client;
+    volatile int done;
+    int regressions;
+    int reads;
+} reader_ctx_t;
+
+static void* reader_main(void* arg) {
+    reader_ctx_t* ctx = (reader_ctx_t*)arg;
+    plexus_total_t last_sent = 0;
+    while (!ctx->done) {
+        plexus_totals_t t;
+        if (plexus_get_totals(ctx->client, &t) != PLEXUS_OK) {
+            ctx->regressions++;
+            break;
+        }
+        if (t.sent < last_sent || t.pending > PLEXUS_MAX_METRICS) {
+            ctx->regressions++;
+        }
+        last_sent = t.sent;
+        ctx->reads++;
+    }
+    return NULL;
+}
+
+TEST(reader_thread_sees_monotonic_totals) {
+    plexus_client_t* c = new_client();
+    reader_ctx_t ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.client = c;
+
+    pthread_t reader;
+    ASSERT(pthread_create(&reader, NULL, reader_main, &ctx) == 0);
+    for (int i = 0; i < WRITER_ROUNDS; i++) {
+        (void)plexus_send(c, "temp", (double)i);
+        if (i % 4 == 3) {
+            (void)plexus_flush(c);
+        }
+    }
+    ctx.done = 1;
+    pthread_join(reader, NULL);
+
+    ASSERT(ctx.regressions == 0);
+    ASSERT(plexus_total_sent(c) == WRITER_ROUNDS);
+    plexus_free(c);
+}
+
+/* ---- Main ---- */
+
+int main(void) {
+    printf("test_totals:\n");
+
+    RUN(new_client_starts_at_zero);
+    RUN(totals_follow_sends_flushes_and_errors);
+    RUN(clear_resets_pending_only);
+    RUN(full_queue_counts_drops);
+    RUN(get_totals_validates);
+    RUN(totals_do_not_share_a_line_with_the_send_path);
+    RUN(reader_thread_sees_monotonic_totals);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file test_trace.c
+ * @brief Tests for plexus_on_trace() flush-phase and WebSocket trace hooks
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_trace
+ * Requires: -DPLEXUS_ENABLE_TRACE=1 -DPLEXUS_ENABLE_WEBSOCKET=1 -DPLEXUS_ENABLE_PERSISTENT_BUFFER=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_ws_reset(void);
+extern void mock_hal_ws_inject(plexus_ws_event_t event, const char* data);
+extern void mock_hal_set_next_post_result(plexus_err_t err);
+extern void mock_hal_storage_reset(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define MAX_EVENTS 64
+static plexus_trace_event_t s_events[MAX_EVENTS];
+static int s_event_count = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_ws_reset(); \
+    mock_hal_storage_reset(); \
+    s_event_count = 0; \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+static void record(const plexus_trace_event_t* event, void* user_data) {
+    (void)user_data;
+    if (s_event_count < MAX_EVENTS) {
+        s_events[s_event_count] = *event;
+    }
+    s_event_count++;
+}
+
+/* Index of the next event matching phase/edge at or after start, or -1 */
+static int find_event(int start, plexus_trace_phase_t phase, plexus_trace_edge_t edge) {
+    for (int i = start; i < s_event_count && i < MAX_EVENTS; i++) {
+        if (s_events[i].phase == phase && s_events[i].edge == edge) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int count_events(plexus_trace_phase_t phase, plexus_trace_edge_t edge) {
+    int n = 0;
+    for (int i = 0; i < s_event_count && i < MAX_EVENTS; i++) {
+        if (s_events[i].phase == phase && s_events[i].edge == edge) {
+            n++;
+        }
+    }
+    return n;
+}
+
+/* Drive the WS state machine to CONNECTED */
+static void ws_connect(plexus_client_t* c) {
+    (void)plexus_set_org_id(c, "org_1");
+    (void)plexus_ws_connect(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_CONNECTED, NULL);
+    (void)plexus_tick(c);
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DATA, "{\"type\":\"authenticated\"}");
+    (void)plexus_tick(c);
+}
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_on_trace(NULL, record, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_on_trace(c, record, NULL) == PLEXUS_OK);
+    ASSERT(plexus_on_trace(c, NULL, NULL) == PLEXUS_OK);
+
+    /* No callback, no events */
+    ASSERT(plexus_send_number(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    ASSERT(s_event_count == 0);
+    plexus_free(c);
+}
+
+TEST(successful_flush_spans_nest) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    int tag = 7;
+    ASSERT(plexus_on_trace(c, record, &tag) == PLEXUS_OK);
+    ASSERT(plexus_send_number(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send_number(c, "temp", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+
+    ASSERT(s_event_count == 6);
+    ASSERT(s_events[0].phase == PLEXUS_TRACE_FLUSH && s_events[0].edge == PLEXUS_TRACE_BEGIN);
+    ASSERT(s_events[0].value == 2);
+    ASSERT(s_events[1].phase == PLEXUS_TRACE_SERIALIZE && s_events[1].edge == PLEXUS_TRACE_BEGIN);
+    ASSERT(s_events[2].phase == PLEXUS_TRACE_SERIALIZE && s_events[2].edge == PLEXUS_TRACE_END);
+    uint32_t bytes = s_events[2].value;
+    ASSERT(bytes > 0);
+    ASSERT(s_events[3].phase == PLEXUS_TRACE_HTTP_POST && s_events[3].edge == PLEXUS_TRACE_BEGIN);
+    ASSERT(s_events[3].value == bytes);
+    ASSERT(s_events[4].phase == PLEXUS_TRACE_HTTP_POST && s_events[4].edge == PLEXUS_TRACE_END);
+    ASSERT(s_events[4].err == PLEXUS_OK);
+    ASSERT(s_events[5].phase == PLEXUS_TRACE_FLUSH && s_events[5].edge == PLEXUS_TRACE_END);
+    ASSERT(s_events[5].value == bytes && s_events[5].err == PLEXUS_OK);
+    plexus_free(c);
+}
+
+TEST(failed_flush_traces_retries_backoff_and_persist) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_on_trace(c, record, NULL) == PLEXUS_OK);
+    ASSERT(plexus_send_number(c, "temp", 1.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+    ASSERT(plexus_flush(c) == PLEXUS_ERR_NETWORK);
+
+    ASSERT(count_events(PLEXUS_TRACE_HTTP_POST, PLEXUS_TRACE_END) == PLEXUS_MAX_RETRIES);
+    ASSERT(count_events(PLEXUS_TRACE_BACKOFF, PLEXUS_TRACE_BEGIN) == PLEXUS_MAX_RETRIES - 1);
+
+    /* Backoff sleeps advance the clock by the traced delay */
+    int b = find_event(0, PLEXUS_TRACE_BACKOFF, PLEXUS_TRACE_BEGIN);
+    ASSERT(b >= 0 && s_events[b + 1].edge == PLEXUS_TRACE_END);
+    ASSERT(s_events[b + 1].timestamp_us - s_events[b].timestamp_us == s_events[b].value * 1000u);
+
+    int w = find_event(0, PLEXUS_TRACE_PERSIST_WRITE, PLEXUS_TRACE_END);
+    ASSERT(w >= 0 && s_events[w].err == PLEXUS_OK && s_events[w].value > 0);
+    int f = find_event(0, PLEXUS_TRACE_FLUSH, PLEXUS_TRACE_END);
+    ASSERT(f == s_event_count - 1 && f > w);
+    ASSERT(s_events[f].err == PLEXUS_ERR_NETWORK);
+
+    /* The next flush drains the stored batch inside its own span */
+    s_event_count = 0;
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    ASSERT(plexus_send_number(c, "temp", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    int d = find_event(0, PLEXUS_TRACE_PERSIST_DRAIN, PLEXUS_TRACE_BEGIN);
+    int d_end = find_event(0, PLEXUS_TRACE_PERSIST_DRAIN, PLEXUS_TRACE_END);
+    ASSERT(d == 1);
+    ASSERT(s_events[d + 1].phase == PLEXUS_TRACE_HTTP_POST);
+    ASSERT(d_end == d + 3 && s_events[d_end].err == PLEXUS_OK);
+    ASSERT(find_event(d_end, PLEXUS_TRACE_SERIALIZE, PLEXUS_TRACE_BEGIN) > d_end);
+    plexus_free(c);
+}
+
+TEST(ws_state_changes_and_send) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_on_trace(c, record, NULL) == PLEXUS_OK);
+    ws_connect(c);
+
+    ASSERT(count_events(PLEXUS_TRACE_WS_STATE, PLEXUS_TRACE_INSTANT) == 3);
+    int i = find_event(0, PLEXUS_TRACE_WS_STATE, PLEXUS_TRACE_INSTANT);
+    ASSERT(s_events[i].value == PLEXUS_WS_CONNECTING);
+    i = find_event(i + 1, PLEXUS_TRACE_WS_STATE, PLEXUS_TRACE_INSTANT);
+    ASSERT(s_events[i].value == PLEXUS_WS_AUTHENTICATING);
+    i = find_event(i + 1, PLEXUS_TRACE_WS_STATE, PLEXUS_TRACE_INSTANT);
+    ASSERT(s_events[i].value == PLEXUS_WS_CONNECTED);
+
+    s_event_count = 0;
+    ASSERT(plexus_send_number(c, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(c) == PLEXUS_OK);
+    int w = find_event(0, PLEXUS_TRACE_WS_SEND, PLEXUS_TRACE_END);
+    ASSERT(w > 0 && s_events[w].err == PLEXUS_OK && s_events[w].value > 0);
+    /* WS-only mode: no HTTP attempt */
+    ASSERT(count_events(PLEXUS_TRACE_HTTP_POST, PLEXUS_TRACE_BEGIN) == 0);
+
+    s_event_count = 0;
+    mock_hal_ws_inject(PLEXUS_WS_EVENT_DISCONNECTED, NULL);
+    ASSERT(plexus_tick(c) == PLEXUS_OK);
+    i = find_event(0, PLEXUS_TRACE_WS_STATE, PLEXUS_TRACE_INSTANT);
+    ASSERT(i >= 0 && s_events[i].value == PLEXUS_WS_RECONNECTING);
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_trace:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(successful_flush_spans_nest);
+    RUN(failed_flush_traces_retries_backoff_and_persist);
+    RUN(ws_state_changes_and_send);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
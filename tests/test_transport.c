@@ -0,0 +1,378 @@
+/**
+ * @file test_transport.c
+ * @brief Tests for the shared transport (plexus_transport_t)
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_transport
+ * Requires: -DPLEXUS_ENABLE_SHARED_TRANSPORT=1 -DPLEXUS_ENABLE_THREAD_SAFE=1
+ *           -DPLEXUS_ENABLE_STATUS_CALLBACK=1 -DPLEXUS_TRANSPORT_BUFFER_SIZE=1024
+ */
+
+#include "plexus.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_set_next_post_result(plexus_err_t err);
+extern int mock_hal_post_call_count(void);
+extern const char* mock_hal_last_post_body(void);
+extern const char* mock_hal_last_post_url(void);
+extern void mock_hal_mutex_reset(void);
+extern int mock_hal_mutex_lock_count(void);
+extern int mock_hal_mutex_unlock_count(void);
+extern int mock_hal_mutex_errors(void);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    mock_hal_mutex_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+/* Fits a 1024-byte request alone, but two of them do not */
+#define SMALL_BATCH 8
+
+static plexus_transport_t* s_transport;
+static plexus_client_t* s_a;
+static plexus_client_t* s_b;
+
+/* No count-based flush unless a test asks for one */
+static plexus_client_t* new_client(const char* source_id) {
+    plexus_client_t* c = plexus_init("plx_key", source_id);
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+    }
+    return c;
+}
+
+static bool setup(void) {
+    s_transport = plexus_transport_init();
+    s_a = new_client("dev-a");
+    s_b = new_client("dev-b");
+    return s_transport && s_a && s_b &&
+           plexus_transport_attach(s_transport, s_a) == PLEXUS_OK &&
+           plexus_transport_attach(s_transport, s_b) == PLEXUS_OK;
+}
+
+static void teardown(void) {
+    plexus_free(s_a);
+    plexus_free(s_b);
+    plexus_transport_free(s_transport);
+}
+
+static bool send_points(plexus_client_t* c, int count) {
+    for (int i = 0; i < count; i++) {
+        if (plexus_send(c, "temp", (double)i) != PLEXUS_OK) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* ---- Coalescing ---- */
+
+TEST(flush_sends_every_client_in_one_request) {
+    ASSERT(setup());
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+
+    ASSERT(plexus_flush(s_a) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(strstr(mock_hal_last_post_body(), "\"source_id\":\"dev-a\"") != NULL);
+    ASSERT(strstr(mock_hal_last_post_body(), "\"source_id\":\"dev-b\"") != NULL);
+    ASSERT(strcmp(mock_hal_last_post_url(), PLEXUS_DEFAULT_ENDPOINT) == 0);
+
+    ASSERT(plexus_pending_count(s_a) == 0 && plexus_pending_count(s_b) == 0);
+    ASSERT(plexus_total_sent(s_a) == 1 && plexus_total_sent(s_b) == 1);
+    ASSERT(plexus_get_status(s_b) == PLEXUS_STATUS_CONNECTED);
+    teardown();
+}
+
+TEST(posts_to_the_transport_endpoint) {
+    ASSERT(setup());
+    ASSERT(plexus_set_endpoint(s_a, "https://a.example.com/ingest") == PLEXUS_OK);
+    ASSERT(plexus_transport_set_endpoint(s_transport, "https://gw.example.com/ingest") == PLEXUS_OK);
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+
+    ASSERT(plexus_transport_flush(s_transport) == PLEXUS_OK);
+    ASSERT(strcmp(mock_hal_last_post_url(), "https://gw.example.com/ingest") == 0);
+    teardown();
+}
+
+TEST(idle_clients_are_left_out) {
+    ASSERT(setup());
+    ASSERT(plexus_transport_flush(s_transport) == PLEXUS_ERR_NO_DATA);
+    ASSERT(mock_hal_post_call_count() == 0);
+
+    /* Flushing a client with nothing queued still sends its neighbours */
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(s_b) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(strstr(mock_hal_last_post_body(), "dev-b") == NULL);
+    ASSERT(plexus_total_sent(s_a) == 1);
+    teardown();
+}
+
+TEST(full_request_buffer_splits_requests) {
+    ASSERT(setup());
+    ASSERT(send_points(s_a, SMALL_BATCH));
+    ASSERT(send_points(s_b, SMALL_BATCH));
+
+    ASSERT(plexus_transport_flush(s_transport) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 2);
+    ASSERT(strstr(mock_hal_last_post_body(), "dev-a") == NULL);
+    ASSERT(plexus_total_sent(s_a) == SMALL_BATCH && plexus_total_sent(s_b) == SMALL_BATCH);
+    teardown();
+}
+
+TEST(client_too_big_for_the_buffer_is_split) {
+    ASSERT(setup());
+    ASSERT(send_points(s_a, PLEXUS_MAX_METRICS));
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+
+    ASSERT(plexus_transport_flush(s_transport) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() > 1);
+    ASSERT(strstr(mock_hal_last_post_body(), "dev-b") != NULL);
+    ASSERT(plexus_total_sent(s_a) == PLEXUS_MAX_METRICS && plexus_total_sent(s_b) == 1);
+    ASSERT(plexus_total_errors(s_a) == 0);
+    ASSERT(plexus_pending_count(s_a) == 0 && plexus_pending_count(s_b) == 0);
+    teardown();
+}
+
+TEST(split_client_keeps_the_rest_on_a_failed_request) {
+    ASSERT(setup());
+    ASSERT(send_points(s_a, PLEXUS_MAX_METRICS));
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+
+    ASSERT(plexus_transport_flush(s_transport) == PLEXUS_ERR_NETWORK);
+    ASSERT(plexus_total_sent(s_a) == 0);
+    ASSERT(plexus_pending_count(s_a) == PLEXUS_MAX_METRICS);
+
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    ASSERT(plexus_transport_flush(s_transport) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(s_a) == PLEXUS_MAX_METRICS);
+    ASSERT(plexus_pending_count(s_a) == 0);
+    teardown();
+}
+
+TEST(tick_interval_flush_coalesces) {
+    ASSERT(setup());
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+
+    mock_hal_advance_tick(PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+    ASSERT(plexus_tick(s_a) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_total_sent(s_b) == 1);
+
+    /* b's interval restarted with the shared flush */
+    ASSERT(plexus_tick(s_b) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    teardown();
+}
+
+/* ---- Shared retry state ---- */
+
+TEST(failed_request_stays_queued) {
+    ASSERT(setup());
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_NETWORK);
+
+    ASSERT(plexus_flush(s_a) == PLEXUS_ERR_NETWORK);
+    ASSERT(mock_hal_post_call_count() == PLEXUS_MAX_RETRIES);
+    ASSERT(plexus_pending_count(s_a) == 1 && plexus_pending_count(s_b) == 1);
+    ASSERT(plexus_total_errors(s_a) == 1 && plexus_total_errors(s_b) == 1);
+    ASSERT(plexus_get_status(s_b) == PLEXUS_STATUS_DISCONNECTED);
+    teardown();
+}
+
+TEST(nowait_hands_back_the_shared_backoff) {
+    ASSERT(setup());
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_SERVER);
+
+    uint32_t retry_after = 0;
+    ASSERT(plexus_flush_nowait(s_a, &retry_after) == PLEXUS_ERR_SERVER);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(retry_after > 0);
+    ASSERT(plexus_total_errors(s_b) == 0);
+
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    ASSERT(plexus_flush_nowait(s_a, &retry_after) == PLEXUS_OK);
+    ASSERT(retry_after == 0);
+    ASSERT(plexus_total_sent(s_b) == 1);
+    teardown();
+}
+
+TEST(rate_limit_holds_back_every_client) {
+    ASSERT(setup());
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    mock_hal_set_next_post_result(PLEXUS_ERR_RATE_LIMIT);
+    ASSERT(plexus_flush(s_a) == PLEXUS_ERR_RATE_LIMIT);
+    ASSERT(mock_hal_post_call_count() == 1);
+
+    mock_hal_set_next_post_result(PLEXUS_OK);
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_flush(s_b) == PLEXUS_ERR_RATE_LIMIT);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(plexus_next_deadline_ms(s_b) > PLEXUS_AUTO_FLUSH_INTERVAL_MS);
+
+    mock_hal_advance_tick(PLEXUS_RATE_LIMIT_COOLDOWN_MS);
+    ASSERT(plexus_flush(s_b) == PLEXUS_OK);
+    ASSERT(plexus_total_sent(s_a) == 1 && plexus_total_sent(s_b) == 1);
+    teardown();
+}
+
+/* ---- Attach / detach ---- */
+
+TEST(attach_validates) {
+    ASSERT(setup());
+    plexus_client_t* other_key = plexus_init("plx_other", "dev-c");
+    ASSERT(other_key);
+
+    ASSERT(plexus_transport_attach(NULL, s_a) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_transport_attach(s_transport, NULL) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_transport_attach(s_transport, s_a) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_transport_attach(s_transport, other_key) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_transport_detach(other_key) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_transport_detach(NULL) == PLEXUS_ERR_NULL_PTR);
+
+    plexus_client_t* extra[PLEXUS_MAX_TRANSPORT_CLIENTS];
+    int attached = 2;
+    for (int i = 0; i < PLEXUS_MAX_TRANSPORT_CLIENTS; i++) {
+        extra[i] = new_client("dev-x");
+        ASSERT(extra[i]);
+        plexus_err_t err = plexus_transport_attach(s_transport, extra[i]);
+        ASSERT(err == (attached < PLEXUS_MAX_TRANSPORT_CLIENTS ? PLEXUS_OK : PLEXUS_ERR_BUFFER_FULL));
+        attached += err == PLEXUS_OK;
+    }
+    for (int i = 0; i < PLEXUS_MAX_TRANSPORT_CLIENTS; i++) {
+        plexus_free(extra[i]);
+    }
+    plexus_free(other_key);
+    teardown();
+}
+
+TEST(detached_client_uses_its_own_path) {
+    ASSERT(setup());
+    ASSERT(plexus_transport_set_endpoint(s_transport, "https://gw.example.com/ingest") == PLEXUS_OK);
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+    ASSERT(plexus_transport_detach(s_b) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(s_b) == 1);
+
+    ASSERT(plexus_flush(s_b) == PLEXUS_OK);
+    ASSERT(strcmp(mock_hal_last_post_url(), PLEXUS_DEFAULT_ENDPOINT) == 0);
+    ASSERT(strstr(mock_hal_last_post_body(), "{\"sdk\":\"c/" PLEXUS_SDK_VERSION "\",\"source_id\":\"dev-b\"") != NULL);
+    ASSERT(plexus_pending_count(s_a) == 1);
+    teardown();
+}
+
+TEST(free_detaches_and_locks_balance) {
+    ASSERT(setup());
+    ASSERT(plexus_send(s_a, "temp", 1.0) == PLEXUS_OK);
+    ASSERT(plexus_send(s_b, "rpm", 2.0) == PLEXUS_OK);
+    plexus_free(s_b);
+    s_b = NULL;
+
+    ASSERT(plexus_flush(s_a) == PLEXUS_OK);
+    ASSERT(mock_hal_post_call_count() == 1);
+    ASSERT(strstr(mock_hal_last_post_body(), "dev-b") == NULL);
+    ASSERT(mock_hal_mutex_lock_count() > 0);
+    ASSERT(mock_hal_mutex_lock_count() == mock_hal_mutex_unlock_count());
+    teardown();
+}
+
+#define SWAP_ROUNDS 20000
+
+static int s_swapping;
+
+static void* send_while_swapped(void* arg) {
+    (void)arg;
+    for (int i = 0; __atomic_load_n(&s_swapping, __ATOMIC_RELAXED); i++) {
+        (void)plexus_send(s_b, "rpm", (double)i);
+        if (i % 16 == 0) {
+            (void)plexus_flush(s_b);
+        }
+        plexus_clear(s_b);
+    }
+    return NULL;
+}
+
+TEST(attach_and_detach_race_senders) {
+    ASSERT(setup());
+    pthread_t sender;
+    __atomic_store_n(&s_swapping, 1, __ATOMIC_RELAXED);
+    ASSERT(pthread_create(&sender, NULL, send_while_swapped, NULL) == 0);
+
+    /* Each swap must leave racing lockers holding the mutex they release */
+    for (int i = 0; i < SWAP_ROUNDS; i++) {
+        (void)plexus_transport_detach(s_b);
+        (void)plexus_transport_attach(s_transport, s_b);
+    }
+    __atomic_store_n(&s_swapping, 0, __ATOMIC_RELAXED);
+    pthread_join(sender, NULL);
+
+    ASSERT(mock_hal_mutex_errors() == 0);
+    ASSERT(mock_hal_mutex_lock_count() == mock_hal_mutex_unlock_count());
+    teardown();
+}
+
+TEST(static_transport) {
+    PLEXUS_TRANSPORT_STATIC_BUF(buf);
+    ASSERT(plexus_transport_init_static(&buf, sizeof(buf) - 1) == NULL);
+    plexus_transport_t* t = plexus_transport_init_static(&buf, sizeof(buf));
+    ASSERT(t == &buf);
+    ASSERT(plexus_transport_flush(t) == PLEXUS_ERR_NO_DATA);
+    plexus_transport_free(t);
+    ASSERT(plexus_transport_flush(t) == PLEXUS_ERR_NOT_INITIALIZED);
+    ASSERT(plexus_transport_flush(NULL) == PLEXUS_ERR_NULL_PTR);
+}
+
+/* ---- Main ---- */
+
+int main(void) {
+    printf("test_transport:\n");
+
+    RUN(flush_sends_every_client_in_one_request);
+    RUN(posts_to_the_transport_endpoint);
+    RUN(idle_clients_are_left_out);
+    RUN(full_request_buffer_splits_requests);
+    RUN(client_too_big_for_the_buffer_is_split);
+    RUN(split_client_keeps_the_rest_on_a_failed_request);
+    RUN(tick_interval_flush_coalesces);
+    RUN(failed_request_stays_queued);
+    RUN(nowait_hands_back_the_shared_backoff);
+    RUN(rate_limit_holds_back_every_client);
+    RUN(attach_validates);
+    RUN(detached_client_uses_its_own_path);
+    RUN(free_detaches_and_locks_balance);
+    RUN(attach_and_detach_race_senders);
+    RUN(static_transport);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}
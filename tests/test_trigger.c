@@ -0,0 +1,241 @@
+/**
+ * @file test_trigger.c
+ * @brief Tests for trigger-based burst capture
+ *
+ * Build: cmake -B build-test tests/ && cmake --build build-test && ./build-test/test_trigger
+ * Requires: -DPLEXUS_ENABLE_TRIGGER=1
+ */
+
+#include "plexus.h"
+#include "plexus_internal.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <assert.h>
+
+/* Mock HAL helpers */
+extern void mock_hal_reset(void);
+extern void mock_hal_advance_tick(uint32_t delta_ms);
+extern void mock_hal_set_next_post_result(plexus_err_t err);
+
+static int tests_passed = 0;
+static int tests_failed = 0;
+static int s_test_failed_flag = 0;
+
+#define TEST(name) static void test_##name(void)
+#define RUN(name) do { \
+    printf("  %-50s", #name); \
+    mock_hal_reset(); \
+    s_test_failed_flag = 0; \
+    test_##name(); \
+    if (!s_test_failed_flag) { \
+        tests_passed++; \
+        printf("PASS\n"); \
+    } \
+} while(0)
+
+#define ASSERT(cond) do { \
+    if (!(cond)) { \
+        printf("FAIL\n    assertion failed: %s\n    at %s:%d\n", \
+               #cond, __FILE__, __LINE__); \
+        tests_failed++; \
+        s_test_failed_flag = 1; \
+        return; \
+    } \
+} while(0)
+
+#define T0 1700000000000ULL
+
+/* Client that never auto-flushes, so the queue can be inspected */
+static plexus_client_t* quiet_client(void) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    if (c) {
+        (void)plexus_set_flush_count(c, PLEXUS_MAX_METRICS + 1);
+        (void)plexus_set_flush_interval(c, 600000);
+    }
+    return c;
+}
+
+/* ---- Tests ---- */
+
+TEST(register_rejects_bad_args) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(NULL, "v", PLEXUS_TRIGGER_ABOVE, 1.0, 4, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_trigger_register(c, NULL, PLEXUS_TRIGGER_ABOVE, 1.0, 4, 0) == PLEXUS_ERR_NULL_PTR);
+    ASSERT(plexus_trigger_register(c, "v", (plexus_trigger_cond_t)9, 1.0, 4, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_trigger_register(c, "v", PLEXUS_TRIGGER_ABOVE, NAN, 4, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_trigger_register(c, "v", PLEXUS_TRIGGER_CHANGE, -1.0, 4, 0) == PLEXUS_ERR_INVALID_ARG);
+    ASSERT(plexus_trigger_fire(c, "v") == PLEXUS_ERR_INVALID_ARG);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_TRIGGERS; i++) {
+        snprintf(name, sizeof(name), "v%d", i);
+        ASSERT(plexus_trigger_register(c, name, PLEXUS_TRIGGER_ABOVE, 1.0, 4, 0) == PLEXUS_OK);
+    }
+    ASSERT(plexus_trigger_register(c, "extra", PLEXUS_TRIGGER_ABOVE, 1.0, 4, 0) == PLEXUS_ERR_BUFFER_FULL);
+    ASSERT(plexus_trigger_register(c, "v0", PLEXUS_TRIGGER_BELOW, 0.0, 2, 0) == PLEXUS_OK);
+
+    plexus_free(c);
+}
+
+TEST(idle_samples_stay_local) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(c, "amp", PLEXUS_TRIGGER_ABOVE, 10.0, 4, 0) == PLEXUS_OK);
+
+    for (int i = 0; i < 3 * PLEXUS_TRIGGER_RING_SIZE; i++) {
+        ASSERT(plexus_send_number_ts(c, "amp", 1.0, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(c->triggers[0].count == PLEXUS_TRIGGER_RING_SIZE);
+
+    plexus_free(c);
+}
+
+TEST(trigger_queues_pre_and_post_samples) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(c, "amp", PLEXUS_TRIGGER_ABOVE, 10.0, 3, 0) == PLEXUS_OK);
+
+    for (int i = 0; i < 5; i++) {
+        ASSERT(plexus_send_number_ts(c, "amp", (double)i, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_send_number_ts(c, "amp", 50.0, T0 + 5) == PLEXUS_OK);   /* fires */
+    ASSERT(plexus_pending_count(c) == 6);
+
+    for (int i = 6; i < 12; i++) {
+        ASSERT(plexus_send_number_ts(c, "amp", 20.0, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+
+    /* 5 pre + trigger sample + 3 post, in time order */
+    ASSERT(plexus_pending_count(c) == 9);
+    for (uint16_t i = 0; i < 9; i++) {
+        ASSERT(c->metrics[i].timestamp_ms == T0 + i);
+    }
+    ASSERT(c->metrics[5].value.data.number == 50.0);
+
+    plexus_free(c);
+}
+
+TEST(trigger_is_edge_sensitive) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(c, "amp", PLEXUS_TRIGGER_ABOVE, 10.0, 0, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send_number_ts(c, "amp", 50.0, T0) == PLEXUS_OK);       /* fires */
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_send_number_ts(c, "amp", 60.0, T0 + 1) == PLEXUS_OK);   /* still above */
+    ASSERT(plexus_pending_count(c) == 1);
+    ASSERT(plexus_send_number_ts(c, "amp", 5.0, T0 + 2) == PLEXUS_OK);    /* re-arms */
+    ASSERT(plexus_send_number_ts(c, "amp", 55.0, T0 + 3) == PLEXUS_OK);   /* fires again */
+    ASSERT(plexus_pending_count(c) == 4);
+
+    plexus_free(c);
+}
+
+TEST(change_and_manual_triggers) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(c, "step", PLEXUS_TRIGGER_CHANGE, 5.0, 0, 0) == PLEXUS_OK);
+    ASSERT(plexus_trigger_register(c, "cur", PLEXUS_TRIGGER_MANUAL, 0.0, 1, 0) == PLEXUS_OK);
+
+    ASSERT(plexus_send_number_ts(c, "step", 100.0, T0) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "step", 103.0, T0 + 1) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 0);
+    ASSERT(plexus_send_number_ts(c, "step", 90.0, T0 + 2) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);
+
+    ASSERT(plexus_send_number_ts(c, "cur", 1.0, T0 + 3) == PLEXUS_OK);
+    ASSERT(plexus_send_number_ts(c, "cur", 2.0, T0 + 4) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 3);
+    ASSERT(plexus_trigger_fire(c, "cur") == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 5);
+    ASSERT(plexus_send_number_ts(c, "cur", 3.0, T0 + 5) == PLEXUS_OK);    /* post window */
+    ASSERT(plexus_send_number_ts(c, "cur", 4.0, T0 + 6) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 6);
+
+    plexus_free(c);
+}
+
+TEST(low_rate_report_between_bursts) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(c, "amp", PLEXUS_TRIGGER_ABOVE, 10.0, 0, 1000) == PLEXUS_OK);
+
+    ASSERT(plexus_send_number_ts(c, "amp", 1.0, T0) == PLEXUS_OK);        /* first report */
+    ASSERT(plexus_send_number_ts(c, "amp", 2.0, T0 + 1) == PLEXUS_OK);
+    mock_hal_advance_tick(999);
+    ASSERT(plexus_send_number_ts(c, "amp", 3.0, T0 + 2) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 1);
+    mock_hal_advance_tick(1);
+    ASSERT(plexus_send_number_ts(c, "amp", 4.0, T0 + 3) == PLEXUS_OK);    /* second report */
+    ASSERT(plexus_pending_count(c) == 2);
+
+    /* Burst does not re-send the already reported samples */
+    ASSERT(plexus_send_number_ts(c, "amp", 40.0, T0 + 4) == PLEXUS_OK);
+    ASSERT(plexus_pending_count(c) == 5);
+    const double expected[] = { 1.0, 4.0, 2.0, 3.0, 40.0 };
+    for (uint16_t i = 0; i < 5; i++) {
+        ASSERT(c->metrics[i].value.data.number == expected[i]);
+    }
+
+    plexus_free(c);
+}
+
+TEST(burst_larger_than_queue_drains_over_flushes) {
+    plexus_client_t* c = plexus_init("plx_key", "dev-001");
+    ASSERT(plexus_set_flush_interval(c, 600000) == PLEXUS_OK);
+    ASSERT(plexus_trigger_register(c, "amp", PLEXUS_TRIGGER_MANUAL, 0.0, 0, 0) == PLEXUS_OK);
+
+    for (int i = 0; i < PLEXUS_TRIGGER_RING_SIZE; i++) {
+        ASSERT(plexus_send_number_ts(c, "amp", (double)i, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(plexus_trigger_fire(c, "amp") == PLEXUS_OK);
+
+    /* Each tick moves what fits and flushes at the count threshold */
+    for (int i = 0; i < PLEXUS_TRIGGER_RING_SIZE && c->triggers[0].pending > 0; i++) {
+        ASSERT(plexus_tick(c) == PLEXUS_OK);
+    }
+    ASSERT(c->triggers[0].pending == 0);
+    ASSERT(plexus_total_sent(c) + plexus_pending_count(c) == PLEXUS_TRIGGER_RING_SIZE);
+
+    plexus_free(c);
+}
+
+TEST(full_ring_of_burst_data_drops_new_samples) {
+    plexus_client_t* c = quiet_client();
+    ASSERT(plexus_trigger_register(c, "amp", PLEXUS_TRIGGER_MANUAL, 0.0,
+                                   2 * PLEXUS_TRIGGER_RING_SIZE, 0) == PLEXUS_OK);
+
+    char name[16];
+    for (int i = 0; i < PLEXUS_MAX_METRICS; i++) {
+        snprintf(name, sizeof(name), "fill_%d", i);
+        ASSERT(plexus_send(c, name, 0.0) == PLEXUS_OK);
+    }
+
+    ASSERT(plexus_trigger_fire(c, "amp") == PLEXUS_OK);
+    for (int i = 0; i < PLEXUS_TRIGGER_RING_SIZE + 5; i++) {
+        ASSERT(plexus_send_number_ts(c, "amp", (double)i, T0 + (uint64_t)i) == PLEXUS_OK);
+    }
+    ASSERT(c->triggers[0].pending == PLEXUS_TRIGGER_RING_SIZE);
+    ASSERT(c->triggers[0].dropped == 5);
+
+    /* Room frees up: oldest committed samples go first */
+    plexus_clear(c);
+    plexus_trigger_drain(c);
+    ASSERT(c->metrics[0].value.data.number == 0.0);
+    ASSERT(c->metrics[0].timestamp_ms == T0);
+
+    plexus_free(c);
+}
+
+int main(void) {
+    printf("test_trigger:\n");
+
+    RUN(register_rejects_bad_args);
+    RUN(idle_samples_stay_local);
+    RUN(trigger_queues_pre_and_post_samples);
+    RUN(trigger_is_edge_sensitive);
+    RUN(change_and_manual_triggers);
+    RUN(low_rate_report_between_bursts);
+    RUN(burst_larger_than_queue_drains_over_flushes);
+    RUN(full_ring_of_burst_data_drops_new_samples);
+
+    printf("\n  %d passed, %d failed\n\n", tests_passed, tests_failed);
+    return tests_failed > 0 ? 1 : 0;
+}